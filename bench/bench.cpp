@@ -0,0 +1,109 @@
+#include "bench.hpp"
+#include "json.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <limits>
+
+using json = nlohmann::json;
+
+namespace amb::bench {
+
+namespace {
+
+std::map<std::string, BenchFn>& registry() {
+    static std::map<std::string, BenchFn> instance;
+    return instance;
+}
+
+std::vector<Result>& rows() {
+    static std::vector<Result> instance;
+    return instance;
+}
+
+} // namespace
+
+bool registerBenchmark(const std::string& name, BenchFn fn) {
+    registry()[name] = std::move(fn);
+    return true;
+}
+
+const std::map<std::string, BenchFn>& benchmarks() {
+    return registry();
+}
+
+double measure(size_t repeat, const std::function<void()>& fn, const std::function<void()>& setup) {
+    double best = std::numeric_limits<double>::max();
+    for (size_t i = 0; i < std::max<size_t>(1, repeat); ++i) {
+        if (setup) {
+            setup();
+        }
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+std::vector<size_t> jobSweep(size_t maxJobs) {
+    std::vector<size_t> sweep;
+    for (size_t jobs = 1; jobs < maxJobs; jobs *= 2) {
+        sweep.push_back(jobs);
+    }
+    sweep.push_back(std::max<size_t>(1, maxJobs));
+    return sweep;
+}
+
+void report(const std::string& bench, const std::string& variant, size_t jobs,
+            double seconds, double items, const std::string& unit, double baseline) {
+    std::printf("%-20s %-16s jobs=%-3zu %10.3f ms %12.2f %s/s", bench.c_str(), variant.c_str(),
+                jobs, seconds * 1e3, items / seconds, unit.c_str());
+    if (baseline > 0) {
+        std::printf("   x%.2f", baseline / seconds);
+    }
+    std::printf("\n");
+    rows().push_back({bench, variant, jobs, seconds, items / seconds, unit});
+}
+
+const std::vector<Result>& results() {
+    return rows();
+}
+
+bool writeJson(const std::string& path, const Options& options) {
+    json out;
+    out["timestamp"] = static_cast<int64_t>(std::time(nullptr));
+    out["options"] = {
+        {"filter", options.filter},
+        {"max_jobs", options.maxJobs},
+        {"repeat", options.repeat},
+        {"registry", {
+            {"packages", options.registry.packages},
+            {"versions", options.registry.versions},
+            {"fanout", options.registry.fanout},
+            {"files", options.registry.files},
+            {"roots", options.registry.roots},
+        }},
+    };
+    json list = json::array();
+    for (const auto& row : rows()) {
+        list.push_back({
+            {"bench", row.bench},
+            {"variant", row.variant},
+            {"jobs", row.jobs},
+            {"seconds", row.seconds},
+            {"rate", row.rate},
+            {"unit", row.unit},
+        });
+    }
+    out["results"] = std::move(list);
+
+    std::ofstream file(path, std::ios::binary);
+    file << out.dump(2) << "\n";
+    return file.good();
+}
+
+} // namespace amb::bench
\ No newline at end of file
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+// Defines and registers a benchmark body: AMB_BENCHMARK(name) { ... uses `options` ... }
+#define AMB_BENCHMARK(name)                                                         \
+    static void name##_benchmark(const ::amb::bench::Options& options);             \
+    static const bool name##_registered =                                           \
+        ::amb::bench::registerBenchmark(#name, name##_benchmark);                   \
+    static void name##_benchmark([[maybe_unused]] const ::amb::bench::Options& options)
+
+namespace amb::bench {
+
+// Shape of the synthetic registry used by the end-to-end scenarios
+struct RegistryShape {
+    size_t packages = 200;
+    size_t versions = 3;   // per package: 1.0.0, 1.1.0, ...
+    size_t fanout = 3;     // dependencies per package, always on later packages (a DAG)
+    size_t files = 20;     // source files per package
+    size_t roots = 8;      // direct dependencies of the benchmark project
+};
+
+struct Options {
+    std::string filter;    // run only benchmarks whose name contains this
+    size_t maxJobs = 0;    // upper bound for scaling sweeps (0 = hardware concurrency)
+    size_t repeat = 3;     // best-of repetitions per measurement
+    RegistryShape registry;
+    std::string amb;       // amb binary driven by the end-to-end scenarios
+};
+
+// One report() row, kept for the JSON output
+struct Result {
+    std::string bench;
+    std::string variant;
+    size_t jobs = 1;
+    double seconds = 0;
+    double rate = 0;       // items per second
+    std::string unit;
+};
+
+using BenchFn = std::function<void(const Options&)>;
+
+bool registerBenchmark(const std::string& name, BenchFn fn);
+const std::map<std::string, BenchFn>& benchmarks();
+
+// Best wall-clock time in seconds over `repeat` runs; `setup` runs untimed before each
+double measure(size_t repeat, const std::function<void()>& fn,
+               const std::function<void()>& setup = nullptr);
+
+// 1, 2, 4, ... up to and including `maxJobs`
+std::vector<size_t> jobSweep(size_t maxJobs);
+
+// Prints one result row. `items` is the work done per run, expressed in `unit`;
+// `baseline` is the single-job time used for the speedup column (0 = none).
+void report(const std::string& bench, const std::string& variant, size_t jobs,
+            double seconds, double items, const std::string& unit, double baseline = 0);
+
+const std::vector<Result>& results();
+// Every reported row plus the run's options, for scripts/bench_compare.py
+bool writeJson(const std::string& path, const Options& options);
+
+} // namespace amb::bench
\ No newline at end of file
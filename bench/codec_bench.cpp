@@ -0,0 +1,126 @@
+#include "bench.hpp"
+#include "package/compressed_cache.hpp"
+#include "utils/lz_codec.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace amb;
+
+namespace {
+
+// Source-like text: what package archives mostly hold. Deterministic, so runs compare.
+std::vector<std::string> sourceFiles(size_t count) {
+    static const char* const types[] = {"Int", "String", "Bool", "List<Int>", "Map<String, Int>", "Token"};
+    static const char* const verbs[] = {"parse", "read", "write", "format", "check", "resolve", "merge", "split"};
+    static const char* const nouns[] = {"token", "header", "entry", "value", "buffer", "path", "range", "node"};
+
+    uint64_t state = 42;
+    auto next = [&](size_t bound) {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        return static_cast<size_t>((state >> 33) % bound);
+    };
+
+    std::vector<std::string> files;
+    for (size_t f = 0; f < count; ++f) {
+        std::string text = "// module " + std::to_string(f) + ": " + nouns[next(8)] + " helpers\n";
+        text += "import \"std/io@1.0.0\"\nimport \"pkg" + std::to_string(next(100)) + "@1." +
+                std::to_string(next(4)) + ".0\"\n\n";
+        size_t functions = 2 + next(6);
+        for (size_t i = 0; i < functions; ++i) {
+            std::string name = std::string(verbs[next(8)]) + "_" + nouns[next(8)] + "_" + std::to_string(next(1000));
+            std::string type = types[next(6)];
+            text += "/// " + std::string(verbs[next(8)]) + "s the " + nouns[next(8)] + " and returns a " + type + "\n";
+            text += "pub fn " + name + "(input: " + type + ", offset: Int) -> Result<" + type + "> {\n";
+            size_t lines = 2 + next(8);
+            for (size_t l = 0; l < lines; ++l) {
+                std::string local = std::string(nouns[next(8)]) + std::to_string(l);
+                switch (next(4)) {
+                case 0:
+                    text += "    let " + local + " = input." + verbs[next(8)] + "(offset + " + std::to_string(next(64)) + ")\n";
+                    break;
+                case 1:
+                    text += "    if " + local + ".is_empty() {\n        return Err(\"unexpected end of " +
+                            nouns[next(8)] + "\")\n    }\n";
+                    break;
+                case 2:
+                    text += "    for item in " + local + ".iter() {\n        total += item." + verbs[next(8)] + "()\n    }\n";
+                    break;
+                default:
+                    text += "    // " + std::string(verbs[next(8)]) + " before " + nouns[next(8)] + "\n";
+                }
+            }
+            text += "    return Ok(input)\n}\n\n";
+        }
+        files.push_back(std::move(text));
+    }
+    return files;
+}
+
+std::string ratioLabel(const std::string& name, double raw, double compressed) {
+    char buffer[64];
+    std::snprintf(buffer, sizeof(buffer), "%s ratio=%.2f", name.c_str(), raw / compressed);
+    return buffer;
+}
+
+} // namespace
+
+// Cache compression: ratio against decode throughput, for small files alone, small
+// files with a trained dictionary, and whole archives in cache blocks
+AMB_BENCHMARK(codec_lz) {
+    auto files = sourceFiles(2000);
+    // Trained on one half, measured on the other, as a cache sees new packages
+    std::vector<std::string_view> training(files.begin(), files.begin() + 1000);
+    std::vector<std::string_view> tested(files.begin() + 1000, files.end());
+    std::string dictionary = lzTrainDictionary(training);
+
+    double raw = 0;
+    std::string joined;
+    for (auto file : tested) {
+        raw += static_cast<double>(file.size());
+        joined += file;
+    }
+
+    for (bool withDictionary : {false, true}) {
+        std::string_view dict = withDictionary ? std::string_view(dictionary) : std::string_view();
+        std::vector<std::string> encoded;
+        double compressed = 0;
+        double encode = bench::measure(options.repeat, [&] {
+            encoded.clear();
+            for (auto file : tested) {
+                encoded.push_back(lzCompress(file, dict));
+            }
+        });
+        for (const auto& block : encoded) {
+            compressed += static_cast<double>(block.size());
+        }
+        size_t failures = 0;
+        double decode = bench::measure(options.repeat, [&] {
+            for (size_t i = 0; i < tested.size(); ++i) {
+                failures += lzDecompress(encoded[i], tested[i].size(), dict) ? 0u : 1u;
+            }
+        });
+        if (failures > 0) {
+            std::printf("codec_lz: %zu round trip failure(s)\n", failures);
+        }
+        std::string name = withDictionary ? "files+dict" : "files";
+        bench::report("codec_lz", ratioLabel(name + " encode", raw, compressed), 1, encode, raw / 1e6, "MB");
+        bench::report("codec_lz", ratioLabel(name + " decode", raw, compressed), 1, decode, raw / 1e6, "MB");
+    }
+
+    // The cache format: one archive's worth of files, in 256KB blocks
+    for (bool withDictionary : {false, true}) {
+        std::string_view dict = withDictionary ? std::string_view(dictionary) : std::string_view();
+        std::string packed = CompressedCache::encode(joined, dict);
+        double decode = bench::measure(options.repeat, [&] {
+            if (!CompressedCache::decode(packed, dict)) {
+                std::printf("codec_lz: archive round trip failed\n");
+            }
+        });
+        std::string name = withDictionary ? "archive+dict" : "archive";
+        bench::report("codec_lz", ratioLabel(name + " decode", raw, static_cast<double>(packed.size())), 1,
+                      decode, raw / 1e6, "MB");
+    }
+}
\ No newline at end of file
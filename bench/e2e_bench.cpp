@@ -0,0 +1,102 @@
+#include "bench.hpp"
+#include "synthetic_registry.hpp"
+#include "package/resolver.hpp"
+#include "registry/registry_index.hpp"
+#include "utils/process.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <map>
+#include <string>
+
+using namespace amb;
+
+namespace {
+
+// Drives the real `amb` binary against a synthetic registry with its own HOME
+class Scenario {
+public:
+    Scenario(const bench::Options& options, bench::SyntheticRegistry registry)
+        : options_(options), registry_(std::move(registry)) {}
+
+    // Best time of `args` over the repeat count; -1 if any run fails
+    double time(const std::string& args, const std::function<void()>& setup = nullptr) {
+        bool ok = true;
+        double seconds = bench::measure(options_.repeat, [&] { ok = run(args) && ok; }, setup);
+        if (!ok) {
+            std::fprintf(stderr, "amb %s failed, see %s\n", args.c_str(), log().string().c_str());
+            return -1;
+        }
+        return seconds;
+    }
+
+    bool run(const std::string& args) {
+        std::string command = "\"" + options_.amb + "\" -j " + std::to_string(options_.maxJobs) + " " + args;
+        auto result = Process::runShell(command, registry_.project, log(), {{"HOME", registry_.home.string()}});
+        return result.exitCode == 0;
+    }
+
+    void clearProject() {
+        fs::remove_all(registry_.project / "ambar_modules");
+        fs::remove(registry_.project / "ambar.lock");
+    }
+
+    void clearAll() {
+        clearProject();
+        fs::remove_all(registry_.home / ".ambar" / "cache");
+        fs::remove_all(registry_.home / ".ambar" / "lib");
+    }
+
+    fs::path log() const { return registry_.home / "amb_bench.log"; }
+
+private:
+    const bench::Options& options_;
+    bench::SyntheticRegistry registry_;
+};
+
+void reportIfOk(const std::string& variant, size_t jobs, double seconds, double items, const std::string& unit) {
+    if (seconds >= 0) {
+        bench::report("e2e", variant, jobs, seconds, items, unit);
+    }
+}
+
+} // namespace
+
+// User-visible commands over a synthetic registry (--packages/--versions/--fanout/--files)
+AMB_BENCHMARK(e2e_commands) {
+    auto registry = bench::syntheticRegistry(options.registry);
+    if (!registry) {
+        std::fprintf(stderr, "could not generate the synthetic registry\n");
+        return;
+    }
+
+    auto index = RegistryIndex::load("file://" + registry->registry.generic_string());
+    if (!index) {
+        return;
+    }
+    std::map<std::string, std::string> roots;
+    for (size_t i = 0; i < std::min(options.registry.roots, options.registry.packages); ++i) {
+        roots[bench::packageName(i)] = "^1.0.0";
+    }
+    auto resolution = Resolver(*index, nullptr).resolve(roots);
+    if (!resolution) {
+        return;
+    }
+    double packages = static_cast<double>(resolution->packages.size());
+    size_t jobs = options.maxJobs;
+
+    Scenario scenario(options, *registry);
+    reportIfOk("cold_install", jobs, scenario.time("install", [&] { scenario.clearAll(); }), packages, "pkg");
+    reportIfOk("warm_install", jobs, scenario.time("install", [&] { scenario.clearProject(); }), packages, "pkg");
+    reportIfOk("noop_install", jobs, scenario.time("install"), packages, "pkg");
+    reportIfOk("list", jobs, scenario.time("list"), packages, "pkg");
+    reportIfOk("search", jobs, scenario.time("search " + bench::packageName(0)), 1, "query");
+
+    double load = bench::measure(options.repeat, [&] {
+        RegistryIndex::load("file://" + registry->registry.generic_string());
+    });
+    bench::report("e2e", "index_load", 1, load, static_cast<double>(index->size()), "record");
+    double resolve = bench::measure(options.repeat, [&] { Resolver(*index, nullptr).resolve(roots); });
+    bench::report("e2e", "resolve", 1, resolve, packages, "pkg");
+}
\ No newline at end of file
@@ -0,0 +1,110 @@
+#include "bench.hpp"
+#include "core/scheduler.hpp"
+#include "utils/filesystem.hpp"
+#include "utils/io_engine.hpp"
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace amb;
+
+namespace {
+
+// Package-like tree: many small sources plus a few large binary assets
+double makeTree(const fs::path& root) {
+    fs::remove_all(root);
+    double bytes = 0;
+    for (size_t i = 0; i < 1500; ++i) {
+        fs::path path = root / ("mod" + std::to_string(i % 24)) / ("sub" + std::to_string(i % 3)) /
+                        ("file" + std::to_string(i) + ".amb");
+        size_t size = 1024 + (i * 7919) % 16384;
+        fs::create_directories(path.parent_path());
+        std::ofstream(path, std::ios::binary) << std::string(size, static_cast<char>('a' + i % 26));
+        bytes += static_cast<double>(size);
+    }
+    for (size_t i = 0; i < 8; ++i) {
+        size_t size = 4 * 1024 * 1024;
+        std::ofstream(root / ("asset" + std::to_string(i) + ".bin"), std::ios::binary)
+            << std::string(size, static_cast<char>('A' + i));
+        bytes += static_cast<double>(size);
+    }
+    return bytes / 1e6;
+}
+
+// The userspace baseline: serial walk, 64 KiB read/write through a buffer
+void naiveCopy(const fs::path& from, const fs::path& to) {
+    std::vector<char> buffer(64 * 1024);
+    fs::create_directories(to);
+    for (const auto& entry : fs::recursive_directory_iterator(from)) {
+        fs::path target = to / entry.path().lexically_relative(from);
+        if (entry.is_directory()) {
+            fs::create_directories(target);
+            continue;
+        }
+        std::ifstream in(entry.path(), std::ios::binary);
+        std::ofstream out(target, std::ios::binary);
+        while (in.read(buffer.data(), static_cast<std::streamsize>(buffer.size())) || in.gcount() > 0) {
+            out.write(buffer.data(), in.gcount());
+        }
+    }
+}
+
+} // namespace
+
+// Global -> local install shape: whole package tree copies
+AMB_BENCHMARK(fs_copy_directory) {
+    fs::path root = fs::temp_directory_path() / "amb_bench_copy";
+    fs::path source = root / "src";
+    fs::path target = root / "dst";
+    double megabytes = makeTree(source);
+    auto clean = [&] { fs::remove_all(target); };
+
+    double baseline = bench::measure(options.repeat, [&] { naiveCopy(source, target); }, clean);
+    bench::report("fs_copy_directory", "read_write_loop", 1, baseline, megabytes, "MB", baseline);
+
+    auto& engine = IoEngine::instance();
+    for (size_t jobs : bench::jobSweep(options.maxJobs)) {
+        Scheduler scheduler(jobs);
+        engine.setExecutor([&scheduler](size_t count, const std::function<void(size_t)>& fn) {
+            parallelFor(scheduler, count, fn);
+        });
+        double seconds = bench::measure(options.repeat, [&] { FileSystem::copyDirectory(source, target); }, clean);
+        bench::report("fs_copy_directory", "copy_file_range", jobs, seconds, megabytes, "MB", baseline);
+    }
+    engine.setExecutor(nullptr);
+
+    fs::remove_all(root);
+}
+
+// Repeated existence probes, as the resolver and installer issue them
+AMB_BENCHMARK(fs_stat_cache) {
+    fs::path root = fs::temp_directory_path() / "amb_bench_stat";
+    makeTree(root);
+    std::vector<fs::path> paths;
+    for (const auto& entry : fs::recursive_directory_iterator(root)) {
+        paths.push_back(entry.path());
+        paths.push_back(entry.path().string() + ".missing");
+    }
+    auto probe = [&] {
+        for (int pass = 0; pass < 4; ++pass) {
+            for (const auto& path : paths) {
+                FileSystem::exists(path);
+                FileSystem::isFile(path);
+                FileSystem::isDirectory(path);
+            }
+        }
+    };
+    double probes = static_cast<double>(paths.size()) * 12;
+
+    FileSystem::enableStatCache(false);
+    double baseline = bench::measure(options.repeat, probe);
+    bench::report("fs_stat_cache", "uncached", 1, baseline, probes, "probes", baseline);
+
+    FileSystem::enableStatCache(true);
+    double seconds = bench::measure(options.repeat, probe, [] { FileSystem::invalidateAll(); });
+    bench::report("fs_stat_cache", "cached", 1, seconds, probes, "probes", baseline);
+    FileSystem::enableStatCache(false);
+
+    fs::remove_all(root);
+}
\ No newline at end of file
@@ -0,0 +1,158 @@
+#include "bench.hpp"
+#include "package/dependency_graph.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <map>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+using namespace amb;
+
+namespace {
+
+constexpr size_t NODES = 100000;
+constexpr size_t VERSIONS = 4;  // per package name
+constexpr size_t FANOUT = 4;    // dependencies per node, on later nodes (a DAG) ...
+constexpr size_t CYCLES = 16;   // ... except for a few edges back
+constexpr size_t ROOTS = 64;
+
+struct Edge {
+    size_t from;
+    size_t to;
+};
+
+// Deterministic, so runs compare
+std::vector<Edge> syntheticEdges() {
+    uint64_t state = 7;
+    auto next = [&](size_t bound) {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        return static_cast<size_t>((state >> 33) % bound);
+    };
+    std::vector<Edge> edges;
+    for (size_t from = 0; from + 1 < NODES; ++from) {
+        for (size_t i = 0; i < FANOUT; ++i) {
+            // Mostly near neighbours, as real dependency graphs cluster
+            size_t span = next(4) == 0 ? NODES - from - 1 : std::min<size_t>(256, NODES - from - 1);
+            edges.push_back({from, from + 1 + next(span)});
+        }
+    }
+    for (size_t i = 0; i < CYCLES; ++i) {
+        size_t from = NODES / 2 + next(NODES / 2);
+        edges.push_back({from, from - 1 - next(64)});
+    }
+    return edges;
+}
+
+std::string nodeName(size_t node) {
+    return "pkg" + std::to_string(node / VERSIONS);
+}
+
+std::string nodeVersion(size_t node) {
+    return "1." + std::to_string(node % VERSIONS) + ".0";
+}
+
+} // namespace
+
+// Dependency graph queries over a 100k-node lock graph: the CSR graph against the
+// string-keyed adjacency map it replaces
+AMB_BENCHMARK(graph_csr) {
+    auto edges = syntheticEdges();
+    std::vector<std::string> names;
+    std::vector<std::string> versions;
+    for (size_t node = 0; node < NODES; ++node) {
+        names.push_back(nodeName(node));
+        versions.push_back(nodeVersion(node));
+    }
+
+    DependencyGraph graph;
+    double build = bench::measure(options.repeat, [&] {
+        DependencyGraph::Builder builder;
+        for (size_t node = 0; node < NODES; ++node) {
+            builder.addNode(names[node], versions[node]);
+        }
+        for (const auto& edge : edges) {
+            builder.addEdge(static_cast<DependencyGraph::NodeId>(edge.from),
+                            static_cast<DependencyGraph::NodeId>(edge.to), "^1.0.0");
+        }
+        for (size_t root = 0; root < ROOTS; ++root) {
+            builder.addRoot(static_cast<DependencyGraph::NodeId>(root));
+        }
+        graph = builder.build();
+    });
+    char label[64];
+    std::snprintf(label, sizeof(label), "build B/edge=%.1f",
+                  static_cast<double>(graph.memoryBytes()) / static_cast<double>(graph.edgeCount()));
+    bench::report("graph_csr", label, 1, build, static_cast<double>(graph.edgeCount()), "edge");
+
+    std::map<std::string, std::vector<std::string>> adjacency;
+    for (const auto& edge : edges) {
+        adjacency[names[edge.from] + "@" + versions[edge.from]].push_back(names[edge.to] + "@" + versions[edge.to]);
+    }
+
+    volatile size_t sink = 0;  // keeps the walks from being optimized away
+    double mapWalk = bench::measure(options.repeat, [&] {
+        std::unordered_set<std::string> seen;
+        std::deque<std::string> queue;
+        for (size_t root = 0; root < ROOTS; ++root) {
+            queue.push_back(names[root] + "@" + versions[root]);
+        }
+        size_t visited = 0;
+        while (!queue.empty()) {
+            std::string key = std::move(queue.front());
+            queue.pop_front();
+            if (!seen.insert(key).second) {
+                continue;
+            }
+            ++visited;
+            auto it = adjacency.find(key);
+            if (it != adjacency.end()) {
+                queue.insert(queue.end(), it->second.begin(), it->second.end());
+            }
+        }
+        sink = visited;
+    });
+    bench::report("graph_csr", "map bfs", 1, mapWalk, static_cast<double>(edges.size()), "edge", mapWalk);
+
+    double csrWalk = bench::measure(options.repeat, [&] {
+        std::vector<char> seen(graph.size(), 0);
+        std::vector<DependencyGraph::NodeId> queue(graph.roots().begin(), graph.roots().end());
+        for (auto root : queue) {
+            seen[root] = 1;
+        }
+        for (size_t head = 0; head < queue.size(); ++head) {
+            for (auto dependency : graph.dependencies(queue[head])) {
+                if (!seen[dependency]) {
+                    seen[dependency] = 1;
+                    queue.push_back(dependency);
+                }
+            }
+        }
+        sink = queue.size();
+    });
+    bench::report("graph_csr", "csr bfs", 1, csrWalk, static_cast<double>(graph.edgeCount()), "edge", mapWalk);
+
+    constexpr size_t QUERIES = 200;
+    double why = bench::measure(options.repeat, [&] {
+        size_t found = 0;
+        for (size_t i = 0; i < QUERIES; ++i) {
+            auto node = static_cast<DependencyGraph::NodeId>((i * 7919) % graph.size());
+            found += graph.shortestPaths(node, 20).paths.size();
+        }
+        sink = found;
+    });
+    bench::report("graph_csr", "why all paths", 1, why, static_cast<double>(QUERIES), "query");
+
+    // What `amb why` and `amb tree` read instead of ambar.lock
+    std::string image = graph.serialize();
+    double load = bench::measure(options.repeat, [&] { sink = DependencyGraph::deserialize(image)->size(); });
+    char loadLabel[64];
+    std::snprintf(loadLabel, sizeof(loadLabel), "load %.1fMB", static_cast<double>(image.size()) / 1e6);
+    bench::report("graph_csr", loadLabel, 1, load, static_cast<double>(graph.size()), "node");
+
+    double cycles = bench::measure(options.repeat, [&] { sink = graph.cycles().size(); });
+    bench::report("graph_csr", "cycles", 1, cycles, static_cast<double>(graph.size()), "node");
+    (void)sink;
+}
\ No newline at end of file
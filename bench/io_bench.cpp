@@ -0,0 +1,70 @@
+#include "bench.hpp"
+#include "utils/filesystem.hpp"
+#include "utils/io_engine.hpp"
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace amb;
+
+namespace {
+
+// Shape of a typical source package: many small files across a few directories
+std::vector<FileWrite> syntheticPackage(const fs::path& root, size_t files) {
+    std::vector<FileWrite> batch;
+    batch.reserve(files);
+    for (size_t i = 0; i < files; ++i) {
+        size_t size = 512 + (i * 7919) % 8192;
+        fs::path path = root / ("dir" + std::to_string(i % 16)) / ("file" + std::to_string(i) + ".amb");
+        batch.push_back(FileWrite{path, std::string(size, static_cast<char>('a' + i % 26))});
+    }
+    return batch;
+}
+
+double totalMegabytes(const std::vector<FileWrite>& batch) {
+    double bytes = 0;
+    for (const auto& file : batch) {
+        bytes += static_cast<double>(file.content.size());
+    }
+    return bytes / 1e6;
+}
+
+} // namespace
+
+// Extraction-style writes: std::ofstream per file vs the IoEngine backends
+AMB_BENCHMARK(io_write_files) {
+    constexpr size_t FILES = 2000;
+    fs::path root = fs::temp_directory_path() / "amb_bench_io";
+    auto batch = syntheticPackage(root, FILES);
+    double megabytes = totalMegabytes(batch);
+
+    auto prepare = [&] {
+        fs::remove_all(root);
+        for (size_t d = 0; d < 16; ++d) {
+            fs::create_directories(root / ("dir" + std::to_string(d)));
+        }
+    };
+
+    auto& engine = IoEngine::instance();
+    auto original = engine.backend();
+
+    double baseline = bench::measure(options.repeat, [&] {
+        for (const auto& file : batch) {
+            std::ofstream out(file.path, std::ios::binary);
+            out.write(file.content.data(), static_cast<std::streamsize>(file.content.size()));
+        }
+    }, prepare);
+    bench::report("io_write_files", "ofstream", 1, baseline, megabytes, "MB", baseline);
+
+    for (auto backend : {IoEngine::Backend::THREAD_POOL, IoEngine::Backend::IO_URING}) {
+        if (!engine.setBackend(backend)) {
+            continue;
+        }
+        double seconds = bench::measure(options.repeat, [&] { engine.writeFiles(batch); }, prepare);
+        bench::report("io_write_files", engine.backendName(), 1, seconds, megabytes, "MB", baseline);
+    }
+
+    engine.setBackend(original);
+    fs::remove_all(root);
+}
\ No newline at end of file
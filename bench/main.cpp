@@ -0,0 +1,83 @@
+#include "bench.hpp"
+#include "core/scheduler.hpp"
+#include "utils/logger.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+using namespace amb;
+
+namespace {
+
+void usage() {
+    std::cout << "Usage: amb_bench [--list] [--filter <text>] [--max-jobs <n>] [--repeat <n>]\n"
+                 "                 [--json <file>] [--amb <path>]\n"
+                 "                 [--packages <n>] [--versions <n>] [--fanout <n>] [--files <n>] [--roots <n>]\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Logger::init(LogLevel::WARNING);
+
+    bench::Options options;
+    options.amb = AMB_BINARY;
+    std::string jsonPath;
+    bool list = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--list") {
+            list = true;
+        } else if (arg == "--filter" && hasValue) {
+            options.filter = argv[++i];
+        } else if (arg == "--max-jobs" && hasValue) {
+            options.maxJobs = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--repeat" && hasValue) {
+            options.repeat = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--json" && hasValue) {
+            jsonPath = argv[++i];
+        } else if (arg == "--amb" && hasValue) {
+            options.amb = argv[++i];
+        } else if (arg == "--packages" && hasValue) {
+            options.registry.packages = std::max<size_t>(1, std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--versions" && hasValue) {
+            options.registry.versions = std::max<size_t>(1, std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--fanout" && hasValue) {
+            options.registry.fanout = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--files" && hasValue) {
+            options.registry.files = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--roots" && hasValue) {
+            options.registry.roots = std::max<size_t>(1, std::strtoul(argv[++i], nullptr, 10));
+        } else {
+            usage();
+            return arg == "-h" || arg == "--help" ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+    if (options.maxJobs == 0) {
+        options.maxJobs = Scheduler::hardwareConcurrency();
+    }
+
+    for (const auto& [name, fn] : bench::benchmarks()) {
+        if (!options.filter.empty() && name.find(options.filter) == std::string::npos) {
+            continue;
+        }
+        if (list) {
+            std::cout << name << "\n";
+            continue;
+        }
+        std::cout << "== " << name << "\n";
+        fn(options);
+        std::cout << std::flush;
+    }
+
+    if (!jsonPath.empty() && !list && !bench::writeJson(jsonPath, options)) {
+        std::cerr << "Failed to write " << jsonPath << "\n";
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -0,0 +1,79 @@
+#include "bench.hpp"
+#include "amb/version.hpp"
+#include "utils/archive.hpp"
+#include "utils/filesystem.hpp"
+#include "utils/sha256.hpp"
+
+#include <string>
+#include <vector>
+
+using namespace amb;
+
+// Version parsing and range matching, as done per candidate during resolution
+AMB_BENCHMARK(micro_version) {
+    std::vector<std::string> versions;
+    for (size_t i = 0; i < 4096; ++i) {
+        versions.push_back(std::to_string(i % 7) + "." + std::to_string(i % 13) + "." + std::to_string(i % 31) +
+                           (i % 5 == 0 ? "-beta." + std::to_string(i % 3) : ""));
+    }
+    const std::vector<std::string> ranges{"^1.2.0", "~3.4.0", ">=2.0.0 <5.0.0", "*"};
+
+    volatile size_t sink = 0;  // keeps the loops from being optimized away
+    double parse = bench::measure(options.repeat, [&] {
+        size_t majors = 0;
+        for (const auto& text : versions) {
+            majors += Version(text).major();
+        }
+        sink = majors;
+    });
+    bench::report("micro_version", "parse", 1, parse, static_cast<double>(versions.size()), "ver");
+
+    std::vector<Version> parsed(versions.begin(), versions.end());
+    double satisfies = bench::measure(options.repeat, [&] {
+        size_t matches = 0;
+        for (const auto& version : parsed) {
+            for (const auto& range : ranges) {
+                matches += version.satisfies(range) ? 1u : 0u;
+            }
+        }
+        sink = matches;
+    });
+    bench::report("micro_version", "satisfies", 1, satisfies,
+                  static_cast<double>(parsed.size() * ranges.size()), "check");
+    (void)sink;
+}
+
+// Archive digests: every fetch and verify hashes the whole archive
+AMB_BENCHMARK(micro_sha256) {
+    std::string data(64 * 1024 * 1024, 'h');
+    double seconds = bench::measure(options.repeat, [&] { Sha256::hash(data); });
+    bench::report("micro_sha256", "64MB", 1, seconds, static_cast<double>(data.size()) / 1e6, "MB");
+}
+
+// Package extraction: one archive of small sources into a fresh directory
+AMB_BENCHMARK(micro_extract) {
+    constexpr size_t FILES = 500;
+    fs::path root = fs::temp_directory_path() / "amb_bench_extract";
+    fs::remove_all(root);
+    fs::create_directories(root);
+
+    fs::path archive = root / "package.zip";
+    ZipWriter writer;
+    double bytes = 0;
+    writer.open(archive);
+    for (size_t i = 0; i < FILES; ++i) {
+        std::string content(512 + (i * 7919) % 8192, static_cast<char>('a' + i % 26));
+        writer.add("src/dir" + std::to_string(i % 8) + "/file" + std::to_string(i) + ".amb", content);
+        bytes += static_cast<double>(content.size());
+    }
+    if (!writer.close()) {
+        return;
+    }
+
+    fs::path target = root / "out";
+    double seconds = bench::measure(options.repeat, [&] { FileSystem::extractZip(archive, target); },
+                                    [&] { fs::remove_all(target); });
+    bench::report("micro_extract", "files=" + std::to_string(FILES), 1, seconds, bytes / 1e6, "MB");
+
+    fs::remove_all(root);
+}
\ No newline at end of file
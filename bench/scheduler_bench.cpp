@@ -0,0 +1,126 @@
+#include "bench.hpp"
+#include "core/scheduler.hpp"
+#include "utils/sha256.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+
+using namespace amb;
+
+namespace {
+
+constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+// Stand-in for the per-file hashing/inflate work of install and verify
+void hashBlock(const std::string& block, std::atomic<uint64_t>& sink) {
+    Sha256 sha;
+    sha.update(block.data(), block.size());
+    sink += static_cast<unsigned char>(sha.digest()[0]);
+}
+
+void forkJoin(Scheduler& scheduler, size_t begin, size_t end, const std::string& block,
+              std::atomic<uint64_t>& sink) {
+    if (end - begin <= 4) {
+        for (size_t i = begin; i < end; ++i) {
+            hashBlock(block, sink);
+        }
+        return;
+    }
+    size_t mid = begin + (end - begin) / 2;
+    TaskGroup group(scheduler);
+    group.run([&, begin, mid] { forkJoin(scheduler, begin, mid, block, sink); });
+    forkJoin(scheduler, mid, end, block, sink);
+    group.wait();
+}
+
+} // namespace
+
+// Per-task overhead: many empty tasks through one group
+AMB_BENCHMARK(scheduler_spawn) {
+    constexpr size_t TASKS = 100000;
+    double baseline = 0;
+    for (size_t jobs : bench::jobSweep(options.maxJobs)) {
+        Scheduler scheduler(jobs);
+        std::atomic<uint64_t> counter{0};
+        double seconds = bench::measure(options.repeat, [&] {
+            TaskGroup group(scheduler);
+            for (size_t i = 0; i < TASKS; ++i) {
+                group.run([&counter] { counter++; });
+            }
+            group.wait();
+        });
+        baseline = baseline > 0 ? baseline : seconds;
+        bench::report("scheduler_spawn", "empty", jobs, seconds, TASKS, "tasks", baseline);
+    }
+}
+
+// Flat data parallelism: SHA-256 over independent blocks via parallelFor
+AMB_BENCHMARK(scheduler_hash) {
+    constexpr size_t BLOCKS = 512;
+    std::string block(BLOCK_SIZE, 'a');
+    double baseline = 0;
+    for (size_t jobs : bench::jobSweep(options.maxJobs)) {
+        Scheduler scheduler(jobs);
+        std::atomic<uint64_t> sink{0};
+        double seconds = bench::measure(options.repeat, [&] {
+            parallelFor(scheduler, BLOCKS, [&](size_t) { hashBlock(block, sink); });
+        });
+        baseline = baseline > 0 ? baseline : seconds;
+        bench::report("scheduler_hash", "parallel_for", jobs, seconds,
+                      BLOCKS * BLOCK_SIZE / 1e6, "MB", baseline);
+    }
+}
+
+// Nested groups: recursive splitting relies on stealing to spread the tree
+AMB_BENCHMARK(scheduler_fork_join) {
+    constexpr size_t BLOCKS = 512;
+    std::string block(BLOCK_SIZE, 'b');
+    double baseline = 0;
+    for (size_t jobs : bench::jobSweep(options.maxJobs)) {
+        Scheduler scheduler(jobs);
+        std::atomic<uint64_t> sink{0};
+        double seconds = bench::measure(options.repeat, [&] {
+            forkJoin(scheduler, 0, BLOCKS, block, sink);
+        });
+        baseline = baseline > 0 ? baseline : seconds;
+        bench::report("scheduler_fork_join", "recursive", jobs, seconds,
+                      BLOCKS * BLOCK_SIZE / 1e6, "MB", baseline);
+        auto stats = scheduler.stats();
+        std::printf("%-20s %-16s executed=%llu stolen=%llu\n", "", "",
+                    static_cast<unsigned long long>(stats.executed),
+                    static_cast<unsigned long long>(stats.stolen));
+    }
+}
+
+// Lanes: how long a HIGH task waits behind a saturated BACKGROUND backlog
+AMB_BENCHMARK(scheduler_priority) {
+    constexpr size_t BACKLOG = 2000;
+    std::string block(BLOCK_SIZE / 4, 'c');
+    for (size_t jobs : bench::jobSweep(options.maxJobs)) {
+        Scheduler scheduler(jobs);
+        std::atomic<uint64_t> sink{0};
+        for (auto priority : {TaskPriority::BACKGROUND, TaskPriority::HIGH}) {
+            TaskGroup background(scheduler, TaskPriority::BACKGROUND);
+            for (size_t i = 0; i < BACKLOG; ++i) {
+                background.run([&] { hashBlock(block, sink); });
+            }
+
+            std::atomic<bool> started{false};
+            auto submitted = std::chrono::steady_clock::now();
+            scheduler.submit([&] { started = true; }, priority);
+            while (!started) {
+                std::this_thread::yield();
+            }
+            std::chrono::duration<double> latency = std::chrono::steady_clock::now() - submitted;
+
+            background.cancel();
+            background.wait();
+            bench::report("scheduler_priority",
+                          priority == TaskPriority::HIGH ? "high_latency" : "same_lane_latency",
+                          jobs, latency.count(), 1, "tasks");
+        }
+    }
+}
\ No newline at end of file
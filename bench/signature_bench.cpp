@@ -0,0 +1,49 @@
+#include "bench.hpp"
+#include "registry/registry_index.hpp"
+#include "utils/ed25519.hpp"
+
+#include <string>
+#include <vector>
+
+using namespace amb;
+
+namespace {
+
+// An install transaction's worth of signed packages from `publishers` distinct keys
+std::vector<Ed25519::BatchItem> signedPackages(size_t count, size_t publishers) {
+    std::vector<Ed25519::Seed> seeds;
+    for (size_t i = 0; i < publishers; ++i) {
+        seeds.push_back(Ed25519::generateSeed());
+    }
+    std::vector<Ed25519::BatchItem> items;
+    items.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        const auto& seed = seeds[i % publishers];
+        std::string payload = signaturePayload("pkg" + std::to_string(i), "1.0.0", std::string(64, 'a'));
+        items.push_back({Ed25519::publicKey(seed), payload, Ed25519::sign(seed, payload)});
+    }
+    return items;
+}
+
+} // namespace
+
+// One verify() per package vs a single verifyBatch() over the transaction
+AMB_BENCHMARK(signature_verify) {
+    for (size_t publishers : {size_t{1}, size_t{0}}) {
+        for (size_t count : {size_t{1}, size_t{8}, size_t{64}, size_t{256}, size_t{1024}}) {
+            auto items = signedPackages(count, publishers == 0 ? count : publishers);
+            std::string bench = publishers == 0 ? "signature_many_keys" : "signature_one_key";
+            std::string size = " n=" + std::to_string(count);
+
+            double single = bench::measure(options.repeat, [&] {
+                for (const auto& item : items) {
+                    Ed25519::verify(item.key, item.message, item.signature);
+                }
+            });
+            bench::report(bench, "single" + size, 1, single, static_cast<double>(count), "sig", single);
+
+            double batch = bench::measure(options.repeat, [&] { Ed25519::verifyBatch(items); });
+            bench::report(bench, "batch" + size, 1, batch, static_cast<double>(count), "sig", single);
+        }
+    }
+}
\ No newline at end of file
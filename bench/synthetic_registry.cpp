@@ -0,0 +1,101 @@
+#include "synthetic_registry.hpp"
+#include "registry/publisher.hpp"
+#include "utils/filesystem.hpp"
+#include "utils/logger.hpp"
+#include "json.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <map>
+
+using json = nlohmann::json;
+
+namespace amb::bench {
+
+namespace {
+
+// Later packages only, so the graph is a DAG whose depth grows with the fan-out
+std::map<std::string, std::string> dependenciesOf(size_t index, const RegistryShape& shape) {
+    std::map<std::string, std::string> deps;
+    size_t later = shape.packages - index - 1;
+    for (size_t k = 0; later > 0 && k < shape.fanout; ++k) {
+        size_t target = index + 1 + (index * 31 + k * 7919) % later;
+        deps[packageName(target)] = "^1.0.0";
+    }
+    return deps;
+}
+
+bool writePackage(const fs::path& dir, size_t index, size_t minor, const RegistryShape& shape) {
+    json manifest = {
+        {"name", packageName(index)},
+        {"version", "1." + std::to_string(minor) + ".0"},
+        {"author", "amb_bench"},
+        {"description", "synthetic benchmark package"},
+        {"license", "MIT"},
+        {"dependencies", dependenciesOf(index, shape)},
+    };
+    std::vector<FileWrite> files{{dir / "ambar.json", manifest.dump(2)}};
+    for (size_t i = 0; i < shape.files; ++i) {
+        // Mostly stable across versions, like real releases, so deltas stay small
+        size_t size = 512 + (index * 131 + i * 7919) % 4096;
+        std::string content(size, static_cast<char>('a' + (index + i) % 26));
+        content += "\n// " + std::to_string(minor) + "\n";
+        files.push_back({dir / "src" / ("module" + std::to_string(i) + ".amb"), std::move(content)});
+    }
+    return FileSystem::writeFiles(files);
+}
+
+} // namespace
+
+std::string packageName(size_t index) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "pkg%04zu", index);
+    return name;
+}
+
+std::optional<SyntheticRegistry> syntheticRegistry(const RegistryShape& shape) {
+    std::string id = "p" + std::to_string(shape.packages) + "_v" + std::to_string(shape.versions) +
+                     "_f" + std::to_string(shape.fanout) + "_n" + std::to_string(shape.files) +
+                     "_r" + std::to_string(shape.roots);
+    fs::path root = fs::temp_directory_path() / ("amb_bench_registry_" + id);
+
+    SyntheticRegistry result{root / "registry", root / "project", root / "home"};
+    if (FileSystem::isFile(root / ".complete")) {
+        return result;
+    }
+
+    std::fprintf(stderr, "generating synthetic registry %s...\n", id.c_str());
+    fs::remove_all(root);
+    Publisher publisher(result.registry);
+    for (size_t index = 0; index < shape.packages; ++index) {
+        for (size_t minor = 0; minor < shape.versions; ++minor) {
+            fs::path dir = root / "sources" / packageName(index) / std::to_string(minor);
+            if (!writePackage(dir, index, minor, shape) || !publisher.publish(dir)) {
+                Logger::error("Failed to publish synthetic package {}", packageName(index));
+                return std::nullopt;
+            }
+        }
+    }
+    fs::remove_all(root / "sources");
+
+    json project = {
+        {"name", "bench_project"},
+        {"version", "0.1.0"},
+        {"dependencies", json::object()},
+    };
+    for (size_t i = 0; i < std::min(shape.roots, shape.packages); ++i) {
+        project["dependencies"][packageName(i)] = "^1.0.0";
+    }
+    json config = {{"registry_url", "file://" + fs::absolute(result.registry).generic_string()}};
+    bool written = FileSystem::writeFiles({
+        {result.project / "ambar.json", project.dump(2)},
+        {result.home / ".ambar" / "config.json", config.dump(2)},
+        {root / ".complete", ""},
+    });
+    if (!written) {
+        return std::nullopt;
+    }
+    return result;
+}
+
+} // namespace amb::bench
\ No newline at end of file
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "bench.hpp"
+
+#include <filesystem>
+#include <optional>
+#include <string>
+
+namespace amb::bench {
+
+namespace fs = std::filesystem;
+
+// A generated filesystem registry, a project depending on its first `roots` packages
+// and a HOME whose ~/.ambar/config.json points at the registry
+struct SyntheticRegistry {
+    fs::path registry;
+    fs::path project;
+    fs::path home;
+};
+
+// Generated once per shape under the temp directory and reused by later runs
+std::optional<SyntheticRegistry> syntheticRegistry(const RegistryShape& shape);
+
+// pkg0000, pkg0001, ...
+std::string packageName(size_t index);
+
+} // namespace amb::bench
\ No newline at end of file
@@ -3,7 +3,9 @@
 #include <filesystem>
 #include <string>
 #include <optional>
+#include <cstdint>
 #include <unordered_map>
+#include <vector>
 
 namespace amb {
 
@@ -16,6 +18,15 @@ struct GlobalConfig {
     std::string registryUrl = "file://./registry"; // Default local
     bool allowInsecure = false;
     int networkTimeout = 30;
+    std::string compiler = "ambar";       // toolchain used by package build scripts
+    std::string compilerFlags;
+    uint64_t buildCacheMaxMb = 2048;      // size bound of ~/.ambar/cache/builds
+    std::vector<std::string> trustedKeys; // Ed25519 publisher keys (hex); empty trusts any signer
+    bool requireSignatures = false;       // refuse to install unsigned packages
+    std::string signingKey;               // hex seed file used by `amb publish --sign`
+    bool statCache = true;                // memoize file probes for the duration of a command
+    bool cacheCompression = false;        // keep cached archives packed (CompressedCache)
+    bool metrics = true;                  // record each command's resource usage for `amb stats`
     
     // Default constructor sets default paths
     GlobalConfig();
@@ -41,6 +52,10 @@ public:
     fs::path getCacheDir() const;
     fs::path getLibDir() const;
     fs::path getRegistryPath() const;
+    // The bundle file when the registry is a snapshot:// URL
+    std::optional<fs::path> getSnapshotPath() const;
+    static std::string snapshotUrl(const fs::path& bundle);
+    const std::string& getRegistryUrl() const { return config_.registryUrl; }
     
     // Configuration manipulation
     void setRegistryUrl(const std::string& url);
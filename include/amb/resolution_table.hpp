@@ -0,0 +1,262 @@
+#pragma once
+
+// Header-only reader for the import resolution tables written by `amb` on every
+// install/update/remove (blueprint §11). A compiler maps the table once per build and
+// answers `import "name@version"` / `import "name"` without probing the lib dirs:
+//
+//   amb::ImportResolver resolver(projectRoot, ambRoot);   // e.g. ~/.ambar
+//   if (auto root = resolver.resolve("math_utils@1.0.0")) { ... }
+//
+// Tables are immutable once written (amb replaces them with a rename), so a mapping
+// stays valid for the lifetime of the reader.
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#ifdef _WIN32
+#include <fstream>
+#include <vector>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace amb {
+
+// On-disk layout (native byte order, checked through `byteOrder`):
+//   ResolutionTableHeader
+//   uint32_t seeds[bucketCount]     - per-bucket displacement of the perfect hash
+//   ResolutionTableSlot slots[count] - exactly one slot per key (minimal perfect hash)
+//   char strings[stringsSize]       - keys and absolute source roots, not terminated
+struct ResolutionTableHeader {
+    static constexpr char MAGIC[8] = {'A', 'M', 'B', 'R', 'E', 'S', 'T', '\0'};
+    static constexpr uint32_t FORMAT_VERSION = 1;
+    static constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint32_t count;
+    uint32_t bucketCount;
+    uint64_t seedsOffset;
+    uint64_t slotsOffset;
+    uint64_t stringsOffset;
+    uint64_t stringsSize;
+};
+
+struct ResolutionTableSlot {
+    uint32_t keyOffset;
+    uint32_t keyLength;
+    uint32_t rootOffset;
+    uint32_t rootLength;
+};
+
+// Seeded FNV-1a with a final avalanche; shared by the writer and the reader
+inline uint64_t resolutionHash(std::string_view key, uint32_t seed) {
+    uint64_t hash = 0xcbf29ce484222325ULL ^ (uint64_t{seed} * 0x9e3779b97f4a7c15ULL);
+    for (char c : key) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 0x100000001b3ULL;
+    }
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+class ResolutionTable {
+public:
+    // File names inside <project>/ambar_modules and the amb root (~/.ambar)
+    static constexpr const char* FILE_NAME = "resolution.table";
+
+    ResolutionTable() = default;
+    ~ResolutionTable() { close(); }
+
+    ResolutionTable(const ResolutionTable&) = delete;
+    ResolutionTable& operator=(const ResolutionTable&) = delete;
+
+    ResolutionTable(ResolutionTable&& other) noexcept { *this = std::move(other); }
+    ResolutionTable& operator=(ResolutionTable&& other) noexcept {
+        if (this != &other) {
+            close();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+#ifdef _WIN32
+            buffer_ = std::move(other.buffer_);
+#endif
+        }
+        return *this;
+    }
+
+    // False if the file is missing, truncated or not a table of this format version
+    bool open(const std::filesystem::path& path) {
+        close();
+#ifdef _WIN32
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            return false;
+        }
+        buffer_.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        data_ = buffer_.data();
+        size_ = buffer_.size();
+#else
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat st {};
+        if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+            ::close(fd);
+            return false;
+        }
+        size_t size = static_cast<size_t>(st.st_size);
+        void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (mapped == MAP_FAILED) {
+            return false;
+        }
+        data_ = static_cast<const char*>(mapped);
+        size_ = size;
+#endif
+        if (!validate()) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+#ifdef _WIN32
+        buffer_.clear();
+#else
+        if (data_) {
+            munmap(const_cast<char*>(data_), size_);
+        }
+#endif
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+    bool isOpen() const { return data_ != nullptr; }
+    size_t size() const { return isOpen() ? header().count : 0; }
+
+    // Absolute source root for "name@version" or a bare "name"
+    std::optional<std::string_view> find(std::string_view key) const {
+        if (!isOpen() || header().count == 0) {
+            return std::nullopt;
+        }
+        const auto& h = header();
+        uint32_t bucket = static_cast<uint32_t>(resolutionHash(key, 0) % h.bucketCount);
+        uint32_t seed = load<uint32_t>(h.seedsOffset + uint64_t{bucket} * sizeof(uint32_t));
+        uint32_t index = static_cast<uint32_t>(resolutionHash(key, seed) % h.count);
+        auto slot = load<ResolutionTableSlot>(h.slotsOffset + uint64_t{index} * sizeof(ResolutionTableSlot));
+
+        // Keys outside the table still hash to some slot, so the stored key decides
+        auto stored = string(slot.keyOffset, slot.keyLength);
+        if (!stored || *stored != key) {
+            return std::nullopt;
+        }
+        return string(slot.rootOffset, slot.rootLength);
+    }
+
+    // Slot `index` in table order, for listing and diagnostics
+    std::optional<std::pair<std::string_view, std::string_view>> entry(size_t index) const {
+        if (index >= size()) {
+            return std::nullopt;
+        }
+        auto slot = load<ResolutionTableSlot>(header().slotsOffset + index * sizeof(ResolutionTableSlot));
+        auto key = string(slot.keyOffset, slot.keyLength);
+        auto root = string(slot.rootOffset, slot.rootLength);
+        if (!key || !root) {
+            return std::nullopt;
+        }
+        return std::make_pair(*key, *root);
+    }
+
+private:
+    const ResolutionTableHeader& header() const {
+        return *reinterpret_cast<const ResolutionTableHeader*>(data_);
+    }
+
+    // memcpy keeps the reads well-defined whatever the alignment of the mapping
+    template <typename T>
+    T load(uint64_t offset) const {
+        T value;
+        std::memcpy(&value, data_ + offset, sizeof(T));
+        return value;
+    }
+
+    std::optional<std::string_view> string(uint32_t offset, uint32_t length) const {
+        const auto& h = header();
+        if (uint64_t{offset} + length > h.stringsSize) {
+            return std::nullopt;
+        }
+        return std::string_view(data_ + h.stringsOffset + offset, length);
+    }
+
+    // Bounds are checked once here so lookups only need to check string ranges
+    bool validate() const {
+        if (size_ < sizeof(ResolutionTableHeader)) {
+            return false;
+        }
+        auto h = load<ResolutionTableHeader>(0);
+        if (std::memcmp(h.magic, ResolutionTableHeader::MAGIC, sizeof(h.magic)) != 0 ||
+            h.version != ResolutionTableHeader::FORMAT_VERSION ||
+            h.byteOrder != ResolutionTableHeader::BYTE_ORDER_MARK) {
+            return false;
+        }
+        if (h.count > 0 && h.bucketCount == 0) {
+            return false;
+        }
+        auto fits = [&](uint64_t offset, uint64_t length) {
+            return offset <= size_ && length <= size_ - offset;
+        };
+        return fits(h.seedsOffset, uint64_t{h.bucketCount} * sizeof(uint32_t)) &&
+               fits(h.slotsOffset, uint64_t{h.count} * sizeof(ResolutionTableSlot)) &&
+               fits(h.stringsOffset, h.stringsSize);
+    }
+
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    std::vector<char> buffer_;
+#endif
+};
+
+// Blueprint §11.2 lookup order: the project's ambar_modules first, then the global lib.
+// Either table may be absent (no project, nothing installed globally).
+class ImportResolver {
+public:
+    ImportResolver(const std::filesystem::path& projectRoot, const std::filesystem::path& ambRoot) {
+        if (!projectRoot.empty()) {
+            local_.open(projectRoot / "ambar_modules" / ResolutionTable::FILE_NAME);
+        }
+        if (!ambRoot.empty()) {
+            global_.open(ambRoot / ResolutionTable::FILE_NAME);
+        }
+    }
+
+    // `spec` is the import string: "name@version" or "name"
+    std::optional<std::string_view> resolve(std::string_view spec) const {
+        if (auto root = local_.find(spec)) {
+            return root;
+        }
+        return global_.find(spec);
+    }
+
+    const ResolutionTable& local() const { return local_; }
+    const ResolutionTable& global() const { return global_; }
+
+private:
+    ResolutionTable local_;
+    ResolutionTable global_;
+};
+
+} // namespace amb
\ No newline at end of file
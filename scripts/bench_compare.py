@@ -0,0 +1,60 @@
+#!/usr/bin/env python3
+"""Compares two amb_bench JSON result files.
+
+    amb_bench --json base.json            # on the baseline build
+    amb_bench --json head.json            # on the candidate build
+    python3 scripts/bench_compare.py base.json head.json [--threshold 0.10]
+
+Rows are matched on (bench, variant, jobs). A row whose time grew by more than
+the threshold is a regression and makes the script exit with status 1; rows
+present in only one file are listed but do not fail the comparison.
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(path):
+    with open(path, encoding="utf-8") as f:
+        data = json.load(f)
+    return {(r["bench"], r["variant"], r["jobs"]): r for r in data.get("results", [])}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--threshold", type=float, default=0.10,
+                        help="relative slowdown that counts as a regression (default 0.10)")
+    args = parser.parse_args()
+
+    base = load(args.baseline)
+    head = load(args.current)
+
+    regressions = 0
+    print(f"{'benchmark':<36} {'base ms':>10} {'head ms':>10} {'change':>8}")
+    for key in sorted(base.keys() | head.keys()):
+        name = f"{key[0]}/{key[1]} jobs={key[2]}"
+        if key not in base or key not in head:
+            print(f"{name:<36} {'(only in ' + ('baseline' if key in base else 'current') + ')':>30}")
+            continue
+        before = base[key]["seconds"]
+        after = head[key]["seconds"]
+        change = after / before - 1 if before > 0 else 0.0
+        mark = ""
+        if change > args.threshold:
+            mark = "  REGRESSION"
+            regressions += 1
+        elif change < -args.threshold:
+            mark = "  improved"
+        print(f"{name:<36} {before * 1e3:>10.3f} {after * 1e3:>10.3f} {change:>+7.1%}{mark}")
+
+    if regressions:
+        print(f"\n{regressions} regression(s) beyond {args.threshold:.0%}")
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
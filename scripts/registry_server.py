@@ -0,0 +1,107 @@
+#!/usr/bin/env python3
+"""Local stand-in for an HTTP registry.
+
+Serves a filesystem registry (blueprint §8 layout) over plain HTTP/1.1 with
+keep-alive and Range support, so `amb` can be exercised against
+registry_url = "http://127.0.0.1:<port>" without a real registry.
+
+    python3 scripts/registry_server.py ./registry --port 8765 [--delay 0.05] [--fail-every 5]
+
+--delay      adds latency to every response (simulates a remote registry)
+--fail-every drops the connection halfway through every Nth download
+"""
+
+import argparse
+import os
+import re
+import threading
+import time
+from http.server import SimpleHTTPRequestHandler, ThreadingHTTPServer
+
+COUNTER = {"requests": 0}
+LOCK = threading.Lock()
+
+
+class RegistryHandler(SimpleHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"
+
+    def log_message(self, fmt, *args):
+        if self.server.verbose:
+            super().log_message(fmt, *args)
+
+    def do_GET(self):
+        with LOCK:
+            COUNTER["requests"] += 1
+            request_no = COUNTER["requests"]
+
+        if self.server.delay:
+            time.sleep(self.server.delay)
+
+        path = self.translate_path(self.path)
+        if not os.path.isfile(path):
+            self.send_error(404)
+            return
+
+        size = os.path.getsize(path)
+        start, end = 0, size - 1
+        status = 200
+
+        match = re.match(r"bytes=(\d+)-(\d*)", self.headers.get("Range", ""))
+        if match:
+            start = int(match.group(1))
+            if match.group(2):
+                end = min(int(match.group(2)), size - 1)
+            if start >= size:
+                self.send_response(416)
+                self.send_header("Content-Range", f"bytes */{size}")
+                self.send_header("Content-Length", "0")
+                self.end_headers()
+                return
+            status = 206
+
+        length = end - start + 1
+        self.send_response(status)
+        self.send_header("Content-Type", "application/octet-stream")
+        self.send_header("Content-Length", str(length))
+        self.send_header("Accept-Ranges", "bytes")
+        if status == 206:
+            self.send_header("Content-Range", f"bytes {start}-{end}/{size}")
+        self.end_headers()
+
+        fail = self.server.fail_every and request_no % self.server.fail_every == 0
+        with open(path, "rb") as f:
+            f.seek(start)
+            remaining = length
+            if fail:
+                remaining //= 2
+            while remaining > 0:
+                chunk = f.read(min(65536, remaining))
+                if not chunk:
+                    break
+                self.wfile.write(chunk)
+                remaining -= len(chunk)
+
+        if fail:
+            self.close_connection = True
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("root", help="registry directory to serve")
+    parser.add_argument("--port", type=int, default=8765)
+    parser.add_argument("--delay", type=float, default=0.0)
+    parser.add_argument("--fail-every", type=int, default=0)
+    parser.add_argument("--verbose", action="store_true")
+    args = parser.parse_args()
+
+    os.chdir(args.root)
+    server = ThreadingHTTPServer(("127.0.0.1", args.port), RegistryHandler)
+    server.delay = args.delay
+    server.fail_every = args.fail_every
+    server.verbose = args.verbose
+    print(f"Serving {os.getcwd()} on http://127.0.0.1:{args.port}")
+    server.serve_forever()
+
+
+if __name__ == "__main__":
+    main()
\ No newline at end of file
@@ -1,11 +1,20 @@
 #include "cli/cli_handler.hpp"
+#include "amb/config.hpp"
+#include "amb/version.hpp"
 #include "core/context.hpp"
 #include "core/command.hpp"
+#include "core/output.hpp"
+#include "core/usage_log.hpp"
 #include "commands/base_command.hpp"
+#include "utils/error.hpp"
+#include "utils/file_lock.hpp"
+#include "utils/filesystem.hpp"
 #include "utils/logger.hpp"
+#include "utils/resource_usage.hpp"
 
-#include <iostream>
 #include <algorithm>
+#include <charconv>
+#include <chrono>
 
 namespace amb {
 
@@ -14,10 +23,17 @@ CLIHandler::CLIHandler(std::shared_ptr<Context> ctx) : ctx_(ctx) {
     CommandFactory::instance().registerCommand<InstallCommand>();
     CommandFactory::instance().registerCommand<RemoveCommand>();
     CommandFactory::instance().registerCommand<ListCommand>();
+    CommandFactory::instance().registerCommand<WhyCommand>();
+    CommandFactory::instance().registerCommand<TreeCommand>();
     CommandFactory::instance().registerCommand<SearchCommand>();
     CommandFactory::instance().registerCommand<PublishCommand>();
+    CommandFactory::instance().registerCommand<YankCommand>();
     CommandFactory::instance().registerCommand<UpdateCommand>();
     CommandFactory::instance().registerCommand<InitCommand>();
+    CommandFactory::instance().registerCommand<VerifyCommand>();
+    CommandFactory::instance().registerCommand<GcCommand>();
+    CommandFactory::instance().registerCommand<SnapshotCommand>();
+    CommandFactory::instance().registerCommand<StatsCommand>();
 }
 
 CLIHandler::~CLIHandler() = default;
@@ -35,10 +51,16 @@ int CLIHandler::run(const std::vector<std::string>& rawArgs) {
         auto parsed = parseArgs(rawArgs);
         
         // Handle global options
+        if (!parsed.output.empty()) {
+            applyOutput(parsed.output);
+        }
         if (parsed.verbose) {
             ctx_->setVerbose(true);
             Logger::setLevel(LogLevel::DEBUG);
         }
+        if (parsed.jobs > 0) {
+            ctx_->setJobs(parsed.jobs);
+        }
         
         // Handle help and version
         if (parsed.showHelp && parsed.command.empty()) {
@@ -52,14 +74,36 @@ int CLIHandler::run(const std::vector<std::string>& rawArgs) {
         }
         
         // Execute command
-        return executeCommand(parsed);
+        int result = executeCommand(parsed);
+        Output::flush();
+        return result;
         
     } catch (const std::exception& e) {
         Logger::error("CLI error: {}", e.what());
+        Output::flush();
         return 1;
     }
 }
 
+void CLIHandler::applyOutput(const std::string& format) {
+    if (format == "ndjson") {
+        Output::setFormat(OutputFormat::NDJSON);
+    } else if (format == "text") {
+        Output::setFormat(OutputFormat::TEXT);
+    } else {
+        throw ConfigError("--output expects text or ndjson, got '" + format + "'");
+    }
+}
+
+size_t CLIHandler::parseJobs(const std::string& value) {
+    size_t jobs = 0;
+    auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), jobs);
+    if (ec != std::errc() || end != value.data() + value.size() || jobs == 0) {
+        throw ConfigError("--jobs expects a positive number, got '" + value + "'");
+    }
+    return jobs;
+}
+
 CLIHandler::ParsedArgs CLIHandler::parseArgs(const std::vector<std::string>& rawArgs) const {
     ParsedArgs parsed;
     
@@ -80,6 +124,23 @@ CLIHandler::ParsedArgs CLIHandler::parseArgs(const std::vector<std::string>& raw
             parsed.showVersion = true;
         } else if (arg == "--verbose") {
             parsed.verbose = true;
+        } else if (arg == "-j" || arg == "--jobs" || arg.starts_with("--jobs=")) {
+            std::string value;
+            if (arg.starts_with("--jobs=")) {
+                value = arg.substr(7);
+            } else if (i + 1 < rawArgs.size()) {
+                value = rawArgs[++i];
+            }
+            parsed.jobs = parseJobs(value);
+        } else if (arg == "--output" || arg.starts_with("--output=")) {
+            if (arg.starts_with("--output=")) {
+                parsed.output = arg.substr(9);
+            } else if (i + 1 < rawArgs.size()) {
+                parsed.output = rawArgs[++i];
+            }
+            if (parsed.output.empty()) {
+                throw ConfigError("--output expects text or ndjson");
+            }
         } else if (arg.starts_with("-")) {
             // Unknown option
             Logger::warning("Unknown option: {}", arg);
@@ -113,14 +174,16 @@ int CLIHandler::executeCommand(const ParsedArgs& parsed) {
         return 1;
     }
     
-    auto command = CommandFactory::instance().create(parsed.command);
+    auto command = CommandFactory::instance().create(parsed.command, ctx_.get());
     if (!command) {
         Logger::error("Unknown command: {}", parsed.command);
-        std::cout << "\nAvailable commands:\n";
-        for (const auto& cmd : CommandFactory::instance().listCommands()) {
-            std::cout << "  " << cmd << "\n";
+        auto commands = CommandFactory::instance().listCommands();
+        std::string text = "\nAvailable commands:\n";
+        for (const auto& cmd : commands) {
+            text += "  " + cmd + "\n";
         }
-        std::cout << "\nUse 'amb --help' for more information\n";
+        text += "\nUse 'amb --help' for more information";
+        Output::emit(Event("error", text).with("command", parsed.command).with("commands", commands));
         return 1;
     }
     
@@ -132,17 +195,76 @@ int CLIHandler::executeCommand(const ParsedArgs& parsed) {
     Logger::debug("Executing command: {} with {} arguments", 
                   parsed.command, parsed.args.size());
     
-    return command->execute(parsed.args);
+    auto started = std::chrono::steady_clock::now();
+    int result = command->execute(parsed.args);
+    recordUsage(parsed.command, result, started);
+    
+    // For tools reading the stream; nothing is shown on a terminal
+    Output::emit(Event("command.done")
+                     .with("command", parsed.command)
+                     .with("exit", result)
+                     .with("wall_s", std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count()));
+    
+    auto locks = FileLock::stats();
+    if (locks.contended > 0) {
+        Logger::debug("Lock waits: {} of {} acquisitions contended, {}ms total, {}ms longest",
+                      locks.contended, locks.acquired, locks.waited.count() / 1000,
+                      locks.longestWait.count() / 1000);
+    }
+    return result;
+}
+
+void CLIHandler::recordUsage(const std::string& command, int exitCode,
+                             std::chrono::steady_clock::time_point started) const {
+    // `amb stats` reading the log is not worth recording in it
+    if (command == "stats" || !ctx_->isInitialized() || !ConfigManager::instance().config().metrics) {
+        return;
+    }
+
+    using Counter = ResourceUsage::Counter;
+    auto usage = ResourceUsage::sample();
+    auto stat = FileSystem::statCacheStats();
+
+    UsageRecord record;
+    record.command = command;
+    record.version = AMB_VERSION.toString();
+    record.timestamp = std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    record.exitCode = exitCode;
+    record.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    record.cpuSeconds = usage.cpuSeconds;
+    record.peakRssBytes = usage.peakRssBytes;
+    record.bytesRead = usage.bytesRead;
+    record.bytesWritten = usage.bytesWritten;
+    record.statCalls = stat.misses;
+    record.statHits = stat.hits;
+    record.networkReceived = ResourceUsage::count(Counter::NETWORK_RECEIVED);
+    record.networkSent = ResourceUsage::count(Counter::NETWORK_SENT);
+    record.archiveDownloads = ResourceUsage::count(Counter::ARCHIVE_DOWNLOADS);
+    record.archiveCacheHits = ResourceUsage::count(Counter::ARCHIVE_CACHE_HITS);
+    record.buildCacheHits = ResourceUsage::count(Counter::BUILD_CACHE_HITS);
+    record.buildCacheMisses = ResourceUsage::count(Counter::BUILD_CACHE_MISSES);
+
+    // Metrics are best effort: a read-only home must not fail the command
+    try {
+        if (!UsageLog::append(ctx_->getAmbRoot(), record)) {
+            Logger::debug("Could not record usage metrics");
+        }
+    } catch (const std::exception& e) {
+        Logger::debug("Could not record usage metrics: {}", e.what());
+    }
 }
 
 void CLIHandler::showHelp() const {
-    std::cout << "Ambar Package Manager (amb) v0.1.0\n\n";
-    std::cout << "Usage: amb <command> [options] [arguments]\n\n";
-    std::cout << "Global options:\n";
-    std::cout << "  -h, --help     Show this help message\n";
-    std::cout << "  -v, --version  Show version information\n";
-    std::cout << "  --verbose      Enable verbose output\n\n";
-    std::cout << "Commands:\n";
+    std::string text = "Ambar Package Manager (amb) v0.1.0\n\n";
+    text += "Usage: amb <command> [options] [arguments]\n\n";
+    text += "Global options:\n";
+    text += "  -h, --help     Show this help message\n";
+    text += "  -v, --version  Show version information\n";
+    text += "  --verbose      Enable verbose output\n";
+    text += "  -j, --jobs <n> Number of worker threads (default: one per core)\n";
+    text += "  --output <fmt> text (default) or ndjson, one JSON event per line\n\n";
+    text += "Commands:\n";
     
     auto commands = CommandFactory::instance().listCommands();
     std::sort(commands.begin(), commands.end());
@@ -150,20 +272,20 @@ void CLIHandler::showHelp() const {
     for (const auto& cmdName : commands) {
         auto cmd = CommandFactory::instance().create(cmdName);
         if (cmd) {
-            std::cout << "  " << cmdName;
-            std::cout << std::string(12 - cmdName.length(), ' ');
-            std::cout << cmd->description() << "\n";
+            text += "  " + cmdName;
+            text += std::string(12 - cmdName.length(), ' ');
+            text += cmd->description() + "\n";
         }
     }
     
-    std::cout << "\nFor more information on a specific command:\n";
-    std::cout << "  amb <command> --help\n";
+    text += "\nFor more information on a specific command:\n";
+    text += "  amb <command> --help";
+    Output::emit(Event("help", text).with("commands", commands));
 }
 
 void CLIHandler::showVersion() const {
-    std::cout << "amb version 0.1.0\n";
-    std::cout << "Ambar Package Manager\n";
-    std::cout << "Copyright (c) 2024 Ambar Language\n";
+    Output::emit(Event("version", "amb version 0.1.0\nAmbar Package Manager\nCopyright (c) 2024 Ambar Language")
+                     .with("version", AMB_VERSION.toString()));
 }
 
 void CLIHandler::showCommandHelp(const std::string& command) const {
@@ -173,13 +295,18 @@ void CLIHandler::showCommandHelp(const std::string& command) const {
         return;
     }
     
-    std::cout << "Usage: amb " << command << " " << cmd->usage() << "\n\n";
-    std::cout << cmd->description() << "\n\n";
+    std::string text = "Usage: amb " + command + " " + cmd->usage() + "\n\n";
+    text += cmd->description() + "\n";
     
     if (!cmd->example().empty()) {
-        std::cout << "Example:\n";
-        std::cout << "  " << cmd->example() << "\n\n";
+        text += "\nExample:\n";
+        text += "  " + cmd->example() + "\n";
     }
+    Output::emit(Event("help", text)
+                     .with("command", command)
+                     .with("usage", cmd->usage())
+                     .with("description", cmd->description())
+                     .with("example", cmd->example()));
 }
 
 } // namespace amb
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <memory>
 #include <string>
 #include <vector>
@@ -29,10 +30,17 @@ private:
         bool showHelp = false;
         bool showVersion = false;
         bool verbose = false;
+        std::string output;    // --output format, empty = text
+        size_t jobs = 0;       // 0 = hardware concurrency
     };
     
+    static size_t parseJobs(const std::string& value);
+    static void applyOutput(const std::string& format);
     ParsedArgs parseArgs(const std::vector<std::string>& rawArgs) const;
     int executeCommand(const ParsedArgs& parsed);
+    // Appends the command's resource usage to the metrics log read by `amb stats`
+    void recordUsage(const std::string& command, int exitCode,
+                     std::chrono::steady_clock::time_point started) const;
     
     std::shared_ptr<Context> ctx_;
 };
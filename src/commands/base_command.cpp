@@ -1,7 +1,7 @@
 #include "commands/base_command.hpp"
 #include "core/context.hpp"
+#include "core/output.hpp"
 #include "utils/logger.hpp"
-#include <iostream>
 
 namespace amb {
 
@@ -26,16 +26,17 @@ bool BaseCommand::validateArgs(const std::vector<std::string>& args) {
 }
 
 void BaseCommand::showUsage() const {
-    std::cout << "Usage: amb " << name() << " " << usage() << "\n";
+    std::string text = "Usage: amb " + name() + " " + usage();
     
     if (!example().empty()) {
-        std::cout << "Example: " << example() << "\n";
+        text += "\nExample: " + example();
     }
+    Output::emit(Event("usage", text).with("command", name()).with("usage", usage()));
 }
 
 void BaseCommand::showError(const std::string& message) const {
     Logger::error("{}: {}", name(), message);
-    std::cerr << "Error: " << message << "\n";
+    Output::emit(Event("error", "Error: " + message).with("command", name()).with("message", message));
 }
 
 } // namespace amb
\ No newline at end of file
@@ -35,11 +35,12 @@ protected:
 
 class InstallCommand : public BaseCommand {
 public:
+    using BaseCommand::BaseCommand;
     static constexpr const char* COMMAND_NAME = "install";
     
     std::string name() const override { return COMMAND_NAME; }
     std::string description() const override { return "Install packages"; }
-    std::string usage() const override { return "<package>[@<version>]"; }
+    std::string usage() const override { return "[--global | --workspace] [--run-scripts] [--plan[=<file>] | --from-plan=<file>] [--from-snapshot=<file>] [<package>[@<version>]...]"; }
     std::string example() const override { return "amb install math_utils@1.0.0"; }
     
 protected:
@@ -48,11 +49,12 @@ protected:
 
 class RemoveCommand : public BaseCommand {
 public:
+    using BaseCommand::BaseCommand;
     static constexpr const char* COMMAND_NAME = "remove";
     
     std::string name() const override { return COMMAND_NAME; }
     std::string description() const override { return "Remove packages"; }
-    std::string usage() const override { return "<package>"; }
+    std::string usage() const override { return "<package>... [--cascade]"; }
     std::string example() const override { return "amb remove math_utils"; }
     
 protected:
@@ -61,6 +63,7 @@ protected:
 
 class ListCommand : public BaseCommand {
 public:
+    using BaseCommand::BaseCommand;
     static constexpr const char* COMMAND_NAME = "list";
     
     std::string name() const override { return COMMAND_NAME; }
@@ -74,6 +77,7 @@ protected:
 
 class SearchCommand : public BaseCommand {
 public:
+    using BaseCommand::BaseCommand;
     static constexpr const char* COMMAND_NAME = "search";
     
     std::string name() const override { return COMMAND_NAME; }
@@ -87,12 +91,58 @@ protected:
 
 class PublishCommand : public BaseCommand {
 public:
+    using BaseCommand::BaseCommand;
     static constexpr const char* COMMAND_NAME = "publish";
     
     std::string name() const override { return COMMAND_NAME; }
     std::string description() const override { return "Publish a package"; }
-    std::string usage() const override { return "[<path>]"; }
-    std::string example() const override { return "amb publish ."; }
+    std::string usage() const override { return "[<path>] [--sign <keyfile>]"; }
+    std::string example() const override { return "amb publish . --sign ~/.ambar/signing.key"; }
+    
+protected:
+    int run(const std::vector<std::string>& args) override;
+};
+
+class YankCommand : public BaseCommand {
+public:
+    using BaseCommand::BaseCommand;
+    static constexpr const char* COMMAND_NAME = "yank";
+    
+    std::string name() const override { return COMMAND_NAME; }
+    std::string description() const override { return "Withdraw a published version from new resolutions"; }
+    std::string usage() const override { return "<package>@<version> [--undo]"; }
+    std::string example() const override { return "amb yank math_utils@1.2.0"; }
+    
+protected:
+    int run(const std::vector<std::string>& args) override;
+};
+
+class WhyCommand : public BaseCommand {
+public:
+    using BaseCommand::BaseCommand;
+    static constexpr const char* COMMAND_NAME = "why";
+    
+    std::string name() const override { return COMMAND_NAME; }
+    std::string description() const override { return "Show why a package is installed"; }
+    std::string usage() const override { return "<package>[@<range>] [--depth=<n>] [--limit=<n>]"; }
+    std::string example() const override { return "amb why math_utils --limit=5"; }
+    
+    // Shortest paths listed per version before the rest are only counted
+    static constexpr size_t DEFAULT_LIMIT = 20;
+    
+protected:
+    int run(const std::vector<std::string>& args) override;
+};
+
+class TreeCommand : public BaseCommand {
+public:
+    using BaseCommand::BaseCommand;
+    static constexpr const char* COMMAND_NAME = "tree";
+    
+    std::string name() const override { return COMMAND_NAME; }
+    std::string description() const override { return "Show the dependency tree"; }
+    std::string usage() const override { return "[<package>[@<range>]] [--depth=<n>]"; }
+    std::string example() const override { return "amb tree --depth=2"; }
     
 protected:
     int run(const std::vector<std::string>& args) override;
@@ -100,11 +150,12 @@ protected:
 
 class UpdateCommand : public BaseCommand {
 public:
+    using BaseCommand::BaseCommand;
     static constexpr const char* COMMAND_NAME = "update";
     
     std::string name() const override { return COMMAND_NAME; }
     std::string description() const override { return "Update packages"; }
-    std::string usage() const override { return "[<package>]"; }
+    std::string usage() const override { return "[--run-scripts] [--plan[=<file>]] [<package>...]"; }
     std::string example() const override { return "amb update math_utils"; }
     
 protected:
@@ -113,6 +164,7 @@ protected:
 
 class InitCommand : public BaseCommand {
 public:
+    using BaseCommand::BaseCommand;
     static constexpr const char* COMMAND_NAME = "init";
     
     std::string name() const override { return COMMAND_NAME; }
@@ -124,4 +176,60 @@ protected:
     int run(const std::vector<std::string>& args) override;
 };
 
+class VerifyCommand : public BaseCommand {
+public:
+    using BaseCommand::BaseCommand;
+    static constexpr const char* COMMAND_NAME = "verify";
+    
+    std::string name() const override { return COMMAND_NAME; }
+    std::string description() const override { return "Check registry, cache or installed packages against their digests"; }
+    std::string usage() const override { return "[--registry|--cache|--project] [--repair] [--restart]"; }
+    std::string example() const override { return "amb verify --cache --repair"; }
+    
+protected:
+    int run(const std::vector<std::string>& args) override;
+};
+
+class GcCommand : public BaseCommand {
+public:
+    using BaseCommand::BaseCommand;
+    static constexpr const char* COMMAND_NAME = "gc";
+    
+    std::string name() const override { return COMMAND_NAME; }
+    std::string description() const override { return "Remove package versions and cache entries no project references"; }
+    std::string usage() const override { return "[--dry-run]"; }
+    std::string example() const override { return "amb gc --dry-run"; }
+    
+protected:
+    int run(const std::vector<std::string>& args) override;
+};
+
+class SnapshotCommand : public BaseCommand {
+public:
+    using BaseCommand::BaseCommand;
+    static constexpr const char* COMMAND_NAME = "snapshot";
+    
+    std::string name() const override { return COMMAND_NAME; }
+    std::string description() const override { return "Pack the resolved dependencies into one bundle for offline installs"; }
+    std::string usage() const override { return "create [--output=<file>] [<package>[@<version>]...]"; }
+    std::string example() const override { return "amb snapshot create --output=deps.ambs"; }
+    
+protected:
+    int run(const std::vector<std::string>& args) override;
+};
+
+class StatsCommand : public BaseCommand {
+public:
+    using BaseCommand::BaseCommand;
+    static constexpr const char* COMMAND_NAME = "stats";
+    
+    std::string name() const override { return COMMAND_NAME; }
+    std::string description() const override { return "Summarize the resource usage of recent commands"; }
+    std::string usage() const override { return "[--last=<n>] [<command>...]"; }
+    std::string example() const override { return "amb stats install update"; }
+    
+protected:
+    int run(const std::vector<std::string>& args) override;
+};
+
 } // namespace amb
\ No newline at end of file
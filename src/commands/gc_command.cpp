@@ -0,0 +1,61 @@
+#include "commands/base_command.hpp"
+#include "core/context.hpp"
+#include "core/output.hpp"
+#include "package/garbage_collector.hpp"
+#include "utils/filesystem.hpp"
+#include "utils/logger.hpp"
+#include <iomanip>
+#include <sstream>
+
+namespace amb {
+
+int GcCommand::run(const std::vector<std::string>& args) {
+    Logger::debug("gc called with {} argument(s)", args.size());
+    
+    if (!ctx_) {
+        showError("No context available");
+        return 1;
+    }
+    
+    GcOptions options;
+    for (const auto& arg : args) {
+        if (arg == "--dry-run" || arg == "-n") {
+            options.dryRun = true;
+        } else {
+            showError("Unknown argument: " + arg);
+            showUsage();
+            return 1;
+        }
+    }
+    
+    GarbageCollector collector(*ctx_);
+    auto report = collector.run(options);
+    
+    if (options.dryRun || ctx_->isVerbose()) {
+        for (const auto& [path, bytes] : report.removed) {
+            std::ostringstream line;
+            line << "  " << std::setw(10) << FileSystem::formatSize(bytes) << "  " << path.string();
+            Output::emit(Event("gc.entry", line.str()).with("path", path.string()).with("bytes", bytes));
+        }
+    }
+    for (const auto& skipped : report.skipped) {
+        Logger::info("Skipped {}", skipped);
+    }
+    
+    std::ostringstream summary;
+    summary << (options.dryRun ? "Would reclaim " : "Reclaimed ") << FileSystem::formatSize(report.bytes) << ": "
+            << report.versions << " package version(s), " << report.cacheEntries << " cache entr"
+            << (report.cacheEntries == 1 ? "y" : "ies") << " (" << report.projects
+            << " project(s), " << report.referenced << " pinned version(s))";
+    Output::emit(Event("gc.done", summary.str())
+                     .with("dry_run", options.dryRun)
+                     .with("bytes", report.bytes)
+                     .with("versions", report.versions)
+                     .with("cache_entries", report.cacheEntries)
+                     .with("projects", report.projects)
+                     .with("pinned", report.referenced));
+    
+    return 0;
+}
+
+} // namespace amb
\ No newline at end of file
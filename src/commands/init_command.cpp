@@ -0,0 +1,52 @@
+#include "commands/base_command.hpp"
+#include "core/manifest.hpp"
+#include "core/output.hpp"
+#include "utils/filesystem.hpp"
+#include "utils/logger.hpp"
+
+namespace amb {
+
+int InitCommand::run(const std::vector<std::string>& args) {
+    Logger::debug("init called with {} argument(s)", args.size());
+    
+    std::vector<std::string> positional;
+    for (const auto& arg : args) {
+        if (arg.starts_with("-")) {
+            showError("Unknown argument: " + arg);
+            showUsage();
+            return 1;
+        }
+        positional.push_back(arg);
+    }
+    if (positional.size() > 1) {
+        showError("Expected at most one <name>");
+        showUsage();
+        return 1;
+    }
+    
+    // `amb init <name>` creates ./<name>; without one the current directory is the project
+    fs::path root = FileSystem::getCurrentDirectory();
+    if (!positional.empty()) {
+        root /= positional[0];
+    }
+    fs::path path = root / "ambar.json";
+    if (FileSystem::exists(path)) {
+        showError(path.string() + " already exists");
+        return 1;
+    }
+    
+    Manifest manifest;
+    manifest.name = positional.empty() ? FileSystem::filename(root) : positional[0];
+    manifest.version = "0.1.0";
+    if (!FileSystem::createDirectories(root) || !manifest.save(path)) {
+        showError("Could not write " + path.string());
+        return 1;
+    }
+    
+    Output::emit(Event("init.done", "Created " + path.string())
+                     .with("name", manifest.name)
+                     .with("path", path.string()));
+    return 0;
+}
+
+} // namespace amb
\ No newline at end of file
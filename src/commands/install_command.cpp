@@ -1,46 +1,122 @@
 #include "commands/base_command.hpp"
+#include "amb/config.hpp"
+#include "core/context.hpp"
+#include "core/output.hpp"
+#include "package/installer.hpp"
+#include "utils/filesystem.hpp"
 #include "utils/logger.hpp"
-#include <iostream>
 
 namespace amb {
 
 int InstallCommand::run(const std::vector<std::string>& args) {
     Logger::info("Installing packages...");
     
-    if (args.empty()) {
+    if (!ctx_) {
+        showError("No context available");
+        return 1;
+    }
+    
+    InstallOptions options;
+    std::vector<PackageSpec> specs;
+    bool planOnly = false;
+    bool workspace = false;
+    std::string planFile;
+    std::string fromPlan;
+    std::string fromSnapshot;
+    
+    for (const auto& arg : args) {
+        if (arg == "--global" || arg == "-g") {
+            options.global = true;
+        } else if (arg == "--workspace" || arg == "-w") {
+            workspace = true;
+        } else if (arg == "--run-scripts") {
+            options.runScripts = true;
+        } else if (arg == "--plan" || arg.starts_with("--plan=")) {
+            planOnly = true;
+            planFile = arg.size() > 7 ? arg.substr(7) : "";
+        } else if (arg.starts_with("--from-plan=")) {
+            fromPlan = arg.substr(12);
+        } else if (arg.starts_with("--from-snapshot=")) {
+            fromSnapshot = arg.substr(16);
+        } else if (arg.starts_with("-")) {
+            Logger::warning("Unknown argument: {}", arg);
+        } else {
+            auto spec = PackageSpec::parse(arg);
+            Logger::debug("Package: {}, Version: {}", spec.name, spec.range);
+            specs.push_back(spec);
+        }
+    }
+    
+    if (!fromSnapshot.empty()) {
+        if (!FileSystem::isFile(fromSnapshot)) {
+            showError("No such snapshot: " + fromSnapshot);
+            return 1;
+        }
+        // The bundle is the registry for this run only; config.json is left alone
+        ConfigManager::instance().mutableConfig().registryUrl = ConfigManager::snapshotUrl(fromSnapshot);
+    }
+    
+    Installer installer(*ctx_);
+    
+    if (!fromPlan.empty()) {
+        auto plan = InstallPlan::load(fromPlan);
+        if (!plan || !installer.execute(*plan)) {
+            showError("Installation failed");
+            return 1;
+        }
+        return 0;
+    }
+    
+    // At a workspace root (outside any member) the whole workspace is installed
+    if (!workspace && !options.global && specs.empty() && ctx_->isInsideWorkspace()) {
+        workspace = !ctx_->isInsideProject() || ctx_->getProjectRoot() == ctx_->getWorkspaceRoot();
+    }
+    
+    if (workspace) {
+        if (options.global || planOnly || !specs.empty()) {
+            showError("--workspace installs the members' declared dependencies; it takes no packages, --global or --plan");
+            return 1;
+        }
+        if (!installer.installWorkspace(options)) {
+            showError("Installation failed");
+            return 1;
+        }
+        return 0;
+    }
+    
+    if (options.global && specs.empty()) {
         showError("No packages specified");
         showUsage();
         return 1;
     }
     
-    for (const auto& arg : args) {
-        Logger::info("Would install: {}", arg);
-        
-        // Parse package name and version
-        size_t at_pos = arg.find('@');
-        std::string package_name = arg;
-        std::string version = "latest";
-        
-        if (at_pos != std::string::npos) {
-            package_name = arg.substr(0, at_pos);
-            version = arg.substr(at_pos + 1);
+    if (planOnly) {
+        auto plan = installer.planInstall(specs, options);
+        if (!plan) {
+            showError("Planning failed");
+            return 1;
         }
-        
-        Logger::debug("Package: {}, Version: {}", package_name, version);
-        
-        // TODO: Implement actual installation
-        // 1. Resolve version if "latest"
-        // 2. Download package
-        // 3. Extract to ambar_modules/lib/
-        // 4. Update ambar.lock
-    }
-    
-    std::cout << "Install command not yet implemented\n";
-    std::cout << "This would install: ";
-    for (const auto& arg : args) {
-        std::cout << arg << " ";
+        plan->print();
+        if (!planFile.empty()) {
+            if (!plan->save(planFile)) {
+                showError("Cannot write " + planFile);
+                return 1;
+            }
+            Output::emit(Event("plan.saved", "Plan saved to " + planFile + " (run it with amb install --from-plan=" + planFile + ")")
+                             .with("path", planFile));
+        }
+        return 0;
     }
-    std::cout << "\n";
+    
+    if (!installer.install(specs, options)) {
+        showError("Installation failed");
+        return 1;
+    }
+    
+    const auto& fetch = installer.report().fetch;
+    Logger::debug("Downloaded {} archive(s), {} from cache, {} bytes, {} from a snapshot, {} unpacked, {} packed",
+                  fetch.downloaded, fetch.cached, fetch.bytes, installer.report().fromSnapshot,
+                  installer.report().unpacked, installer.report().packed);
     
     return 0;
 }
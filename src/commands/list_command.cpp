@@ -1,7 +1,8 @@
 #include "commands/base_command.hpp"
 #include "utils/logger.hpp"
 #include "utils/filesystem.hpp"
-#include <iostream>
+#include "core/context.hpp"
+#include "core/output.hpp"
 
 namespace amb {
 
@@ -26,8 +27,8 @@ int ListCommand::run(const std::vector<std::string>& args) {
         // Check if we're in a project
         if (!ctx_ || !ctx_->isInsideProject()) {
             showError("Not in an Ambar project directory");
-            std::cout << "Run this command inside a project directory,\n";
-            std::cout << "or use --global to list global packages\n";
+            Output::emit("message", "Run this command inside a project directory,\n"
+                                    "or use --global to list global packages");
             return 1;
         }
         
@@ -40,21 +41,24 @@ int ListCommand::run(const std::vector<std::string>& args) {
                 auto packages = FileSystem::listDirectories(libDir);
                 
                 if (packages.empty()) {
-                    std::cout << "No packages installed locally\n";
+                    Output::emit("message", "No packages installed locally");
                 } else {
-                    std::cout << "Locally installed packages:\n";
+                    Output::emit("message", "Locally installed packages:");
                     for (const auto& pkg : packages) {
-                        std::cout << "  " << FileSystem::filename(pkg) << "\n";
+                        std::string name = FileSystem::filename(pkg);
+                        std::string text = "  " + name;
                         
                         // List versions
-                        auto versions = FileSystem::listDirectories(pkg);
-                        for (const auto& ver : versions) {
-                            std::cout << "    " << FileSystem::filename(ver) << "\n";
+                        std::vector<std::string> versions;
+                        for (const auto& ver : FileSystem::listDirectories(pkg)) {
+                            versions.push_back(FileSystem::filename(ver));
+                            text += "\n    " + versions.back();
                         }
+                        Output::emit(Event("package", text).with("name", name).with("versions", versions));
                     }
                 }
             } else {
-                std::cout << "No packages installed locally\n";
+                Output::emit("message", "No packages installed locally");
             }
         }
     }
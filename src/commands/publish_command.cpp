@@ -0,0 +1,120 @@
+#include "commands/base_command.hpp"
+#include "amb/config.hpp"
+#include "core/context.hpp"
+#include "core/output.hpp"
+#include "registry/publisher.hpp"
+#include "utils/ed25519.hpp"
+#include "utils/filesystem.hpp"
+#include "utils/logger.hpp"
+#include "utils/sha256.hpp"
+#include <algorithm>
+#include <cctype>
+
+namespace amb {
+
+namespace {
+
+// Hex seed file; a missing file gets a fresh key so first-time publishers need no extra tool
+std::optional<Ed25519::Seed> loadSigningKey(const fs::path& path) {
+    if (!FileSystem::exists(path)) {
+        auto seed = Ed25519::generateSeed();
+        if (!FileSystem::writeFile(path, Sha256::toHex(seed.data(), seed.size()) + "\n")) {
+            Logger::error("Cannot write signing key {}", path.string());
+            return std::nullopt;
+        }
+        std::error_code ec;
+        fs::permissions(path, fs::perms::owner_read | fs::perms::owner_write, ec);
+        auto publicKey = Ed25519::publicKey(seed);
+        std::string hex = Sha256::toHex(publicKey.data(), publicKey.size());
+        Output::emit(Event("publish.key", "Generated signing key " + path.string() + " (public key " + hex + ")")
+                         .with("path", path.string())
+                         .with("public_key", hex));
+        return seed;
+    }
+    
+    auto content = FileSystem::readFile(path);
+    std::string hex = content ? *content : "";
+    hex.erase(std::remove_if(hex.begin(), hex.end(), [](unsigned char c) { return std::isspace(c); }), hex.end());
+    auto seed = Ed25519::parseSeed(hex);
+    if (!seed) {
+        Logger::error("{} is not an Ed25519 signing key (64 hex digits)", path.string());
+    }
+    return seed;
+}
+
+} // namespace
+
+int PublishCommand::run(const std::vector<std::string>& args) {
+    Logger::debug("publish called with {} argument(s)", args.size());
+    
+    std::vector<std::string> positional;
+    std::string keyFile = ConfigManager::instance().config().signingKey;
+    for (size_t i = 0; i < args.size(); ++i) {
+        if (args[i] == "--sign" && i + 1 < args.size()) {
+            keyFile = args[++i];
+        } else if (args[i].starts_with("--")) {
+            showError("Unknown argument: " + args[i]);
+            showUsage();
+            return 1;
+        } else {
+            positional.push_back(args[i]);
+        }
+    }
+    if (positional.size() > 1) {
+        showError("Too many arguments");
+        showUsage();
+        return 1;
+    }
+    
+    std::optional<Ed25519::Seed> signingKey;
+    if (!keyFile.empty()) {
+        signingKey = loadSigningKey(keyFile);
+        if (!signingKey) {
+            return 1;
+        }
+    }
+    
+    fs::path packageDir;
+    if (!positional.empty()) {
+        packageDir = fs::absolute(positional[0]);
+    } else if (ctx_ && ctx_->isInsideProject()) {
+        packageDir = *ctx_->getProjectRoot();
+    } else {
+        packageDir = fs::current_path();
+    }
+    
+    fs::path registryRoot = ConfigManager::instance().getRegistryPath();
+    if (registryRoot.empty()) {
+        showError("Publishing requires a file:// registry (got " +
+                  ConfigManager::instance().getRegistryUrl() + ")");
+        return 1;
+    }
+    
+    Publisher publisher(registryRoot, signingKey);
+    auto result = publisher.publish(packageDir);
+    if (!result) {
+        showError("Publish failed");
+        return 1;
+    }
+    
+    Event published("publish.done", "Published " + result->name + "@" + result->version + " (" +
+                                    std::to_string(result->archiveSize) + " bytes, sha256 " +
+                                    result->sha256.substr(0, 12) + ")");
+    published.with("name", result->name)
+        .with("version", result->version)
+        .with("size", result->archiveSize)
+        .with("sha256", result->sha256);
+    if (!result->publicKey.empty()) {
+        published.text += "\n  signed with key " + result->publicKey;
+        published.with("public_key", result->publicKey);
+    }
+    if (result->deltaFrom) {
+        published.text += "\n  delta from " + *result->deltaFrom + ": " + std::to_string(result->deltaSize) + " bytes";
+        published.with("delta_from", *result->deltaFrom).with("delta_size", result->deltaSize);
+    }
+    Output::emit(published);
+    
+    return 0;
+}
+
+} // namespace amb
\ No newline at end of file
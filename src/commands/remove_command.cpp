@@ -1,4 +1,6 @@
 #include "commands/base_command.hpp"
+#include "core/context.hpp"
+#include "package/installer.hpp"
 #include "utils/logger.hpp"
 #include <iostream>
 
@@ -7,28 +9,35 @@ namespace amb {
 int RemoveCommand::run(const std::vector<std::string>& args) {
     Logger::info("Removing packages...");
     
-    if (args.empty()) {
-        showError("No packages specified");
-        showUsage();
+    if (!ctx_) {
+        showError("No context available");
         return 1;
     }
     
+    RemoveOptions options;
+    std::vector<std::string> names;
+    
     for (const auto& arg : args) {
-        Logger::info("Would remove: {}", arg);
-        
-        // TODO: Implement actual removal
-        // 1. Check if package is installed
-        // 2. Remove from ambar_modules/lib/
-        // 3. Update ambar.lock
-        // 4. Clean up if no dependencies
+        if (arg == "--cascade") {
+            options.cascade = true;
+        } else if (arg.starts_with("-")) {
+            Logger::warning("Unknown argument: {}", arg);
+        } else {
+            names.push_back(arg);
+        }
     }
     
-    std::cout << "Remove command not yet implemented\n";
-    std::cout << "This would remove: ";
-    for (const auto& arg : args) {
-        std::cout << arg << " ";
+    if (names.empty()) {
+        showError("No packages specified");
+        showUsage();
+        return 1;
+    }
+    
+    Installer installer(*ctx_);
+    if (!installer.remove(names, options)) {
+        showError("Removal failed");
+        return 1;
     }
-    std::cout << "\n";
     
     return 0;
 }
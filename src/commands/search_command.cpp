@@ -0,0 +1,73 @@
+#include "commands/base_command.hpp"
+#include "amb/config.hpp"
+#include "core/context.hpp"
+#include "core/output.hpp"
+#include "registry/registry_index.hpp"
+#include "utils/logger.hpp"
+
+#include <algorithm>
+#include <cctype>
+
+namespace amb {
+
+namespace {
+
+std::string lower(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return std::tolower(c); });
+    return text;
+}
+
+} // namespace
+
+int SearchCommand::run(const std::vector<std::string>& args) {
+    Logger::debug("search called with {} argument(s)", args.size());
+    
+    std::vector<std::string> positional;
+    for (const auto& arg : args) {
+        if (arg.starts_with("-")) {
+            showError("Unknown argument: " + arg);
+            showUsage();
+            return 1;
+        }
+        positional.push_back(arg);
+    }
+    if (positional.size() != 1) {
+        showError("Expected exactly one <query>");
+        showUsage();
+        return 1;
+    }
+    std::string query = lower(positional[0]);
+    
+    const auto& config = ConfigManager::instance();
+    auto index = RegistryIndex::load(config.getRegistryUrl(), config.config().networkTimeout,
+                                     ctx_ ? ctx_->getCacheDir() : fs::path());
+    if (!index) {
+        showError("Could not load the registry index from " + config.getRegistryUrl());
+        return 1;
+    }
+    
+    // The index only knows names and versions, so the query matches package names
+    size_t found = 0;
+    for (const auto& name : index->packageNames()) {
+        if (lower(name).find(query) == std::string::npos) {
+            continue;
+        }
+        const auto* latest = index->best(name, "*");
+        if (!latest) {
+            continue;  // every version is yanked
+        }
+        found++;
+        Output::emit(Event("search.package", "  " + name + " " + latest->version)
+                         .with("name", name)
+                         .with("version", latest->version)
+                         .with("versions", index->versions(name)->size()));
+    }
+    
+    Output::emit(Event("search.done", found == 0 ? "No packages match '" + positional[0] + "'"
+                                                 : std::to_string(found) + " package(s) found")
+                     .with("query", positional[0])
+                     .with("found", found));
+    return 0;
+}
+
+} // namespace amb
\ No newline at end of file
@@ -0,0 +1,60 @@
+#include "commands/base_command.hpp"
+#include "core/context.hpp"
+#include "core/output.hpp"
+#include "package/snapshot_builder.hpp"
+#include "registry/snapshot_bundle.hpp"
+#include "utils/filesystem.hpp"
+#include "utils/logger.hpp"
+
+namespace amb {
+
+int SnapshotCommand::run(const std::vector<std::string>& args) {
+    Logger::debug("snapshot called with {} argument(s)", args.size());
+    
+    if (!ctx_) {
+        showError("No context available");
+        return 1;
+    }
+    
+    if (args.empty() || args[0] != "create") {
+        showUsage();
+        return 1;
+    }
+    
+    fs::path output;
+    std::vector<PackageSpec> specs;
+    for (size_t i = 1; i < args.size(); ++i) {
+        const auto& arg = args[i];
+        if (arg.starts_with("--output=")) {
+            output = arg.substr(9);
+        } else if (arg.starts_with("-")) {
+            showError("Unknown argument: " + arg);
+            showUsage();
+            return 1;
+        } else {
+            specs.push_back(PackageSpec::parse(arg));
+        }
+    }
+    if (output.empty()) {
+        std::string stem = ctx_->isInsideProject() ? FileSystem::filename(*ctx_->getProjectRoot()) : "snapshot";
+        output = stem + SnapshotBundle::EXTENSION;
+    }
+    
+    SnapshotBuilder builder(*ctx_);
+    auto report = builder.create(specs, output);
+    if (!report) {
+        showError("Snapshot failed");
+        return 1;
+    }
+    
+    Logger::debug("Downloaded {} archive(s), {} from cache", report->fetch.downloaded, report->fetch.cached);
+    Output::emit(Event("snapshot.done", "Packed " + std::to_string(report->packages) + " package(s) into " +
+                                            output.string() + " (" + FileSystem::formatSize(report->bytes) + ")\n" +
+                                            "Install with: amb install --from-snapshot=" + output.string())
+                     .with("path", output.string())
+                     .with("packages", report->packages)
+                     .with("bytes", report->bytes));
+    return 0;
+}
+
+} // namespace amb
\ No newline at end of file
@@ -0,0 +1,173 @@
+#include "commands/base_command.hpp"
+#include "core/context.hpp"
+#include "core/output.hpp"
+#include "core/usage_log.hpp"
+#include "utils/filesystem.hpp"
+#include "utils/logger.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <map>
+#include <set>
+
+namespace amb {
+
+namespace {
+
+// Nearest-rank percentile of an unsorted sample
+double percentile(std::vector<double> values, double p) {
+    if (values.empty()) {
+        return 0;
+    }
+    std::sort(values.begin(), values.end());
+    auto rank = static_cast<size_t>(std::ceil(p / 100.0 * static_cast<double>(values.size())));
+    return values[std::clamp<size_t>(rank, 1, values.size()) - 1];
+}
+
+std::string formatSeconds(double seconds) {
+    char buffer[32];
+    if (seconds < 1) {
+        std::snprintf(buffer, sizeof(buffer), "%.0fms", seconds * 1000);
+    } else {
+        std::snprintf(buffer, sizeof(buffer), "%.2fs", seconds);
+    }
+    return buffer;
+}
+
+std::string formatRatio(uint64_t hits, uint64_t total) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.0f%%", 100.0 * static_cast<double>(hits) / static_cast<double>(total));
+    return buffer;
+}
+
+using Field = std::function<double(const UsageRecord&)>;
+
+// One row of the group's text, and <key>_p50/_p90/_p99 in its fields
+void addPercentiles(Event& event, const std::string& label, const std::string& key,
+                    const std::vector<const UsageRecord*>& runs, const Field& field,
+                    const std::function<std::string(double)>& format) {
+    std::vector<double> values;
+    for (const auto* run : runs) {
+        values.push_back(field(*run));
+    }
+    double p50 = percentile(values, 50), p90 = percentile(values, 90), p99 = percentile(values, 99);
+    std::string padded = label + std::string(label.size() < 10 ? 10 - label.size() : 1, ' ');
+    event.text += "\n  " + padded + "p50 " + format(p50) + "  p90 " + format(p90) + "  p99 " + format(p99);
+    event.with(key + "_p50", p50).with(key + "_p90", p90).with(key + "_p99", p99);
+}
+
+} // namespace
+
+int StatsCommand::run(const std::vector<std::string>& args) {
+    Logger::debug("stats called with {} argument(s)", args.size());
+    
+    if (!ctx_) {
+        showError("No context available");
+        return 1;
+    }
+    
+    size_t last = 0;
+    std::set<std::string> commands;
+    for (const auto& arg : args) {
+        if (arg.starts_with("--last=")) {
+            auto value = arg.substr(7);
+            auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), last);
+            if (ec != std::errc() || end != value.data() + value.size() || last == 0) {
+                showError("--last expects a positive number, got '" + value + "'");
+                return 1;
+            }
+        } else if (arg.starts_with("-")) {
+            showError("Unknown argument: " + arg);
+            showUsage();
+            return 1;
+        } else {
+            commands.insert(arg);
+        }
+    }
+    
+    auto records = UsageLog::load(ctx_->getAmbRoot());
+    
+    // One group per command and amb version, so an upgrade shows up as a new row;
+    // versions are listed in the order they were first used
+    std::map<std::string, std::vector<std::string>> versions;
+    std::map<std::pair<std::string, std::string>, std::vector<const UsageRecord*>> groups;
+    for (const auto& record : records) {
+        if (!commands.empty() && !commands.count(record.command)) {
+            continue;
+        }
+        auto& runs = groups[{record.command, record.version}];
+        if (runs.empty()) {
+            versions[record.command].push_back(record.version);
+        }
+        runs.push_back(&record);
+    }
+    
+    if (groups.empty()) {
+        Output::emit("message", "No usage recorded yet in " + (ctx_->getAmbRoot() / UsageLog::FILE_NAME).string());
+        return 0;
+    }
+    
+    auto bytes = [](double value) { return FileSystem::formatSize(static_cast<uint64_t>(value)); };
+    for (const auto& [command, seen] : versions) {
+        for (const auto& version : seen) {
+            auto runs = groups[{command, version}];
+            if (last > 0 && runs.size() > last) {
+                runs.erase(runs.begin(), runs.end() - static_cast<std::ptrdiff_t>(last));
+            }
+            
+            size_t failed = 0;
+            uint64_t statCalls = 0, statHits = 0, netIn = 0, netOut = 0;
+            uint64_t downloads = 0, archiveHits = 0, buildHits = 0, buildMisses = 0;
+            for (const auto* run : runs) {
+                failed += run->exitCode != 0 ? 1 : 0;
+                statCalls += run->statCalls;
+                statHits += run->statHits;
+                netIn += run->networkReceived;
+                netOut += run->networkSent;
+                downloads += run->archiveDownloads;
+                archiveHits += run->archiveCacheHits;
+                buildHits += run->buildCacheHits;
+                buildMisses += run->buildCacheMisses;
+            }
+            
+            Event group("stats.command", command + " (amb " + (version.empty() ? "?" : version) + ") - " +
+                                             std::to_string(runs.size()) + " run(s)");
+            if (failed > 0) {
+                group.text += ", " + std::to_string(failed) + " failed";
+            }
+            group.with("command", command).with("version", version).with("runs", runs.size()).with("failed", failed);
+            
+            addPercentiles(group, "wall", "wall_s", runs, [](const UsageRecord& r) { return r.wallSeconds; }, formatSeconds);
+            addPercentiles(group, "cpu", "cpu_s", runs, [](const UsageRecord& r) { return r.cpuSeconds; }, formatSeconds);
+            addPercentiles(group, "peak rss", "peak_rss", runs, [](const UsageRecord& r) { return static_cast<double>(r.peakRssBytes); }, bytes);
+            addPercentiles(group, "read", "read", runs, [](const UsageRecord& r) { return static_cast<double>(r.bytesRead); }, bytes);
+            addPercentiles(group, "written", "written", runs, [](const UsageRecord& r) { return static_cast<double>(r.bytesWritten); }, bytes);
+            if (netIn + netOut > 0) {
+                group.text += "\n  network   " + FileSystem::formatSize(netIn) + " in, " +
+                              FileSystem::formatSize(netOut) + " out in total";
+            }
+            if (statCalls + statHits > 0) {
+                group.text += "\n  stat      " + std::to_string(statCalls) + " call(s), " +
+                              formatRatio(statHits, statCalls + statHits) + " answered by the stat cache";
+            }
+            if (downloads + archiveHits > 0) {
+                group.text += "\n  archives  " + std::to_string(downloads) + " download(s), " +
+                              formatRatio(archiveHits, downloads + archiveHits) + " cache hits";
+            }
+            if (buildHits + buildMisses > 0) {
+                group.text += "\n  builds    " + formatRatio(buildHits, buildHits + buildMisses) + " build cache hits";
+            }
+            group.with("net_in", netIn).with("net_out", netOut)
+                .with("stat_calls", statCalls).with("stat_hits", statHits)
+                .with("downloads", downloads).with("archive_hits", archiveHits)
+                .with("build_hits", buildHits).with("build_misses", buildMisses);
+            Output::emit(group);
+        }
+    }
+    
+    return 0;
+}
+
+} // namespace amb
\ No newline at end of file
@@ -0,0 +1,141 @@
+#include "commands/base_command.hpp"
+#include "core/context.hpp"
+#include "core/output.hpp"
+#include "package/lock_graph.hpp"
+#include "package/resolver.hpp"
+#include "utils/logger.hpp"
+
+#include <charconv>
+#include <limits>
+
+namespace amb {
+
+int TreeCommand::run(const std::vector<std::string>& args) {
+    Logger::debug("tree called with {} argument(s)", args.size());
+    
+    std::vector<std::string> positional;
+    size_t depth = std::numeric_limits<size_t>::max();
+    for (const auto& arg : args) {
+        if (arg.starts_with("--depth=")) {
+            auto value = arg.substr(8);
+            auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), depth);
+            if (ec != std::errc() || end != value.data() + value.size()) {
+                showError("--depth expects a number, got '" + value + "'");
+                return 1;
+            }
+        } else if (arg.starts_with("-")) {
+            showError("Unknown argument: " + arg);
+            showUsage();
+            return 1;
+        } else {
+            positional.push_back(arg);
+        }
+    }
+    if (positional.size() > 1) {
+        showError("Too many arguments");
+        showUsage();
+        return 1;
+    }
+    
+    if (!ctx_ || !ctx_->isInsideProject()) {
+        showError("Not in an Ambar project directory");
+        return 1;
+    }
+    auto graph = LockGraph::load(*ctx_->getProjectRoot());
+    if (!graph) {
+        showError("No ambar.lock in this project; run 'amb install' first");
+        return 1;
+    }
+    
+    std::vector<DependencyGraph::NodeId> starts = graph->roots();
+    if (!positional.empty()) {
+        auto spec = PackageSpec::parse(positional[0]);
+        starts = graph->versionsOf(spec.name, spec.range);
+        if (starts.empty()) {
+            showError("'" + positional[0] + "' is not installed in this project");
+            return 1;
+        }
+    }
+    
+    // The whole tree is rendered into one string and written at once. A package whose
+    // dependencies were already listed is marked (*) instead of being expanded again,
+    // which also stops cycles; past --depth it is marked (...).
+    struct Frame {
+        DependencyGraph::NodeId node;
+        uint32_t next;  // index of the next dependency to print
+    };
+    std::string text;
+    text.reserve(graph->size() * 32);
+    std::string prefix;
+    std::vector<Frame> frames;
+    std::vector<char> expanded(graph->size(), 0);
+    std::vector<std::string> roots;
+    uint64_t lines = 0, deduped = 0, truncated = 0;
+    
+    auto appendNode = [&](DependencyGraph::NodeId node, size_t level) {
+        text.append(graph->name(node)).append("@").append(graph->version(node));
+        ++lines;
+        bool expand = false;
+        if (!graph->dependencies(node).empty()) {
+            if (expanded[node]) {
+                text += " (*)";
+                ++deduped;
+            } else if (level >= depth) {
+                text += " (...)";
+                ++truncated;
+            } else {
+                expanded[node] = 1;
+                expand = true;
+            }
+        }
+        text += '\n';
+        return expand;
+    };
+    
+    for (auto start : starts) {
+        roots.push_back(graph->key(start));
+        if (!appendNode(start, 0)) {
+            continue;
+        }
+        frames.push_back({start, 0});
+        while (!frames.empty()) {
+            auto& frame = frames.back();
+            auto dependencies = graph->dependencies(frame.node);
+            if (frame.next == dependencies.size()) {
+                frames.pop_back();
+                if (!frames.empty()) {
+                    prefix.resize(prefix.size() - 4);
+                }
+                continue;
+            }
+            auto child = dependencies[frame.next++];
+            bool last = frame.next == dependencies.size();
+            text += prefix;
+            text += last ? "`-- " : "|-- ";
+            if (appendNode(child, frames.size())) {
+                prefix += last ? "    " : "|   ";
+                frames.push_back({child, 0});
+            }
+        }
+    }
+    
+    if (deduped > 0) {
+        text += "(*) dependencies listed above\n";
+    }
+    if (truncated > 0) {
+        text += "(...) deeper than --depth=" + std::to_string(depth) + "\n";
+    }
+    if (starts.empty()) {
+        text = "No dependencies\n";
+    }
+    text.pop_back();
+    Output::emit(Event("tree", std::move(text))
+                     .with("roots", roots)
+                     .with("packages", lines)
+                     .with("deduped", deduped)
+                     .with("truncated", truncated));
+    
+    return 0;
+}
+
+} // namespace amb
\ No newline at end of file
@@ -0,0 +1,66 @@
+#include "commands/base_command.hpp"
+#include "core/context.hpp"
+#include "core/output.hpp"
+#include "package/installer.hpp"
+#include "utils/logger.hpp"
+
+namespace amb {
+
+int UpdateCommand::run(const std::vector<std::string>& args) {
+    Logger::debug("update called with {} argument(s)", args.size());
+    
+    if (!ctx_) {
+        showError("No context available");
+        return 1;
+    }
+    
+    InstallOptions options;
+    std::vector<std::string> names;
+    bool planOnly = false;
+    std::string planFile;
+    for (const auto& arg : args) {
+        if (arg == "--run-scripts") {
+            options.runScripts = true;
+        } else if (arg == "--plan" || arg.starts_with("--plan=")) {
+            planOnly = true;
+            planFile = arg.size() > 7 ? arg.substr(7) : "";
+        } else if (arg.starts_with("-")) {
+            Logger::warning("Unknown argument: {}", arg);
+        } else {
+            names.push_back(arg);
+        }
+    }
+    
+    Installer installer(*ctx_);
+    
+    if (planOnly) {
+        auto plan = installer.planUpdate(names, options);
+        if (!plan) {
+            showError("Planning failed");
+            return 1;
+        }
+        plan->print();
+        if (!planFile.empty()) {
+            if (!plan->save(planFile)) {
+                showError("Cannot write " + planFile);
+                return 1;
+            }
+            Output::emit(Event("plan.saved", "Plan saved to " + planFile + " (run it with amb install --from-plan=" + planFile + ")")
+                             .with("path", planFile));
+        }
+        return 0;
+    }
+    
+    if (!installer.update(names, options)) {
+        showError("Update failed");
+        return 1;
+    }
+    
+    const auto& fetch = installer.report().fetch;
+    Logger::debug("Downloaded {} artifact(s), {} from cache, {} bytes",
+                  fetch.downloaded, fetch.cached, fetch.bytes);
+    
+    return 0;
+}
+
+} // namespace amb
\ No newline at end of file
@@ -0,0 +1,79 @@
+#include "commands/base_command.hpp"
+#include "core/context.hpp"
+#include "core/output.hpp"
+#include "package/verifier.hpp"
+#include "utils/logger.hpp"
+#include <iomanip>
+#include <sstream>
+
+namespace amb {
+
+int VerifyCommand::run(const std::vector<std::string>& args) {
+    Logger::debug("verify called with {} argument(s)", args.size());
+    
+    if (!ctx_) {
+        showError("No context available");
+        return 1;
+    }
+    
+    VerifyOptions options;
+    options.scope = ctx_->isInsideProject() ? VerifyScope::PROJECT : VerifyScope::CACHE;
+    for (const auto& arg : args) {
+        if (arg == "--registry") {
+            options.scope = VerifyScope::REGISTRY;
+        } else if (arg == "--cache") {
+            options.scope = VerifyScope::CACHE;
+        } else if (arg == "--project") {
+            options.scope = VerifyScope::PROJECT;
+        } else if (arg == "--repair") {
+            options.repair = true;
+        } else if (arg == "--restart") {
+            options.restart = true;
+        } else {
+            showError("Unknown argument: " + arg);
+            showUsage();
+            return 1;
+        }
+    }
+    
+    Verifier verifier(*ctx_);
+    auto report = verifier.run(options);
+    
+    for (const auto& problem : report.problems) {
+        Output::emit(Event("verify.problem", "  " + problem).with("message", problem));
+    }
+    
+    double seconds = static_cast<double>(report.elapsed.count()) / 1000.0;
+    double megabytes = static_cast<double>(report.bytes) / (1024.0 * 1024.0);
+    std::ostringstream summary;
+    summary << "Verified " << report.checked << " entries (" << std::fixed << std::setprecision(1)
+            << megabytes << " MB in " << seconds << "s";
+    if (seconds > 0) {
+        summary << ", " << megabytes / seconds << " MB/s";
+    }
+    summary << ")";
+    if (report.resumed > 0) {
+        summary << ", " << report.resumed << " from checkpoint";
+    }
+    summary << ": " << report.mismatched << " mismatched, " << report.missing << " missing";
+    if (report.unverifiable > 0) {
+        summary << ", " << report.unverifiable << " without digests";
+    }
+    if (options.repair) {
+        summary << ", " << report.repaired << " repaired";
+    }
+    Output::emit(Event("verify.done", summary.str())
+                     .with("checked", report.checked)
+                     .with("bytes", report.bytes)
+                     .with("seconds", seconds)
+                     .with("resumed", report.resumed)
+                     .with("mismatched", report.mismatched)
+                     .with("missing", report.missing)
+                     .with("unverifiable", report.unverifiable)
+                     .with("repaired", report.repaired)
+                     .with("ok", report.ok()));
+    
+    return report.ok() ? 0 : 1;
+}
+
+} // namespace amb
\ No newline at end of file
@@ -0,0 +1,92 @@
+#include "commands/base_command.hpp"
+#include "core/context.hpp"
+#include "core/output.hpp"
+#include "package/lock_graph.hpp"
+#include "package/resolver.hpp"
+#include "utils/logger.hpp"
+
+#include <charconv>
+#include <limits>
+
+namespace amb {
+
+int WhyCommand::run(const std::vector<std::string>& args) {
+    Logger::debug("why called with {} argument(s)", args.size());
+    
+    std::vector<std::string> positional;
+    size_t limit = DEFAULT_LIMIT;
+    size_t depth = std::numeric_limits<size_t>::max();
+    for (const auto& arg : args) {
+        if (arg.starts_with("--limit=") || arg.starts_with("--depth=")) {
+            auto value = arg.substr(8);
+            size_t& target = arg.starts_with("--limit=") ? limit : depth;
+            auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), target);
+            if (ec != std::errc() || end != value.data() + value.size()) {
+                showError(arg.substr(0, 7) + " expects a number, got '" + value + "'");
+                return 1;
+            }
+        } else if (arg.starts_with("-")) {
+            showError("Unknown argument: " + arg);
+            showUsage();
+            return 1;
+        } else {
+            positional.push_back(arg);
+        }
+    }
+    if (positional.size() != 1) {
+        showError("Expected exactly one <package>");
+        showUsage();
+        return 1;
+    }
+    auto spec = PackageSpec::parse(positional[0]);
+    
+    if (!ctx_ || !ctx_->isInsideProject()) {
+        showError("Not in an Ambar project directory");
+        return 1;
+    }
+    auto graph = LockGraph::load(*ctx_->getProjectRoot());
+    if (!graph) {
+        showError("No ambar.lock in this project; run 'amb install' first");
+        return 1;
+    }
+    
+    auto nodes = graph->versionsOf(spec.name, spec.range);
+    if (nodes.empty()) {
+        showError("'" + positional[0] + "' is not installed in this project");
+        return 1;
+    }
+    
+    for (auto node : nodes) {
+        auto found = graph->shortestPaths(node, limit, depth);
+        
+        std::string text = graph->key(node);
+        std::vector<std::string> paths;
+        bool direct = false;
+        for (const auto& path : found.paths) {
+            std::string line;
+            for (auto step : path) {
+                line += (line.empty() ? "" : " -> ") + graph->key(step);
+            }
+            direct |= path.size() == 1;
+            paths.push_back(line);
+            text += "\n  " + line + (path.size() == 1 ? " (direct dependency)" : "");
+        }
+        if (found.total == 0) {
+            text += depth == std::numeric_limits<size_t>::max()
+                ? "\n  not required by any direct dependency"
+                : "\n  not reached from a direct dependency within " + std::to_string(depth) + " step(s)";
+        } else if (found.total > found.paths.size()) {
+            text += "\n  ... " + std::to_string(found.total - found.paths.size()) +
+                    " more shortest path(s), see --limit=<n>";
+        }
+        Output::emit(Event("why.package", text)
+                         .with("package", graph->key(node))
+                         .with("direct", direct)
+                         .with("paths", paths)
+                         .with("total", found.total));
+    }
+    
+    return 0;
+}
+
+} // namespace amb
\ No newline at end of file
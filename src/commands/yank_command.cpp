@@ -0,0 +1,53 @@
+#include "commands/base_command.hpp"
+#include "amb/config.hpp"
+#include "core/output.hpp"
+#include "registry/publisher.hpp"
+#include "utils/logger.hpp"
+
+namespace amb {
+
+int YankCommand::run(const std::vector<std::string>& args) {
+    Logger::debug("yank called with {} argument(s)", args.size());
+    
+    std::vector<std::string> positional;
+    bool undo = false;
+    for (const auto& arg : args) {
+        if (arg == "--undo") {
+            undo = true;
+        } else if (arg.starts_with("--")) {
+            showError("Unknown argument: " + arg);
+            showUsage();
+            return 1;
+        } else {
+            positional.push_back(arg);
+        }
+    }
+    auto at = positional.size() == 1 ? positional[0].rfind('@') : std::string::npos;
+    if (at == std::string::npos || at == 0 || at + 1 == positional[0].size()) {
+        showError("Expected exactly one <package>@<version>");
+        showUsage();
+        return 1;
+    }
+    std::string package = positional[0].substr(0, at);
+    std::string version = positional[0].substr(at + 1);
+    
+    fs::path registryRoot = ConfigManager::instance().getRegistryPath();
+    if (registryRoot.empty()) {
+        showError("Yanking requires a file:// registry (got " +
+                  ConfigManager::instance().getRegistryUrl() + ")");
+        return 1;
+    }
+    
+    bool changed = Publisher(registryRoot).yank(package, version, !undo);
+    std::string state = undo ? "available" : "yanked";
+    Output::emit(Event("yank.done", changed ? package + "@" + version + " is now " + state
+                                            : package + "@" + version + " was already " + state)
+                     .with("name", package)
+                     .with("version", version)
+                     .with("yanked", !undo)
+                     .with("changed", changed));
+    
+    return 0;
+}
+
+} // namespace amb
\ No newline at end of file
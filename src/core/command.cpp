@@ -16,12 +16,12 @@ void CommandFactory::registerCommand(const std::string& name, CommandCreator cre
     creators_[name] = creator;
 }
 
-std::unique_ptr<Command> CommandFactory::create(const std::string& name) {
+std::unique_ptr<Command> CommandFactory::create(const std::string& name, Context* ctx) {
     auto it = creators_.find(name);
     if (it == creators_.end()) {
         return nullptr;
     }
-    return it->second();
+    return it->second(ctx);
 }
 
 std::vector<std::string> CommandFactory::listCommands() const {
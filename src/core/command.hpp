@@ -25,19 +25,19 @@ public:
 // Command factory
 class CommandFactory {
 public:
-    using CommandCreator = std::function<std::unique_ptr<Command>()>;
+    using CommandCreator = std::function<std::unique_ptr<Command>(Context*)>;
     
     static CommandFactory& instance();
     
     void registerCommand(const std::string& name, CommandCreator creator);
-    std::unique_ptr<Command> create(const std::string& name);
+    std::unique_ptr<Command> create(const std::string& name, Context* ctx = nullptr);
     std::vector<std::string> listCommands() const;
     bool exists(const std::string& name) const;
     
     template<typename T>
     void registerCommand() {
-        registerCommand(T::COMMAND_NAME, []() {
-            return std::make_unique<T>();
+        registerCommand(T::COMMAND_NAME, [](Context* ctx) {
+            return std::make_unique<T>(ctx);
         });
     }
     
@@ -1,8 +1,9 @@
 #include "amb/config.hpp"
 #include "utils/logger.hpp"
 #include "utils/filesystem.hpp"
+#include "utils/file_lock.hpp"
 #include <fstream>
-#include <nlohmann/json.hpp>
+#include "json.hpp"
 
 using json = nlohmann::json;
 
@@ -66,6 +67,18 @@ fs::path ConfigManager::getRegistryPath() const {
     return fs::path();
 }
 
+std::optional<fs::path> ConfigManager::getSnapshotPath() const {
+    // snapshot:///abs/bundle.ambs, snapshot://./bundle.ambs
+    if (config_.registryUrl.starts_with("snapshot://")) {
+        return fs::path(config_.registryUrl.substr(11));
+    }
+    return std::nullopt;
+}
+
+std::string ConfigManager::snapshotUrl(const fs::path& bundle) {
+    return "snapshot://" + fs::absolute(bundle).lexically_normal().generic_string();
+}
+
 void ConfigManager::setRegistryUrl(const std::string& url) {
     config_.registryUrl = url;
     save();
@@ -103,6 +116,42 @@ bool ConfigManager::load() {
             config_.networkTimeout = j["network_timeout"];
         }
         
+        if (j.contains("compiler")) {
+            config_.compiler = j["compiler"];
+        }
+        
+        if (j.contains("compiler_flags")) {
+            config_.compilerFlags = j["compiler_flags"];
+        }
+        
+        if (j.contains("build_cache_max_mb")) {
+            config_.buildCacheMaxMb = j["build_cache_max_mb"];
+        }
+        
+        if (j.contains("trusted_keys")) {
+            config_.trustedKeys = j["trusted_keys"].get<std::vector<std::string>>();
+        }
+        
+        if (j.contains("require_signatures")) {
+            config_.requireSignatures = j["require_signatures"];
+        }
+        
+        if (j.contains("signing_key")) {
+            config_.signingKey = j["signing_key"];
+        }
+        
+        if (j.contains("stat_cache")) {
+            config_.statCache = j["stat_cache"];
+        }
+        
+        if (j.contains("cache_compression")) {
+            config_.cacheCompression = j["cache_compression"];
+        }
+        
+        if (j.contains("metrics")) {
+            config_.metrics = j["metrics"];
+        }
+        
         Logger::debug("Configuration loaded from {}", configPath_.string());
         return true;
         
@@ -118,9 +167,33 @@ bool ConfigManager::save() {
         j["registry_url"] = config_.registryUrl;
         j["allow_insecure"] = config_.allowInsecure;
         j["network_timeout"] = config_.networkTimeout;
+        j["compiler"] = config_.compiler;
+        j["compiler_flags"] = config_.compilerFlags;
+        j["build_cache_max_mb"] = config_.buildCacheMaxMb;
+        j["trusted_keys"] = config_.trustedKeys;
+        j["require_signatures"] = config_.requireSignatures;
+        j["signing_key"] = config_.signingKey;
+        j["stat_cache"] = config_.statCache;
+        j["cache_compression"] = config_.cacheCompression;
+        j["metrics"] = config_.metrics;
         
         std::string content = j.dump(2);
-        return FileSystem::writeFile(configPath_, content);
+        
+        // Concurrent amb processes may save at once: serialize writers and
+        // replace the file atomically so readers never see a partial config
+        fs::path lockPath = configPath_;
+        lockPath += ".lock";
+        auto guard = FileLock::acquire(lockPath, LockMode::EXCLUSIVE);
+        
+        fs::path staging = configPath_;
+        staging += ".tmp";
+        if (!FileSystem::writeFile(staging, content)) {
+            return false;
+        }
+        fs::rename(staging, configPath_);
+        FileSystem::invalidate(staging);
+        FileSystem::invalidate(configPath_);
+        return true;
         
     } catch (const std::exception& e) {
         Logger::error("Failed to save config: {}", e.what());
@@ -1,7 +1,10 @@
 #include "core/context.hpp"
 #include "amb/config.hpp"
+#include "core/scheduler.hpp"
+#include "core/workspace.hpp"
 #include "utils/logger.hpp"
 #include "utils/filesystem.hpp"
+#include "utils/io_engine.hpp"
 
 #include <iostream>
 
@@ -9,7 +12,18 @@ namespace amb {
 
 Context::Context() = default;
 
-Context::~Context() = default;
+Context::~Context() {
+    if (initialized_) {
+        IoEngine::instance().setExecutor(nullptr);
+        
+        auto stats = FileSystem::statCacheStats();
+        if (stats.hits + stats.misses > 0) {
+            Logger::debug("Stat cache: {} hits, {} misses, {} invalidations", stats.hits,
+                          stats.misses, stats.invalidations);
+        }
+        FileSystem::enableStatCache(false);
+    }
+}
 
 bool Context::initialize() {
     if (initialized_) {
@@ -24,12 +38,20 @@ bool Context::initialize() {
         return false;
     }
     
+    // File probes are memoized for the rest of the command
+    FileSystem::enableStatCache(ConfigManager::instance().config().statCache);
+    
     // Find project root
     findProjectRoot();
     
     // Setup directories
     setupDirectories();
     
+    // Blocking I/O fallback runs on the shared scheduler
+    IoEngine::instance().setExecutor([this](size_t count, const std::function<void(size_t)>& fn) {
+        parallelFor(scheduler(), count, fn);
+    });
+    
     initialized_ = true;
     Logger::debug("Context initialized successfully");
     
@@ -38,6 +60,9 @@ bool Context::initialize() {
     } else {
         Logger::debug("Not inside a project");
     }
+    if (isInsideWorkspace()) {
+        Logger::debug("Inside workspace: {}", workspaceRoot_->string());
+    }
     
     return true;
 }
@@ -46,19 +71,23 @@ bool Context::findProjectRoot() {
     namespace fs = std::filesystem;
     
     fs::path current = fs::current_path();
+    projectRoot_.reset();
+    workspaceRoot_.reset();
     
-    // Look for ambar.json or ambar.lock
+    // Look for ambar.json or ambar.lock, then keep going up for a workspace
     while (current != current.root_path()) {
-        if (FileSystem::isFile(current / "ambar.json") ||
-            FileSystem::isFile(current / "ambar.lock")) {
+        if (!projectRoot_ && (FileSystem::isFile(current / "ambar.json") ||
+                              FileSystem::isFile(current / "ambar.lock"))) {
             projectRoot_ = current;
-            return true;
+        }
+        if (FileSystem::isFile(current / Workspace::FILE_NAME)) {
+            workspaceRoot_ = current;
+            break;
         }
         current = current.parent_path();
     }
     
-    projectRoot_.reset();
-    return false;
+    return projectRoot_.has_value();
 }
 
 void Context::setupDirectories() {
@@ -88,4 +117,22 @@ std::filesystem::path Context::getLibDir() const {
     return ConfigManager::instance().getLibDir();
 }
 
+size_t Context::getJobs() const {
+    return jobs_ > 0 ? jobs_ : Scheduler::hardwareConcurrency();
+}
+
+Scheduler& Context::scheduler() {
+    if (!scheduler_) {
+        scheduler_ = std::make_unique<Scheduler>(getJobs());
+    }
+    return *scheduler_;
+}
+
+std::filesystem::path Context::getModulesDir() const {
+    if (!projectRoot_) {
+        return {};
+    }
+    return *projectRoot_ / "ambar_modules" / "lib";
+}
+
 } // namespace amb
\ No newline at end of file
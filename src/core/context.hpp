@@ -8,6 +8,7 @@
 namespace amb {
 
 class ConfigManager;
+class Scheduler;
 
 class Context {
 public:
@@ -21,23 +22,35 @@ public:
     // Project detection
     bool isInsideProject() const { return projectRoot_.has_value(); }
     std::optional<std::filesystem::path> getProjectRoot() const { return projectRoot_; }
+    // Nearest directory at or above the working directory holding ambar.workspace.json
+    bool isInsideWorkspace() const { return workspaceRoot_.has_value(); }
+    std::optional<std::filesystem::path> getWorkspaceRoot() const { return workspaceRoot_; }
     
     // Configuration
     std::filesystem::path getAmbRoot() const;
     std::filesystem::path getCacheDir() const;
     std::filesystem::path getLibDir() const;
+    std::filesystem::path getModulesDir() const; // <project>/ambar_modules/lib
     
     // State
     void setVerbose(bool verbose) { verbose_ = verbose; }
     bool isVerbose() const { return verbose_; }
     
+    // Parallelism: 0 jobs means one worker per hardware thread
+    void setJobs(size_t jobs) { jobs_ = jobs; }
+    size_t getJobs() const;
+    Scheduler& scheduler(); // created on first use
+    
 private:
     bool findProjectRoot();
     void setupDirectories();
     
     bool initialized_ = false;
     bool verbose_ = false;
+    size_t jobs_ = 0;
+    std::unique_ptr<Scheduler> scheduler_;
     std::optional<std::filesystem::path> projectRoot_;
+    std::optional<std::filesystem::path> workspaceRoot_;
 };
 
 } // namespace amb
\ No newline at end of file
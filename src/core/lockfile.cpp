@@ -0,0 +1,111 @@
+#include "core/lockfile.hpp"
+#include "utils/filesystem.hpp"
+#include "utils/logger.hpp"
+#include "json.hpp"
+
+using json = nlohmann::json;
+
+namespace amb {
+
+const LockEntry* Lockfile::find(const std::string& name, const std::string& version) const {
+    auto it = packages.find(name + "@" + version);
+    return it == packages.end() ? nullptr : &it->second;
+}
+
+void Lockfile::indexDependents() {
+    for (auto& [_, entry] : packages) {
+        entry.dependents.clear();
+    }
+    for (const auto& [key, entry] : packages) {
+        for (const auto& [name, version] : entry.dependencies) {
+            auto it = packages.find(name + "@" + version);
+            if (it != packages.end()) {
+                it->second.dependents.insert(key);
+            }
+        }
+    }
+}
+
+std::optional<Lockfile> Lockfile::load(const fs::path& path, const EntryCallback& onEntry) {
+    auto content = FileSystem::readFile(path);
+    if (!content) {
+        return std::nullopt;
+    }
+    auto lock = parse(*content, onEntry);
+    if (!lock) {
+        Logger::error("Invalid lockfile: {}", path.string());
+    }
+    return lock;
+}
+
+std::optional<Lockfile> Lockfile::parse(const std::string& content, const EntryCallback& onEntry) {
+    try {
+        auto j = json::parse(content);
+        Lockfile lock;
+        bool indexed = true;
+
+        if (j.contains("dependencies")) {
+            lock.dependencies = j["dependencies"].get<std::map<std::string, std::string>>();
+        }
+
+        if (j.contains("packages")) {
+            for (const auto& [key, value] : j["packages"].items()) {
+                auto at = key.rfind('@');
+                if (at == std::string::npos || at == 0) {
+                    Logger::warning("Skipping malformed lock entry '{}'", key);
+                    continue;
+                }
+
+                LockEntry entry;
+                entry.name = key.substr(0, at);
+                entry.version = key.substr(at + 1);
+                entry.sha256 = value.value("sha256", "");
+                if (value.contains("dependencies")) {
+                    entry.dependencies = value["dependencies"].get<std::map<std::string, std::string>>();
+                }
+                if (value.contains("dependents")) {
+                    entry.dependents = value["dependents"].get<std::set<std::string>>();
+                } else {
+                    indexed = false;
+                }
+                auto placed = lock.packages.emplace(key, std::move(entry));
+                if (onEntry && placed.second) {
+                    onEntry(placed.first->second);
+                }
+            }
+        }
+
+        // Written before the reverse index existed
+        if (!indexed) {
+            lock.indexDependents();
+        }
+        return lock;
+
+    } catch (const std::exception& e) {
+        Logger::debug("Failed to parse lockfile: {}", e.what());
+        return std::nullopt;
+    }
+}
+
+std::string Lockfile::serialize() const {
+    json j;
+    j["lockfile_version"] = FORMAT_VERSION;
+    j["dependencies"] = dependencies;
+
+    json pkgs = json::object();
+    for (const auto& [key, entry] : packages) {
+        json e;
+        e["sha256"] = entry.sha256;
+        e["dependencies"] = entry.dependencies;
+        e["dependents"] = entry.dependents;
+        pkgs[key] = std::move(e);
+    }
+    j["packages"] = std::move(pkgs);
+    return j.dump(2) + "\n";
+}
+
+bool Lockfile::save(const fs::path& path) const {
+    return FileSystem::writeFile(path, serialize());
+}
+
+} // namespace amb
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <optional>
+#include <set>
+#include <string>
+
+namespace amb {
+
+namespace fs = std::filesystem;
+
+// A single resolved package in ambar.lock
+struct LockEntry {
+    std::string name;
+    std::string version;
+    std::string sha256;
+    std::map<std::string, std::string> dependencies; // name -> exact version
+    std::set<std::string> dependents;                // keys of the entries that depend on this one
+
+    std::string key() const { return name + "@" + version; }
+};
+
+// ambar.lock - exact installed reality (blueprint §5)
+struct Lockfile {
+    static constexpr int FORMAT_VERSION = 1;
+
+    std::map<std::string, std::string> dependencies; // direct deps: name -> exact version
+    std::map<std::string, LockEntry> packages;       // keyed by name@version
+
+    const LockEntry* find(const std::string& name, const std::string& version) const;
+
+    // Rebuilds every entry's `dependents` from the forward edges. The reverse index is
+    // stored in the file, so only freshly resolved locks and pre-index files need this.
+    void indexDependents();
+
+    // Called for each package entry as soon as it is read, before the rest of the file;
+    // its `dependents` may not be filled in yet
+    using EntryCallback = std::function<void(const LockEntry&)>;
+
+    static std::optional<Lockfile> load(const fs::path& path, const EntryCallback& onEntry = {});
+    static std::optional<Lockfile> parse(const std::string& content, const EntryCallback& onEntry = {});
+
+    std::string serialize() const;
+    bool save(const fs::path& path) const;
+};
+
+} // namespace amb
\ No newline at end of file
@@ -0,0 +1,87 @@
+#include "core/manifest.hpp"
+#include "utils/filesystem.hpp"
+#include "utils/logger.hpp"
+#include "json.hpp"
+
+using json = nlohmann::json;
+
+namespace amb {
+
+namespace {
+
+void readMap(const json& j, const char* key, std::map<std::string, std::string>& out) {
+    if (!j.contains(key) || !j[key].is_object()) {
+        return;
+    }
+    for (const auto& [name, value] : j[key].items()) {
+        if (value.is_string()) {
+            out[name] = value.get<std::string>();
+        }
+    }
+}
+
+std::string readString(const json& j, const char* key) {
+    if (j.contains(key) && j[key].is_string()) {
+        return j[key].get<std::string>();
+    }
+    return "";
+}
+
+} // namespace
+
+std::optional<Manifest> Manifest::load(const fs::path& path) {
+    auto content = FileSystem::readFile(path);
+    if (!content) {
+        return std::nullopt;
+    }
+    auto manifest = parse(*content);
+    if (!manifest) {
+        Logger::error("Invalid manifest: {}", path.string());
+    }
+    return manifest;
+}
+
+std::optional<Manifest> Manifest::parse(const std::string& content) {
+    try {
+        auto j = json::parse(content);
+        if (!j.is_object()) {
+            return std::nullopt;
+        }
+
+        Manifest m;
+        m.name = readString(j, "name");
+        m.version = readString(j, "version");
+        m.author = readString(j, "author");
+        m.description = readString(j, "description");
+        m.license = readString(j, "license");
+        readMap(j, "dependencies", m.dependencies);
+        readMap(j, "optional_dependencies", m.optionalDependencies);
+        readMap(j, "dev_dependencies", m.devDependencies);
+        readMap(j, "scripts", m.scripts);
+        return m;
+
+    } catch (const std::exception& e) {
+        Logger::debug("Failed to parse manifest: {}", e.what());
+        return std::nullopt;
+    }
+}
+
+std::string Manifest::serialize() const {
+    json j = json::object();
+    j["name"] = name;
+    j["version"] = version;
+    if (!author.empty()) j["author"] = author;
+    if (!description.empty()) j["description"] = description;
+    if (!license.empty()) j["license"] = license;
+    if (!dependencies.empty()) j["dependencies"] = dependencies;
+    if (!optionalDependencies.empty()) j["optional_dependencies"] = optionalDependencies;
+    if (!devDependencies.empty()) j["dev_dependencies"] = devDependencies;
+    if (!scripts.empty()) j["scripts"] = scripts;
+    return j.dump(2) + "\n";
+}
+
+bool Manifest::save(const fs::path& path) const {
+    return FileSystem::writeFile(path, serialize());
+}
+
+} // namespace amb
\ No newline at end of file
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <string>
+
+namespace amb {
+
+namespace fs = std::filesystem;
+
+// ambar.json - package/project intent (blueprint §4)
+struct Manifest {
+    std::string name;
+    std::string version;
+    std::string author;
+    std::string description;
+    std::string license;
+    std::map<std::string, std::string> dependencies;          // name -> version range
+    std::map<std::string, std::string> optionalDependencies;
+    std::map<std::string, std::string> devDependencies;
+    std::map<std::string, std::string> scripts;               // build, pre_install, post_install
+
+    static std::optional<Manifest> load(const fs::path& path);
+    static std::optional<Manifest> parse(const std::string& content);
+
+    std::string serialize() const;
+    bool save(const fs::path& path) const;
+};
+
+} // namespace amb
\ No newline at end of file
@@ -0,0 +1,452 @@
+#include "core/output.hpp"
+#include "utils/filesystem.hpp"
+#include "json.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <variant>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+// Keeps "event" first on each line, for people reading the stream
+using json = nlohmann::ordered_json;
+
+namespace amb {
+
+struct Output::Progress::State {
+    ProgressState info;  // id, task, label and unit; the counters live below
+    std::atomic<uint64_t> done{0};
+    std::atomic<uint64_t> total{0};
+    std::atomic<bool> finished{false};
+};
+
+namespace {
+
+constexpr auto TICK = std::chrono::milliseconds(100);
+constexpr size_t BATCH_BYTES = 64 * 1024;  // buffered output past this is written early
+constexpr size_t BAR_WIDTH = 24;
+
+bool isTerminal(FILE* stream) {
+#ifdef _WIN32
+    return _isatty(_fileno(stream)) != 0;
+#else
+    return isatty(fileno(stream)) != 0;
+#endif
+}
+
+void write(FILE* stream, const std::string& data) {
+    if (!data.empty()) {
+        std::fwrite(data.data(), 1, data.size(), stream);
+    }
+    std::fflush(stream);
+}
+
+std::string amount(uint64_t value, const std::string& unit) {
+    return unit == "bytes" ? FileSystem::formatSize(value) : std::to_string(value);
+}
+
+// Text on stdout, diagnostics on stderr. On a terminal, running tasks are bars at the
+// bottom of stderr, erased before anything else is written and redrawn on the next tick.
+class TextSink : public EventSink {
+public:
+    TextSink() : stdoutTerminal_(isTerminal(stdout)) {
+        const char* term = std::getenv("TERM");
+        bars_ = isTerminal(stderr) && !(term && std::string(term) == "dumb");
+    }
+
+    void event(const Event& event) override {
+        if (event.text.empty()) {
+            return;
+        }
+        if (event.type == "error") {
+            diagnostic(event.text);
+            return;
+        }
+        out_ += event.text;
+        out_ += '\n';
+        if (out_.size() >= BATCH_BYTES) {
+            writeOut();
+        }
+    }
+
+    void log(LogLevel level, const std::string& message) override {
+        diagnostic(Logger::formatLine(level, message));
+    }
+
+    void progress(const std::vector<ProgressState>& tasks) override {
+        if (!bars_) {
+            return;
+        }
+        lines_.clear();
+        for (const auto& task : tasks) {
+            if (!task.finished) {
+                lines_.push_back(render(task));
+            }
+        }
+    }
+
+    void flush() override {
+        if (out_.empty() && lines_ == drawn_) {
+            return;
+        }
+        writeOut();
+        clearBars();
+        std::string text;
+        for (const auto& line : lines_) {
+            text += line + "\n";
+        }
+        if (!text.empty()) {
+            write(stderr, text);
+        }
+        drawn_ = lines_;
+    }
+
+private:
+    static std::string render(const ProgressState& task) {
+        std::string line = "  " + task.label + std::string(task.label.size() < 12 ? 12 - task.label.size() : 1, ' ');
+        if (task.total == 0) {
+            return line + amount(task.done, task.unit);
+        }
+        uint64_t done = std::min(task.done, task.total);
+        auto filled = static_cast<size_t>(done * BAR_WIDTH / task.total);
+        line += "[" + std::string(filled, '#') + std::string(BAR_WIDTH - filled, '.') + "] ";
+        return line + amount(done, task.unit) + "/" + amount(task.total, task.unit);
+    }
+
+    // stderr, after the stdout lines emitted before it
+    void diagnostic(const std::string& text) {
+        writeOut();
+        clearBars();
+        write(stderr, text + "\n");
+    }
+
+    void writeOut() {
+        if (out_.empty()) {
+            return;
+        }
+        if (stdoutTerminal_) {
+            clearBars();
+        }
+        write(stdout, out_);
+        out_.clear();
+    }
+
+    void clearBars() {
+        if (drawn_.empty()) {
+            return;
+        }
+        std::string erase;
+        for (size_t i = 0; i < drawn_.size(); ++i) {
+            erase += "\x1b[1A\x1b[2K";
+        }
+        write(stderr, erase);
+        drawn_.clear();
+    }
+
+    bool stdoutTerminal_;
+    bool bars_ = false;
+    std::string out_;
+    std::vector<std::string> lines_;  // bars as of the last tick
+    std::vector<std::string> drawn_;  // bars on screen now
+};
+
+// One JSON object per line on stdout: {"event": type, "time": ms, "message": text, fields...}
+class NdjsonSink : public EventSink {
+public:
+    void event(const Event& event) override {
+        json line = record(event.type);
+        if (!event.text.empty()) {
+            line["message"] = event.text;
+        }
+        for (const auto& [key, value] : event.fields) {
+            std::visit([&](const auto& v) { line[key] = v; }, value);
+        }
+        append(line);
+    }
+
+    void log(LogLevel level, const std::string& message) override {
+        json line = record("log");
+        line["level"] = Logger::levelToString(level);
+        line["message"] = message;
+        append(line);
+    }
+
+    // Start and end of every task, and its counters once per tick while they move
+    void progress(const std::vector<ProgressState>& tasks) override {
+        for (const auto& task : tasks) {
+            auto [it, started] = reported_.try_emplace(task.id, task.done);
+            if (started) {
+                json line = progressRecord("progress.start", task);
+                line["label"] = task.label;
+                append(line);
+            }
+            if (task.finished) {
+                append(progressRecord("progress.done", task));
+                reported_.erase(it);
+            } else if (it->second != task.done) {
+                append(progressRecord("progress", task));
+                it->second = task.done;
+            }
+        }
+    }
+
+    void flush() override {
+        if (!out_.empty()) {
+            write(stdout, out_);
+            out_.clear();
+        }
+    }
+
+private:
+    static json record(const std::string& type) {
+        json line;
+        line["event"] = type;
+        line["time"] = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        return line;
+    }
+
+    static json progressRecord(const std::string& type, const ProgressState& task) {
+        json line = record(type);
+        line["id"] = task.id;
+        line["task"] = task.task;
+        line["done"] = task.done;
+        line["total"] = task.total;
+        if (!task.unit.empty()) {
+            line["unit"] = task.unit;
+        }
+        return line;
+    }
+
+    void append(const json& line) {
+        // Paths need not be UTF-8; a bad byte must not cost the line
+        out_ += line.dump(-1, ' ', false, json::error_handler_t::replace);
+        out_ += '\n';
+        if (out_.size() >= BATCH_BYTES) {
+            flush();
+        }
+    }
+
+    std::string out_;
+    std::map<uint64_t, uint64_t> reported_;  // task id -> last reported count
+};
+
+std::unique_ptr<EventSink> makeSink(OutputFormat format) {
+    if (format == OutputFormat::NDJSON) {
+        return std::make_unique<NdjsonSink>();
+    }
+    return std::make_unique<TextSink>();
+}
+
+// The sink, the running tasks and the ticker that flushes them. The ticker starts with
+// the first event and is joined at exit, after a last flush.
+struct Stream {
+    std::mutex mutex;
+    std::condition_variable wake;
+    OutputFormat format = OutputFormat::TEXT;
+    std::unique_ptr<EventSink> sink = makeSink(format);
+    std::vector<std::shared_ptr<Output::Progress::State>> tasks;
+    uint64_t nextId = 1;
+    std::thread ticker;
+    bool stopping = false;
+
+    Stream() {
+        Logger::setSink([this](LogLevel level, const std::string& message) {
+            std::lock_guard lock(mutex);
+            sink->log(level, message);
+        });
+    }
+
+    ~Stream() {
+        Logger::setSink(nullptr);
+        {
+            std::lock_guard lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        if (ticker.joinable()) {
+            ticker.join();
+        }
+        std::lock_guard lock(mutex);
+        publish();
+        sink->flush();
+    }
+
+    // The caller holds `mutex`
+    void start() {
+        if (!ticker.joinable()) {
+            ticker = std::thread([this] { run(); });
+        }
+    }
+
+    void run() {
+        std::unique_lock lock(mutex);
+        while (!stopping) {
+            wake.wait_for(lock, TICK);
+            if (!stopping) {
+                publish();
+                sink->flush();
+            }
+        }
+    }
+
+    // Hands the sink a snapshot of the tasks; finished ones are reported once and dropped
+    void publish() {
+        if (tasks.empty()) {
+            return;
+        }
+        std::vector<ProgressState> states;
+        for (const auto& task : tasks) {
+            ProgressState state = task->info;
+            state.finished = task->finished.load();
+            state.done = task->done.load(std::memory_order_relaxed);
+            state.total = task->total.load(std::memory_order_relaxed);
+            states.push_back(std::move(state));
+        }
+        size_t kept = 0;
+        for (size_t i = 0; i < tasks.size(); ++i) {
+            if (!states[i].finished) {
+                tasks[kept++] = std::move(tasks[i]);
+            }
+        }
+        tasks.resize(kept);
+        sink->progress(states);
+    }
+};
+
+Stream& stream() {
+    static Stream instance;
+    return instance;
+}
+
+} // namespace
+
+Event& Event::with(std::string key, std::string value) {
+    fields.emplace_back(std::move(key), std::move(value));
+    return *this;
+}
+
+Event& Event::with(std::string key, const char* value) {
+    return with(std::move(key), std::string(value));
+}
+
+Event& Event::with(std::string key, bool value) {
+    fields.emplace_back(std::move(key), value);
+    return *this;
+}
+
+Event& Event::with(std::string key, double value) {
+    fields.emplace_back(std::move(key), value);
+    return *this;
+}
+
+Event& Event::with(std::string key, std::vector<std::string> value) {
+    fields.emplace_back(std::move(key), std::move(value));
+    return *this;
+}
+
+void Output::setFormat(OutputFormat format) {
+    auto& s = stream();
+    std::lock_guard lock(s.mutex);
+    s.sink->flush();
+    s.sink = makeSink(format);
+    s.format = format;
+}
+
+OutputFormat Output::format() {
+    auto& s = stream();
+    std::lock_guard lock(s.mutex);
+    return s.format;
+}
+
+void Output::setSink(std::unique_ptr<EventSink> sink) {
+    auto& s = stream();
+    std::lock_guard lock(s.mutex);
+    s.sink->flush();
+    s.sink = std::move(sink);
+}
+
+void Output::emit(const Event& event) {
+    auto& s = stream();
+    std::lock_guard lock(s.mutex);
+    // Tasks that moved or ended before the event are reported first, keeping the stream in order
+    s.publish();
+    s.sink->event(event);
+    s.start();
+}
+
+void Output::emit(std::string type, std::string text) {
+    emit(Event(std::move(type), std::move(text)));
+}
+
+void Output::flush() {
+    auto& s = stream();
+    std::lock_guard lock(s.mutex);
+    s.publish();
+    s.sink->flush();
+}
+
+Output::Progress Output::progress(std::string task, std::string label, uint64_t total, std::string unit) {
+    auto state = std::make_shared<Progress::State>();
+    state->info.task = std::move(task);
+    state->info.label = std::move(label);
+    state->info.unit = std::move(unit);
+    state->total = total;
+
+    auto& s = stream();
+    std::lock_guard lock(s.mutex);
+    state->info.id = s.nextId++;
+    s.tasks.push_back(state);
+    s.start();
+    return Progress(std::move(state));
+}
+
+Output::Progress& Output::Progress::operator=(Progress&& other) noexcept {
+    if (this != &other) {
+        finish();
+        state_ = std::move(other.state_);
+    }
+    return *this;
+}
+
+Output::Progress::~Progress() {
+    finish();
+}
+
+void Output::Progress::advance(uint64_t amount) {
+    if (state_) {
+        state_->done.fetch_add(amount, std::memory_order_relaxed);
+    }
+}
+
+void Output::Progress::set(uint64_t done) {
+    if (state_) {
+        state_->done.store(done, std::memory_order_relaxed);
+    }
+}
+
+void Output::Progress::setTotal(uint64_t total) {
+    if (state_) {
+        state_->total.store(total, std::memory_order_relaxed);
+    }
+}
+
+void Output::Progress::finish() {
+    if (state_) {
+        state_->finished.store(true);
+        state_.reset();
+    }
+}
+
+} // namespace amb
\ No newline at end of file
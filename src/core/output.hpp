@@ -0,0 +1,118 @@
+#pragma once
+
+#include "utils/logger.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace amb {
+
+enum class OutputFormat {
+    TEXT,    // lines for people, with progress bars when stderr is a terminal
+    NDJSON   // one JSON object per line on stdout, for tools
+};
+
+// Something a command reports. `type` names it for tools ("install.done"), `text` is what
+// a person reads (empty for nothing, or several lines) and `fields` carry the data.
+// An "error" event's text goes to stderr.
+struct Event {
+    using Value = std::variant<std::string, int64_t, uint64_t, double, bool, std::vector<std::string>>;
+
+    std::string type;
+    std::string text;
+    std::vector<std::pair<std::string, Value>> fields;
+
+    explicit Event(std::string eventType, std::string eventText = "")
+        : type(std::move(eventType)), text(std::move(eventText)) {}
+
+    Event& with(std::string key, std::string value);
+    Event& with(std::string key, const char* value);
+    Event& with(std::string key, bool value);
+    Event& with(std::string key, double value);
+    Event& with(std::string key, std::vector<std::string> value);
+
+    template<typename T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>, int> = 0>
+    Event& with(std::string key, T value) {
+        if constexpr (std::is_signed_v<T>) {
+            fields.emplace_back(std::move(key), static_cast<int64_t>(value));
+        } else {
+            fields.emplace_back(std::move(key), static_cast<uint64_t>(value));
+        }
+        return *this;
+    }
+};
+
+// A task with a known amount of work, as the sinks see it on each tick
+struct ProgressState {
+    uint64_t id = 0;
+    std::string task;    // "fetch", "extract"
+    std::string label;   // what a person sees next to the bar
+    std::string unit;    // "bytes", or empty for a count of items
+    uint64_t done = 0;
+    uint64_t total = 0;  // 0 when unknown
+    bool finished = false;
+};
+
+// Renders events. Calls are serialized by Output; nothing needs to reach the terminal
+// before flush(), which runs on a short timer, so parallel work is written in batches.
+class EventSink {
+public:
+    virtual ~EventSink() = default;
+
+    virtual void event(const Event& event) = 0;
+    // A Logger message that passed the level filter
+    virtual void log(LogLevel level, const std::string& message) = 0;
+    // Every task still running, plus those finished since the last call
+    virtual void progress(const std::vector<ProgressState>& tasks) = 0;
+    virtual void flush() = 0;
+};
+
+// The command output stream: commands emit events instead of writing to std::cout, and
+// the sink for the chosen --output format renders them. Logger messages are routed
+// through it too, so they neither tear a progress bar nor break an NDJSON stream.
+class Output {
+public:
+    class Progress;
+
+    static void setFormat(OutputFormat format);
+    static OutputFormat format();
+    // Replaces the sink, flushing the previous one
+    static void setSink(std::unique_ptr<EventSink> sink);
+
+    static void emit(const Event& event);
+    // Shorthand for an event that is only text
+    static void emit(std::string type, std::string text);
+    static void flush();
+
+    // Starts a task; the handle may be advanced from any thread and finishes it when destroyed
+    static Progress progress(std::string task, std::string label, uint64_t total, std::string unit = "");
+};
+
+class Output::Progress {
+public:
+    Progress() = default;
+    Progress(Progress&&) noexcept = default;
+    Progress& operator=(Progress&& other) noexcept;
+    ~Progress();
+
+    // Lock-free: only the ticker reads the counters
+    void advance(uint64_t amount = 1);
+    void set(uint64_t done);
+    void setTotal(uint64_t total);
+    void finish();
+
+    struct State;
+
+private:
+    friend class Output;
+    explicit Progress(std::shared_ptr<State> state) : state_(std::move(state)) {}
+
+    std::shared_ptr<State> state_;
+};
+
+} // namespace amb
\ No newline at end of file
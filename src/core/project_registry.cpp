@@ -0,0 +1,91 @@
+#include "core/project_registry.hpp"
+#include "core/workspace.hpp"
+#include "utils/file_lock.hpp"
+#include "utils/filesystem.hpp"
+#include "utils/logger.hpp"
+#include "json.hpp"
+
+#include <algorithm>
+
+using json = nlohmann::json;
+
+namespace amb {
+
+ProjectRegistry::ProjectRegistry(fs::path ambRoot) : path_(std::move(ambRoot) / FILE_NAME) {}
+
+std::vector<fs::path> ProjectRegistry::list() const {
+    std::vector<fs::path> roots;
+    auto content = FileSystem::readFile(path_);
+    if (!content) {
+        return roots;
+    }
+    auto j = json::parse(*content, nullptr, false);
+    if (j.is_discarded() || !j.contains("projects") || !j["projects"].is_array()) {
+        Logger::warning("Ignoring malformed {}", path_.string());
+        return roots;
+    }
+    for (const auto& root : j["projects"]) {
+        if (root.is_string()) {
+            roots.emplace_back(root.get<std::string>());
+        }
+    }
+    return roots;
+}
+
+bool ProjectRegistry::add(const fs::path& root) const {
+    fs::path normalized = fs::absolute(root).lexically_normal();
+    // Installs run far more often than new projects appear: check before locking
+    auto known = list();
+    if (std::find(known.begin(), known.end(), normalized) != known.end()) {
+        return true;
+    }
+
+    auto guard = FileLock::acquire(FileLock::siblingLockPath(path_), LockMode::EXCLUSIVE);
+    known = list();
+    if (std::find(known.begin(), known.end(), normalized) != known.end()) {
+        return true;
+    }
+    known.push_back(normalized);
+    return save(known);
+}
+
+std::vector<fs::path> ProjectRegistry::prune() const {
+    auto guard = FileLock::acquire(FileLock::siblingLockPath(path_), LockMode::EXCLUSIVE);
+    auto roots = list();
+    auto stale = std::remove_if(roots.begin(), roots.end(), [](const fs::path& root) {
+        return !FileSystem::isFile(root / "ambar.json") && !FileSystem::isFile(root / Workspace::FILE_NAME);
+    });
+    if (stale != roots.end()) {
+        Logger::debug("Forgetting {} project(s) that no longer exist", std::distance(stale, roots.end()));
+        roots.erase(stale, roots.end());
+        save(roots);
+    }
+    return roots;
+}
+
+bool ProjectRegistry::save(const std::vector<fs::path>& roots) const {
+    json list = json::array();
+    for (const auto& root : roots) {
+        list.push_back(root.string());
+    }
+    json j;
+    j["projects"] = std::move(list);
+
+    // Replaced atomically so a concurrent reader never sees half a file
+    fs::path staging = path_;
+    staging += ".tmp";
+    if (!FileSystem::writeFile(staging, j.dump(2))) {
+        return false;
+    }
+    std::error_code ec;
+    fs::rename(staging, path_, ec);
+    FileSystem::invalidate(staging);
+    FileSystem::invalidate(path_);
+    if (ec) {
+        Logger::warning("Failed to update {}: {}", path_.string(), ec.message());
+        return false;
+    }
+    return true;
+}
+
+} // namespace amb
\ No newline at end of file
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <filesystem>
+#include <vector>
+
+namespace amb {
+
+namespace fs = std::filesystem;
+
+// Every project (or workspace) root amb has installed into on this machine, in
+// ~/.ambar/projects.json.
+// `amb gc` walks their lockfiles to decide which package versions are still referenced.
+class ProjectRegistry {
+public:
+    static constexpr const char* FILE_NAME = "projects.json";
+
+    explicit ProjectRegistry(fs::path ambRoot);
+
+    std::vector<fs::path> list() const;
+    // Idempotent; only rewrites the file when `root` is new
+    bool add(const fs::path& root) const;
+    // Drops roots that no longer hold an ambar.json or ambar.workspace.json and returns
+    // what is left
+    std::vector<fs::path> prune() const;
+
+private:
+    bool save(const std::vector<fs::path>& roots) const;
+
+    fs::path path_;
+};
+
+} // namespace amb
\ No newline at end of file
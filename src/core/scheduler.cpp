@@ -0,0 +1,265 @@
+#include "core/scheduler.hpp"
+#include "utils/logger.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+namespace amb {
+
+namespace {
+
+// Identifies the pool and slot of the current worker thread
+thread_local Scheduler* currentScheduler = nullptr;
+thread_local size_t currentWorker = 0;
+
+size_t laneOf(TaskPriority priority) {
+    return static_cast<size_t>(priority);
+}
+
+} // namespace
+
+Scheduler::Scheduler(size_t workers) {
+    size_t count = workers > 0 ? workers : hardwareConcurrency();
+
+    workers_.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        workers_.push_back(std::make_unique<Worker>());
+    }
+    for (size_t i = 0; i < count; ++i) {
+        workers_[i]->thread = std::thread([this, i] { workerLoop(i); });
+    }
+    Logger::debug("Scheduler started with {} worker(s)", count);
+}
+
+Scheduler::~Scheduler() {
+    // Workers drain everything still queued before exiting
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto& worker : workers_) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+}
+
+size_t Scheduler::hardwareConcurrency() {
+    return std::max<size_t>(1, std::thread::hardware_concurrency());
+}
+
+void Scheduler::submit(Task task, TaskPriority priority) {
+    size_t lane = laneOf(priority);
+
+    if (currentScheduler == this) {
+        auto& worker = *workers_[currentWorker];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.lanes[lane].push_back(std::move(task));
+        laneQueued_[lane]++;
+    } else {
+        std::lock_guard<std::mutex> lock(injectMutex_);
+        injected_[lane].push_back(std::move(task));
+        laneQueued_[lane]++;
+    }
+    queued_++;
+
+    // Pairs with the sleepers_ increment in workerLoop: either the submitter sees a
+    // sleeper and notifies, or the sleeper sees the queued task and stays awake
+    if (sleepers_ > 0) {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        wake_.notify_one();
+    }
+}
+
+bool Scheduler::take(size_t self, Task& task) {
+    auto claim = [&](std::deque<Task>& queue, bool back, size_t lane) {
+        if (queue.empty()) {
+            return false;
+        }
+        if (back) {
+            task = std::move(queue.back());
+            queue.pop_back();
+        } else {
+            task = std::move(queue.front());
+            queue.pop_front();
+        }
+        laneQueued_[lane]--;
+        queued_--;
+        return true;
+    };
+
+    for (size_t lane = 0; lane < LANES; ++lane) {
+        if (laneQueued_[lane] == 0) {
+            continue;
+        }
+
+        if (self != NO_WORKER) {
+            auto& own = *workers_[self];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (claim(own.lanes[lane], true, lane)) {
+                return true;
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(injectMutex_);
+            if (claim(injected_[lane], false, lane)) {
+                return true;
+            }
+        }
+
+        size_t start = self == NO_WORKER ? 0 : self + 1;
+        for (size_t n = 0; n < workers_.size(); ++n) {
+            size_t victim = (start + n) % workers_.size();
+            if (victim == self) {
+                continue;
+            }
+            auto& other = *workers_[victim];
+            std::lock_guard<std::mutex> lock(other.mutex);
+            if (claim(other.lanes[lane], false, lane)) {
+                stolen_++;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void Scheduler::execute(Task& task) {
+    try {
+        task();
+    } catch (const std::exception& e) {
+        Logger::error("Unhandled exception in scheduled task: {}", e.what());
+    } catch (...) {
+        Logger::error("Unhandled exception in scheduled task");
+    }
+    executed_++;
+}
+
+void Scheduler::workerLoop(size_t index) {
+    currentScheduler = this;
+    currentWorker = index;
+
+    Task task;
+    while (true) {
+        if (take(index, task)) {
+            execute(task);
+            task = nullptr;
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        sleepers_++;
+        wake_.wait(lock, [this] { return stopping_ || queued_ > 0; });
+        sleepers_--;
+        if (stopping_ && queued_ == 0) {
+            break;
+        }
+    }
+
+    currentScheduler = nullptr;
+}
+
+bool Scheduler::runOne() {
+    Task task;
+    if (!take(currentScheduler == this ? currentWorker : NO_WORKER, task)) {
+        return false;
+    }
+    execute(task);
+    return true;
+}
+
+Scheduler::Stats Scheduler::stats() const {
+    return Stats{executed_, stolen_};
+}
+
+TaskGroup::TaskGroup(Scheduler& scheduler, TaskPriority priority)
+    : scheduler_(scheduler), priority_(priority) {}
+
+TaskGroup::~TaskGroup() {
+    try {
+        wait();
+    } catch (...) {
+        // Errors are only reported through an explicit wait()
+    }
+}
+
+void TaskGroup::run(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_++;
+    }
+
+    scheduler_.submit([this, task = std::move(task)] {
+        if (!cancelled_) {
+            try {
+                task();
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!error_) {
+                    error_ = std::current_exception();
+                }
+                cancelled_ = true;
+            }
+        }
+        finish();
+    }, priority_);
+}
+
+void TaskGroup::finish() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (--pending_ == 0) {
+        done_.notify_all();
+    }
+}
+
+void TaskGroup::wait() {
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (pending_ == 0) {
+                break;
+            }
+        }
+        // Help out rather than block a worker; nested waits would otherwise starve the pool
+        if (scheduler_.runOne()) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait_for(lock, std::chrono::milliseconds(1), [this] { return pending_ == 0; });
+    }
+
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::swap(error, error_);
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void parallelFor(Scheduler& scheduler, size_t count, const std::function<void(size_t)>& fn,
+                 TaskPriority priority) {
+    if (count == 0) {
+        return;
+    }
+
+    // A few chunks per worker keeps stealing effective without per-index overhead
+    size_t chunks = std::min(count, scheduler.workerCount() * 4);
+    size_t chunkSize = (count + chunks - 1) / chunks;
+
+    TaskGroup group(scheduler, priority);
+    for (size_t begin = 0; begin < count; begin += chunkSize) {
+        size_t end = std::min(count, begin + chunkSize);
+        group.run([&fn, &group, begin, end] {
+            for (size_t i = begin; i < end && !group.isCancelled(); ++i) {
+                fn(i);
+            }
+        });
+    }
+    group.wait();
+}
+
+} // namespace amb
\ No newline at end of file
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace amb {
+
+// Scheduling lanes, highest first. A worker only picks a lower lane when no
+// higher-lane task is queued anywhere in the pool.
+enum class TaskPriority {
+    HIGH,        // resolution and other work the user is waiting on
+    NORMAL,
+    BACKGROUND   // cache eviction, prefetch, housekeeping
+};
+
+// Work-stealing thread pool shared by every subsystem (owned by Context).
+// Each worker keeps one deque per lane: it pushes/pops its own tasks LIFO and
+// steals FIFO from its peers. Tasks submitted from outside the pool go through
+// a shared injection queue.
+class Scheduler {
+public:
+    using Task = std::function<void()>;
+
+    struct Stats {
+        uint64_t executed = 0;
+        uint64_t stolen = 0;
+    };
+
+    // `workers` == 0 sizes the pool from the hardware concurrency
+    explicit Scheduler(size_t workers = 0);
+    ~Scheduler();
+
+    Scheduler(const Scheduler&) = delete;
+    Scheduler& operator=(const Scheduler&) = delete;
+
+    size_t workerCount() const { return workers_.size(); }
+
+    void submit(Task task, TaskPriority priority = TaskPriority::NORMAL);
+
+    // Runs one queued task on the calling thread; false when nothing was runnable.
+    // Lets blocked callers help instead of idling (see TaskGroup::wait).
+    bool runOne();
+
+    Stats stats() const;
+
+    static size_t hardwareConcurrency();
+
+private:
+    static constexpr size_t LANES = 3;
+    static constexpr size_t NO_WORKER = static_cast<size_t>(-1);
+
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> lanes[LANES];
+        std::thread thread;
+    };
+
+    void workerLoop(size_t index);
+    bool take(size_t self, Task& task);
+    void execute(Task& task);
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+
+    std::mutex injectMutex_;
+    std::deque<Task> injected_[LANES];
+
+    std::atomic<size_t> laneQueued_[LANES] = {};
+    std::atomic<size_t> queued_{0};
+
+    std::mutex sleepMutex_;
+    std::condition_variable wake_;
+    std::atomic<size_t> sleepers_{0};
+    std::atomic<bool> stopping_{false};
+
+    std::atomic<uint64_t> executed_{0};
+    std::atomic<uint64_t> stolen_{0};
+};
+
+// A set of related tasks that can be waited on and cancelled together.
+// Cancellation skips tasks that have not started; running tasks may poll isCancelled().
+// The first exception thrown by a task cancels the group and is rethrown by wait().
+class TaskGroup {
+public:
+    explicit TaskGroup(Scheduler& scheduler, TaskPriority priority = TaskPriority::NORMAL);
+    ~TaskGroup();
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    void run(std::function<void()> task);
+
+    // Blocks until every task has finished, running queued work in the meantime
+    void wait();
+
+    void cancel() { cancelled_ = true; }
+    bool isCancelled() const { return cancelled_; }
+
+private:
+    void finish();
+
+    Scheduler& scheduler_;
+    TaskPriority priority_;
+
+    std::mutex mutex_;
+    std::condition_variable done_;
+    size_t pending_ = 0;
+    std::exception_ptr error_;
+    std::atomic<bool> cancelled_{false};
+};
+
+// Runs fn(0..count-1) across the pool and waits; indices are batched into chunks
+void parallelFor(Scheduler& scheduler, size_t count, const std::function<void(size_t)>& fn,
+                 TaskPriority priority = TaskPriority::NORMAL);
+
+} // namespace amb
\ No newline at end of file
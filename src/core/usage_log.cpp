@@ -0,0 +1,129 @@
+#include "core/usage_log.hpp"
+#include "utils/file_lock.hpp"
+#include "utils/filesystem.hpp"
+#include "utils/logger.hpp"
+#include "json.hpp"
+
+#include <fstream>
+#include <sstream>
+
+using json = nlohmann::json;
+
+namespace amb {
+
+namespace {
+
+json toJson(const UsageRecord& r) {
+    return {
+        {"command", r.command},
+        {"version", r.version},
+        {"time", r.timestamp},
+        {"exit", r.exitCode},
+        {"wall_s", r.wallSeconds},
+        {"cpu_s", r.cpuSeconds},
+        {"peak_rss", r.peakRssBytes},
+        {"read", r.bytesRead},
+        {"written", r.bytesWritten},
+        {"stat_calls", r.statCalls},
+        {"stat_hits", r.statHits},
+        {"net_in", r.networkReceived},
+        {"net_out", r.networkSent},
+        {"downloads", r.archiveDownloads},
+        {"archive_hits", r.archiveCacheHits},
+        {"build_hits", r.buildCacheHits},
+        {"build_misses", r.buildCacheMisses},
+    };
+}
+
+UsageRecord fromJson(const json& j) {
+    UsageRecord r;
+    r.command = j.at("command").get<std::string>();
+    r.version = j.value("version", "");
+    r.timestamp = j.value("time", int64_t{0});
+    r.exitCode = j.value("exit", 0);
+    r.wallSeconds = j.value("wall_s", 0.0);
+    r.cpuSeconds = j.value("cpu_s", 0.0);
+    r.peakRssBytes = j.value("peak_rss", uint64_t{0});
+    r.bytesRead = j.value("read", uint64_t{0});
+    r.bytesWritten = j.value("written", uint64_t{0});
+    r.statCalls = j.value("stat_calls", uint64_t{0});
+    r.statHits = j.value("stat_hits", uint64_t{0});
+    r.networkReceived = j.value("net_in", uint64_t{0});
+    r.networkSent = j.value("net_out", uint64_t{0});
+    r.archiveDownloads = j.value("downloads", uint64_t{0});
+    r.archiveCacheHits = j.value("archive_hits", uint64_t{0});
+    r.buildCacheHits = j.value("build_hits", uint64_t{0});
+    r.buildCacheMisses = j.value("build_misses", uint64_t{0});
+    return r;
+}
+
+std::vector<std::string> readLines(const fs::path& path) {
+    std::vector<std::string> lines;
+    std::ifstream in(path);
+    for (std::string line; std::getline(in, line);) {
+        if (!line.empty()) {
+            lines.push_back(std::move(line));
+        }
+    }
+    return lines;
+}
+
+} // namespace
+
+bool UsageLog::append(const fs::path& ambRoot, const UsageRecord& record) {
+    fs::path path = ambRoot / FILE_NAME;
+    auto guard = FileLock::acquire(FileLock::siblingLockPath(path), LockMode::EXCLUSIVE);
+
+    {
+        std::ofstream out(path, std::ios::app);
+        out << toJson(record).dump() << '\n';
+        if (!out.good()) {
+            return false;
+        }
+    }
+    FileSystem::invalidate(path);
+
+    std::error_code ec;
+    if (fs::file_size(path, ec) < COMPACT_BYTES || ec) {
+        return true;
+    }
+
+    // Keep the newest runs; a rewrite every few thousand commands
+    auto lines = readLines(path);
+    size_t first = lines.size() > MAX_RECORDS ? lines.size() - MAX_RECORDS : 0;
+    std::ostringstream kept;
+    for (size_t i = first; i < lines.size(); ++i) {
+        kept << lines[i] << '\n';
+    }
+    fs::path staging = path;
+    staging += ".tmp";
+    if (!FileSystem::writeFile(staging, kept.str())) {
+        return false;
+    }
+    fs::rename(staging, path, ec);
+    FileSystem::invalidate(staging);
+    FileSystem::invalidate(path);
+    Logger::debug("Compacted {} to {} runs", path.string(), lines.size() - first);
+    return !ec;
+}
+
+std::vector<UsageRecord> UsageLog::load(const fs::path& ambRoot) {
+    fs::path path = ambRoot / FILE_NAME;
+    auto guard = FileLock::acquire(FileLock::siblingLockPath(path), LockMode::SHARED);
+
+    std::vector<UsageRecord> records;
+    for (const auto& line : readLines(path)) {
+        auto j = json::parse(line, nullptr, false);
+        if (j.is_discarded() || !j.is_object() || !j.contains("command")) {
+            continue;
+        }
+        try {
+            records.push_back(fromJson(j));
+        } catch (const std::exception&) {
+            continue;
+        }
+    }
+    return records;
+}
+
+} // namespace amb
\ No newline at end of file
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace amb {
+
+namespace fs = std::filesystem;
+
+// What one command run cost
+struct UsageRecord {
+    std::string command;
+    std::string version;          // amb version that ran it
+    int64_t timestamp = 0;        // seconds since the epoch
+    int exitCode = 0;
+    double wallSeconds = 0;
+    double cpuSeconds = 0;
+    uint64_t peakRssBytes = 0;
+    uint64_t bytesRead = 0;
+    uint64_t bytesWritten = 0;
+    uint64_t statCalls = 0;       // file probes that reached the OS
+    uint64_t statHits = 0;        // file probes answered by the stat cache
+    uint64_t networkReceived = 0;
+    uint64_t networkSent = 0;
+    uint64_t archiveDownloads = 0;
+    uint64_t archiveCacheHits = 0;
+    uint64_t buildCacheHits = 0;
+    uint64_t buildCacheMisses = 0;
+};
+
+// Rolling metrics in ~/.ambar/metrics.jsonl, one JSON object per run. Appending is one
+// short write under the file's lock; once the file outgrows COMPACT_BYTES it is rewritten
+// with the newest MAX_RECORDS runs.
+struct UsageLog {
+    static constexpr const char* FILE_NAME = "metrics.jsonl";
+    static constexpr size_t MAX_RECORDS = 2000;
+    static constexpr uint64_t COMPACT_BYTES = 2 * 1024 * 1024;
+
+    static bool append(const fs::path& ambRoot, const UsageRecord& record);
+    // Oldest first; malformed lines are skipped
+    static std::vector<UsageRecord> load(const fs::path& ambRoot);
+};
+
+} // namespace amb
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "amb/version.hpp"
+#include <algorithm>
 #include <regex>
 #include <sstream>
 
@@ -22,8 +23,8 @@ std::string Version::toString() const {
 }
 
 bool Version::fromString(const std::string& str) {
-    // Regex simples para MVP
-    std::regex pattern(R"(^(\d+)\.(\d+)\.(\d+)(?:-([a-zA-Z0-9.-]+))?(?:\+([a-zA-Z0-9.-]+))?$)");
+    // Regex simples para MVP (compiled once: parsing is hot when scanning lib dirs)
+    static const std::regex pattern(R"(^(\d+)\.(\d+)\.(\d+)(?:-([a-zA-Z0-9.-]+))?(?:\+([a-zA-Z0-9.-]+))?$)");
     std::smatch match;
     
     if (!std::regex_match(str, match, pattern)) {
@@ -55,10 +56,106 @@ std::strong_ordering Version::operator<=>(const Version& other) const {
     return patch_ <=> other.patch_;
 }
 
+namespace {
+
+// Accepts partial versions ("1", "1.2") by padding missing components with zero
+bool parseLenient(std::string text, Version& out) {
+    auto dots = std::count(text.begin(), text.end(), '.');
+    auto core = text.find_first_of("-+");
+    if (core != std::string::npos) {
+        dots = std::count(text.begin(), text.begin() + static_cast<std::ptrdiff_t>(core), '.');
+    }
+    std::string padding;
+    for (auto i = dots; i < 2; ++i) {
+        padding += ".0";
+    }
+    if (core != std::string::npos) {
+        text.insert(core, padding);
+    } else {
+        text += padding;
+    }
+    return out.fromString(text);
+}
+
+bool matchComparator(const Version& v, std::string comparator) {
+    auto trim = [](std::string& s) {
+        s.erase(0, s.find_first_not_of(" \t"));
+        s.erase(s.find_last_not_of(" \t") + 1);
+    };
+    trim(comparator);
+
+    if (comparator.empty() || comparator == "*" || comparator == "latest") {
+        return true;
+    }
+
+    std::string op;
+    for (const char* candidate : {">=", "<=", ">", "<", "=", "^", "~"}) {
+        if (comparator.starts_with(candidate)) {
+            op = candidate;
+            break;
+        }
+    }
+    std::string text = comparator.substr(op.size());
+    trim(text);
+
+    Version bound;
+    if (!parseLenient(text, bound)) {
+        return false;
+    }
+
+    if (op == ">=") return v >= bound;
+    if (op == "<=") return v <= bound;
+    if (op == ">") return v > bound;
+    if (op == "<") return v < bound;
+    if (op == "^") {
+        Version upper = bound.major() > 0 ? Version(bound.major() + 1, 0, 0)
+                                          : Version(0, bound.minor() + 1, 0);
+        return v >= bound && v < upper;
+    }
+    if (op == "~") {
+        return v >= bound && v < Version(bound.major(), bound.minor() + 1, 0);
+    }
+    return (v <=> bound) == 0;
+}
+
+} // namespace
+
 bool Version::satisfies(const std::string& range) const {
-    // Implementação simplificada para MVP
-    // TODO: Implementar SemVer range parsing
-    return true;
+    // Comparators separated by ',' or whitespace must all match; "||" separates alternatives
+    size_t start = 0;
+    while (start <= range.size()) {
+        size_t end = range.find("||", start);
+        std::string alternative = range.substr(start, end == std::string::npos ? std::string::npos : end - start);
+
+        bool all = true;
+        std::string normalized;
+        for (size_t i = 0; i < alternative.size(); ++i) {
+            char c = alternative[i];
+            // Glue operators to their version ("> = 1.0" is not supported, ">= 1.0" is)
+            if (c == ' ' && !normalized.empty() && std::string("<>=^~").find(normalized.back()) != std::string::npos) {
+                continue;
+            }
+            normalized += (c == ',') ? ' ' : c;
+        }
+
+        std::stringstream ss(normalized);
+        std::string comparator;
+        while (ss >> comparator) {
+            if (!matchComparator(*this, comparator)) {
+                all = false;
+                break;
+            }
+        }
+        if (all) {
+            return true;
+        }
+
+        if (end == std::string::npos) {
+            break;
+        }
+        start = end + 2;
+    }
+    return false;
 }
 
 } // namespace amb
\ No newline at end of file
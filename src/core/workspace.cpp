@@ -0,0 +1,73 @@
+#include "core/workspace.hpp"
+#include "utils/filesystem.hpp"
+#include "utils/logger.hpp"
+#include "json.hpp"
+
+#include <algorithm>
+
+using json = nlohmann::json;
+
+namespace amb {
+
+namespace {
+
+// "ws/." normalizes to "ws/"; member roots compare without the trailing separator
+fs::path normalDir(const fs::path& dir) {
+    fs::path normal = dir.lexically_normal();
+    return normal.has_filename() ? normal : normal.parent_path();
+}
+
+} // namespace
+
+std::optional<Workspace> Workspace::load(const fs::path& root) {
+    fs::path path = root / FILE_NAME;
+    auto content = FileSystem::readFile(path);
+    if (!content) {
+        return std::nullopt;
+    }
+
+    Workspace workspace;
+    workspace.root = root;
+    try {
+        auto j = json::parse(*content);
+        if (!j.is_object() || !j.contains("members") || !j["members"].is_array()) {
+            Logger::error("Invalid workspace file {}: expected a \"members\" array", path.string());
+            return std::nullopt;
+        }
+        for (const auto& item : j["members"]) {
+            if (!item.is_string()) {
+                continue;
+            }
+            std::string member = item.get<std::string>();
+            if (member.ends_with("/*")) {
+                fs::path parent = normalDir(root / member.substr(0, member.size() - 2));
+                for (const auto& dir : FileSystem::listDirectories(parent)) {
+                    if (FileSystem::isFile(dir / "ambar.json")) {
+                        workspace.members.push_back(normalDir(dir));
+                    }
+                }
+                continue;
+            }
+            fs::path dir = normalDir(root / member);
+            if (!FileSystem::isFile(dir / "ambar.json")) {
+                Logger::warning("Workspace member {} has no ambar.json; skipping", member);
+                continue;
+            }
+            workspace.members.push_back(dir);
+        }
+    } catch (const std::exception& e) {
+        Logger::error("Invalid workspace file {}: {}", path.string(), e.what());
+        return std::nullopt;
+    }
+
+    std::sort(workspace.members.begin(), workspace.members.end());
+    workspace.members.erase(std::unique(workspace.members.begin(), workspace.members.end()),
+                            workspace.members.end());
+    return workspace;
+}
+
+bool Workspace::contains(const fs::path& project) const {
+    return std::binary_search(members.begin(), members.end(), normalDir(project));
+}
+
+} // namespace amb
\ No newline at end of file
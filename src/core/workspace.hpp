@@ -0,0 +1,30 @@
+#pragma once
+
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+namespace amb {
+
+namespace fs = std::filesystem;
+
+// ambar.workspace.json - several projects installed as one: their dependencies are
+// resolved together into <root>/ambar_modules/lib, and each member's ambar_modules/lib
+// links the versions it uses from there.
+//
+//   { "members": ["apps/web", "libs/*"] }
+//
+// "dir/*" stands for every subdirectory of dir that holds an ambar.json.
+struct Workspace {
+    static constexpr const char* FILE_NAME = "ambar.workspace.json";
+
+    fs::path root;
+    std::vector<fs::path> members;  // absolute project roots, sorted
+
+    static std::optional<Workspace> load(const fs::path& root);
+
+    bool contains(const fs::path& project) const;
+    fs::path storeDir() const { return root / "ambar_modules" / "lib"; }
+};
+
+} // namespace amb
\ No newline at end of file
@@ -0,0 +1,296 @@
+#include "package/build_cache.hpp"
+#include "utils/file_lock.hpp"
+#include "utils/filesystem.hpp"
+#include "utils/logger.hpp"
+#include "utils/process.hpp"
+#include "utils/resource_usage.hpp"
+#include "utils/sha256.hpp"
+#include "json.hpp"
+
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+using json = nlohmann::json;
+
+namespace amb {
+
+namespace {
+
+std::optional<json> readEntry(const fs::path& entry) {
+    auto content = FileSystem::readFile(entry / "entry.json");
+    if (!content) {
+        return std::nullopt;
+    }
+    auto j = json::parse(*content, nullptr, false);
+    if (j.is_discarded() || !j.contains("files") || !j["files"].is_array()) {
+        return std::nullopt;
+    }
+    return j;
+}
+
+// [size, mtime] as recorded in entry.json
+json fileStat(const fs::path& file) {
+    std::error_code ec;
+    auto size = fs::file_size(file, ec);
+    if (ec) {
+        return nullptr;
+    }
+    auto mtime = fs::last_write_time(file, ec);
+    if (ec) {
+        return nullptr;
+    }
+    return json::array({size, mtime.time_since_epoch().count()});
+}
+
+} // namespace
+
+BuildCache::BuildCache(const fs::path& root, uint64_t maxBytes) : root_(root), maxBytes_(maxBytes) {}
+
+std::string BuildCache::fingerprint(const std::string& compiler, const std::string& flags) {
+    static std::mutex mutex;
+    static std::map<std::string, std::string> computed;
+
+    std::string id = compiler + "\n" + flags;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = computed.find(id);
+    if (it != computed.end()) {
+        return it->second;
+    }
+
+    // The version banner identifies the toolchain build; a missing compiler still gets a
+    // stable fingerprint so scripts that do not use it can be cached
+    std::string version = "unavailable";
+    fs::path output = FileSystem::getTempDirectory() / ("amb-toolchain-" + Sha256::hash(id).substr(0, 16));
+    FileSystem::removeFile(output);
+    auto result = Process::runShell(compiler + " --version", FileSystem::getTempDirectory(), output);
+    if (result.exitCode == 0) {
+        version = FileSystem::readFile(output).value_or(version);
+    }
+    FileSystem::removeFile(output);
+    Logger::debug("Toolchain '{}': {}", compiler, result.exitCode == 0 ? "found" : "not found");
+
+    return computed[id] = Sha256::hash(id + "\n" + version);
+}
+
+std::string BuildCache::key(const std::string& digest, const std::string& fingerprint) {
+    return Sha256::hash(digest + "\n" + fingerprint);
+}
+
+bool BuildCache::restore(const std::string& key, const fs::path& packageDir) {
+    fs::path entry = root_ / key;
+    if (!FileSystem::isDirectory(entry)) {
+        misses_++;
+        ResourceUsage::add(ResourceUsage::Counter::BUILD_CACHE_MISSES);
+        return false;
+    }
+
+    FileSystem::createDirectories(root_);
+    // Shared: eviction takes the cache lock exclusively and never runs during a restore
+    auto guard = FileLock::acquire(root_ / ".lock", LockMode::SHARED);
+    auto manifest = readEntry(entry);
+    if (!manifest) {
+        misses_++;
+        ResourceUsage::add(ResourceUsage::Counter::BUILD_CACHE_MISSES);
+        return false;
+    }
+
+    // The files are read-only, which does not stop root; a linked copy written in place
+    // shows up here as a changed size or mtime, and the entry is discarded
+    const json stats = manifest->value("stat", json::object());
+    for (const auto& file : (*manifest)["files"]) {
+        auto rel = file.get<std::string>();
+        fs::path source = entry / "files" / rel;
+        fs::path target = packageDir / rel;
+        if (stats.contains(rel) && stats[rel] != fileStat(source)) {
+            Logger::warning("Cached build {} was modified ({} changed), discarding it", key.substr(0, 12), rel);
+            // Dropped so that this build stores a clean entry again
+            auto entryGuard = FileLock::acquire(FileLock::siblingLockPath(entry), LockMode::EXCLUSIVE);
+            FileSystem::removeDirectories(entry);
+            misses_++;
+            ResourceUsage::add(ResourceUsage::Counter::BUILD_CACHE_MISSES);
+            return false;
+        }
+        FileSystem::createDirectories(target.parent_path());
+
+        std::error_code ec;
+        fs::remove(target, ec);
+        fs::create_hard_link(source, target, ec);
+        FileSystem::invalidate(target);
+        if (ec && !FileSystem::copyFile(source, target)) {
+            Logger::warning("Cached build {} is incomplete ({} missing)", key.substr(0, 12), rel);
+            misses_++;
+            ResourceUsage::add(ResourceUsage::Counter::BUILD_CACHE_MISSES);
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    fs::last_write_time(entry / "entry.json", fs::file_time_type::clock::now(), ec);
+    hits_++;
+    ResourceUsage::add(ResourceUsage::Counter::BUILD_CACHE_HITS);
+    return true;
+}
+
+BuildCache::Snapshot BuildCache::snapshot(const fs::path& dir) {
+    Snapshot files;
+    std::error_code ec;
+    for (auto it = fs::recursive_directory_iterator(dir, ec); !ec && it != fs::recursive_directory_iterator();
+         it.increment(ec)) {
+        if (!it->is_regular_file(ec)) {
+            continue;
+        }
+        auto rel = fs::relative(it->path(), dir, ec).generic_string();
+        files[rel] = {it->file_size(ec), it->last_write_time(ec)};
+    }
+    return files;
+}
+
+bool BuildCache::store(const std::string& key, const fs::path& packageDir, const Snapshot& before,
+                       const std::string& digest) {
+    std::vector<std::string> outputs;
+    for (const auto& [rel, state] : snapshot(packageDir)) {
+        auto it = before.find(rel);
+        if (it == before.end() || it->second != state) {
+            outputs.push_back(rel);
+        }
+    }
+
+    fs::path entry = root_ / key;
+    FileSystem::createDirectories(root_);
+    auto guard = FileLock::acquire(FileLock::siblingLockPath(entry), LockMode::EXCLUSIVE);
+    if (FileSystem::isDirectory(entry)) {
+        return true;
+    }
+
+    fs::path staging = root_ / ("." + key + ".tmp");
+    FileSystem::removeDirectories(staging);
+
+    // Copies, not links: the project may rebuild its files in place later. Restores do
+    // link them, so they are made read-only to keep one project from rewriting another's.
+    uintmax_t bytes = 0;
+    json stats = json::object();
+    for (const auto& rel : outputs) {
+        fs::path target = staging / "files" / rel;
+        FileSystem::createDirectories(target.parent_path());
+        if (!FileSystem::copyFile(packageDir / rel, target)) {
+            FileSystem::removeDirectories(staging);
+            return false;
+        }
+        std::error_code ec;
+        fs::permissions(target, fs::perms::owner_write | fs::perms::group_write | fs::perms::others_write,
+                        fs::perm_options::remove, ec);
+        bytes += FileSystem::fileSize(target);
+        stats[rel] = fileStat(target);
+    }
+
+    json manifest = {{"files", outputs}, {"bytes", bytes}, {"digest", digest}, {"stat", stats}};
+    std::error_code ec;
+    if (FileSystem::writeFile(staging / "entry.json", manifest.dump(2))) {
+        fs::rename(staging, entry, ec);
+        FileSystem::invalidate(staging);
+        FileSystem::invalidate(entry);
+    } else {
+        ec = std::make_error_code(std::errc::io_error);
+    }
+    if (ec) {
+        Logger::warning("Failed to store build output in {}", entry.string());
+        FileSystem::removeDirectories(staging);
+        return false;
+    }
+
+    Logger::debug("Cached {} build output file(s) ({} bytes) as {}", outputs.size(), bytes, key.substr(0, 12));
+    stored_++;
+    return true;
+}
+
+std::string BuildCache::entryDigest(const fs::path& dir) {
+    auto manifest = readEntry(dir);
+    return manifest ? manifest->value("digest", "") : "";
+}
+
+void BuildCache::evict() {
+    if (!FileSystem::isDirectory(root_)) {
+        return;
+    }
+    auto guard = FileLock::tryAcquire(root_ / ".lock", LockMode::EXCLUSIVE);
+    if (!guard) {
+        Logger::debug("Build cache in use, skipping eviction");
+        return;
+    }
+
+    struct Entry {
+        fs::path dir;
+        uintmax_t bytes = 0;
+        fs::file_time_type used;
+    };
+    std::vector<Entry> entries;
+    uintmax_t total = 0;
+
+    for (const auto& dir : FileSystem::listDirectories(root_)) {
+        if (FileSystem::filename(dir).starts_with(".")) {
+            continue;
+        }
+        auto manifest = readEntry(dir);
+        std::error_code ec;
+        auto used = fs::last_write_time(dir / "entry.json", ec);
+        if (!manifest || ec) {
+            FileSystem::removeDirectories(dir);
+            continue;
+        }
+        Entry item{dir, manifest->value("bytes", uintmax_t{0}), used};
+        total += item.bytes;
+        entries.push_back(std::move(item));
+    }
+    if (total <= maxBytes_) {
+        return;
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.used < b.used; });
+    for (const auto& item : entries) {
+        if (total <= maxBytes_) {
+            break;
+        }
+        if (FileSystem::removeDirectories(item.dir)) {
+            FileSystem::removeFile(FileLock::siblingLockPath(item.dir));
+            total -= item.bytes;
+            evicted_++;
+        }
+    }
+    Logger::debug("Build cache evicted {} entries, {} bytes left", evicted_.load(), total);
+}
+
+BuildCache::Stats BuildCache::stats() const {
+    return Stats{hits_, misses_, stored_, evicted_};
+}
+
+BuildCache::Stats BuildCache::saveStats() const {
+    fs::path file = root_ / "stats.json";
+    FileSystem::createDirectories(root_);
+    auto guard = FileLock::acquire(FileLock::siblingLockPath(file), LockMode::EXCLUSIVE);
+
+    Stats totals = stats();
+    if (auto content = FileSystem::readFile(file)) {
+        auto j = json::parse(*content, nullptr, false);
+        if (!j.is_discarded()) {
+            totals.hits += j.value("hits", uint64_t{0});
+            totals.misses += j.value("misses", uint64_t{0});
+            totals.stored += j.value("stored", uint64_t{0});
+            totals.evicted += j.value("evicted", uint64_t{0});
+        }
+    }
+
+    json j = {{"hits", totals.hits}, {"misses", totals.misses},
+              {"stored", totals.stored}, {"evicted", totals.evicted}};
+    fs::path staging = file;
+    staging += ".tmp";
+    std::error_code ec;
+    if (FileSystem::writeFile(staging, j.dump(2))) {
+        fs::rename(staging, file, ec);
+        FileSystem::invalidate(staging);
+        FileSystem::invalidate(file);
+    }
+    return totals;
+}
+
+} // namespace amb
\ No newline at end of file
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <string>
+
+namespace amb {
+
+namespace fs = std::filesystem;
+
+// Prebuilt outputs of package `build` hooks, shared by every project on the machine.
+// Entries are keyed by the package digest plus a toolchain fingerprint (compiler
+// version and flags) and live in <cache>/builds/<key>/:
+//   files/...     what the build added or changed in the package directory
+//   entry.json    file list with each file's size and mtime, total size and package
+//                 digest; its mtime is the entry's last use
+// A hit hardlinks the files into the new package directory (copying across devices), so
+// stored files are read-only and a hit checks that none of them changed since.
+// Once the cache exceeds its size bound, least recently used entries are evicted.
+class BuildCache {
+public:
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t stored = 0;
+        uint64_t evicted = 0;
+    };
+
+    // Relative path -> (size, mtime) of the files in a package directory
+    using Snapshot = std::map<std::string, std::pair<uintmax_t, fs::file_time_type>>;
+
+    BuildCache(const fs::path& root, uint64_t maxBytes);
+
+    // Hash of `<compiler> --version` and the flags; computed once per process
+    static std::string fingerprint(const std::string& compiler, const std::string& flags);
+    static std::string key(const std::string& digest, const std::string& fingerprint);
+
+    // Links a cached build into `packageDir`; false on a miss
+    bool restore(const std::string& key, const fs::path& packageDir);
+
+    static Snapshot snapshot(const fs::path& dir);
+    // Stores the files of `packageDir` that are new or changed since `before`. The package
+    // digest is recorded so `amb gc` can drop builds of packages nothing references.
+    bool store(const std::string& key, const fs::path& packageDir, const Snapshot& before,
+               const std::string& digest);
+    // Package digest recorded for the entry in `dir`, empty when unknown
+    static std::string entryDigest(const fs::path& dir);
+
+    // Evicts least recently used entries until the cache fits its bound.
+    // Skipped when another process is restoring from the cache.
+    void evict();
+
+    // This session's counters
+    Stats stats() const;
+    // Adds this session's counters to <root>/stats.json and returns the totals
+    Stats saveStats() const;
+
+private:
+    fs::path root_;
+    uint64_t maxBytes_;
+
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+    std::atomic<uint64_t> stored_{0};
+    std::atomic<uint64_t> evicted_{0};
+};
+
+} // namespace amb
\ No newline at end of file
@@ -0,0 +1,219 @@
+#include "package/compressed_cache.hpp"
+#include "utils/archive.hpp"
+#include "utils/file_lock.hpp"
+#include "utils/filesystem.hpp"
+#include "utils/logger.hpp"
+#include "utils/lz_codec.hpp"
+
+#include <algorithm>
+
+namespace amb {
+
+namespace {
+
+constexpr char MAGIC[8] = {'A', 'M', 'B', 'Z', 'B', 'L', 'K', '1'};
+constexpr size_t HEADER_SIZE = 32;
+constexpr uint32_t STORED = 0x80000000u;  // block size flag: kept as is, compression did not help
+
+uint64_t readLe(std::string_view data, size_t pos, size_t bytes) {
+    uint64_t value = 0;
+    for (size_t i = bytes; i-- > 0;) {
+        value = (value << 8) | static_cast<uint8_t>(data[pos + i]);
+    }
+    return value;
+}
+
+void writeLe(std::string& out, uint64_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; ++i) {
+        out.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+    }
+}
+
+// Names the dictionary a file was packed with; 0 means none
+uint32_t dictionaryId(std::string_view dictionary) {
+    return dictionary.empty() ? 0 : crc32(dictionary.data(), dictionary.size()) | 1;
+}
+
+} // namespace
+
+CompressedCache::CompressedCache(fs::path cacheDir) : cacheDir_(std::move(cacheDir)) {
+    if (auto dictionary = FileSystem::readFile(cacheDir_ / DICTIONARY_FILE)) {
+        dictionary_ = std::move(*dictionary);
+    }
+}
+
+fs::path CompressedCache::packedPath(const fs::path& archive) {
+    fs::path packed = archive;
+    packed += EXTENSION;
+    return packed;
+}
+
+bool CompressedCache::train(const std::vector<fs::path>& archives) {
+    if (hasDictionary()) {
+        return true;
+    }
+
+    fs::path path = cacheDir_ / DICTIONARY_FILE;
+    auto guard = FileLock::acquire(FileLock::siblingLockPath(path), LockMode::EXCLUSIVE);
+    // Another install may have trained one meanwhile; packed files name the one they use
+    if (auto existing = FileSystem::readFile(path)) {
+        dictionary_ = std::move(*existing);
+        return true;
+    }
+
+    std::vector<std::string> files;
+    size_t bytes = 0;
+    for (const auto& archive : archives) {
+        ZipReader reader;
+        if (!reader.open(archive)) {
+            continue;
+        }
+        for (const auto& entry : reader.entries()) {
+            if (entry.isDirectory) {
+                continue;
+            }
+            if (auto content = reader.read(entry)) {
+                bytes += content->size();
+                files.push_back(std::move(*content));
+            }
+        }
+    }
+    if (bytes < MIN_TRAINING_BYTES) {
+        return false;
+    }
+
+    std::vector<std::string_view> samples(files.begin(), files.end());
+    std::string dictionary = lzTrainDictionary(samples);
+    if (dictionary.empty()) {
+        return false;
+    }
+    fs::path staging = path;
+    staging += ".tmp";
+    std::error_code ec;
+    if (!FileSystem::writeFile(staging, dictionary)) {
+        return false;
+    }
+    fs::rename(staging, path, ec);
+    FileSystem::invalidate(staging);
+    FileSystem::invalidate(path);
+    if (ec) {
+        return false;
+    }
+    Logger::debug("Trained a {} byte cache dictionary on {} file(s)", dictionary.size(), files.size());
+    dictionary_ = std::move(dictionary);
+    return true;
+}
+
+bool CompressedCache::pack(const fs::path& archive) const {
+    fs::path lockPath = archive;
+    lockPath += ".lock";
+    auto guard = FileLock::acquire(lockPath, LockMode::EXCLUSIVE);
+
+    auto data = FileSystem::readFile(archive);
+    if (!data) {
+        return false;
+    }
+    fs::path packed = packedPath(archive);
+    fs::path staging = packed;
+    staging += ".tmp";
+    if (!FileSystem::writeFile(staging, encode(*data, dictionary_))) {
+        FileSystem::removeFile(staging);
+        return false;
+    }
+    std::error_code ec;
+    fs::rename(staging, packed, ec);
+    FileSystem::invalidate(staging);
+    FileSystem::invalidate(packed);
+    if (ec) {
+        return false;
+    }
+    return FileSystem::removeFile(archive);
+}
+
+std::optional<std::string> CompressedCache::unpack(const fs::path& archive) const {
+    auto packed = FileSystem::readFile(packedPath(archive));
+    if (!packed) {
+        return std::nullopt;
+    }
+    auto data = decode(*packed, dictionary_);
+    if (!data) {
+        Logger::debug("Packed archive {} is corrupt or needs another dictionary", packedPath(archive).string());
+    }
+    return data;
+}
+
+std::string CompressedCache::encode(std::string_view data, std::string_view dictionary) {
+    size_t blocks = (data.size() + BLOCK_SIZE - 1) / BLOCK_SIZE;
+
+    std::string out(MAGIC, sizeof(MAGIC));
+    writeLe(out, data.size(), 8);
+    writeLe(out, dictionaryId(dictionary), 4);
+    writeLe(out, BLOCK_SIZE, 4);
+    writeLe(out, blocks, 4);
+    writeLe(out, crc32(data.data(), data.size()), 4);
+
+    std::string table;
+    std::string body;
+    for (size_t i = 0; i < blocks; ++i) {
+        auto raw = data.substr(i * BLOCK_SIZE, BLOCK_SIZE);
+        std::string compressed = lzCompress(raw, dictionary);
+        if (compressed.size() < raw.size()) {
+            writeLe(table, compressed.size(), 4);
+            body += compressed;
+        } else {
+            writeLe(table, raw.size() | STORED, 4);
+            body += raw;
+        }
+    }
+    return out + table + body;
+}
+
+std::optional<std::string> CompressedCache::decode(std::string_view packed, std::string_view dictionary) {
+    if (packed.size() < HEADER_SIZE || packed.substr(0, sizeof(MAGIC)) != std::string_view(MAGIC, sizeof(MAGIC))) {
+        return std::nullopt;
+    }
+    uint64_t size = readLe(packed, 8, 8);
+    auto id = static_cast<uint32_t>(readLe(packed, 16, 4));
+    uint64_t blockSize = readLe(packed, 20, 4);
+    uint64_t blocks = readLe(packed, 24, 4);
+    auto crc = static_cast<uint32_t>(readLe(packed, 28, 4));
+    if (id != 0 && id != dictionaryId(dictionary)) {
+        return std::nullopt;
+    }
+    if (blockSize == 0 || blockSize > STORED || blocks != (size + blockSize - 1) / blockSize ||
+        packed.size() < HEADER_SIZE + 4 * blocks) {
+        return std::nullopt;
+    }
+    if (id == 0) {
+        dictionary = {};
+    }
+
+    std::string out(static_cast<size_t>(size), '\0');
+    size_t pos = HEADER_SIZE + 4 * blocks;
+    for (uint64_t i = 0; i < blocks; ++i) {
+        auto entry = static_cast<uint32_t>(readLe(packed, HEADER_SIZE + 4 * i, 4));
+        size_t length = entry & ~STORED;
+        size_t offset = static_cast<size_t>(i * blockSize);
+        size_t raw = static_cast<size_t>(std::min<uint64_t>(blockSize, size - offset));
+        if (length > packed.size() - pos) {
+            return std::nullopt;
+        }
+        auto block = packed.substr(pos, length);
+        pos += length;
+        if (entry & STORED) {
+            if (length != raw) {
+                return std::nullopt;
+            }
+            block.copy(out.data() + offset, length);
+        } else if (!lzDecompress(block, out.data() + offset, raw, dictionary)) {
+            return std::nullopt;
+        }
+    }
+
+    if (crc32(out.data(), out.size()) != crc) {
+        return std::nullopt;
+    }
+    return out;
+}
+
+} // namespace amb
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace amb {
+
+namespace fs = std::filesystem;
+
+// Optional compressed form of the archive cache (config "cache_compression"). A packed
+// archive is kept as "<name>-<version>.zip.amz": fixed-size blocks, each compressed on
+// its own with the built-in LZ codec against a dictionary trained on cached sources,
+// plus a CRC of the whole. Installs decode it into memory and extract from there, so
+// the raw archive is never written back.
+class CompressedCache {
+public:
+    static constexpr const char* EXTENSION = ".amz";
+    static constexpr const char* DICTIONARY_FILE = "amz.dict";
+    static constexpr size_t BLOCK_SIZE = 256 * 1024;
+    // Less sample data than this trains a dictionary that does not pay for itself
+    static constexpr size_t MIN_TRAINING_BYTES = 64 * 1024;
+
+    explicit CompressedCache(fs::path cacheDir);
+
+    // <archive>.amz
+    static fs::path packedPath(const fs::path& archive);
+
+    bool hasDictionary() const { return !dictionary_.empty(); }
+    // Trains and stores the dictionary from the files inside `archives`, unless there is
+    // one already or the samples are too small. True when a dictionary is in use.
+    bool train(const std::vector<fs::path>& archives);
+
+    // Replaces `archive` by its packed form, under the artifact's lock
+    bool pack(const fs::path& archive) const;
+    // The archive's bytes, nullopt when it is not packed or the packed file is corrupt
+    std::optional<std::string> unpack(const fs::path& archive) const;
+
+    // The container format over memory; `dictionary` may be empty
+    static std::string encode(std::string_view data, std::string_view dictionary);
+    static std::optional<std::string> decode(std::string_view packed, std::string_view dictionary);
+
+private:
+    fs::path cacheDir_;
+    std::string dictionary_;
+};
+
+} // namespace amb
\ No newline at end of file
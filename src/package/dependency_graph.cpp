@@ -0,0 +1,391 @@
+#include "package/dependency_graph.hpp"
+#include "amb/version.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <tuple>
+
+namespace amb {
+
+DependencyGraph DependencyGraph::fromPackages(const std::map<std::string, LockEntry>& packages,
+                                              const std::map<std::string, std::string>& roots) {
+    Builder builder;
+    for (const auto& [key, entry] : packages) {
+        NodeId from = builder.addNode(entry.name, entry.version);
+        for (const auto& [name, version] : entry.dependencies) {
+            // Edges to entries the lock does not have would only add phantom nodes
+            if (packages.count(name + "@" + version)) {
+                builder.addEdge(from, builder.addNode(name, version));
+            }
+        }
+    }
+    for (const auto& [name, version] : roots) {
+        if (packages.count(name + "@" + version)) {
+            builder.addRoot(builder.addNode(name, version));
+        }
+    }
+    return builder.build();
+}
+
+DependencyGraph DependencyGraph::fromLockfile(const Lockfile& lock) {
+    return fromPackages(lock.packages, lock.dependencies);
+}
+
+std::string DependencyGraph::key(NodeId node) const {
+    std::string result(name(node));
+    result += '@';
+    result += version(node);
+    return result;
+}
+
+DependencyGraph::NodeId DependencyGraph::find(std::string_view name, std::string_view version) const {
+    NodeId low = 0;
+    NodeId high = static_cast<NodeId>(size());
+    while (low < high) {
+        NodeId mid = low + (high - low) / 2;
+        if (std::make_tuple(this->name(mid), this->version(mid)) < std::make_tuple(name, version)) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low < size() && this->name(low) == name && this->version(low) == version ? low : NONE;
+}
+
+std::vector<DependencyGraph::NodeId> DependencyGraph::versionsOf(std::string_view name,
+                                                                 const std::string& range) const {
+    NodeId low = 0;
+    NodeId high = static_cast<NodeId>(size());
+    while (low < high) {
+        NodeId mid = low + (high - low) / 2;
+        if (this->name(mid) < name) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    std::vector<NodeId> nodes;
+    for (NodeId node = low; node < size() && this->name(node) == name; ++node) {
+        if (range == "*" || Version(std::string(version(node))).satisfies(range)) {
+            nodes.push_back(node);
+        }
+    }
+    return nodes;
+}
+
+bool DependencyGraph::isRoot(NodeId node) const {
+    return std::binary_search(roots_.begin(), roots_.end(), node);
+}
+
+DependencyGraph::Paths DependencyGraph::shortestPaths(NodeId node, size_t limit, size_t maxDepth) const {
+    // Steps down to `node` from each of its ancestors, found breadth-first up the
+    // dependents; `reached` lists them nearest first
+    std::vector<uint32_t> distance(size(), NONE);
+    std::vector<NodeId> reached{node};
+    distance[node] = 0;
+    // Once every root is found, the nodes nearer than the last one all are too: the
+    // rest of the ancestors cannot be on a shortest chain
+    size_t rootsLeft = roots_.size() - (isRoot(node) ? 1 : 0);
+    for (size_t head = 0; head < reached.size() && rootsLeft > 0; ++head) {
+        NodeId current = reached[head];
+        if (distance[current] >= maxDepth) {
+            continue;
+        }
+        for (NodeId dependent : dependents(current)) {
+            if (distance[dependent] == NONE) {
+                distance[dependent] = distance[current] + 1;
+                reached.push_back(dependent);
+                if (isRoot(dependent)) {
+                    --rootsLeft;
+                }
+            }
+        }
+    }
+    auto onShortestPath = [&](NodeId from, NodeId to) {
+        return distance[to] != NONE && distance[to] + 1 == distance[from];
+    };
+
+    // Number of shortest chains from each ancestor, nearest first so each sum is complete
+    std::vector<uint64_t> chains(size(), 0);
+    chains[node] = 1;
+    for (size_t i = 1; i < reached.size(); ++i) {
+        NodeId current = reached[i];
+        for (NodeId dependency : dependencies(current)) {
+            if (onShortestPath(current, dependency)) {
+                chains[current] = chains[current] > UINT64_MAX - chains[dependency] ? UINT64_MAX
+                                                                                    : chains[current] + chains[dependency];
+            }
+        }
+    }
+
+    Paths result;
+    std::vector<NodeId> path;
+    std::vector<uint32_t> next;  // per path node: the next dependency edge to try
+    for (NodeId root : reached) {
+        if (!isRoot(root)) {
+            continue;
+        }
+        result.total = result.total > UINT64_MAX - chains[root] ? UINT64_MAX : result.total + chains[root];
+
+        path.assign(1, root);
+        next.assign(1, offsets_[root]);
+        while (!path.empty() && result.paths.size() < limit) {
+            NodeId current = path.back();
+            if (current == node) {
+                result.paths.push_back(path);
+                path.pop_back();
+                next.pop_back();
+                continue;
+            }
+            uint32_t edge = next.back();
+            while (edge < offsets_[current + 1] && !onShortestPath(current, targets_[edge])) {
+                ++edge;
+            }
+            if (edge == offsets_[current + 1]) {
+                path.pop_back();
+                next.pop_back();
+                continue;
+            }
+            next.back() = edge + 1;
+            path.push_back(targets_[edge]);
+            next.push_back(offsets_[targets_[edge]]);
+        }
+    }
+    return result;
+}
+
+std::vector<std::vector<DependencyGraph::NodeId>> DependencyGraph::cycles() const {
+    // Tarjan's strongly connected components, with an explicit stack so deep chains
+    // cannot overflow the call stack
+    std::vector<uint32_t> order(size(), NONE);
+    std::vector<uint32_t> low(size(), 0);
+    std::vector<char> onStack(size(), 0);
+    std::vector<NodeId> stack;
+    std::vector<std::pair<NodeId, uint32_t>> frames;  // node, next dependency to visit
+    std::vector<std::vector<NodeId>> components;
+    uint32_t counter = 0;
+
+    for (NodeId start = 0; start < size(); ++start) {
+        if (order[start] != NONE) {
+            continue;
+        }
+        frames.emplace_back(start, offsets_[start]);
+        order[start] = low[start] = counter++;
+        stack.push_back(start);
+        onStack[start] = 1;
+
+        while (!frames.empty()) {
+            auto& [node, edge] = frames.back();
+            if (edge < offsets_[node + 1]) {
+                NodeId target = targets_[edge++];
+                if (order[target] == NONE) {
+                    order[target] = low[target] = counter++;
+                    stack.push_back(target);
+                    onStack[target] = 1;
+                    frames.emplace_back(target, offsets_[target]);
+                } else if (onStack[target]) {
+                    low[node] = std::min(low[node], order[target]);
+                }
+                continue;
+            }
+
+            NodeId done = node;
+            frames.pop_back();
+            if (!frames.empty()) {
+                NodeId parent = frames.back().first;
+                low[parent] = std::min(low[parent], low[done]);
+            }
+            if (low[done] != order[done]) {
+                continue;
+            }
+            std::vector<NodeId> component;
+            NodeId member;
+            do {
+                member = stack.back();
+                stack.pop_back();
+                onStack[member] = 0;
+                component.push_back(member);
+            } while (member != done);
+
+            auto deps = dependencies(done);
+            if (component.size() > 1 || std::binary_search(deps.begin(), deps.end(), done)) {
+                std::sort(component.begin(), component.end());
+                components.push_back(std::move(component));
+            }
+        }
+    }
+    std::sort(components.begin(), components.end());
+    return components;
+}
+
+size_t DependencyGraph::memoryBytes() const {
+    size_t ids = poolOffsets_.capacity() + nameId_.capacity() + versionId_.capacity() + offsets_.capacity() +
+                 targets_.capacity() + ranges_.capacity() + reverseOffsets_.capacity() + sources_.capacity() +
+                 roots_.capacity();
+    return sizeof(*this) + pool_.capacity() + ids * sizeof(uint32_t);
+}
+
+std::string DependencyGraph::serialize() const {
+    std::string out;
+    auto put = [&](const auto& values) {
+        out.append(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(values[0]));
+    };
+    const std::vector<uint32_t> counts{static_cast<uint32_t>(pool_.size()), static_cast<uint32_t>(poolOffsets_.size()),
+                                       static_cast<uint32_t>(size()), static_cast<uint32_t>(edgeCount()),
+                                       static_cast<uint32_t>(roots_.size())};
+    put(counts);
+    put(pool_);
+    for (const auto* values : {&poolOffsets_, &nameId_, &versionId_, &offsets_, &targets_, &ranges_,
+                               &reverseOffsets_, &sources_, &roots_}) {
+        put(*values);
+    }
+    return out;
+}
+
+std::optional<DependencyGraph> DependencyGraph::deserialize(std::string_view data) {
+    size_t pos = 0;
+    auto take = [&](auto& values, size_t count) {
+        size_t bytes = count * sizeof(values[0]);
+        if (data.size() - pos < bytes) {
+            return false;
+        }
+        values.resize(count);
+        std::memcpy(values.data(), data.data() + pos, bytes);
+        pos += bytes;
+        return true;
+    };
+
+    std::vector<uint32_t> counts;
+    if (!take(counts, 5) || counts[1] == 0) {
+        return std::nullopt;
+    }
+    size_t strings = counts[1] - 1;
+    size_t nodes = counts[2];
+    size_t edges = counts[3];
+
+    DependencyGraph graph;
+    if (!take(graph.pool_, counts[0]) || !take(graph.poolOffsets_, strings + 1) || !take(graph.nameId_, nodes) ||
+        !take(graph.versionId_, nodes) || !take(graph.offsets_, nodes + 1) || !take(graph.targets_, edges) ||
+        !take(graph.ranges_, edges) || !take(graph.reverseOffsets_, nodes + 1) || !take(graph.sources_, edges) ||
+        !take(graph.roots_, counts[4]) || pos != data.size()) {
+        return std::nullopt;
+    }
+
+    auto monotonic = [](const std::vector<uint32_t>& offsets, size_t end) {
+        return offsets.front() == 0 && offsets.back() == end && std::is_sorted(offsets.begin(), offsets.end());
+    };
+    auto below = [](const std::vector<uint32_t>& ids, size_t bound) {
+        return std::all_of(ids.begin(), ids.end(), [&](uint32_t id) { return id < bound; });
+    };
+    if (!monotonic(graph.poolOffsets_, graph.pool_.size()) || !monotonic(graph.offsets_, edges) ||
+        !monotonic(graph.reverseOffsets_, edges) || !below(graph.nameId_, strings) ||
+        !below(graph.versionId_, strings) || !below(graph.ranges_, strings) || !below(graph.targets_, nodes) ||
+        !below(graph.sources_, nodes) || !below(graph.roots_, nodes)) {
+        return std::nullopt;
+    }
+    return graph;
+}
+
+DependencyGraph::NodeId DependencyGraph::Builder::addNode(std::string_view name, std::string_view version) {
+    uint32_t nameId = intern(name);
+    uint32_t versionId = intern(version);
+    auto [it, added] = nodeIds_.try_emplace(uint64_t{nameId} << 32 | versionId, static_cast<NodeId>(nodes_.size()));
+    if (added) {
+        nodes_.emplace_back(nameId, versionId);
+    }
+    return it->second;
+}
+
+void DependencyGraph::Builder::addEdge(NodeId from, NodeId to, std::string_view range) {
+    edges_.push_back({from, to, intern(range)});
+}
+
+void DependencyGraph::Builder::addRoot(NodeId node) {
+    roots_.push_back(node);
+}
+
+uint32_t DependencyGraph::Builder::intern(std::string_view text) {
+    auto [it, added] = stringIds_.try_emplace(std::string(text), static_cast<uint32_t>(strings_.size()));
+    if (added) {
+        strings_.emplace_back(text);
+    }
+    return it->second;
+}
+
+DependencyGraph DependencyGraph::Builder::build() const {
+    DependencyGraph graph;
+    size_t n = nodes_.size();
+
+    size_t poolSize = 0;
+    for (const auto& text : strings_) {
+        poolSize += text.size();
+    }
+    graph.pool_.reserve(poolSize);
+    graph.poolOffsets_.reserve(strings_.size() + 1);
+    for (const auto& text : strings_) {
+        graph.poolOffsets_.push_back(static_cast<uint32_t>(graph.pool_.size()));
+        graph.pool_ += text;
+    }
+    graph.poolOffsets_.push_back(static_cast<uint32_t>(graph.pool_.size()));
+
+    // Renumber in (name, version) order
+    std::vector<NodeId> order(n);
+    std::iota(order.begin(), order.end(), NodeId{0});
+    std::sort(order.begin(), order.end(), [&](NodeId a, NodeId b) {
+        return std::tie(strings_[nodes_[a].first], strings_[nodes_[a].second]) <
+               std::tie(strings_[nodes_[b].first], strings_[nodes_[b].second]);
+    });
+    std::vector<NodeId> renumbered(n);
+    graph.nameId_.resize(n);
+    graph.versionId_.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        renumbered[order[i]] = static_cast<NodeId>(i);
+        graph.nameId_[i] = nodes_[order[i]].first;
+        graph.versionId_[i] = nodes_[order[i]].second;
+    }
+
+    // Forward rows: edges sorted by (from, to), repeated edges kept once
+    std::vector<Edge> edges;
+    edges.reserve(edges_.size());
+    for (const auto& edge : edges_) {
+        edges.push_back({renumbered[edge.from], renumbered[edge.to], edge.range});
+    }
+    std::stable_sort(edges.begin(), edges.end(), [](const Edge& a, const Edge& b) {
+        return std::tie(a.from, a.to) < std::tie(b.from, b.to);
+    });
+    edges.erase(std::unique(edges.begin(), edges.end(),
+                            [](const Edge& a, const Edge& b) { return a.from == b.from && a.to == b.to; }),
+                edges.end());
+
+    graph.offsets_.assign(n + 1, 0);
+    graph.targets_.reserve(edges.size());
+    graph.ranges_.reserve(edges.size());
+    for (const auto& edge : edges) {
+        graph.offsets_[edge.from + 1]++;
+        graph.targets_.push_back(edge.to);
+        graph.ranges_.push_back(edge.range);
+    }
+    std::partial_sum(graph.offsets_.begin(), graph.offsets_.end(), graph.offsets_.begin());
+
+    // Reverse rows by counting sort; sources come out sorted since edges are in `from` order
+    graph.reverseOffsets_.assign(n + 1, 0);
+    for (const auto& edge : edges) {
+        graph.reverseOffsets_[edge.to + 1]++;
+    }
+    std::partial_sum(graph.reverseOffsets_.begin(), graph.reverseOffsets_.end(), graph.reverseOffsets_.begin());
+    graph.sources_.resize(edges.size());
+    std::vector<uint32_t> fill(graph.reverseOffsets_.begin(), graph.reverseOffsets_.end() - 1);
+    for (const auto& edge : edges) {
+        graph.sources_[fill[edge.to]++] = edge.from;
+    }
+
+    for (NodeId root : roots_) {
+        graph.roots_.push_back(renumbered[root]);
+    }
+    std::sort(graph.roots_.begin(), graph.roots_.end());
+    graph.roots_.erase(std::unique(graph.roots_.begin(), graph.roots_.end()), graph.roots_.end());
+    return graph;
+}
+
+} // namespace amb
\ No newline at end of file
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "core/lockfile.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace amb {
+
+// Immutable package-version graph in compressed sparse rows: node IDs are 32-bit, every
+// node's dependencies (and, in a second set of rows, its dependents) are one contiguous
+// run of IDs, and names, versions and edge ranges are indexes into a single string pool.
+// Nodes are numbered in (name, version) order, so lookups are binary searches.
+class DependencyGraph {
+public:
+    using NodeId = uint32_t;
+    static constexpr NodeId NONE = std::numeric_limits<NodeId>::max();
+
+    // One row: the dependencies or dependents of a node, sorted by ID
+    class Row {
+    public:
+        Row(const NodeId* first, const NodeId* last) : first_(first), last_(last) {}
+        const NodeId* begin() const { return first_; }
+        const NodeId* end() const { return last_; }
+        size_t size() const { return static_cast<size_t>(last_ - first_); }
+        bool empty() const { return first_ == last_; }
+        NodeId operator[](size_t i) const { return first_[i]; }
+
+    private:
+        const NodeId* first_;
+        const NodeId* last_;
+    };
+
+    class Builder;
+
+    DependencyGraph() = default;
+
+    // The graph of a resolved set of packages; `roots` maps direct dependencies to versions
+    static DependencyGraph fromPackages(const std::map<std::string, LockEntry>& packages,
+                                        const std::map<std::string, std::string>& roots);
+    static DependencyGraph fromLockfile(const Lockfile& lock);
+
+    size_t size() const { return nameId_.size(); }
+    size_t edgeCount() const { return targets_.size(); }
+
+    std::string_view name(NodeId node) const { return text(nameId_[node]); }
+    std::string_view version(NodeId node) const { return text(versionId_[node]); }
+    std::string key(NodeId node) const;
+
+    NodeId find(std::string_view name, std::string_view version) const;
+    // The versions of `name` that satisfy `range`, in version string order
+    std::vector<NodeId> versionsOf(std::string_view name, const std::string& range = "*") const;
+
+    Row dependencies(NodeId node) const { return row(offsets_, targets_, node); }
+    Row dependents(NodeId node) const { return row(reverseOffsets_, sources_, node); }
+    // Range behind the i-th dependency of `node`; empty when the edge was pinned
+    std::string_view range(NodeId node, size_t i) const { return text(ranges_[offsets_[node] + i]); }
+
+    const std::vector<NodeId>& roots() const { return roots_; }
+    bool isRoot(NodeId node) const;
+
+    struct Paths {
+        std::vector<std::vector<NodeId>> paths;  // root first, shorter chains first
+        uint64_t total = 0;                      // before `limit`; saturates
+    };
+    // For every root that reaches `node` in at most `maxDepth` steps, all of its shortest
+    // chains to it. Only the ancestors of `node` are visited.
+    Paths shortestPaths(NodeId node, size_t limit, size_t maxDepth = std::numeric_limits<size_t>::max()) const;
+    // Groups of nodes that depend on each other, directly or not, each sorted by ID
+    std::vector<std::vector<NodeId>> cycles() const;
+
+    // Bytes held by the graph, pool included
+    size_t memoryBytes() const;
+
+    // The arrays as they are in memory; deserialize() checks every ID and offset, so a
+    // damaged file gives nullopt rather than a graph that reads out of bounds
+    std::string serialize() const;
+    static std::optional<DependencyGraph> deserialize(std::string_view data);
+
+private:
+    std::string_view text(uint32_t id) const {
+        return std::string_view(pool_).substr(poolOffsets_[id], poolOffsets_[id + 1] - poolOffsets_[id]);
+    }
+    static Row row(const std::vector<uint32_t>& offsets, const std::vector<NodeId>& ids, NodeId node) {
+        return Row(ids.data() + offsets[node], ids.data() + offsets[node + 1]);
+    }
+
+    std::string pool_;                   // interned strings back to back; string 0 is ""
+    std::vector<uint32_t> poolOffsets_;  // string id -> start in pool_, plus the end
+    std::vector<uint32_t> nameId_;       // per node
+    std::vector<uint32_t> versionId_;
+    std::vector<uint32_t> offsets_;      // per node, plus the end: its run in targets_
+    std::vector<NodeId> targets_;
+    std::vector<uint32_t> ranges_;       // per edge, parallel to targets_
+    std::vector<uint32_t> reverseOffsets_;
+    std::vector<NodeId> sources_;
+    std::vector<NodeId> roots_;          // sorted
+};
+
+// Collects nodes and edges in any order; build() sorts, deduplicates and packs them
+class DependencyGraph::Builder {
+public:
+    // The same name and version always give the same (builder) ID
+    NodeId addNode(std::string_view name, std::string_view version);
+    void addEdge(NodeId from, NodeId to, std::string_view range = {});
+    void addRoot(NodeId node);
+
+    size_t size() const { return nodes_.size(); }
+    DependencyGraph build() const;
+
+private:
+    uint32_t intern(std::string_view text);
+
+    struct Edge {
+        NodeId from;
+        NodeId to;
+        uint32_t range;
+    };
+
+    std::vector<std::string> strings_{""};
+    std::unordered_map<std::string, uint32_t> stringIds_{{"", 0}};
+    std::vector<std::pair<uint32_t, uint32_t>> nodes_;  // name id, version id
+    std::unordered_map<uint64_t, NodeId> nodeIds_;      // (name id, version id) -> ID
+    std::vector<Edge> edges_;
+    std::vector<NodeId> roots_;
+};
+
+} // namespace amb
\ No newline at end of file
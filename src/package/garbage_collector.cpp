@@ -0,0 +1,375 @@
+#include "package/garbage_collector.hpp"
+#include "amb/version.hpp"
+#include "core/context.hpp"
+#include "core/lockfile.hpp"
+#include "core/project_registry.hpp"
+#include "core/scheduler.hpp"
+#include "core/workspace.hpp"
+#include "package/build_cache.hpp"
+#include "package/compressed_cache.hpp"
+#include "package/installer.hpp"
+#include "utils/file_lock.hpp"
+#include "utils/filesystem.hpp"
+#include "utils/logger.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <optional>
+#include <set>
+
+namespace amb {
+
+namespace {
+
+struct Candidate {
+    fs::path path;
+    bool version = false;  // an installed package version, deleted under its sibling lock
+    uint64_t bytes = 0;
+};
+
+uint64_t diskUsage(const fs::path& path) {
+    std::error_code ec;
+    if (fs::is_regular_file(fs::symlink_status(path, ec))) {
+        return fs::file_size(path, ec);
+    }
+    uint64_t total = 0;
+    for (fs::recursive_directory_iterator it(path, ec), end; !ec && it != end; it.increment(ec)) {
+        if (it->is_regular_file(ec) && !it->is_symlink(ec)) {
+            total += it->file_size(ec);
+        }
+    }
+    return total;
+}
+
+std::pair<std::string, std::string> splitKey(const std::string& key) {
+    auto at = key.rfind('@');
+    return {key.substr(0, at), key.substr(at + 1)};
+}
+
+// Package versions under `libDir` that `keep` rejects, plus leftovers of interrupted
+// installs and lock files of versions that are gone
+void collectLib(const fs::path& libDir, const fs::path& hooksDir,
+                const std::function<bool(const std::string&, const std::string&)>& keep,
+                std::vector<Candidate>& candidates) {
+    for (const auto& nameDir : FileSystem::listDirectories(libDir)) {
+        std::string name = FileSystem::filename(nameDir);
+        std::set<std::string> removed;
+        for (const auto& versionDir : FileSystem::listDirectories(nameDir)) {
+            std::string version = FileSystem::filename(versionDir);
+            if (version.starts_with(".")) {
+                candidates.push_back({versionDir});
+            } else if (!keep(name, version)) {
+                candidates.push_back({versionDir, true});
+                removed.insert(version);
+                std::string key = name + "@" + version;
+                for (const char* ext : {".json", ".log"}) {
+                    if (FileSystem::isFile(hooksDir / (key + ext))) {
+                        candidates.push_back({hooksDir / (key + ext)});
+                    }
+                }
+            }
+        }
+        // .<version>.lock files go after their version, so only orphans are collected here
+        for (const auto& file : FileSystem::listFiles(nameDir)) {
+            std::string filename = FileSystem::filename(file);
+            if (!filename.starts_with(".") || !filename.ends_with(".lock")) {
+                continue;
+            }
+            std::string version = filename.substr(1, filename.size() - 6);
+            if (!removed.count(version) && !FileSystem::isDirectory(nameDir / version)) {
+                candidates.push_back({file});
+            }
+        }
+    }
+}
+
+} // namespace
+
+GarbageCollector::GarbageCollector(Context& ctx) : ctx_(ctx) {}
+
+GcReport GarbageCollector::run(const GcOptions& options) {
+    GcReport report;
+    LockMode mode = options.dryRun ? LockMode::SHARED : LockMode::EXCLUSIVE;
+    fs::path cacheDir = ctx_.getCacheDir();
+    fs::path libDir = ctx_.getLibDir();
+
+    // Installs hold the cache lock shared for their whole fetch/extract phase
+    auto cacheGuard = FileLock::acquire(cacheDir / ".lock", mode);
+
+    ProjectRegistry registry(ctx_.getAmbRoot());
+    if (ctx_.isInsideProject()) {
+        registry.add(*ctx_.getProjectRoot());
+    }
+    if (ctx_.isInsideWorkspace()) {
+        registry.add(*ctx_.getWorkspaceRoot());
+    }
+    auto roots = options.dryRun ? registry.list() : registry.prune();
+
+    std::set<std::string> referenced;  // name@version
+    std::set<std::string> digests;
+    std::vector<Candidate> candidates;
+    std::vector<FileLock> projectGuards;
+
+    for (const auto& root : roots) {
+        // A workspace store is reachable through its members' locks; the workspace lock
+        // is what its installs hold while they write the store and those locks
+        if (FileSystem::isFile(root / Workspace::FILE_NAME)) {
+            auto workspace = Workspace::load(root);
+            if (!workspace || !FileSystem::isDirectory(workspace->storeDir())) {
+                continue;
+            }
+            auto guard = FileLock::tryAcquire(root / "ambar_modules" / ".lock", mode);
+            if (!guard) {
+                report.skipped.push_back(root.string() + " (in use)");
+                continue;
+            }
+            std::optional<Lockfile> pins = Lockfile{};
+            for (const auto& member : workspace->members) {
+                auto lock = FileSystem::isFile(member / "ambar.lock") ? Lockfile::load(member / "ambar.lock")
+                                                                     : std::nullopt;
+                if (!lock) {
+                    pins.reset();
+                    break;
+                }
+                pins->packages.insert(lock->packages.begin(), lock->packages.end());
+            }
+            if (!pins) {
+                report.skipped.push_back(root.string() + " (a member has no ambar.lock)");
+                continue;
+            }
+            for (const auto& [key, entry] : pins->packages) {
+                referenced.insert(key);
+                if (!entry.sha256.empty()) {
+                    digests.insert(entry.sha256);
+                }
+            }
+            projectGuards.push_back(std::move(*guard));
+            collectLib(workspace->storeDir(), root / "ambar_modules" / ".hooks",
+                       [&](const std::string& name, const std::string& version) {
+                return pins->find(name, version) != nullptr;
+            }, candidates);
+            continue;
+        }
+
+        if (!FileSystem::isFile(root / "ambar.json")) {
+            continue;
+        }
+        report.projects++;
+
+        // The lock is read under the project guard: read before it, an install could
+        // commit new pins in between and have them collected from its own lib
+        fs::path modules = root / "ambar_modules";
+        bool hasLib = FileSystem::isDirectory(modules / "lib");
+        std::optional<FileLock> guard;
+        if (hasLib) {
+            guard = FileLock::tryAcquire(modules / ".lock", mode);
+        }
+        std::optional<Lockfile> lock;
+        if (FileSystem::isFile(root / "ambar.lock")) {
+            lock = Lockfile::load(root / "ambar.lock");
+        }
+        // Pins of a project without a lib, or a busy one, only widen what is kept
+        // elsewhere; nothing is collected against them
+        if (lock) {
+            for (const auto& [key, entry] : lock->packages) {
+                referenced.insert(key);
+                if (!entry.sha256.empty()) {
+                    digests.insert(entry.sha256);
+                }
+            }
+        }
+
+        if (!hasLib) {
+            continue;
+        }
+        if (!guard) {
+            report.skipped.push_back(root.string() + " (in use)");
+            continue;
+        }
+        if (!lock) {
+            report.skipped.push_back(root.string() + " (no ambar.lock)");
+            continue;
+        }
+        projectGuards.push_back(std::move(*guard));
+        collectLib(modules / "lib", modules / ".hooks", [&](const std::string& name, const std::string& version) {
+            return lock->find(name, version) != nullptr;
+        }, candidates);
+    }
+    report.referenced = referenced.size();
+
+    // Global lib: pinned versions and the newest of each package stay
+    std::set<std::string> kept = referenced;
+    for (const auto& nameDir : FileSystem::listDirectories(libDir)) {
+        std::optional<std::pair<Version, std::string>> newest;
+        for (const auto& versionDir : FileSystem::listDirectories(nameDir)) {
+            std::string version = FileSystem::filename(versionDir);
+            if (!version.starts_with(".") && (!newest || newest->first < Version(version))) {
+                newest.emplace(Version(version), version);
+            }
+        }
+        if (newest) {
+            kept.insert(FileSystem::filename(nameDir) + "@" + newest->second);
+        }
+    }
+    collectLib(libDir, ctx_.getAmbRoot() / ".hooks", [&](const std::string& name, const std::string& version) {
+        return kept.count(name + "@" + version) > 0;
+    }, candidates);
+
+    // Cache: archives and deltas of kept versions
+    std::set<std::string> archives;
+    std::map<std::string, std::set<std::string>> keptVersions;
+    for (const auto& key : kept) {
+        auto [name, version] = splitKey(key);
+        archives.insert(FileSystem::filename(Installer::cachedArchive(cacheDir, name, version)));
+        keptVersions[name].insert(version);
+    }
+    auto keepDelta = [&](const std::string& filename) {
+        // <name>-<from>-<to>.delta; names may contain dashes, so try every split
+        std::string stem = filename.substr(0, filename.size() - 6);
+        auto dash = stem.rfind('-');
+        if (dash == std::string::npos) {
+            return false;
+        }
+        std::string to = stem.substr(dash + 1);
+        for (const auto& [name, versions] : keptVersions) {
+            if (stem.starts_with(name + "-") && versions.count(to)) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    std::set<std::string> removedFiles;
+    for (const auto& file : FileSystem::listFiles(cacheDir)) {
+        std::string filename = FileSystem::filename(file);
+        // <name>-<version>.zip.amz stands for its archive
+        bool packed = filename.ends_with(CompressedCache::EXTENSION);
+        std::string archive = packed ? fs::path(filename).stem().string() : filename;
+        bool garbage = (archive.ends_with(".zip") && !archives.count(archive)) ||
+                       (filename.ends_with(".delta") && !keepDelta(filename)) ||
+                       filename.ends_with(".part");
+        if (garbage) {
+            candidates.push_back({file});
+            removedFiles.insert(filename);
+            removedFiles.insert(archive);
+        }
+    }
+    for (const auto& file : FileSystem::listFiles(cacheDir)) {
+        std::string filename = FileSystem::filename(file);
+        if (filename == ".lock" || !filename.ends_with(".lock")) {
+            continue;
+        }
+        // <file>.lock from the fetcher, or .<file>.lock from FileLock::siblingLockPath
+        // (e.g. the dictionary's)
+        std::string target = filename.substr(0, filename.size() - 5);
+        if (target.starts_with(".") && fs::exists(cacheDir / target.substr(1))) {
+            target.erase(0, 1);
+        }
+        bool present = fs::exists(cacheDir / target) ||
+                       fs::exists(CompressedCache::packedPath(cacheDir / target));
+        if (removedFiles.count(target) || !present) {
+            candidates.push_back({file});
+        }
+    }
+
+    // Signature verdicts and builds are keyed by digest
+    for (const auto& file : FileSystem::listFiles(cacheDir / "signatures")) {
+        if (!digests.count(FileSystem::filename(file))) {
+            candidates.push_back({file});
+        }
+    }
+    fs::path builds = cacheDir / "builds";
+    if (FileSystem::isDirectory(builds)) {
+        auto buildsGuard = FileLock::tryAcquire(builds / ".lock", mode);
+        if (!buildsGuard) {
+            report.skipped.push_back(builds.string() + " (in use)");
+        } else {
+            std::set<std::string> removedBuilds;
+            for (const auto& dir : FileSystem::listDirectories(builds)) {
+                std::string filename = FileSystem::filename(dir);
+                std::string digest = BuildCache::entryDigest(dir);
+                // Entries written before digests were recorded are left to the LRU bound
+                if (filename.starts_with(".") || (!digest.empty() && !digests.count(digest))) {
+                    candidates.push_back({dir});
+                    removedBuilds.insert(filename);
+                }
+            }
+            for (const auto& file : FileSystem::listFiles(builds)) {
+                std::string filename = FileSystem::filename(file);
+                if (filename.starts_with(".") && filename.ends_with(".lock") && filename != ".lock") {
+                    std::string target = filename.substr(1, filename.size() - 6);
+                    // stats.json is a file with a sibling lock of its own
+                    if (removedBuilds.count(target) || !fs::exists(builds / target)) {
+                        candidates.push_back({file});
+                    }
+                }
+            }
+            // Held until the deletions below are done
+            projectGuards.push_back(std::move(*buildsGuard));
+        }
+    }
+
+    // Sizing and deleting are both dominated by metadata syscalls over many small
+    // files, so both fan out over the scheduler
+    parallelFor(ctx_.scheduler(), candidates.size(), [&](size_t i) {
+        candidates[i].bytes = diskUsage(candidates[i].path);
+    }, TaskPriority::HIGH);
+
+    std::vector<char> done(candidates.size(), 0);
+    if (options.dryRun) {
+        std::fill(done.begin(), done.end(), 1);
+    } else {
+        parallelFor(ctx_.scheduler(), candidates.size(), [&](size_t i) {
+            const auto& candidate = candidates[i];
+            if (!candidate.version) {
+                done[i] = FileSystem::isDirectory(candidate.path) ? FileSystem::removeDirectories(candidate.path)
+                                                                  : FileSystem::removeFile(candidate.path);
+                return;
+            }
+            // A reader (delta base, tree copy) holds the version shared
+            fs::path lockPath = FileLock::siblingLockPath(candidate.path);
+            auto guard = FileLock::tryAcquire(lockPath, LockMode::EXCLUSIVE);
+            if (!guard) {
+                return;
+            }
+            done[i] = FileSystem::removeDirectories(candidate.path);
+            if (done[i]) {
+                FileSystem::removeFile(lockPath);
+            }
+        }, TaskPriority::HIGH);
+    }
+
+    std::set<fs::path> parents;
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        const auto& candidate = candidates[i];
+        if (!done[i]) {
+            report.skipped.push_back(candidate.path.string() + " (in use)");
+            continue;
+        }
+        if (candidate.version) {
+            report.versions++;
+            parents.insert(candidate.path.parent_path());
+        } else {
+            report.cacheEntries++;
+        }
+        report.bytes += candidate.bytes;
+        report.removed.emplace_back(candidate.path, candidate.bytes);
+    }
+
+    // <lib>/<name> directories left empty
+    if (!options.dryRun) {
+        for (const auto& parent : parents) {
+            std::error_code ec;
+            if (fs::is_empty(parent, ec) && !ec) {
+                fs::remove(parent, ec);
+                FileSystem::invalidate(parent);
+            }
+        }
+    }
+
+    std::sort(report.removed.begin(), report.removed.end());
+    return report;
+}
+
+} // namespace amb
\ No newline at end of file
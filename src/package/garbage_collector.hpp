@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace amb {
+
+namespace fs = std::filesystem;
+
+class Context;
+
+struct GcOptions {
+    bool dryRun = false;   // report what would be removed without touching anything
+};
+
+struct GcReport {
+    size_t projects = 0;     // registered projects whose lockfiles were read
+    size_t referenced = 0;   // distinct name@version pins across those lockfiles
+    size_t versions = 0;     // installed package versions removed (or removable)
+    size_t cacheEntries = 0; // archives, deltas, builds, verdicts and stale lock files
+    uint64_t bytes = 0;      // reclaimed (or reclaimable)
+    std::vector<std::pair<fs::path, uint64_t>> removed;  // path -> bytes
+    std::vector<std::string> skipped;                    // left alone because in use
+};
+
+// `amb gc`: reclaims what no registered project references (core/project_registry.hpp).
+// The reachability set is the union of the pins in every registered ambar.lock:
+//   - a project's ambar_modules/lib keeps only the versions its own lockfile pins
+//   - a workspace store keeps the versions pinned by any member's lockfile
+//   - ~/.ambar/lib keeps pinned versions plus the newest version of each package,
+//     which is what a bare global import resolves to
+//   - the cache keeps archives and deltas of kept versions, builds and signature
+//     verdicts of pinned digests
+// Interrupted staging directories, partial downloads and lock files whose target is
+// gone are removed too. The cache lock is held exclusively, so no install runs
+// meanwhile; projects and build entries that are busy are skipped, not waited for.
+class GarbageCollector {
+public:
+    explicit GarbageCollector(Context& ctx);
+
+    GcReport run(const GcOptions& options);
+
+private:
+    Context& ctx_;
+};
+
+} // namespace amb
\ No newline at end of file
@@ -0,0 +1,246 @@
+#include "package/hook_runner.hpp"
+#include "amb/config.hpp"
+#include "core/context.hpp"
+#include "core/manifest.hpp"
+#include "core/scheduler.hpp"
+#include "package/build_cache.hpp"
+#include "utils/filesystem.hpp"
+#include "utils/logger.hpp"
+#include "utils/process.hpp"
+#include "json.hpp"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <semaphore>
+
+using json = nlohmann::json;
+
+namespace amb {
+
+namespace {
+
+struct Node {
+    const LockEntry* entry = nullptr;
+    fs::path dir;
+    std::vector<std::pair<std::string, std::string>> hooks;  // hook -> command, in run order
+    std::vector<size_t> dependents;
+    std::atomic<size_t> waiting{0};     // dependencies whose hooks have not finished
+    std::atomic<bool> blocked{false};   // a dependency failed
+    std::atomic<bool> started{false};
+};
+
+// The last successful run recorded for a package, if it ran against `sha256`
+bool upToDate(const fs::path& stamp, const std::string& sha256) {
+    if (sha256.empty()) {
+        return false;
+    }
+    auto content = FileSystem::readFile(stamp);
+    if (!content) {
+        return false;
+    }
+    auto j = json::parse(*content, nullptr, false);
+    return !j.is_discarded() && j.value("sha256", "") == sha256 && j.value("ok", false);
+}
+
+} // namespace
+
+HookRunner::HookRunner(Context& ctx, const fs::path& libDir)
+    : ctx_(ctx), libDir_(libDir), stateDir_(libDir.parent_path() / ".hooks") {}
+
+bool HookRunner::run(const std::map<std::string, LockEntry>& packages) {
+    report_ = HookReport{};
+
+    std::vector<std::unique_ptr<Node>> nodes;
+    std::map<std::string, size_t> byKey;
+    for (const auto& [key, entry] : packages) {
+        auto node = std::make_unique<Node>();
+        node->entry = &entry;
+        node->dir = libDir_ / entry.name / entry.version;
+        if (auto manifest = Manifest::load(node->dir / "ambar.json")) {
+            for (const char* hook : HOOKS) {
+                auto it = manifest->scripts.find(hook);
+                if (it != manifest->scripts.end() && !it->second.empty()) {
+                    node->hooks.emplace_back(hook, it->second);
+                }
+            }
+        }
+        byKey[entry.key()] = nodes.size();
+        nodes.push_back(std::move(node));
+    }
+
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        for (const auto& [name, version] : nodes[i]->entry->dependencies) {
+            auto it = byKey.find(name + "@" + version);
+            if (it != byKey.end() && it->second != i) {
+                nodes[it->second]->dependents.push_back(i);
+                nodes[i]->waiting++;
+            }
+        }
+        if (!nodes[i]->hooks.empty()) {
+            report_.packages++;
+        }
+    }
+    if (report_.packages == 0) {
+        return true;
+    }
+    FileSystem::createDirectories(stateDir_);
+
+    // Hooks block on child processes; the semaphore keeps them to --jobs even though the
+    // thread waiting on the group helps run tasks too
+    std::counting_semaphore<> slots(static_cast<std::ptrdiff_t>(ctx_.getJobs()));
+    std::mutex reportMutex;
+
+    const auto& config = ConfigManager::instance().config();
+    BuildCache buildCache(ctx_.getCacheDir() / "builds", config.buildCacheMaxMb * 1024 * 1024);
+    std::string toolchain;
+    for (const auto& node : nodes) {
+        for (const auto& [hook, _] : node->hooks) {
+            if (hook == "build" && toolchain.empty()) {
+                toolchain = BuildCache::fingerprint(config.compiler, config.compilerFlags);
+            }
+        }
+    }
+
+    auto runHooks = [&](Node& node) {
+        const auto& entry = *node.entry;
+        if (node.hooks.empty()) {
+            return true;
+        }
+        fs::path stamp = stateDir_ / (entry.key() + ".json");
+        fs::path log = stateDir_ / (entry.key() + ".log");
+        if (upToDate(stamp, entry.sha256)) {
+            Logger::debug("Hooks of {} already ran for this digest", entry.key());
+            std::lock_guard<std::mutex> lock(reportMutex);
+            report_.skipped++;
+            return true;
+        }
+
+        FileSystem::writeFile(log, "");
+        FileSystem::removeFile(stamp);
+        json record = {{"sha256", entry.sha256}, {"ok", false}, {"hooks", json::object()}};
+        bool ok = true;
+
+        std::map<std::string, std::string> env = {
+            {"AMB_PACKAGE_NAME", entry.name},
+            {"AMB_PACKAGE_VERSION", entry.version},
+            {"AMB_PACKAGE_DIR", node.dir.string()},
+            {"AMB_COMPILER", config.compiler},
+            {"AMB_COMPILER_FLAGS", config.compilerFlags},
+        };
+        for (const auto& [hook, command] : node.hooks) {
+            env["AMB_HOOK"] = hook;
+
+            // Builds are keyed by digest and toolchain; without a digest there is no key
+            bool cacheable = hook == "build" && !entry.sha256.empty();
+            std::string cacheKey = cacheable ? BuildCache::key(entry.sha256, toolchain) : "";
+            if (cacheable && buildCache.restore(cacheKey, node.dir)) {
+                Logger::debug("{} build restored from the build cache", entry.key());
+                FileSystem::appendFile(log, "> " + hook + ": restored from the build cache\n");
+                record["hooks"][hook] = {{"exit", 0}, {"ms", 0}, {"cached", true}};
+                std::lock_guard<std::mutex> lock(reportMutex);
+                report_.buildsCached++;
+                continue;
+            }
+            BuildCache::Snapshot before;
+            if (cacheable) {
+                before = BuildCache::snapshot(node.dir);
+            }
+            FileSystem::appendFile(log, "> " + hook + ": " + command + "\n");
+
+            slots.acquire();
+            auto result = Process::runShell(command, node.dir, log, env);
+            slots.release();
+
+            if (cacheable && result.exitCode == 0) {
+                buildCache.store(cacheKey, node.dir, before, entry.sha256);
+                std::lock_guard<std::mutex> lock(reportMutex);
+                report_.buildsMissed++;
+            }
+
+            Logger::debug("{} {}: exit {} in {}ms", entry.key(), hook, result.exitCode,
+                          result.duration.count());
+            record["hooks"][hook] = {{"exit", result.exitCode}, {"ms", result.duration.count()}};
+            {
+                std::lock_guard<std::mutex> lock(reportMutex);
+                report_.ran++;
+                report_.timings.push_back({entry.key(), hook, result.exitCode, result.duration});
+            }
+            if (result.exitCode != 0) {
+                Logger::error("{} hook of {} failed with exit code {} (see {})", hook, entry.key(),
+                              result.exitCode, log.string());
+                ok = false;
+                break;
+            }
+        }
+
+        record["ok"] = ok;
+        FileSystem::writeFile(stamp, record.dump(2));
+        if (!ok) {
+            std::lock_guard<std::mutex> lock(reportMutex);
+            report_.failed++;
+        }
+        return ok;
+    };
+
+    TaskGroup group(ctx_.scheduler());
+    std::function<void(size_t)> launch = [&](size_t index) {
+        nodes[index]->started = true;
+        group.run([&, index] {
+            auto& node = *nodes[index];
+            bool ok = false;
+            if (node.blocked) {
+                if (!node.hooks.empty()) {
+                    Logger::warning("Skipping hooks of {}: a dependency's hooks failed", node.entry->key());
+                    std::lock_guard<std::mutex> lock(reportMutex);
+                    report_.blocked++;
+                }
+            } else {
+                ok = runHooks(node);
+            }
+            // Dependents are released as soon as this package is done, not per level
+            for (size_t dependent : node.dependents) {
+                if (!ok) {
+                    nodes[dependent]->blocked = true;
+                }
+                if (--nodes[dependent]->waiting == 0) {
+                    launch(dependent);
+                }
+            }
+        });
+    };
+
+    // Roots are collected before any task runs: finished tasks decrement `waiting` and
+    // would otherwise make a dependent look like a root and launch it twice
+    std::vector<size_t> roots;
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        if (nodes[i]->waiting == 0) {
+            roots.push_back(i);
+        }
+    }
+    for (size_t root : roots) {
+        launch(root);
+    }
+    group.wait();
+
+    // Packages on a dependency cycle never become ready; run them one by one in key order
+    for (auto& node : nodes) {
+        if (!node->started) {
+            Logger::warning("{} is part of a dependency cycle, running its hooks unordered",
+                            node->entry->key());
+            node->started = true;
+            runHooks(*node);
+        }
+    }
+
+    if (report_.buildsCached > 0 || report_.buildsMissed > 0) {
+        buildCache.evict();
+        auto totals = buildCache.saveStats();
+        Logger::debug("Build cache: {} hit(s), {} miss(es) this run; {} hit(s), {} miss(es), {} evicted overall",
+                      report_.buildsCached, report_.buildsMissed, totals.hits, totals.misses, totals.evicted);
+    }
+
+    return report_.failed == 0 && report_.blocked == 0;
+}
+
+} // namespace amb
\ No newline at end of file
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "core/lockfile.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace amb {
+
+namespace fs = std::filesystem;
+
+class Context;
+
+struct HookTiming {
+    std::string package;   // name@version
+    std::string hook;
+    int exitCode = 0;
+    std::chrono::milliseconds duration{0};
+};
+
+struct HookReport {
+    size_t packages = 0;   // packages declaring at least one hook
+    size_t ran = 0;        // hooks executed
+    size_t skipped = 0;    // packages whose digest matched their last successful run
+    size_t failed = 0;     // packages with a failing hook
+    size_t blocked = 0;    // not run because a dependency's hooks failed
+    size_t buildsCached = 0;  // build hooks replaced by a build-cache hit
+    size_t buildsMissed = 0;  // build hooks that ran and were offered to the cache
+    std::vector<HookTiming> timings;
+};
+
+// Runs the manifest scripts (pre_install, build, post_install, in that order) of
+// installed packages. Packages form a DAG through their lockfile dependencies: a
+// package's hooks start once every dependency's hooks succeeded, and independent
+// packages run concurrently, at most Context::getJobs() processes at a time.
+//
+// Output of each package goes to <state>/<name>@<version>.log next to a stamp file
+// recording the package digest and hook durations; a package whose digest matches its
+// last successful run is skipped. `build` hooks go through the BuildCache: outputs of a
+// package built with the same toolchain by another project are linked in instead.
+class HookRunner {
+public:
+    static constexpr const char* HOOKS[] = {"pre_install", "build", "post_install"};
+
+    // `libDir` holds <name>/<version>; state and logs go to <libDir>/../.hooks
+    HookRunner(Context& ctx, const fs::path& libDir);
+
+    // False if any hook failed
+    bool run(const std::map<std::string, LockEntry>& packages);
+
+    const HookReport& report() const { return report_; }
+    const fs::path& stateDir() const { return stateDir_; }
+
+private:
+    Context& ctx_;
+    fs::path libDir_;
+    fs::path stateDir_;
+    HookReport report_;
+};
+
+} // namespace amb
\ No newline at end of file
@@ -0,0 +1,249 @@
+#include "package/install_plan.hpp"
+#include "core/output.hpp"
+#include "package/throughput_stats.hpp"
+#include "utils/filesystem.hpp"
+#include "utils/logger.hpp"
+#include "utils/sha256.hpp"
+#include "json.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+using json = nlohmann::json;
+
+namespace amb {
+
+namespace {
+
+constexpr PlanAction ACTIONS[] = {
+    PlanAction::REUSE, PlanAction::COPY, PlanAction::CACHE_HIT, PlanAction::FETCH,
+    PlanAction::DELTA, PlanAction::EXTRACT, PlanAction::HOOK,
+};
+
+std::optional<PlanAction> actionFromString(const std::string& text) {
+    for (auto action : ACTIONS) {
+        if (text == toString(action)) {
+            return action;
+        }
+    }
+    return std::nullopt;
+}
+
+std::string formatSeconds(double seconds) {
+    char text[32];
+    std::snprintf(text, sizeof(text), seconds < 10 ? "%.1f s" : "%.0f s", seconds);
+    return text;
+}
+
+} // namespace
+
+const char* toString(PlanAction action) {
+    switch (action) {
+        case PlanAction::REUSE: return "reuse";
+        case PlanAction::COPY: return "copy";
+        case PlanAction::CACHE_HIT: return "cache-hit";
+        case PlanAction::FETCH: return "fetch";
+        case PlanAction::DELTA: return "delta";
+        case PlanAction::EXTRACT: return "extract";
+        case PlanAction::HOOK: return "hook";
+    }
+    return "unknown";
+}
+
+void InstallPlan::estimate(const ThroughputStats& stats, size_t jobs) {
+    downloadBytes = 0;
+    writeBytes = 0;
+    double ioSeconds = 0;
+    double hookSeconds = 0;
+    size_t hooks = 0;
+
+    for (auto& step : steps) {
+        auto download = static_cast<double>(step.downloadBytes);
+        auto write = static_cast<double>(step.writeBytes);
+        switch (step.action) {
+            case PlanAction::FETCH:
+                step.seconds = download / stats.downloadBytesPerSecond;
+                break;
+            case PlanAction::DELTA:
+                step.seconds = download / stats.downloadBytesPerSecond + write / stats.extractBytesPerSecond;
+                break;
+            case PlanAction::EXTRACT:
+                step.seconds = write / stats.extractBytesPerSecond;
+                break;
+            case PlanAction::COPY:
+                step.seconds = write / stats.copyBytesPerSecond;
+                break;
+            case PlanAction::HOOK:
+                // Keeps the duration recorded by the package's last run, when there was one
+                if (step.seconds <= 0) {
+                    step.seconds = stats.hookSeconds;
+                }
+                break;
+            case PlanAction::REUSE:
+            case PlanAction::CACHE_HIT:
+                step.seconds = 0;
+                break;
+        }
+        downloadBytes += step.downloadBytes;
+        writeBytes += step.writeBytes;
+        if (step.action == PlanAction::HOOK) {
+            hookSeconds += step.seconds;
+            hooks++;
+        } else {
+            ioSeconds += step.seconds;
+        }
+    }
+
+    // The measured rates already are aggregates over parallel work; hooks are timed one
+    // process at a time
+    estimatedSeconds = ioSeconds + hookSeconds / static_cast<double>(std::max<size_t>(1, std::min(jobs, hooks)));
+}
+
+std::string InstallPlan::serialize() const {
+    json list = json::array();
+    for (const auto& step : steps) {
+        json s = {
+            {"action", toString(step.action)},
+            {"package", step.package},
+            {"download_bytes", step.downloadBytes},
+            {"write_bytes", step.writeBytes},
+            {"seconds", step.seconds},
+        };
+        if (!step.detail.empty()) {
+            s["detail"] = step.detail;
+        }
+        list.push_back(std::move(s));
+    }
+
+    json j = {
+        {"plan_version", FORMAT_VERSION},
+        {"command", command},
+        {"global", global},
+        {"run_scripts", runScripts},
+        {"registry_url", registryUrl},
+        {"project_digest", projectDigest},
+        {"manifest_dependencies", manifestDependencies},
+        {"lock", json::parse(lock.serialize())},
+        {"steps", std::move(list)},
+        {"unknown_hooks", unknownHooks},
+        {"download_bytes", downloadBytes},
+        {"write_bytes", writeBytes},
+        {"estimated_seconds", estimatedSeconds},
+    };
+    return j.dump(2) + "\n";
+}
+
+std::optional<InstallPlan> InstallPlan::parse(const std::string& content) {
+    try {
+        auto j = json::parse(content);
+        if (j.value("plan_version", 0) != FORMAT_VERSION) {
+            Logger::error("Unsupported plan version {}", j.value("plan_version", 0));
+            return std::nullopt;
+        }
+
+        InstallPlan plan;
+        plan.command = j.at("command").get<std::string>();
+        plan.global = j.value("global", false);
+        plan.runScripts = j.value("run_scripts", false);
+        plan.registryUrl = j.at("registry_url").get<std::string>();
+        plan.projectDigest = j.value("project_digest", "");
+        plan.manifestDependencies =
+            j.value("manifest_dependencies", std::map<std::string, std::string>{});
+
+        auto lock = Lockfile::parse(j.at("lock").dump());
+        if (!lock) {
+            return std::nullopt;
+        }
+        plan.lock = std::move(*lock);
+
+        for (const auto& s : j.value("steps", json::array())) {
+            auto action = actionFromString(s.value("action", ""));
+            if (!action) {
+                Logger::warning("Skipping plan step with unknown action '{}'", s.value("action", ""));
+                continue;
+            }
+            PlanStep step;
+            step.action = *action;
+            step.package = s.value("package", "");
+            step.detail = s.value("detail", "");
+            step.downloadBytes = s.value("download_bytes", uint64_t{0});
+            step.writeBytes = s.value("write_bytes", uint64_t{0});
+            step.seconds = s.value("seconds", 0.0);
+            plan.steps.push_back(std::move(step));
+        }
+        plan.unknownHooks = j.value("unknown_hooks", size_t{0});
+        plan.downloadBytes = j.value("download_bytes", uint64_t{0});
+        plan.writeBytes = j.value("write_bytes", uint64_t{0});
+        plan.estimatedSeconds = j.value("estimated_seconds", 0.0);
+        return plan;
+
+    } catch (const std::exception& e) {
+        Logger::error("Invalid install plan: {}", e.what());
+        return std::nullopt;
+    }
+}
+
+std::optional<InstallPlan> InstallPlan::load(const fs::path& path) {
+    auto content = FileSystem::readFile(path);
+    if (!content) {
+        Logger::error("Cannot read plan {}", path.string());
+        return std::nullopt;
+    }
+    return parse(*content);
+}
+
+bool InstallPlan::save(const fs::path& path) const {
+    return FileSystem::writeFile(path, serialize());
+}
+
+void InstallPlan::print() const {
+    size_t reused = 0;
+    for (const auto& step : steps) {
+        if (step.action == PlanAction::REUSE) {
+            reused++;
+            continue;
+        }
+        std::string bytes = step.downloadBytes > 0 ? FileSystem::formatSize(step.downloadBytes) + " down"
+                          : step.writeBytes > 0 ? FileSystem::formatSize(step.writeBytes) + " written"
+                          : "";
+        std::string package = step.package + (step.detail.empty() ? "" : " (" + step.detail + ")");
+        char line[160];
+        std::snprintf(line, sizeof(line), "  %-10s %-40s %16s %10s", toString(step.action), package.c_str(),
+                      bytes.c_str(), step.seconds >= 0.05 ? ("~" + formatSeconds(step.seconds)).c_str() : "");
+        Output::emit(Event("plan.step", line)
+                         .with("action", toString(step.action))
+                         .with("package", step.package)
+                         .with("detail", step.detail)
+                         .with("download_bytes", step.downloadBytes)
+                         .with("write_bytes", step.writeBytes)
+                         .with("seconds", step.seconds));
+    }
+    Event summary("plan.summary");
+    if (reused > 0) {
+        summary.text += "  " + std::to_string(reused) + " package(s) already installed\n";
+    }
+    if (unknownHooks > 0) {
+        summary.text += "  hooks of " + std::to_string(unknownHooks) + " package(s) are only known once fetched\n";
+    }
+    summary.text += "Plan: " + std::to_string(lock.packages.size()) + " package(s), download " +
+                    FileSystem::formatSize(downloadBytes) + ", write " + FileSystem::formatSize(writeBytes) +
+                    ", estimated " + formatSeconds(estimatedSeconds);
+    Output::emit(summary.with("packages", lock.packages.size())
+                     .with("reused", reused)
+                     .with("unknown_hooks", unknownHooks)
+                     .with("download_bytes", downloadBytes)
+                     .with("write_bytes", writeBytes)
+                     .with("seconds", estimatedSeconds));
+}
+
+std::string InstallPlan::digestProject(const fs::path& root) {
+    Sha256 hasher;
+    for (const char* file : {"ambar.json", "ambar.lock"}) {
+        auto content = FileSystem::readFile(root / file).value_or("");
+        hasher.update(std::string(file) + ":" + std::to_string(content.size()) + "\n");
+        hasher.update(content);
+    }
+    return hasher.hexDigest();
+}
+
+} // namespace amb
\ No newline at end of file
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "core/lockfile.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace amb {
+
+namespace fs = std::filesystem;
+
+struct ThroughputStats;
+
+enum class PlanAction {
+    REUSE,      // already installed in the target lib dir
+    COPY,       // tree copy from the global lib dir
+    CACHE_HIT,  // archive already in the cache
+    FETCH,      // full archive download
+    DELTA,      // delta download applied to an installed or cached version
+    EXTRACT,    // archive unpacked into the lib dir
+    HOOK,       // pre_install/build/post_install script
+};
+
+const char* toString(PlanAction action);
+
+struct PlanStep {
+    PlanAction action = PlanAction::REUSE;
+    std::string package;         // name@version
+    std::string detail;          // delta base version or hook name
+    uint64_t downloadBytes = 0;
+    uint64_t writeBytes = 0;     // estimated from the archive size, archives are mostly stored
+    double seconds = 0;          // estimate from ThroughputStats
+};
+
+// What `amb install/update --plan` computed: the exact resolution plus the actions it
+// implies. Executing a plan installs that resolution without resolving again; each
+// package's action is re-derived from the disk at that point, so work done in the
+// meantime (a newly cached archive) is not repeated.
+struct InstallPlan {
+    static constexpr int FORMAT_VERSION = 1;
+
+    std::string command;                     // "install" or "update"
+    bool global = false;
+    bool runScripts = false;
+    std::string registryUrl;
+    // Digest of ambar.json and ambar.lock when planned; a plan for a project that
+    // changed since is stale and refused
+    std::string projectDigest;
+    std::map<std::string, std::string> manifestDependencies;  // ranges to record in ambar.json
+    Lockfile lock;                           // the resolution: roots and packages
+
+    std::vector<PlanStep> steps;
+    size_t unknownHooks = 0;  // packages whose hooks are only known once fetched
+    uint64_t downloadBytes = 0;
+    uint64_t writeBytes = 0;
+    double estimatedSeconds = 0;
+
+    // Fills in step durations and the totals; up to `jobs` hook processes run at once
+    void estimate(const ThroughputStats& stats, size_t jobs);
+
+    std::string serialize() const;
+    static std::optional<InstallPlan> parse(const std::string& content);
+    static std::optional<InstallPlan> load(const fs::path& path);
+    bool save(const fs::path& path) const;
+
+    void print() const;
+
+    // Digest of the project's ambar.json and ambar.lock as they are now
+    static std::string digestProject(const fs::path& root);
+};
+
+} // namespace amb
\ No newline at end of file
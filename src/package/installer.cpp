@@ -0,0 +1,1371 @@
+#include "package/installer.hpp"
+#include "amb/config.hpp"
+#include "amb/resolution_table.hpp"
+#include "amb/version.hpp"
+#include "core/context.hpp"
+#include "core/output.hpp"
+#include "core/project_registry.hpp"
+#include "core/scheduler.hpp"
+#include "package/compressed_cache.hpp"
+#include "package/lock_graph.hpp"
+#include "package/resolution_table.hpp"
+#include "package/throughput_stats.hpp"
+#include "registry/delta.hpp"
+#include "registry/registry_index.hpp"
+#include "registry/snapshot_bundle.hpp"
+#include "utils/archive.hpp"
+#include "utils/error.hpp"
+#include "utils/file_lock.hpp"
+#include "utils/filesystem.hpp"
+#include "utils/logger.hpp"
+#include "utils/sha256.hpp"
+#include "json.hpp"
+
+#include <chrono>
+#include <functional>
+#include <set>
+
+using json = nlohmann::json;
+
+namespace amb {
+
+namespace {
+
+// Builds a package directory next to `target` and renames it into place, under the
+// per-version lock so concurrent amb processes never interleave on one target.
+// Returns true without building when another process finished it first, unless
+// `replace` asks for an existing directory to be swapped out for the new build.
+bool materialize(const fs::path& target, const std::function<bool(const fs::path&)>& build,
+                 bool replace = false) {
+    auto guard = FileLock::acquire(FileLock::siblingLockPath(target), LockMode::EXCLUSIVE);
+    if (!replace && FileSystem::isDirectory(target)) {
+        return true;
+    }
+
+    fs::path staging = target.parent_path() / ("." + target.filename().string() + ".tmp");
+    FileSystem::removeDirectories(staging);
+    if (!build(staging)) {
+        FileSystem::removeDirectories(staging);
+        return false;
+    }
+
+    // The old tree is moved aside rather than deleted first, so the live path only
+    // ever holds a complete package
+    fs::path old = target.parent_path() / ("." + target.filename().string() + ".old");
+    std::error_code ec;
+    if (replace && FileSystem::isDirectory(target)) {
+        FileSystem::removeDirectories(old);
+        fs::rename(target, old, ec);
+        FileSystem::invalidate(target);
+        FileSystem::invalidate(old);
+    }
+    if (!ec) {
+        fs::rename(staging, target, ec);
+    }
+    FileSystem::invalidate(staging);
+    FileSystem::invalidate(target);
+    FileSystem::removeDirectories(old);
+    if (ec) {
+        Logger::error("Failed to move {} into place: {}", target.string(), ec.message());
+        FileSystem::removeDirectories(staging);
+        return false;
+    }
+    return true;
+}
+
+// Keeps an installed version from being replaced or removed while it is read
+std::optional<FileLock> readLock(const fs::path& packageDir) {
+    if (packageDir.empty() || !FileSystem::isDirectory(packageDir)) {
+        return std::nullopt;
+    }
+    return FileLock::acquire(FileLock::siblingLockPath(packageDir), LockMode::SHARED);
+}
+
+// ambar.lock and ambar.json are replaced through a small redo journal: both are staged
+// and synced under ambar_modules/.txn, then a COMMIT marker is synced and the files are
+// renamed into place. A crash before the marker keeps the old pair; one after it is
+// rolled forward by the next command that takes the project lock.
+constexpr const char* TXN_DIR = ".txn";
+constexpr const char* TXN_COMMIT = "COMMIT";
+
+bool finishTransaction(const fs::path& root) {
+    fs::path txn = root / "ambar_modules" / TXN_DIR;
+    if (!FileSystem::isDirectory(txn)) {
+        return true;
+    }
+    if (FileSystem::isFile(txn / TXN_COMMIT)) {
+        for (const char* name : {"ambar.lock", "ambar.json"}) {
+            if (!FileSystem::isFile(txn / name)) {
+                continue;  // moved before an earlier interruption
+            }
+            std::error_code ec;
+            fs::rename(txn / name, root / name, ec);
+            FileSystem::invalidate(txn / name);
+            FileSystem::invalidate(root / name);
+            if (ec) {
+                Logger::error("Failed to move {} into place: {}", name, ec.message());
+                return false;
+            }
+        }
+    }
+    FileSystem::removeDirectories(txn);
+    return true;
+}
+
+bool commitProjectFiles(const fs::path& root, const std::vector<FileWrite>& files) {
+    fs::path txn = root / "ambar_modules" / TXN_DIR;
+    FileSystem::removeDirectories(txn);
+
+    std::vector<FileWrite> staged;
+    for (const auto& file : files) {
+        staged.push_back({txn / file.path.filename(), file.content});
+    }
+    if (!FileSystem::writeFiles(staged, true) ||
+        !FileSystem::writeFiles({{txn / TXN_COMMIT, ""}}, true)) {
+        FileSystem::removeDirectories(txn);
+        return false;
+    }
+    return finishTransaction(root);
+}
+
+Lockfile lockOf(const Resolution& resolution) {
+    Lockfile lock;
+    lock.dependencies = resolution.roots;
+    lock.packages = resolution.packages;
+    lock.indexDependents();
+    return lock;
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// What ambar.json records for a spec once it resolved to `version`
+std::string manifestRange(const PackageSpec& spec, const std::string& version) {
+    return spec.range == "latest" ? "^" + version : spec.range;
+}
+
+void printInstalled(const InstallReport& report) {
+    std::string text = "Installed " + std::to_string(report.installed) + " package(s)";
+    if (report.reused > 0) {
+        text += ", " + std::to_string(report.reused) + " already present";
+    }
+    Output::emit(Event("install.done", text)
+                     .with("installed", report.installed)
+                     .with("reused", report.reused)
+                     .with("copied", report.copied)
+                     .with("via_delta", report.viaDelta)
+                     .with("from_snapshot", report.fromSnapshot)
+                     .with("unpacked", report.unpacked)
+                     .with("packed", report.packed)
+                     .with("downloaded", report.fetch.downloaded)
+                     .with("cached", report.fetch.cached)
+                     .with("bytes", report.fetch.bytes));
+}
+
+// Nothing to do: an install.done event with nothing installed
+void printNothing(const std::string& text, size_t reused) {
+    Output::emit(Event("install.done", text).with("installed", 0).with("reused", reused));
+}
+
+// The manifest of a package that is installed or cached, without fetching anything
+std::optional<Manifest> localManifest(const std::vector<fs::path>& dirs, const fs::path& archive) {
+    for (const auto& dir : dirs) {
+        if (FileSystem::isFile(dir / "ambar.json")) {
+            return Manifest::load(dir / "ambar.json");
+        }
+    }
+    ZipReader reader;
+    if (!FileSystem::isFile(archive) || !reader.open(archive)) {
+        return std::nullopt;
+    }
+    const auto* entry = reader.find("ambar.json");
+    auto content = entry ? reader.read(*entry) : std::nullopt;
+    return content ? Manifest::parse(*content) : std::nullopt;
+}
+
+// The lock pins a version of every root within its range and each of them is installed
+bool isSatisfied(const Lockfile& lock, const std::map<std::string, std::string>& roots,
+                 const fs::path& libDir) {
+    if (lock.dependencies.size() != roots.size()) {
+        return false;
+    }
+    for (const auto& [name, range] : roots) {
+        auto it = lock.dependencies.find(name);
+        if (it == lock.dependencies.end() || !Version(it->second).satisfies(range)) {
+            return false;
+        }
+    }
+    for (const auto& [_, entry] : lock.packages) {
+        if (!FileSystem::isDirectory(libDir / entry.name / entry.version)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Points <libDir>/<name>/<version> at the workspace store's copy. A package directory
+// already there (a link, or one installed before the project joined) is kept; where
+// symlinks are unavailable the package is copied.
+bool linkView(const fs::path& store, const fs::path& libDir,
+              const std::map<std::string, LockEntry>& packages) {
+    for (const auto& [_, entry] : packages) {
+        fs::path view = libDir / entry.name / entry.version;
+        if (FileSystem::isDirectory(view)) {
+            continue;
+        }
+        fs::path target = store / entry.name / entry.version;
+        FileSystem::createDirectories(view.parent_path());
+        if (!FileSystem::linkDirectory(target.lexically_relative(view.parent_path()), view) &&
+            !Installer::copyPackage(target, view)) {
+            Logger::error("Failed to link {} into {}", entry.key(), libDir.string());
+            return false;
+        }
+    }
+    return true;
+}
+
+// Every lock key of `name`, whatever the version: keys sort as name@version
+std::vector<std::string> lockKeys(const Lockfile& lock, const std::string& name) {
+    std::vector<std::string> keys;
+    std::string prefix = name + "@";
+    for (auto it = lock.packages.lower_bound(prefix);
+         it != lock.packages.end() && it->first.starts_with(prefix); ++it) {
+        keys.push_back(it->first);
+    }
+    return keys;
+}
+
+} // namespace
+
+Installer::Installer(Context& ctx) : ctx_(ctx) {}
+
+fs::path Installer::cachedArchive(const fs::path& cacheDir, const std::string& name,
+                                  const std::string& version) {
+    return cacheDir / (name + "-" + version + ".zip");
+}
+
+bool Installer::extractPackage(const fs::path& archive, const fs::path& target) {
+    return materialize(target, [&](const fs::path& staging) {
+        return FileSystem::extractZip(archive, staging);
+    });
+}
+
+bool Installer::extractPackage(std::string_view archive, const std::string& label,
+                               const fs::path& target) {
+    return materialize(target, [&](const fs::path& staging) {
+        return FileSystem::extractZipData(archive, label, staging);
+    });
+}
+
+bool Installer::replacePackage(const fs::path& archive, const fs::path& target) {
+    return materialize(target, [&](const fs::path& staging) {
+        return FileSystem::extractZip(archive, staging);
+    }, true);
+}
+
+bool Installer::applyDelta(const fs::path& delta, const fs::path& baseDir,
+                           const fs::path& baseArchive, const fs::path& target) {
+    auto baseGuard = readLock(baseDir);
+    return materialize(target, [&](const fs::path& staging) {
+        return PackageDelta::apply(delta, baseDir, baseArchive, staging);
+    });
+}
+
+bool Installer::copyPackage(const fs::path& source, const fs::path& target) {
+    auto sourceGuard = readLock(source);
+    return materialize(target, [&](const fs::path& staging) {
+        return FileSystem::copyDirectory(source, staging);
+    });
+}
+
+Installer::Project Installer::loadProject(const Lockfile::EntryCallback& onEntry) const {
+    return loadProject(*ctx_.getProjectRoot(), onEntry);
+}
+
+Installer::Project Installer::loadProject(const fs::path& root, const Lockfile::EntryCallback& onEntry) const {
+    Project project;
+    project.root = root;
+    // Held until the command finishes: ambar.lock/ambar.json are read-modify-write
+    project.guard = FileLock::acquire(project.root / "ambar_modules" / ".lock", LockMode::EXCLUSIVE);
+    if (!finishTransaction(project.root)) {
+        throw CommandError("could not recover an interrupted update of ambar.lock");
+    }
+
+    auto manifest = Manifest::load(project.root / "ambar.json");
+    if (manifest) {
+        project.manifest = std::move(*manifest);
+    } else {
+        project.manifest.name = FileSystem::filename(project.root);
+        project.manifest.version = "0.1.0";
+    }
+    if (FileSystem::isFile(project.root / "ambar.lock")) {
+        project.lock = Lockfile::load(project.root / "ambar.lock", onEntry);
+    }
+    return project;
+}
+
+bool Installer::saveProject(const Project& project, Lockfile lock, bool withManifest) const {
+    std::vector<FileWrite> files{{project.root / "ambar.lock", lock.serialize()}};
+    if (withManifest) {
+        files.push_back({project.root / "ambar.json", project.manifest.serialize()});
+    }
+    if (!commitProjectFiles(project.root, files)) {
+        Logger::error("Failed to write ambar.lock");
+        return false;
+    }
+    emitResolutionTable(project.root, lock.dependencies);
+    // Queries rebuild a missing or stale graph themselves, so this is not fatal either
+    if (!LockGraph::save(project.root, lock)) {
+        Logger::debug("Could not update the lock graph index");
+    }
+    // Makes the lockfile a gc root
+    ProjectRegistry(ctx_.getAmbRoot()).add(project.root);
+    return true;
+}
+
+void Installer::emitResolutionTable(const std::optional<fs::path>& projectRoot,
+                                    const std::map<std::string, std::string>& pinned) const {
+    // The table only saves the compiler directory probes, so failing to write it is not fatal
+    bool written = projectRoot
+        ? ResolutionTableWriter::emit(*projectRoot / "ambar_modules" / "lib",
+                                      *projectRoot / "ambar_modules" / ResolutionTable::FILE_NAME, pinned)
+        : ResolutionTableWriter::emit(ctx_.getLibDir(), ctx_.getAmbRoot() / ResolutionTable::FILE_NAME);
+    if (!written) {
+        Logger::warning("Could not update the import resolution table");
+    }
+}
+
+std::map<std::string, std::string> Installer::installRoots(const Project* project,
+                                                          const std::vector<PackageSpec>& specs) {
+    std::map<std::string, std::string> roots;
+    if (project) {
+        roots = project->manifest.dependencies;
+    }
+    for (const auto& spec : specs) {
+        roots[spec.name] = spec.range;
+    }
+    return roots;
+}
+
+Lockfile Installer::relaxedLock(const Project& project, const std::vector<std::string>& names) {
+    // No names: nothing stays pinned, transitive packages included
+    if (names.empty()) {
+        return Lockfile{};
+    }
+
+    // Unpin the targets so the resolver picks the newest allowed versions again. Their
+    // dependents stay pinned but lose the edge to them, which the resolver picks anew.
+    const auto& roots = project.manifest.dependencies;
+    Lockfile relaxed = project.lock.value_or(Lockfile{});
+    for (const auto& name : names) {
+        auto keys = lockKeys(relaxed, name);
+        if (keys.empty() && !roots.count(name)) {
+            throw CommandError("update", "'" + name + "' is not a dependency of this project");
+        }
+        relaxed.dependencies.erase(name);
+        for (const auto& key : keys) {
+            for (const auto& dependent : relaxed.packages.at(key).dependents) {
+                auto it = relaxed.packages.find(dependent);
+                if (it != relaxed.packages.end()) {
+                    it->second.dependencies.erase(name);
+                }
+            }
+        }
+        for (const auto& key : keys) {
+            relaxed.packages.erase(key);
+        }
+    }
+    return relaxed;
+}
+
+bool Installer::install(const std::vector<PackageSpec>& specs, const InstallOptions& options) {
+    report_ = InstallReport{};
+    auto& config = ConfigManager::instance();
+
+    if (!options.global && !ctx_.isInsideProject()) {
+        throw CommandError("install", "not in an Ambar project directory (use --global)");
+    }
+
+    std::optional<Project> project;
+    fs::path libDir = options.global ? ctx_.getLibDir() : ctx_.getModulesDir();
+
+    // The archives ambar.lock pins start downloading as its entries are read, overlapping
+    // the index load and resolution; installResolution() keeps those still needed.
+    // Integrity is checked against the lock's digest and signatures before extraction.
+    FileLock cacheGuard;
+    std::unique_ptr<Prefetcher> prefetch;
+    RegistryIndex locator;
+    locator.setBaseUrl(config.getRegistryUrl());
+    auto speculate = [&](const LockEntry& entry) {
+        fs::path archive = cachedArchive(ctx_.getCacheDir(), entry.name, entry.version);
+        if (entry.sha256.empty() || FileSystem::isDirectory(libDir / entry.name / entry.version) ||
+            FileSystem::isDirectory(ctx_.getLibDir() / entry.name / entry.version) ||
+            FileSystem::isFile(CompressedCache::packedPath(archive))) {
+            return;
+        }
+        if (!prefetch) {
+            // The same shared cache lock installResolution() takes
+            cacheGuard = FileLock::acquire(ctx_.getCacheDir() / ".lock", LockMode::SHARED);
+            prefetch = std::make_unique<Prefetcher>(Fetcher::defaultOptions());
+        }
+        PackageRecord location;
+        location.name = entry.name;
+        location.version = entry.version;
+
+        FetchJob job;
+        job.url = locator.archiveUrl(location);
+        job.destination = archive;
+        job.sha256 = entry.sha256;
+        prefetch->add(std::move(job));
+    };
+
+    if (!options.global) {
+        // A snapshot registry is mapped in place, there is nothing to download
+        project = config.getSnapshotPath() ? loadProject() : loadProject(speculate);
+    }
+    auto roots = installRoots(project ? &*project : nullptr, specs);
+
+    if (roots.empty()) {
+        printNothing("No dependencies to install", 0);
+        return true;
+    }
+
+    // No-op fast path: lockfile already covers the manifest and everything is on disk
+    const Lockfile* lock = project && project->lock ? &*project->lock : nullptr;
+    if (specs.empty() && lock && isSatisfied(*lock, roots, libDir)) {
+        if (!FileSystem::isFile(project->root / "ambar_modules" / ResolutionTable::FILE_NAME)) {
+            emitResolutionTable(project->root, lock->dependencies);
+        }
+        report_.reused = lock->packages.size();
+        printNothing("All " + std::to_string(lock->packages.size()) + " packages up to date", report_.reused);
+        return !options.runScripts || runHooks(lock->packages, libDir);
+    }
+
+    auto index = RegistryIndex::load(config.getRegistryUrl(), config.config().networkTimeout, ctx_.getCacheDir());
+    if (!index) {
+        return false;
+    }
+
+    Resolver resolver(*index, lock);
+    auto resolution = resolver.resolve(roots);
+    if (!resolution) {
+        return false;
+    }
+
+    if (!installResolution(*resolution, *index, libDir, prefetch.get())) {
+        return false;
+    }
+
+    if (project) {
+        for (const auto& spec : specs) {
+            project->manifest.dependencies[spec.name] = manifestRange(spec, resolution->roots[spec.name]);
+        }
+        if (!saveProject(*project, lockOf(*resolution), !specs.empty())) {
+            return false;
+        }
+    } else {
+        emitResolutionTable(std::nullopt, {});
+    }
+
+    printInstalled(report_);
+    return !options.runScripts || runHooks(resolution->packages, libDir);
+}
+
+bool Installer::installWorkspace(const InstallOptions& options) {
+    report_ = InstallReport{};
+    auto& config = ConfigManager::instance();
+
+    if (!ctx_.isInsideWorkspace()) {
+        throw CommandError("install", "not in an Ambar workspace (no " + std::string(Workspace::FILE_NAME) + " found)");
+    }
+    auto workspace = Workspace::load(*ctx_.getWorkspaceRoot());
+    if (!workspace) {
+        return false;
+    }
+    if (workspace->members.empty()) {
+        Output::emit("message", "No projects in the workspace");
+        return true;
+    }
+
+    // Workspace first, then the members in path order
+    fs::path store = workspace->storeDir();
+    auto guard = FileLock::acquire(workspace->root / "ambar_modules" / ".lock", LockMode::EXCLUSIVE);
+    // Makes the store a gc root, reachable through the members' locks
+    ProjectRegistry(ctx_.getAmbRoot()).add(workspace->root);
+    std::vector<Project> projects;
+    std::vector<std::map<std::string, std::string>> roots;
+    Lockfile pins;  // every member's lock, so pinned versions survive the joint resolution
+    bool upToDate = true;
+    for (const auto& member : workspace->members) {
+        Project& project = projects.emplace_back(loadProject(member));
+        roots.push_back(project.manifest.dependencies);
+        if (project.lock) {
+            pins.packages.insert(project.lock->packages.begin(), project.lock->packages.end());
+        }
+        upToDate = upToDate && project.lock &&
+                   isSatisfied(*project.lock, roots.back(), member / "ambar_modules" / "lib");
+    }
+
+    if (upToDate) {
+        std::map<std::string, LockEntry> packages;
+        for (const auto& project : projects) {
+            packages.insert(project.lock->packages.begin(), project.lock->packages.end());
+        }
+        report_.reused = packages.size();
+        printNothing("All " + std::to_string(packages.size()) + " packages of " + std::to_string(projects.size()) +
+                     " project(s) up to date", report_.reused);
+        return !options.runScripts || runHooks(packages, store);
+    }
+
+    auto index = RegistryIndex::load(config.getRegistryUrl(), config.config().networkTimeout, ctx_.getCacheDir());
+    if (!index) {
+        return false;
+    }
+    auto resolution = Resolver(*index, &pins).resolveWorkspace(roots);
+    if (!resolution) {
+        return false;
+    }
+
+    if (!installResolution(resolution->store, *index, store)) {
+        return false;
+    }
+
+    for (size_t i = 0; i < projects.size(); ++i) {
+        auto& member = resolution->members[i];
+        // Digests the install filled in for entries that had none
+        for (auto& [key, entry] : member.packages) {
+            entry = resolution->store.packages.at(key);
+        }
+        if (!linkView(store, projects[i].root / "ambar_modules" / "lib", member.packages) ||
+            !saveProject(projects[i], lockOf(member), false)) {
+            return false;
+        }
+    }
+
+    printInstalled(report_);
+    Output::emit(Event("workspace.linked", "Linked " + std::to_string(resolution->store.packages.size()) +
+                                               " package(s) into " + std::to_string(projects.size()) + " project(s)")
+                     .with("packages", resolution->store.packages.size())
+                     .with("projects", projects.size()));
+    return !options.runScripts || runHooks(resolution->store.packages, store);
+}
+
+bool Installer::update(const std::vector<std::string>& names, const InstallOptions& options) {
+    report_ = InstallReport{};
+    auto& config = ConfigManager::instance();
+
+    if (!ctx_.isInsideProject()) {
+        throw CommandError("update", "not in an Ambar project directory");
+    }
+
+    auto project = loadProject();
+    const auto& roots = project.manifest.dependencies;
+    if (roots.empty()) {
+        Output::emit(Event("update.done", "No dependencies to update").with("changed", 0));
+        return true;
+    }
+
+    Lockfile relaxed = relaxedLock(project, names);
+
+    auto index = RegistryIndex::load(config.getRegistryUrl(), config.config().networkTimeout, ctx_.getCacheDir());
+    if (!index) {
+        return false;
+    }
+
+    Resolver resolver(*index, &relaxed);
+    auto resolution = resolver.resolve(roots);
+    if (!resolution) {
+        return false;
+    }
+
+    if (!installResolution(*resolution, *index, ctx_.getModulesDir())) {
+        return false;
+    }
+    if (!saveProject(project, lockOf(*resolution), false)) {
+        return false;
+    }
+
+    // Every package whose installed versions changed, transitive ones included
+    auto versionsOf = [](const std::map<std::string, LockEntry>& packages) {
+        std::map<std::string, std::string> versions;
+        for (const auto& [key, entry] : packages) {
+            auto& list = versions[entry.name];
+            list += (list.empty() ? "" : ", ") + entry.version;
+        }
+        return versions;
+    };
+    auto before = project.lock ? versionsOf(project.lock->packages) : std::map<std::string, std::string>{};
+    auto after = versionsOf(resolution->packages);
+
+    size_t changed = 0;
+    for (const auto& [name, version] : after) {
+        auto it = before.find(name);
+        std::string previous = it == before.end() ? "" : it->second;
+        if (previous != version) {
+            Output::emit(Event("update.package", "  " + name + " " + (previous.empty() ? "(new)" : previous) +
+                                                     " -> " + version)
+                             .with("name", name)
+                             .with("from", previous)
+                             .with("to", version));
+            changed++;
+        }
+    }
+
+    std::string summary = "All dependencies are at their newest allowed versions";
+    if (changed > 0) {
+        summary = "Updated " + std::to_string(changed) + " package(s)";
+        if (report_.viaDelta > 0) {
+            summary += ", " + std::to_string(report_.viaDelta) + " via delta";
+        }
+    }
+    Output::emit(Event("update.done", summary)
+                     .with("changed", changed)
+                     .with("installed", report_.installed)
+                     .with("via_delta", report_.viaDelta)
+                     .with("downloaded", report_.fetch.downloaded)
+                     .with("bytes", report_.fetch.bytes));
+    return !options.runScripts || runHooks(resolution->packages, ctx_.getModulesDir());
+}
+
+std::optional<InstallPlan> Installer::planInstall(const std::vector<PackageSpec>& specs,
+                                                  const InstallOptions& options) {
+    auto& config = ConfigManager::instance();
+
+    if (!options.global && !ctx_.isInsideProject()) {
+        throw CommandError("install", "not in an Ambar project directory (use --global)");
+    }
+
+    std::optional<Project> project;
+    if (!options.global) {
+        project = loadProject();
+    }
+    auto roots = installRoots(project ? &*project : nullptr, specs);
+
+    InstallPlan plan;
+    plan.command = "install";
+    plan.global = options.global;
+    plan.runScripts = options.runScripts;
+    plan.registryUrl = config.getRegistryUrl();
+    if (project) {
+        plan.projectDigest = InstallPlan::digestProject(project->root);
+    }
+    if (roots.empty()) {
+        return plan;
+    }
+
+    auto index = RegistryIndex::load(config.getRegistryUrl(), config.config().networkTimeout, ctx_.getCacheDir());
+    if (!index) {
+        return std::nullopt;
+    }
+    const Lockfile* lock = project && project->lock ? &*project->lock : nullptr;
+    auto resolution = Resolver(*index, lock).resolve(roots);
+    if (!resolution) {
+        return std::nullopt;
+    }
+
+    if (project) {
+        for (const auto& spec : specs) {
+            plan.manifestDependencies[spec.name] = manifestRange(spec, resolution->roots[spec.name]);
+        }
+    }
+    plan.lock = lockOf(*resolution);
+    describe(plan, *resolution, *index, options.global ? ctx_.getLibDir() : ctx_.getModulesDir());
+    plan.estimate(ThroughputStats::load(ctx_.getAmbRoot()), ctx_.getJobs());
+    return plan;
+}
+
+std::optional<InstallPlan> Installer::planUpdate(const std::vector<std::string>& names,
+                                                 const InstallOptions& options) {
+    auto& config = ConfigManager::instance();
+
+    if (!ctx_.isInsideProject()) {
+        throw CommandError("update", "not in an Ambar project directory");
+    }
+
+    auto project = loadProject();
+    InstallPlan plan;
+    plan.command = "update";
+    plan.runScripts = options.runScripts;
+    plan.registryUrl = config.getRegistryUrl();
+    plan.projectDigest = InstallPlan::digestProject(project.root);
+    if (project.manifest.dependencies.empty()) {
+        return plan;
+    }
+
+    Lockfile relaxed = relaxedLock(project, names);
+    auto index = RegistryIndex::load(config.getRegistryUrl(), config.config().networkTimeout, ctx_.getCacheDir());
+    if (!index) {
+        return std::nullopt;
+    }
+    auto resolution = Resolver(*index, &relaxed).resolve(project.manifest.dependencies);
+    if (!resolution) {
+        return std::nullopt;
+    }
+
+    plan.lock = lockOf(*resolution);
+    describe(plan, *resolution, *index, ctx_.getModulesDir());
+    plan.estimate(ThroughputStats::load(ctx_.getAmbRoot()), ctx_.getJobs());
+    return plan;
+}
+
+bool Installer::execute(const InstallPlan& plan) {
+    report_ = InstallReport{};
+    auto& config = ConfigManager::instance();
+
+    if (plan.registryUrl != config.getRegistryUrl()) {
+        throw CommandError(plan.command, "the plan was made for registry " + plan.registryUrl +
+                                         ", not the configured " + config.getRegistryUrl());
+    }
+
+    std::optional<Project> project;
+    fs::path libDir = plan.global ? ctx_.getLibDir() : ctx_.getModulesDir();
+    if (!plan.global) {
+        if (!ctx_.isInsideProject()) {
+            throw CommandError(plan.command, "not in an Ambar project directory");
+        }
+        project = loadProject();
+        if (InstallPlan::digestProject(project->root) != plan.projectDigest) {
+            throw CommandError(plan.command, "the plan is stale: ambar.json or ambar.lock changed since it was made");
+        }
+    }
+
+    if (plan.lock.packages.empty()) {
+        printNothing("No dependencies to install", 0);
+        return true;
+    }
+
+    auto index = RegistryIndex::load(plan.registryUrl, config.config().networkTimeout, ctx_.getCacheDir());
+    if (!index) {
+        return false;
+    }
+
+    Resolution resolution;
+    resolution.roots = plan.lock.dependencies;
+    resolution.packages = plan.lock.packages;
+    if (!installResolution(resolution, *index, libDir)) {
+        return false;
+    }
+
+    if (project) {
+        for (const auto& [name, range] : plan.manifestDependencies) {
+            project->manifest.dependencies[name] = range;
+        }
+        if (!saveProject(*project, lockOf(resolution), !plan.manifestDependencies.empty())) {
+            return false;
+        }
+    } else {
+        emitResolutionTable(std::nullopt, {});
+    }
+
+    printInstalled(report_);
+    return !plan.runScripts || runHooks(resolution.packages, libDir);
+}
+
+void Installer::describe(InstallPlan& plan, const Resolution& resolution, const RegistryIndex& index,
+                         const fs::path& libDir) const {
+    fs::path cacheDir = ctx_.getCacheDir();
+    fs::path globalDir = ctx_.getLibDir();
+    fs::path stateDir = libDir.parent_path() / ".hooks";
+
+    for (const auto& [key, entry] : resolution.packages) {
+        const PackageRecord* record = index.find(entry.name, entry.version);
+        uint64_t size = record ? record->size : 0;
+        fs::path target = libDir / entry.name / entry.version;
+        fs::path global = globalDir / entry.name / entry.version;
+        fs::path archive = cachedArchive(cacheDir, entry.name, entry.version);
+
+        if (FileSystem::isDirectory(target)) {
+            plan.steps.push_back({PlanAction::REUSE, key, ""});
+        } else if (libDir != globalDir && !entry.sha256.empty() && FileSystem::isDirectory(global)) {
+            plan.steps.push_back({PlanAction::COPY, key, "", 0, size});
+        } else if (FileSystem::isFile(archive)) {
+            plan.steps.push_back({PlanAction::CACHE_HIT, key, ""});
+            plan.steps.push_back({PlanAction::EXTRACT, key, "", 0, FileSystem::fileSize(archive)});
+        } else {
+            // Same delta choice as installResolution(): the first base that is at hand
+            bool viaDelta = false;
+            for (const auto& [from, delta] : record ? record->deltas : std::map<std::string, DeltaRecord>{}) {
+                if (FileSystem::isDirectory(libDir / entry.name / from) ||
+                    FileSystem::isFile(cachedArchive(cacheDir, entry.name, from))) {
+                    plan.steps.push_back({PlanAction::DELTA, key, "from " + from, delta.size, size});
+                    viaDelta = true;
+                    break;
+                }
+            }
+            if (!viaDelta) {
+                plan.steps.push_back({PlanAction::FETCH, key, "", size, 0});
+                plan.steps.push_back({PlanAction::EXTRACT, key, "", 0, size});
+            }
+        }
+
+        if (!plan.runScripts) {
+            continue;
+        }
+        auto manifest = localManifest({target, global}, archive);
+        if (!manifest) {
+            plan.unknownHooks++;
+            continue;
+        }
+        // A stamp for this digest means HookRunner will skip the package; an older one
+        // still tells how long its hooks took
+        json stamp;
+        if (auto content = FileSystem::readFile(stateDir / (key + ".json"))) {
+            stamp = json::parse(*content, nullptr, false);
+        }
+        if (stamp.is_object() && !entry.sha256.empty() && stamp.value("sha256", "") == entry.sha256 &&
+            stamp.value("ok", false)) {
+            continue;
+        }
+        for (const char* hook : HookRunner::HOOKS) {
+            auto it = manifest->scripts.find(hook);
+            if (it == manifest->scripts.end() || it->second.empty()) {
+                continue;
+            }
+            PlanStep step{PlanAction::HOOK, key, hook};
+            if (stamp.is_object() && stamp.contains("hooks") && stamp["hooks"].contains(hook)) {
+                step.seconds = stamp["hooks"][hook].value("ms", 0.0) / 1000.0;
+            }
+            plan.steps.push_back(std::move(step));
+        }
+    }
+}
+
+bool Installer::remove(const std::vector<std::string>& names, const RemoveOptions& options) {
+    report_ = InstallReport{};
+
+    if (!ctx_.isInsideProject()) {
+        throw CommandError("remove", "not in an Ambar project directory");
+    }
+
+    auto project = loadProject();
+    Lockfile lock = std::move(project.lock).value_or(Lockfile{});
+
+    std::set<std::string> targets;
+    bool manifestChanged = false;
+    for (const auto& name : names) {
+        auto keys = lockKeys(lock, name);
+        bool declared = project.manifest.dependencies.erase(name) > 0;
+        manifestChanged |= declared;
+        if (keys.empty() && !declared) {
+            throw CommandError("remove", "'" + name + "' is not installed in this project");
+        }
+        targets.insert(keys.begin(), keys.end());
+    }
+
+    // With --cascade everything that reaches a target through its dependents goes too;
+    // otherwise any dependent outside the targets blocks the removal. Only the entries
+    // reached from the targets are visited.
+    std::vector<std::string> walk(targets.begin(), targets.end());
+    std::set<std::string> doomed;
+    std::set<std::string> blockers;
+    while (!walk.empty()) {
+        std::string key = std::move(walk.back());
+        walk.pop_back();
+        if (!doomed.insert(key).second) {
+            continue;
+        }
+        for (const auto& dependent : lock.packages.at(key).dependents) {
+            if (!lock.packages.count(dependent)) {
+                continue;
+            }
+            if (options.cascade) {
+                walk.push_back(dependent);
+            } else if (!targets.count(dependent)) {
+                blockers.insert(dependent);
+            }
+        }
+    }
+    if (!blockers.empty()) {
+        std::string list;
+        for (const auto& key : blockers) {
+            list += (list.empty() ? "" : ", ") + key;
+        }
+        throw CommandError("remove", "still required by " + list + " (use --cascade to remove them too)");
+    }
+
+    for (const auto& key : doomed) {
+        const auto& entry = lock.packages.at(key);
+        auto root = lock.dependencies.find(entry.name);
+        if (root != lock.dependencies.end() && root->second == entry.version) {
+            lock.dependencies.erase(root);
+            manifestChanged |= project.manifest.dependencies.erase(entry.name) > 0;
+        }
+    }
+
+    // Drop the doomed entries' edges; a dependency left with no dependents that is not a
+    // direct dependency is orphaned and removed the same way
+    std::vector<std::string> pending(doomed.begin(), doomed.end());
+    while (!pending.empty()) {
+        std::string key = std::move(pending.back());
+        pending.pop_back();
+        for (const auto& [name, version] : lock.packages.at(key).dependencies) {
+            std::string depKey = name + "@" + version;
+            auto dep = lock.packages.find(depKey);
+            if (dep == lock.packages.end() || doomed.count(depKey)) {
+                continue;
+            }
+            dep->second.dependents.erase(key);
+            auto root = lock.dependencies.find(name);
+            bool isRoot = root != lock.dependencies.end() && root->second == version;
+            if (dep->second.dependents.empty() && !isRoot) {
+                doomed.insert(depKey);
+                pending.push_back(depKey);
+            }
+        }
+    }
+
+    std::vector<LockEntry> removed;
+    for (const auto& key : doomed) {
+        removed.push_back(std::move(lock.packages.at(key)));
+        lock.packages.erase(key);
+    }
+
+    // The files go only after the new lock is committed: an interruption past this point
+    // leaves unreferenced directories for `amb gc`, never a lock naming missing packages
+    auto pinned = lock.dependencies;
+    if (!saveProject(project, std::move(lock), manifestChanged)) {
+        return false;
+    }
+
+    fs::path libDir = ctx_.getModulesDir();
+    fs::path hooksDir = HookRunner(ctx_, libDir).stateDir();
+    std::vector<char> deleted(removed.size(), 0);
+    parallelFor(ctx_.scheduler(), removed.size(), [&](size_t i) {
+        fs::path dir = libDir / removed[i].name / removed[i].version;
+        // Waits for readers such as a delta or copy based on this version
+        fs::path lockPath = FileLock::siblingLockPath(dir);
+        auto guard = FileLock::acquire(lockPath, LockMode::EXCLUSIVE);
+        deleted[i] = FileSystem::removeDirectories(dir) ? 1 : 0;
+        if (deleted[i]) {
+            FileSystem::removeFile(lockPath);
+            // A reinstall must run the hooks again
+            FileSystem::removeFile(hooksDir / (removed[i].key() + ".json"));
+            FileSystem::removeFile(hooksDir / (removed[i].key() + ".log"));
+        }
+    }, TaskPriority::HIGH);
+
+    for (size_t i = 0; i < removed.size(); i++) {
+        Output::emit(Event("remove.package", "  - " + removed[i].key())
+                         .with("package", removed[i].key())
+                         .with("deleted", deleted[i] != 0));
+        if (deleted[i]) {
+            report_.removed++;
+            // <lib>/<name> left empty
+            std::error_code ec;
+            fs::path parent = libDir / removed[i].name;
+            if (fs::is_empty(parent, ec) && !ec) {
+                fs::remove(parent, ec);
+                FileSystem::invalidate(parent);
+            }
+        } else {
+            Logger::warning("Could not delete {}; `amb gc` will retry", removed[i].key());
+        }
+    }
+    // saveProject listed the directories before they were deleted; the compiler trusts
+    // the table over the global lib, so it must not keep naming them
+    if (!removed.empty()) {
+        emitResolutionTable(project.root, pinned);
+    }
+    Output::emit(Event("remove.done", "Removed " + std::to_string(removed.size()) + " package(s)")
+                     .with("removed", removed.size()));
+    return true;
+}
+
+bool Installer::runHooks(const std::map<std::string, LockEntry>& packages, const fs::path& libDir) {
+    HookRunner runner(ctx_, libDir);
+    bool ok = runner.run(packages);
+    report_.hooks = runner.report();
+
+    const auto& hooks = report_.hooks;
+    if (hooks.packages == 0) {
+        return true;
+    }
+    double hookSeconds = 0;
+    for (const auto& timing : hooks.timings) {
+        hookSeconds += std::chrono::duration<double>(timing.duration).count();
+    }
+    ThroughputStats throughput;
+    throughput.sample(ThroughputStats::Rate::HOOK, static_cast<double>(hooks.timings.size()), hookSeconds);
+    throughput.save(ctx_.getAmbRoot());
+
+    std::string text = "Ran " + std::to_string(hooks.ran) + " hook(s) for " +
+                       std::to_string(hooks.packages - hooks.skipped - hooks.blocked) + " package(s)";
+    if (hooks.skipped > 0) {
+        text += ", " + std::to_string(hooks.skipped) + " unchanged";
+    }
+    if (hooks.buildsCached > 0) {
+        text += ", " + std::to_string(hooks.buildsCached) + " build(s) from cache";
+    }
+    if (hooks.failed > 0 || hooks.blocked > 0) {
+        text += ", " + std::to_string(hooks.failed) + " failed, " + std::to_string(hooks.blocked) + " not run";
+    }
+    text += " (logs in " + runner.stateDir().string() + ")";
+    Output::emit(Event("hooks.done", text)
+                     .with("packages", hooks.packages)
+                     .with("ran", hooks.ran)
+                     .with("skipped", hooks.skipped)
+                     .with("failed", hooks.failed)
+                     .with("blocked", hooks.blocked)
+                     .with("builds_cached", hooks.buildsCached)
+                     .with("logs", runner.stateDir().string()));
+    return ok;
+}
+
+bool Installer::installResolution(Resolution& resolution, const RegistryIndex& index,
+                                  const fs::path& libDir, Prefetcher* prefetch) {
+    fs::path cacheDir = ctx_.getCacheDir();
+    // Adding entries only needs the shared side; pruning the cache takes it exclusively
+    auto cacheGuard = FileLock::acquire(cacheDir / ".lock", LockMode::SHARED);
+
+    struct Pending {
+        LockEntry* entry = nullptr;
+        const PackageRecord* record = nullptr;
+        fs::path archive;
+        std::string deltaFrom;  // empty when the full archive is fetched
+        fs::path delta;
+        std::string_view mapped;  // the archive inside a snapshot bundle, used in place
+        std::string origin;       // where `mapped` comes from, for messages
+        bool packed = false;      // to be decoded from the compressed cache
+        std::shared_ptr<const std::string> decoded;  // owns `mapped` once it is
+    };
+
+    // A snapshot registry is mapped and extracted from directly, skipping the cache
+    std::shared_ptr<const SnapshotBundle> snapshot;
+    if (auto bundle = ConfigManager::instance().getSnapshotPath()) {
+        snapshot = SnapshotBundle::open(*bundle);
+        if (!snapshot) {
+            return false;
+        }
+    }
+
+    auto archiveJob = [&](const Pending& p) {
+        PackageRecord location;
+        location.name = p.entry->name;
+        location.version = p.entry->version;
+
+        FetchJob job;
+        job.url = index.archiveUrl(p.record ? *p.record : location);
+        job.destination = p.archive;
+        job.sha256 = p.entry->sha256;
+        job.size = p.record ? p.record->size : 0;
+        return job;
+    };
+
+    std::vector<Pending> pending;
+    std::vector<FetchJob> jobs;
+    // Rates for ThroughputStats, which plan estimates are based on
+    ThroughputStats throughput;
+    double copyBytes = 0;
+    double copySeconds = 0;
+
+    for (auto& [key, entry] : resolution.packages) {
+        if (FileSystem::isDirectory(libDir / entry.name / entry.version)) {
+            report_.reused++;
+            continue;
+        }
+
+        // Already installed globally: a local install is a pure tree copy
+        fs::path global = ctx_.getLibDir() / entry.name / entry.version;
+        if (libDir != ctx_.getLibDir() && !entry.sha256.empty() && FileSystem::isDirectory(global)) {
+            fs::path target = libDir / entry.name / entry.version;
+            FileSystem::createDirectories(target.parent_path());
+            auto start = std::chrono::steady_clock::now();
+            bool copied = copyPackage(global, target);
+            copySeconds += secondsSince(start);
+            if (copied) {
+                const auto* record = index.find(entry.name, entry.version);
+                copyBytes += record ? static_cast<double>(record->size) : 0;
+                Logger::debug("Copied {} from {}", entry.key(), global.string());
+                report_.copied++;
+                report_.installed++;
+                continue;
+            }
+            Logger::warning("Copying {} from the global lib dir failed, fetching it instead", entry.key());
+        }
+
+        Pending p;
+        p.entry = &entry;
+        p.record = index.find(entry.name, entry.version);
+        p.archive = cachedArchive(cacheDir, entry.name, entry.version);
+
+        if (snapshot) {
+            PackageRecord location;
+            location.name = entry.name;
+            location.version = entry.version;
+            if (auto data = snapshot->find(location.archivePath())) {
+                p.mapped = *data;
+                p.origin = snapshot->path().string();
+                p.archive.clear();
+                pending.push_back(std::move(p));
+                continue;
+            }
+        }
+
+        if (!FileSystem::isFile(p.archive) && FileSystem::isFile(CompressedCache::packedPath(p.archive))) {
+            p.packed = true;
+            pending.push_back(std::move(p));
+            continue;
+        }
+
+        // A delta only pays off when the full archive is not cached and a base version is at hand
+        if (p.record && !FileSystem::isFile(p.archive)) {
+            for (const auto& [from, delta] : p.record->deltas) {
+                if (!FileSystem::isDirectory(libDir / entry.name / from) &&
+                    !FileSystem::isFile(cachedArchive(cacheDir, entry.name, from))) {
+                    continue;
+                }
+                p.deltaFrom = from;
+                p.delta = cacheDir / (entry.name + "-" + from + "-" + entry.version + ".delta");
+
+                FetchJob job;
+                job.url = index.deltaUrl(*p.record, from);
+                job.destination = p.delta;
+                job.sha256 = delta.sha256;
+                job.size = delta.size;
+                jobs.push_back(std::move(job));
+                break;
+            }
+        }
+        if (p.deltaFrom.empty()) {
+            jobs.push_back(archiveJob(p));
+        }
+        pending.push_back(std::move(p));
+    }
+
+    // A signature covers name, version and digest, so the whole transaction is checked
+    // (in one batch) before anything is extracted. Only this fetch waits for it: archives
+    // the lock pins may already be prefetching, verified against the lock's digest.
+    std::vector<SignedArtifact> artifacts;
+    for (const auto& p : pending) {
+        if (p.record) {
+            const auto& entry = *p.entry;
+            artifacts.push_back({entry.name, entry.version,
+                                 entry.sha256.empty() ? p.record->sha256 : entry.sha256,
+                                 p.record->publicKey, p.record->signature});
+        }
+    }
+    const auto& config = ConfigManager::instance().config();
+    SignatureChecker checker(cacheDir, {config.trustedKeys, config.requireSignatures});
+    report_.signatures = checker.check(artifacts);
+    for (const auto& problem : report_.signatures.problems) {
+        Logger::error("Signature check failed: {}", problem);
+    }
+    if (!report_.signatures.ok()) {
+        return false;
+    }
+
+    // Packed archives decode in parallel; one that fails to (corrupt, or packed with a
+    // dictionary since replaced) is dropped and fetched again
+    CompressedCache compressed(cacheDir);
+    std::vector<Pending*> packed;
+    for (auto& p : pending) {
+        if (p.packed) {
+            packed.push_back(&p);
+        }
+    }
+    parallelFor(ctx_.scheduler(), packed.size(), [&](size_t i) {
+        auto& p = *packed[i];
+        if (auto data = compressed.unpack(p.archive)) {
+            p.decoded = std::make_shared<const std::string>(std::move(*data));
+            p.mapped = *p.decoded;
+            p.origin = CompressedCache::packedPath(p.archive).string();
+        }
+    }, TaskPriority::HIGH);
+    for (auto* p : packed) {
+        if (p->decoded) {
+            p->archive.clear();
+            continue;
+        }
+        Logger::warning("Compressed cache entry for {} is unusable, downloading it again", p->entry->key());
+        FileSystem::removeFile(CompressedCache::packedPath(p->archive));
+        jobs.push_back(archiveJob(*p));
+    }
+
+    Fetcher fetcher(Fetcher::defaultOptions());
+    double fetchSeconds = 0;
+    auto fetch = [&](const std::vector<FetchJob>& batch, Prefetcher* running) {
+        Output::Progress bar;
+        if (!batch.empty()) {
+            uint64_t expected = 0;
+            for (const auto& job : batch) {
+                expected += job.size;
+            }
+            bar = Output::progress("fetch", "Downloading", expected, "bytes");
+        }
+        FetchReport result;
+        if (running) {
+            running->retain(batch);
+            for (const auto& job : batch) {
+                running->add(job);
+            }
+            running->setProgress(&bar);
+            result = running->finish();
+            running->setProgress(nullptr);
+            fetchSeconds += running->seconds();
+        } else if (!batch.empty()) {
+            auto start = std::chrono::steady_clock::now();
+            fetcher.setProgress(&bar);
+            result = fetcher.fetchAll(batch);
+            fetcher.setProgress(nullptr);
+            fetchSeconds += secondsSince(start);
+        }
+        report_.fetch.downloaded += result.downloaded;
+        report_.fetch.cached += result.cached;
+        report_.fetch.cancelled += result.cancelled;
+        report_.fetch.bytes += result.bytes;
+        report_.fetch.resumedBytes += result.resumedBytes;
+        for (const auto& error : result.errors) {
+            Logger::warning("Download failed: {}", error);
+        }
+    };
+
+    // Only successful fetches leave the destination in place, so a missing delta just
+    // means falling back to the full archive while a missing archive is fatal
+    fetch(jobs, prefetch);
+
+    // Inflating, hashing and writing files is CPU bound, so both the delta and the
+    // extraction passes are spread over the scheduler; parents are created up front
+    for (const auto& p : pending) {
+        FileSystem::createDirectories(libDir / p.entry->name);
+    }
+
+    std::vector<Pending*> patches;
+    for (auto& p : pending) {
+        if (!p.deltaFrom.empty()) {
+            patches.push_back(&p);
+        }
+    }
+    std::vector<char> patched(patches.size(), 0);
+    parallelFor(ctx_.scheduler(), patches.size(), [&](size_t i) {
+        const auto& p = *patches[i];
+        fs::path baseDir = libDir / p.entry->name / p.deltaFrom;
+        patched[i] = FileSystem::isFile(p.delta) &&
+                     applyDelta(p.delta, FileSystem::isDirectory(baseDir) ? baseDir : fs::path(),
+                                cachedArchive(cacheDir, p.entry->name, p.deltaFrom),
+                                libDir / p.entry->name / p.entry->version);
+    }, TaskPriority::HIGH);
+
+    std::vector<FetchJob> fallback;
+    for (size_t i = 0; i < patches.size(); ++i) {
+        auto& p = *patches[i];
+        auto& entry = *p.entry;
+        if (patched[i]) {
+            Logger::debug("Installed {} from {} via delta", entry.key(), p.deltaFrom);
+            report_.viaDelta++;
+            report_.installed++;
+            p.archive.clear();
+            continue;
+        }
+
+        Logger::warning("Delta {} -> {} for {} unavailable, downloading the full archive",
+                        p.deltaFrom, entry.version, entry.name);
+        FileSystem::removeFile(p.delta);
+        fallback.push_back(archiveJob(p));
+    }
+    fetch(fallback, nullptr);
+
+    for (const auto& p : pending) {
+        if (!p.archive.empty() && !FileSystem::isFile(p.archive)) {
+            Logger::error("Could not fetch {}", p.entry->key());
+            report_.fetch.failed++;
+        }
+    }
+    if (report_.fetch.failed > 0) {
+        return false;
+    }
+
+    std::vector<Pending*> archives;
+    for (auto& p : pending) {
+        if (!p.archive.empty() || !p.mapped.empty()) {
+            archives.push_back(&p);
+        }
+    }
+    double extractBytes = 0;
+    for (const auto* p : archives) {
+        extractBytes += p->mapped.empty() ? static_cast<double>(FileSystem::fileSize(p->archive))
+                                          : static_cast<double>(p->mapped.size());
+    }
+    auto extractStart = std::chrono::steady_clock::now();
+    Output::Progress extracting;
+    if (!archives.empty()) {
+        extracting = Output::progress("extract", "Extracting", archives.size());
+    }
+    std::vector<char> extracted(archives.size(), 0);
+    parallelFor(ctx_.scheduler(), archives.size(), [&](size_t i) {
+        const auto& p = *archives[i];
+        auto& entry = *p.entry;
+        fs::path target = libDir / entry.name / entry.version;
+        if (!p.mapped.empty()) {
+            // Nothing verified these bytes on the way in, unlike a fetch
+            std::string digest = Sha256::hash(p.mapped);
+            if (!entry.sha256.empty() && digest != entry.sha256) {
+                Logger::error("Digest mismatch for {} in {}", entry.key(), p.origin);
+                extracting.advance();
+                return;
+            }
+            entry.sha256 = digest;
+            extracted[i] = extractPackage(p.mapped, entry.key() + " in " + p.origin, target);
+        } else {
+            if (entry.sha256.empty()) {
+                // Registries without an index carry no digest - pin what we downloaded
+                entry.sha256 = Sha256::hashFile(p.archive);
+            }
+            extracted[i] = extractPackage(p.archive, target);
+        }
+        if (extracted[i]) {
+            Logger::debug("Installed {} into {}", entry.key(), target.string());
+        } else {
+            Logger::error("Failed to extract {}", entry.key());
+        }
+        extracting.advance();
+    }, TaskPriority::HIGH);
+
+    double extractSeconds = secondsSince(extractStart);
+    extracting.finish();
+
+    for (size_t i = 0; i < archives.size(); ++i) {
+        if (!extracted[i]) {
+            return false;
+        }
+        report_.installed++;
+        if (archives[i]->decoded) {
+            report_.unpacked++;
+        } else if (!archives[i]->mapped.empty()) {
+            report_.fromSnapshot++;
+        }
+    }
+
+    // Archives used from the plain cache move into the compressed one; the dictionary
+    // is trained on the first batch large enough to make one worthwhile
+    if (ConfigManager::instance().config().cacheCompression) {
+        std::vector<fs::path> raw;
+        for (const auto* p : archives) {
+            if (p->mapped.empty() && FileSystem::isFile(p->archive)) {
+                raw.push_back(p->archive);
+            }
+        }
+        if (!raw.empty()) {
+            compressed.train(raw);
+        }
+        std::vector<char> moved(raw.size(), 0);
+        parallelFor(ctx_.scheduler(), raw.size(), [&](size_t i) {
+            moved[i] = compressed.pack(raw[i]);
+        });
+        for (size_t i = 0; i < raw.size(); ++i) {
+            if (moved[i]) {
+                report_.packed++;
+            } else {
+                Logger::warning("Could not compress {}", raw[i].string());
+            }
+        }
+    }
+
+    throughput.sample(ThroughputStats::Rate::DOWNLOAD, static_cast<double>(report_.fetch.bytes), fetchSeconds);
+    throughput.sample(ThroughputStats::Rate::EXTRACT, extractBytes, extractSeconds);
+    throughput.sample(ThroughputStats::Rate::COPY, copyBytes, copySeconds);
+    throughput.save(ctx_.getAmbRoot());
+    return true;
+}
+
+} // namespace amb
\ No newline at end of file
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "core/lockfile.hpp"
+#include "core/manifest.hpp"
+#include "core/workspace.hpp"
+#include "package/hook_runner.hpp"
+#include "package/install_plan.hpp"
+#include "package/resolver.hpp"
+#include "package/signatures.hpp"
+#include "registry/fetcher.hpp"
+#include "registry/prefetcher.hpp"
+#include "utils/file_lock.hpp"
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace amb {
+
+namespace fs = std::filesystem;
+
+class Context;
+
+struct InstallOptions {
+    bool global = false;       // install into ~/.ambar/lib instead of ./ambar_modules/lib
+    bool runScripts = false;   // run pre_install/build/post_install hooks afterwards
+};
+
+struct RemoveOptions {
+    bool cascade = false;      // also remove every package that depends on a target
+};
+
+struct InstallReport {
+    size_t installed = 0;  // newly extracted packages
+    size_t reused = 0;     // already present in the target lib dir
+    size_t viaDelta = 0;   // built from a previous version plus a delta artifact
+    size_t copied = 0;     // copied from the global lib dir instead of fetched
+    size_t fromSnapshot = 0;  // extracted straight out of a mapped snapshot bundle
+    size_t unpacked = 0;   // decoded from the compressed cache instead of fetched
+    size_t packed = 0;     // archives moved into the compressed cache afterwards
+    size_t removed = 0;    // package versions deleted by remove()
+    FetchReport fetch;
+    HookReport hooks;
+    SignatureReport signatures;
+};
+
+// Install pipeline: resolve -> fetch into the cache -> extract -> write ambar.lock
+class Installer {
+public:
+    explicit Installer(Context& ctx);
+
+    // Installs `specs` (adding them to ambar.json in project mode), or everything
+    // declared by ambar.json/ambar.lock when `specs` is empty.
+    bool install(const std::vector<PackageSpec>& specs, const InstallOptions& options);
+
+    // Installs every member of the enclosing workspace from one resolution: packages go
+    // once into the workspace store and each member's ambar_modules/lib links the versions
+    // it uses. Each member still gets its own ambar.lock and resolution table.
+    bool installWorkspace(const InstallOptions& options = {});
+
+    // Moves `names` (every direct dependency when empty) to the newest versions ambar.json
+    // allows. Packages with a registry delta from an installed/cached version are patched
+    // instead of downloaded in full.
+    bool update(const std::vector<std::string>& names, const InstallOptions& options = {});
+
+    // Resolve like install()/update() but only describe the work: nothing is fetched,
+    // extracted or written. The plan can be saved and carried out later by execute().
+    std::optional<InstallPlan> planInstall(const std::vector<PackageSpec>& specs, const InstallOptions& options);
+    std::optional<InstallPlan> planUpdate(const std::vector<std::string>& names, const InstallOptions& options = {});
+
+    // Installs a plan's resolution as computed, without resolving again. Refused when the
+    // project's ambar.json or ambar.lock changed since the plan was made.
+    bool execute(const InstallPlan& plan);
+
+    // Removes `names` from ambar.json, ambar.lock and ambar_modules. A package that other
+    // entries still depend on is refused unless `options.cascade` is set, which removes
+    // those dependents too. Dependencies nothing else needs any more go with them. Walks
+    // the lockfile's reverse index, so the cost follows the affected subgraph.
+    bool remove(const std::vector<std::string>& names, const RemoveOptions& options = {});
+
+    const InstallReport& report() const { return report_; }
+
+    // <cache>/<name>-<version>.zip
+    static fs::path cachedArchive(const fs::path& cacheDir, const std::string& name,
+                                  const std::string& version);
+    // Extracts through a temporary sibling directory so a half-written package is never visible
+    static bool extractPackage(const fs::path& archive, const fs::path& target);
+    static bool extractPackage(std::string_view archive, const std::string& label, const fs::path& target);
+    // Like extractPackage, but swaps out an existing (damaged) directory under the same lock
+    static bool replacePackage(const fs::path& archive, const fs::path& target);
+    // Same staging discipline for delta application and tree copies
+    static bool applyDelta(const fs::path& delta, const fs::path& baseDir,
+                           const fs::path& baseArchive, const fs::path& target);
+    static bool copyPackage(const fs::path& source, const fs::path& target);
+
+private:
+    struct Project {
+        fs::path root;
+        Manifest manifest;
+        std::optional<Lockfile> lock;
+        FileLock guard;  // exclusive project lock, held while the project is being changed
+    };
+
+    // `onEntry` sees each ambar.lock entry as it is read (Lockfile::load)
+    Project loadProject(const Lockfile::EntryCallback& onEntry = {}) const;  // the current project
+    Project loadProject(const fs::path& root, const Lockfile::EntryCallback& onEntry = {}) const;
+    // Replaces ambar.lock, and ambar.json when `withManifest`, as one transaction
+    bool saveProject(const Project& project, Lockfile lock, bool withManifest) const;
+    // Rewrites the compiler's import table: the project's when `projectRoot` is set,
+    // the global lib's otherwise
+    void emitResolutionTable(const std::optional<fs::path>& projectRoot,
+                             const std::map<std::string, std::string>& pinned) const;
+
+    // The requirements install() resolves: ambar.json's dependencies (in project mode) and `specs`
+    static std::map<std::string, std::string> installRoots(const Project* project,
+                                                           const std::vector<PackageSpec>& specs);
+    // The project's lock with `names` unpinned, direct or transitive; empty unpins all
+    static Lockfile relaxedLock(const Project& project, const std::vector<std::string>& names);
+    // Plan steps for `resolution`, following the decisions installResolution() would make
+    void describe(InstallPlan& plan, const Resolution& resolution, const RegistryIndex& index,
+                  const fs::path& libDir) const;
+
+    // Runs the hooks of `packages` installed under `libDir` (InstallOptions::runScripts)
+    bool runHooks(const std::map<std::string, LockEntry>& packages, const fs::path& libDir);
+
+    // With `prefetch`, downloads go through it: jobs it already started are joined, its
+    // other speculative jobs are cancelled
+    bool installResolution(Resolution& resolution, const RegistryIndex& index,
+                           const fs::path& libDir, Prefetcher* prefetch = nullptr);
+
+    Context& ctx_;
+    InstallReport report_;
+};
+
+} // namespace amb
\ No newline at end of file
@@ -0,0 +1,77 @@
+#include "package/lock_graph.hpp"
+#include "utils/file_lock.hpp"
+#include "utils/filesystem.hpp"
+#include "utils/logger.hpp"
+
+namespace amb {
+
+namespace {
+
+constexpr char MAGIC[8] = {'A', 'M', 'B', 'L', 'G', 'R', 'F', '1'};
+constexpr size_t HEADER_SIZE = sizeof(MAGIC) + 2 * sizeof(uint64_t);
+
+// Size and modification time of ambar.lock; all zero when it cannot be read
+std::string stamp(const fs::path& lockPath) {
+    std::error_code ec;
+    uint64_t values[2] = {static_cast<uint64_t>(fs::file_size(lockPath, ec)), 0};
+    if (ec) {
+        return std::string(sizeof(values), '\0');
+    }
+    values[1] = static_cast<uint64_t>(fs::last_write_time(lockPath, ec).time_since_epoch().count());
+    return std::string(reinterpret_cast<const char*>(values), sizeof(values));
+}
+
+fs::path indexPath(const fs::path& projectRoot) {
+    return projectRoot / "ambar_modules" / LockGraph::FILE_NAME;
+}
+
+bool write(const fs::path& projectRoot, const DependencyGraph& graph) {
+    fs::path path = indexPath(projectRoot);
+    auto guard = FileLock::acquire(FileLock::siblingLockPath(path), LockMode::EXCLUSIVE);
+    fs::path staging = path;
+    staging += ".tmp";
+    std::string content(MAGIC, sizeof(MAGIC));
+    content += stamp(projectRoot / "ambar.lock");
+    content += graph.serialize();
+    if (!FileSystem::writeFile(staging, content)) {
+        return false;
+    }
+    std::error_code ec;
+    fs::rename(staging, path, ec);
+    FileSystem::invalidate(staging);
+    FileSystem::invalidate(path);
+    return !ec;
+}
+
+} // namespace
+
+bool LockGraph::save(const fs::path& projectRoot, const Lockfile& lock) {
+    return write(projectRoot, DependencyGraph::fromLockfile(lock));
+}
+
+std::optional<DependencyGraph> LockGraph::load(const fs::path& projectRoot) {
+    fs::path lockPath = projectRoot / "ambar.lock";
+    if (auto content = FileSystem::readFile(indexPath(projectRoot))) {
+        std::string_view data(*content);
+        if (data.size() >= HEADER_SIZE && data.substr(0, sizeof(MAGIC)) == std::string_view(MAGIC, sizeof(MAGIC)) &&
+            data.substr(sizeof(MAGIC), HEADER_SIZE - sizeof(MAGIC)) == stamp(lockPath)) {
+            if (auto graph = DependencyGraph::deserialize(data.substr(HEADER_SIZE))) {
+                return graph;
+            }
+            Logger::debug("{} is damaged, rebuilding it", indexPath(projectRoot).string());
+        }
+    }
+
+    auto lock = Lockfile::load(lockPath);
+    if (!lock) {
+        return std::nullopt;
+    }
+    auto graph = DependencyGraph::fromLockfile(*lock);
+    // Only saves the next query the parse
+    if (!write(projectRoot, graph)) {
+        Logger::debug("Could not write {}", indexPath(projectRoot).string());
+    }
+    return graph;
+}
+
+} // namespace amb
\ No newline at end of file
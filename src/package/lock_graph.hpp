@@ -0,0 +1,26 @@
+#pragma once
+
+#include "core/lockfile.hpp"
+#include "package/dependency_graph.hpp"
+
+#include <filesystem>
+#include <optional>
+
+namespace amb {
+
+namespace fs = std::filesystem;
+
+// The dependency graph of a project's ambar.lock, kept prebuilt in
+// ambar_modules/.lock-graph so queries such as `amb why` and `amb tree` skip parsing
+// the lock. The file names the size and modification time of the lock it was built
+// from; any other lock is read again and the file rewritten.
+class LockGraph {
+public:
+    static constexpr const char* FILE_NAME = ".lock-graph";
+
+    static bool save(const fs::path& projectRoot, const Lockfile& lock);
+    // nullopt when the project has no readable ambar.lock
+    static std::optional<DependencyGraph> load(const fs::path& projectRoot);
+};
+
+} // namespace amb
\ No newline at end of file
@@ -0,0 +1,211 @@
+#include "package/resolution_table.hpp"
+#include "amb/resolution_table.hpp"
+#include "amb/version.hpp"
+#include "utils/file_lock.hpp"
+#include "utils/filesystem.hpp"
+#include "utils/logger.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace amb {
+
+namespace {
+
+// Average keys per bucket; 4 keeps the seed search short while the seed array stays small
+constexpr size_t KEYS_PER_BUCKET = 4;
+constexpr uint32_t MAX_SEED = 1u << 24;
+
+template <typename T>
+void append(std::string& out, const T& value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+bool isHidden(const fs::path& path) {
+    // Skips lock files and the staging directories of in-flight installs
+    return FileSystem::filename(path).starts_with(".");
+}
+
+} // namespace
+
+std::map<std::string, fs::path> ResolutionTableWriter::collect(
+    const fs::path& libDir, const std::map<std::string, std::string>& pinned) {
+    std::map<std::string, fs::path> entries;
+    if (!FileSystem::isDirectory(libDir)) {
+        return entries;
+    }
+
+    for (const auto& packageDir : FileSystem::listDirectories(libDir)) {
+        if (isHidden(packageDir)) {
+            continue;
+        }
+        std::string name = FileSystem::filename(packageDir);
+        std::optional<Version> newest;
+        fs::path newestDir;
+
+        for (const auto& versionDir : FileSystem::listDirectories(packageDir)) {
+            if (isHidden(versionDir)) {
+                continue;
+            }
+            std::string version = FileSystem::filename(versionDir);
+            fs::path root = fs::absolute(versionDir).lexically_normal();
+            entries[name + "@" + version] = root;
+
+            Version parsed(version);
+            if (!newest || parsed > *newest) {
+                newest = parsed;
+                newestDir = root;
+            }
+        }
+        if (!newest) {
+            continue;
+        }
+
+        auto pin = pinned.find(name);
+        auto pinnedEntry = pin == pinned.end() ? entries.end() : entries.find(name + "@" + pin->second);
+        entries[name] = pinnedEntry != entries.end() ? pinnedEntry->second : newestDir;
+    }
+    return entries;
+}
+
+bool ResolutionTableWriter::write(const fs::path& table, const std::map<std::string, fs::path>& entries) {
+    std::vector<std::string> keys;
+    std::vector<std::string> roots;
+    keys.reserve(entries.size());
+    roots.reserve(entries.size());
+    for (const auto& [key, root] : entries) {
+        keys.push_back(key);
+        roots.push_back(root.string());
+    }
+
+    size_t count = keys.size();
+    if (count > std::numeric_limits<uint32_t>::max()) {
+        Logger::error("Too many entries for a resolution table: {}", count);
+        return false;
+    }
+    size_t bucketCount = std::max<size_t>(1, (count + KEYS_PER_BUCKET - 1) / KEYS_PER_BUCKET);
+
+    // Hash-and-displace: place the largest buckets first, searching each bucket for a
+    // seed that sends all of its keys to distinct free slots
+    std::vector<std::vector<uint32_t>> buckets(bucketCount);
+    for (size_t i = 0; i < count; ++i) {
+        buckets[resolutionHash(keys[i], 0) % bucketCount].push_back(static_cast<uint32_t>(i));
+    }
+    std::vector<uint32_t> order(bucketCount);
+    for (size_t b = 0; b < bucketCount; ++b) {
+        order[b] = static_cast<uint32_t>(b);
+    }
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        return buckets[a].size() > buckets[b].size();
+    });
+
+    std::vector<uint32_t> seeds(bucketCount, 0);
+    std::vector<uint32_t> slotOf(count, 0);
+    std::vector<char> taken(count, 0);
+    std::vector<uint32_t> candidate;
+
+    for (uint32_t b : order) {
+        const auto& bucket = buckets[b];
+        if (bucket.empty()) {
+            break;
+        }
+
+        bool placed = false;
+        for (uint32_t seed = 1; seed < MAX_SEED && !placed; ++seed) {
+            candidate.clear();
+            placed = true;
+            for (uint32_t key : bucket) {
+                auto slot = static_cast<uint32_t>(resolutionHash(keys[key], seed) % count);
+                if (taken[slot] || std::find(candidate.begin(), candidate.end(), slot) != candidate.end()) {
+                    placed = false;
+                    break;
+                }
+                candidate.push_back(slot);
+            }
+            if (placed) {
+                seeds[b] = seed;
+                for (size_t k = 0; k < bucket.size(); ++k) {
+                    slotOf[bucket[k]] = candidate[k];
+                    taken[candidate[k]] = 1;
+                }
+            }
+        }
+        if (!placed) {
+            Logger::error("Could not build a perfect hash for {} entries", count);
+            return false;
+        }
+    }
+
+    std::string strings;
+    std::vector<ResolutionTableSlot> slots(count);
+    for (size_t i = 0; i < count; ++i) {
+        if (strings.size() + keys[i].size() + roots[i].size() > std::numeric_limits<uint32_t>::max()) {
+            Logger::error("Resolution table strings exceed 4GB");
+            return false;
+        }
+        auto& slot = slots[slotOf[i]];
+        slot.keyOffset = static_cast<uint32_t>(strings.size());
+        slot.keyLength = static_cast<uint32_t>(keys[i].size());
+        strings += keys[i];
+        slot.rootOffset = static_cast<uint32_t>(strings.size());
+        slot.rootLength = static_cast<uint32_t>(roots[i].size());
+        strings += roots[i];
+    }
+
+    ResolutionTableHeader header{};
+    std::memcpy(header.magic, ResolutionTableHeader::MAGIC, sizeof(header.magic));
+    header.version = ResolutionTableHeader::FORMAT_VERSION;
+    header.byteOrder = ResolutionTableHeader::BYTE_ORDER_MARK;
+    header.count = static_cast<uint32_t>(count);
+    header.bucketCount = static_cast<uint32_t>(bucketCount);
+    header.seedsOffset = sizeof(ResolutionTableHeader);
+    header.slotsOffset = header.seedsOffset + bucketCount * sizeof(uint32_t);
+    header.stringsOffset = header.slotsOffset + count * sizeof(ResolutionTableSlot);
+    header.stringsSize = strings.size();
+
+    std::string out;
+    out.reserve(header.stringsOffset + strings.size());
+    append(out, header);
+    for (uint32_t seed : seeds) {
+        append(out, seed);
+    }
+    for (const auto& slot : slots) {
+        append(out, slot);
+    }
+    out += strings;
+
+    // Readers keep their mapping of the old file; new readers see the complete new one
+    fs::path staging = table;
+    staging += ".tmp";
+    if (!FileSystem::writeFile(staging, out)) {
+        Logger::error("Failed to write {}", staging.string());
+        return false;
+    }
+    std::error_code ec;
+    fs::rename(staging, table, ec);
+    FileSystem::invalidate(staging);
+    FileSystem::invalidate(table);
+    if (ec) {
+        Logger::error("Failed to replace {}: {}", table.string(), ec.message());
+        FileSystem::removeFile(staging);
+        return false;
+    }
+    return true;
+}
+
+bool ResolutionTableWriter::emit(const fs::path& libDir, const fs::path& table,
+                                 const std::map<std::string, std::string>& pinned) {
+    FileSystem::createDirectories(table.parent_path());
+    auto guard = FileLock::acquire(FileLock::siblingLockPath(table), LockMode::EXCLUSIVE);
+
+    auto entries = collect(libDir, pinned);
+    if (!write(table, entries)) {
+        return false;
+    }
+    Logger::debug("Wrote resolution table {} ({} entries)", table.string(), entries.size());
+    return true;
+}
+
+} // namespace amb
\ No newline at end of file
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <filesystem>
+#include <map>
+#include <string>
+
+namespace amb {
+
+namespace fs = std::filesystem;
+
+// Writes the import resolution tables read by include/amb/resolution_table.hpp
+class ResolutionTableWriter {
+public:
+    // Import key -> absolute source root, for every <libDir>/<name>/<version>.
+    // Bare names map to the `pinned` version when installed, the newest one otherwise.
+    static std::map<std::string, fs::path> collect(const fs::path& libDir,
+                                                   const std::map<std::string, std::string>& pinned = {});
+
+    // Builds the minimal perfect hash over `entries` and replaces `table` atomically
+    static bool write(const fs::path& table, const std::map<std::string, fs::path>& entries);
+
+    // collect() + write(), serialized against other amb processes updating the same table
+    static bool emit(const fs::path& libDir, const fs::path& table,
+                     const std::map<std::string, std::string>& pinned = {});
+};
+
+} // namespace amb
\ No newline at end of file
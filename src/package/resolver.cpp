@@ -0,0 +1,210 @@
+#include "package/resolver.hpp"
+#include "amb/version.hpp"
+#include "package/dependency_graph.hpp"
+#include "registry/registry_index.hpp"
+#include "utils/logger.hpp"
+
+#include <deque>
+
+namespace amb {
+
+PackageSpec PackageSpec::parse(const std::string& arg) {
+    PackageSpec spec;
+    auto at = arg.find('@');
+    if (at == std::string::npos) {
+        spec.name = arg;
+    } else {
+        spec.name = arg.substr(0, at);
+        spec.range = arg.substr(at + 1);
+        if (spec.range.empty()) {
+            spec.range = "latest";
+        }
+    }
+    return spec;
+}
+
+Resolver::Resolver(const RegistryIndex& index, const Lockfile* lock)
+    : index_(index), lock_(lock) {}
+
+std::optional<std::string> Resolver::pick(const std::string& name, const std::string& range,
+                                          const Resolution& resolution) const {
+    std::optional<Version> bestVersion;
+
+    auto consider = [&](const std::string& candidate) {
+        Version v(candidate);
+        if (v.satisfies(range) && (!bestVersion || v > *bestVersion)) {
+            bestVersion = v;
+        }
+    };
+
+    // 1. A version already chosen in this resolution (dedup)
+    for (auto it = resolution.packages.lower_bound(name + "@");
+         it != resolution.packages.end() && it->second.name == name; ++it) {
+        consider(it->second.version);
+    }
+    // 2. A version pinned by the lockfile
+    if (!bestVersion && lock_) {
+        for (auto it = lock_->packages.lower_bound(name + "@");
+             it != lock_->packages.end() && it->second.name == name; ++it) {
+            consider(it->second.version);
+        }
+    }
+    if (bestVersion) {
+        return bestVersion->toString();
+    }
+
+    // 3. Highest matching version in the registry
+    if (const auto* record = index_.best(name, range)) {
+        return record->version;
+    }
+    return std::nullopt;
+}
+
+void Resolver::expand(const std::map<std::string, std::string>& roots, Resolution& own,
+                      Resolution& pool) {
+    std::deque<std::pair<std::string, std::string>> queue; // name, exact version
+
+    for (const auto& [name, range] : roots) {
+        auto version = pick(name, range, pool);
+        if (!version) {
+            errors_.push_back("no version of '" + name + "' matches '" + range + "'");
+            continue;
+        }
+        own.roots[name] = *version;
+        queue.emplace_back(name, *version);
+    }
+
+    while (!queue.empty()) {
+        auto [name, version] = queue.front();
+        queue.pop_front();
+
+        std::string key = name + "@" + version;
+        if (own.packages.count(key)) {
+            continue;
+        }
+
+        // Resolved for an earlier member: only the closure is walked again
+        auto shared = pool.packages.find(key);
+        if (shared != pool.packages.end()) {
+            own.packages.emplace(key, shared->second);
+            own.archiveSha256[key] = shared->second.sha256;
+            for (const auto& [depName, depVersion] : shared->second.dependencies) {
+                queue.emplace_back(depName, depVersion);
+            }
+            continue;
+        }
+
+        LockEntry entry;
+        entry.name = name;
+        entry.version = version;
+
+        const LockEntry* locked = lock_ ? lock_->find(name, version) : nullptr;
+        const PackageRecord* record = index_.find(name, version);
+
+        if (locked) {
+            entry.sha256 = locked->sha256;
+            entry.dependencies = locked->dependencies;
+        } else if (record) {
+            entry.sha256 = record->sha256;
+        } else {
+            errors_.push_back("package '" + key + "' not found in registry");
+            continue;
+        }
+
+        pool.packages.emplace(key, entry);
+        auto& stored = pool.packages[key];
+
+        // A locked entry keeps its edges, except those unpinned for an update
+        if (record) {
+            for (const auto& [depName, depRange] : record->dependencies) {
+                if (locked && stored.dependencies.count(depName)) {
+                    continue;
+                }
+                auto depVersion = pick(depName, depRange, pool);
+                if (!depVersion) {
+                    errors_.push_back("no version of '" + depName + "' matches '" + depRange +
+                                      "' (required by " + key + ")");
+                    continue;
+                }
+                stored.dependencies[depName] = *depVersion;
+            }
+        }
+
+        pool.archiveSha256[key] = stored.sha256;
+        if (&own != &pool) {
+            own.packages.emplace(key, stored);
+            own.archiveSha256[key] = stored.sha256;
+        }
+        for (const auto& [depName, depVersion] : stored.dependencies) {
+            queue.emplace_back(depName, depVersion);
+        }
+    }
+}
+
+bool Resolver::finish(const Resolution& pool) const {
+    if (!errors_.empty()) {
+        for (const auto& error : errors_) {
+            Logger::error("Resolution failed: {}", error);
+        }
+        return false;
+    }
+
+    // Nodes are in (name, version) order, so the versions of a package are neighbours
+    auto graph = DependencyGraph::fromPackages(pool.packages, {});
+    for (DependencyGraph::NodeId first = 0, last = 0; first < graph.size(); first = last) {
+        while (last < graph.size() && graph.name(last) == graph.name(first)) {
+            ++last;
+        }
+        if (last - first < 2) {
+            continue;
+        }
+        std::string list;
+        for (auto node = first; node < last; ++node) {
+            std::string requiredBy;
+            for (auto dependent : graph.dependents(node)) {
+                requiredBy += (requiredBy.empty() ? "" : ", ") + graph.key(dependent);
+            }
+            list += (list.empty() ? "" : "; ") + std::string(graph.version(node));
+            if (!requiredBy.empty()) {
+                list += " (by " + requiredBy + ")";
+            }
+        }
+        Logger::warning("Multiple versions of '{}' will be installed: {}", std::string(graph.name(first)), list);
+    }
+
+    for (const auto& cycle : graph.cycles()) {
+        std::string members;
+        for (auto node : cycle) {
+            members += (members.empty() ? "" : ", ") + graph.key(node);
+        }
+        Logger::warning("Dependency cycle between {}", members);
+    }
+    return true;
+}
+
+std::optional<Resolution> Resolver::resolve(const std::map<std::string, std::string>& roots) {
+    Resolution resolution;
+    errors_.clear();
+
+    expand(roots, resolution, resolution);
+    if (!finish(resolution)) {
+        return std::nullopt;
+    }
+    return resolution;
+}
+
+std::optional<WorkspaceResolution> Resolver::resolveWorkspace(
+    const std::vector<std::map<std::string, std::string>>& members) {
+    WorkspaceResolution resolution;
+    errors_.clear();
+
+    for (const auto& roots : members) {
+        expand(roots, resolution.members.emplace_back(), resolution.store);
+    }
+    if (!finish(resolution.store)) {
+        return std::nullopt;
+    }
+    return resolution;
+}
+
+} // namespace amb
\ No newline at end of file
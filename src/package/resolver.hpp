@@ -0,0 +1,65 @@
+#pragma once
+
+#include "core/lockfile.hpp"
+
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace amb {
+
+class RegistryIndex;
+
+// "name" or "name@range" as typed on the command line
+struct PackageSpec {
+    std::string name;
+    std::string range = "latest";
+
+    static PackageSpec parse(const std::string& arg);
+};
+
+struct Resolution {
+    std::map<std::string, std::string> roots;   // direct deps: name -> exact version
+    std::map<std::string, LockEntry> packages;  // closure keyed by name@version
+    std::map<std::string, std::string> archiveSha256; // name@version -> expected archive digest
+};
+
+struct WorkspaceResolution {
+    Resolution store;                 // every member's closure, installed once (no roots)
+    std::vector<Resolution> members;  // each member's roots and closure, in input order
+};
+
+// Picks exact versions for a set of root requirements.
+// Existing lock entries are reused whenever they still satisfy the requested ranges;
+// otherwise the highest matching version from the index wins. Multiple versions of the
+// same package may coexist (blueprint §10) - duplication is reported as a warning.
+class Resolver {
+public:
+    Resolver(const RegistryIndex& index, const Lockfile* lock);
+
+    std::optional<Resolution> resolve(const std::map<std::string, std::string>& roots);
+
+    // Resolves several projects as one: a version picked for one member is reused by the
+    // others whenever it satisfies their ranges, and the dependencies of a package are
+    // resolved once however many members reach it.
+    std::optional<WorkspaceResolution> resolveWorkspace(
+        const std::vector<std::map<std::string, std::string>>& members);
+
+    const std::vector<std::string>& errors() const { return errors_; }
+
+private:
+    std::optional<std::string> pick(const std::string& name, const std::string& range,
+                                    const Resolution& resolution) const;
+    // Adds the closure of `roots` to `own`; packages already in `pool` are taken from
+    // there, new ones are added to both. `own` and `pool` may be the same resolution.
+    void expand(const std::map<std::string, std::string>& roots, Resolution& own, Resolution& pool);
+    // Logs the errors and the packages present in several versions; false on errors
+    bool finish(const Resolution& pool) const;
+
+    const RegistryIndex& index_;
+    const Lockfile* lock_;
+    std::vector<std::string> errors_;
+};
+
+} // namespace amb
\ No newline at end of file
@@ -0,0 +1,84 @@
+#include "package/signatures.hpp"
+#include "registry/registry_index.hpp"
+#include "utils/ed25519.hpp"
+#include "utils/filesystem.hpp"
+#include "utils/logger.hpp"
+
+#include <algorithm>
+
+namespace amb {
+
+namespace {
+
+// The signature covers name, version and digest, so a verdict only stands for all three:
+// another record reusing this digest, key and signature must be verified on its own
+std::string verdictLine(const SignedArtifact& artifact) {
+    return artifact.name + "@" + artifact.version + " " + artifact.publicKey + " " + artifact.signature + "\n";
+}
+
+} // namespace
+
+SignatureChecker::SignatureChecker(fs::path cacheDir, SignaturePolicy policy)
+    : cacheDir_(std::move(cacheDir)), policy_(std::move(policy)) {}
+
+fs::path SignatureChecker::verdictPath(const std::string& sha256) const {
+    return cacheDir_ / "signatures" / sha256;
+}
+
+SignatureReport SignatureChecker::check(const std::vector<SignedArtifact>& artifacts) const {
+    SignatureReport report;
+    std::vector<Ed25519::BatchItem> batch;
+    std::vector<const SignedArtifact*> batched;
+
+    for (const auto& artifact : artifacts) {
+        std::string label = artifact.name + "@" + artifact.version;
+        if (artifact.signature.empty()) {
+            if (policy_.requireSignatures) {
+                report.problems.push_back(label + " is not signed");
+            } else {
+                report.unsigned_++;
+            }
+            continue;
+        }
+        if (!policy_.trustedKeys.empty() &&
+            std::find(policy_.trustedKeys.begin(), policy_.trustedKeys.end(), artifact.publicKey) ==
+                policy_.trustedKeys.end()) {
+            report.problems.push_back(label + " is signed by an untrusted key " + artifact.publicKey.substr(0, 16));
+            continue;
+        }
+        auto key = Ed25519::parsePublicKey(artifact.publicKey);
+        auto signature = Ed25519::parseSignature(artifact.signature);
+        if (!key || !signature || artifact.sha256.empty()) {
+            report.problems.push_back(label + " has a malformed signature");
+            continue;
+        }
+
+        if (auto verdicts = FileSystem::readFile(verdictPath(artifact.sha256))) {
+            if (verdicts->find(verdictLine(artifact)) != std::string::npos) {
+                report.cached++;
+                continue;
+            }
+        }
+
+        batch.push_back({*key, signaturePayload(artifact.name, artifact.version, artifact.sha256), *signature});
+        batched.push_back(&artifact);
+    }
+
+    auto verdicts = Ed25519::verifyBatch(batch);
+    for (size_t i = 0; i < batched.size(); ++i) {
+        const auto& artifact = *batched[i];
+        if (!verdicts[i]) {
+            report.problems.push_back(artifact.name + "@" + artifact.version + " has an invalid signature");
+            continue;
+        }
+        report.verified++;
+        // Appends of one short line do not interleave, so concurrent installs are safe
+        FileSystem::appendFile(verdictPath(artifact.sha256), verdictLine(artifact));
+    }
+
+    Logger::debug("Signatures: {} verified, {} cached, {} unsigned", report.verified, report.cached,
+                  report.unsigned_);
+    return report;
+}
+
+} // namespace amb
\ No newline at end of file
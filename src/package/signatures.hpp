@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace amb {
+
+namespace fs = std::filesystem;
+
+// A package about to be installed, with the signature its registry record carries
+struct SignedArtifact {
+    std::string name;
+    std::string version;
+    std::string sha256;     // digest that will be installed (the lockfile's when pinned)
+    std::string publicKey;  // hex, empty when unsigned
+    std::string signature;  // hex
+};
+
+struct SignaturePolicy {
+    std::vector<std::string> trustedKeys;  // empty: any key, signatures only prove integrity
+    bool requireSignatures = false;
+};
+
+struct SignatureReport {
+    size_t verified = 0;   // checked in this run
+    size_t cached = 0;     // verdict already in the content store
+    size_t unsigned_ = 0;  // no signature, allowed by the policy
+    std::vector<std::string> problems;
+
+    bool ok() const { return problems.empty(); }
+};
+
+// Package signatures (blueprint §12). All signatures of an install transaction are
+// checked in one Ed25519 batch before anything is extracted (archives ambar.lock pins may
+// already be downloading by then, checked against the lock's digest). A good verdict is
+// recorded per archive digest in <cache>/signatures/<sha256> (one
+// "<name>@<version> <key> <signature>" line per verified signature, since that is what
+// the signature covers), so an archive is never verified twice on this machine.
+class SignatureChecker {
+public:
+    SignatureChecker(fs::path cacheDir, SignaturePolicy policy);
+
+    SignatureReport check(const std::vector<SignedArtifact>& artifacts) const;
+
+private:
+    fs::path verdictPath(const std::string& sha256) const;
+
+    fs::path cacheDir_;
+    SignaturePolicy policy_;
+};
+
+} // namespace amb
\ No newline at end of file
@@ -0,0 +1,127 @@
+#include "package/snapshot_builder.hpp"
+#include "amb/config.hpp"
+#include "core/context.hpp"
+#include "core/manifest.hpp"
+#include "package/compressed_cache.hpp"
+#include "package/installer.hpp"
+#include "registry/registry_index.hpp"
+#include "registry/snapshot_bundle.hpp"
+#include "utils/error.hpp"
+#include "utils/file_lock.hpp"
+#include "utils/filesystem.hpp"
+#include "utils/logger.hpp"
+#include "utils/sha256.hpp"
+
+namespace amb {
+
+SnapshotBuilder::SnapshotBuilder(Context& ctx) : ctx_(ctx) {}
+
+std::optional<SnapshotReport> SnapshotBuilder::create(const std::vector<PackageSpec>& specs,
+                                                      const fs::path& output) {
+    auto& config = ConfigManager::instance();
+
+    // The project's pins are honoured, so the bundle installs exactly what ambar.lock says
+    std::map<std::string, std::string> roots;
+    std::optional<Lockfile> lock;
+    if (ctx_.isInsideProject()) {
+        fs::path root = *ctx_.getProjectRoot();
+        if (auto manifest = Manifest::load(root / "ambar.json")) {
+            roots = manifest->dependencies;
+        }
+        if (FileSystem::isFile(root / "ambar.lock")) {
+            lock = Lockfile::load(root / "ambar.lock");
+        }
+    }
+    for (const auto& spec : specs) {
+        roots[spec.name] = spec.range;
+    }
+    if (roots.empty()) {
+        throw CommandError("snapshot", "nothing to pack: no dependencies in ambar.json and no packages given");
+    }
+
+    auto url = Url::parse(config.getRegistryUrl());
+    auto index = RegistryIndex::load(config.getRegistryUrl(), config.config().networkTimeout, ctx_.getCacheDir());
+    if (!url || !index) {
+        return std::nullopt;
+    }
+    auto resolution = Resolver(*index, lock ? &*lock : nullptr).resolve(roots);
+    if (!resolution) {
+        return std::nullopt;
+    }
+
+    // Archives are packed from the cache, fetching the missing ones first
+    fs::path cacheDir = ctx_.getCacheDir();
+    auto cacheGuard = FileLock::acquire(cacheDir / ".lock", LockMode::SHARED);
+
+    RegistryIndex subset;
+    std::vector<const PackageRecord*> records;
+    std::vector<fs::path> archives;
+    std::vector<FetchJob> jobs;
+    // A packed archive is decoded when written instead of being fetched again
+    CompressedCache compressed(cacheDir);
+    for (const auto& [key, entry] : resolution->packages) {
+        const auto* record = index->find(entry.name, entry.version);
+        if (!record) {
+            throw CommandError("snapshot", key + " is pinned by ambar.lock but not in the registry");
+        }
+        PackageRecord packed = *record;
+        packed.deltas.clear();  // bundles carry full archives only
+        subset.add(packed);
+        records.push_back(record);
+        fs::path archive = Installer::cachedArchive(cacheDir, entry.name, entry.version);
+        archives.push_back(archive);
+        if (FileSystem::isFile(archive) || !FileSystem::isFile(CompressedCache::packedPath(archive))) {
+            jobs.push_back({index->archiveUrl(*record), archive, record->sha256, record->size});
+        }
+    }
+
+    SnapshotReport report;
+    report.fetch = Fetcher(Fetcher::defaultOptions()).fetchAll(jobs);
+    for (const auto& error : report.fetch.errors) {
+        Logger::error("Download failed: {}", error);
+    }
+    if (!report.fetch.ok()) {
+        return std::nullopt;
+    }
+
+    TransportOptions options;
+    options.timeoutSeconds = config.config().networkTimeout;
+    auto transport = TransportFactory::instance().create(url->scheme, options);
+
+    SnapshotWriter writer;
+    if (!writer.open(output) || !writer.add(RegistryIndex::INDEX_FILE, subset.serialize())) {
+        return std::nullopt;
+    }
+    for (size_t i = 0; i < records.size(); ++i) {
+        const auto& record = *records[i];
+        auto archive = FileSystem::readFile(archives[i]);
+        if (!archive) {
+            archive = compressed.unpack(archives[i]);
+            if (archive && !record.sha256.empty() && Sha256::hash(*archive) != record.sha256) {
+                archive.reset();
+            }
+        }
+        if (!archive || !writer.add(record.archivePath(), *archive)) {
+            Logger::error("Failed to pack {}@{}", record.name, record.version);
+            return std::nullopt;
+        }
+        // Per-file digests let `amb verify` check installs from the bundle too
+        try {
+            auto digests = transport ? transport->getText(url->join(record.digestsPath())) : std::nullopt;
+            if (digests && !writer.add(record.digestsPath(), *digests)) {
+                return std::nullopt;
+            }
+        } catch (const NetworkError& e) {
+            Logger::debug("No file digests for {}@{}: {}", record.name, record.version, e.what());
+        }
+    }
+    if (!writer.close()) {
+        return std::nullopt;
+    }
+
+    report.packages = records.size();
+    report.bytes = FileSystem::fileSize(output);
+    return report;
+}
+
+} // namespace amb
\ No newline at end of file
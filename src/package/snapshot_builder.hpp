@@ -0,0 +1,38 @@
+#pragma once
+
+#include "package/resolver.hpp"
+#include "registry/fetcher.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+namespace amb {
+
+namespace fs = std::filesystem;
+
+class Context;
+
+struct SnapshotReport {
+    size_t packages = 0;
+    uint64_t bytes = 0;  // size of the bundle
+    FetchReport fetch;   // archives that had to be downloaded first
+};
+
+// `amb snapshot create`: packs the resolved closure of the current project (plus `specs`)
+// into one bundle (registry/snapshot_bundle.hpp) holding an index.json of just those
+// versions, their archives and per-file digests. `amb install --from-snapshot` and
+// snapshot:// registries install from it with no network access.
+class SnapshotBuilder {
+public:
+    explicit SnapshotBuilder(Context& ctx);
+
+    std::optional<SnapshotReport> create(const std::vector<PackageSpec>& specs, const fs::path& output);
+
+private:
+    Context& ctx_;
+};
+
+} // namespace amb
\ No newline at end of file
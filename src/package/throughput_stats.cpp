@@ -0,0 +1,104 @@
+#include "package/throughput_stats.hpp"
+#include "utils/file_lock.hpp"
+#include "utils/filesystem.hpp"
+#include "utils/logger.hpp"
+#include "json.hpp"
+
+#include <iterator>
+
+using json = nlohmann::json;
+
+namespace amb {
+
+namespace {
+
+// Weight of the newest run in the averages
+constexpr double SMOOTHING = 0.3;
+
+constexpr double MIN_SAMPLE_SECONDS = 0.05;
+constexpr double MIN_SAMPLE_BYTES = 256 * 1024;
+
+// File keys, indexed by ThroughputStats::Rate
+constexpr const char* KEYS[] = {
+    "download_bytes_per_second",
+    "extract_bytes_per_second",
+    "copy_bytes_per_second",
+    "hook_seconds",
+};
+
+json read(const fs::path& path) {
+    auto content = FileSystem::readFile(path);
+    if (!content) {
+        return json::object();
+    }
+    auto j = json::parse(*content, nullptr, false);
+    if (j.is_discarded() || !j.is_object()) {
+        Logger::debug("Ignoring malformed {}", path.string());
+        return json::object();
+    }
+    return j;
+}
+
+} // namespace
+
+ThroughputStats ThroughputStats::load(const fs::path& ambRoot) {
+    ThroughputStats stats;
+    json j = read(ambRoot / FILE_NAME);
+    double* fields[] = {&stats.downloadBytesPerSecond, &stats.extractBytesPerSecond,
+                        &stats.copyBytesPerSecond, &stats.hookSeconds};
+    for (size_t i = 0; i < std::size(KEYS); ++i) {
+        if (j.contains(KEYS[i]) && j[KEYS[i]].is_number()) {
+            *fields[i] = j[KEYS[i]].get<double>();
+        }
+    }
+    stats.runs = j.value("runs", size_t{0});
+    return stats;
+}
+
+void ThroughputStats::sample(Rate rate, double amount, double seconds) {
+    if (amount <= 0 || seconds < MIN_SAMPLE_SECONDS) {
+        return;
+    }
+    if (rate == Rate::HOOK) {
+        samples_[static_cast<size_t>(rate)] = seconds / amount;
+    } else if (amount >= MIN_SAMPLE_BYTES) {
+        samples_[static_cast<size_t>(rate)] = amount / seconds;
+    }
+}
+
+bool ThroughputStats::save(const fs::path& ambRoot) const {
+    bool measured = false;
+    for (double value : samples_) {
+        measured = measured || value > 0;
+    }
+    if (!measured) {
+        return true;
+    }
+
+    fs::path path = ambRoot / FILE_NAME;
+    auto guard = FileLock::acquire(FileLock::siblingLockPath(path), LockMode::EXCLUSIVE);
+    // Another process may have saved since this one loaded
+    json j = read(path);
+    for (size_t i = 0; i < std::size(KEYS); ++i) {
+        if (samples_[i] <= 0) {
+            continue;
+        }
+        bool known = j.contains(KEYS[i]) && j[KEYS[i]].is_number();
+        double value = known ? j[KEYS[i]].get<double>() : samples_[i];
+        j[KEYS[i]] = value + SMOOTHING * (samples_[i] - value);
+    }
+    j["runs"] = j.value("runs", size_t{0}) + 1;
+
+    fs::path staging = path;
+    staging += ".tmp";
+    if (!FileSystem::writeFile(staging, j.dump(2))) {
+        return false;
+    }
+    std::error_code ec;
+    fs::rename(staging, path, ec);
+    FileSystem::invalidate(staging);
+    FileSystem::invalidate(path);
+    return !ec;
+}
+
+} // namespace amb
\ No newline at end of file
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+
+namespace amb {
+
+namespace fs = std::filesystem;
+
+// Rates measured by earlier installs, in ~/.ambar/throughput.json, used to estimate how
+// long an install plan will take. Each rate is an exponentially weighted average over
+// the runs that measured it; the defaults stand in until a first run has.
+struct ThroughputStats {
+    static constexpr const char* FILE_NAME = "throughput.json";
+
+    enum class Rate { DOWNLOAD, EXTRACT, COPY, HOOK };
+
+    double downloadBytesPerSecond = 10e6;  // aggregate over parallel fetches
+    double extractBytesPerSecond = 100e6;  // archive bytes unpacked per second, all jobs
+    double copyBytesPerSecond = 200e6;     // global lib -> project tree copies
+    double hookSeconds = 1.0;              // one hook process
+    size_t runs = 0;                       // measurements folded in so far
+
+    static ThroughputStats load(const fs::path& ambRoot);
+
+    // `amount` is bytes, or hook runs for Rate::HOOK. Tiny samples are ignored: they
+    // mostly measure fixed overhead and would skew the averages.
+    void sample(Rate rate, double amount, double seconds);
+
+    // Folds this run's samples into the file under its lock
+    bool save(const fs::path& ambRoot) const;
+
+private:
+    double samples_[4] = {};  // this run's measurements, 0 = none
+};
+
+} // namespace amb
\ No newline at end of file
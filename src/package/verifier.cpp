@@ -0,0 +1,412 @@
+#include "package/verifier.hpp"
+#include "amb/config.hpp"
+#include "core/context.hpp"
+#include "core/lockfile.hpp"
+#include "core/scheduler.hpp"
+#include "package/compressed_cache.hpp"
+#include "package/hook_runner.hpp"
+#include "package/installer.hpp"
+#include "registry/delta.hpp"
+#include "registry/registry_index.hpp"
+#include "registry/transport.hpp"
+#include "utils/error.hpp"
+#include "utils/file_lock.hpp"
+#include "utils/filesystem.hpp"
+#include "utils/logger.hpp"
+#include "utils/sha256.hpp"
+#include "json.hpp"
+
+#include <algorithm>
+#include <mutex>
+#include <set>
+#include <unordered_set>
+
+using json = nlohmann::json;
+
+namespace amb {
+
+namespace {
+
+enum Status : uint8_t {
+    PENDING,
+    VERIFIED,
+    RESUMED,
+    MISMATCHED,
+    MISSING
+};
+
+// Flush the checkpoint after this many verified entries or this much time
+constexpr size_t CHECKPOINT_BATCH = 256;
+constexpr auto CHECKPOINT_INTERVAL = std::chrono::seconds(1);
+constexpr auto PROGRESS_INTERVAL = std::chrono::seconds(5);
+
+const char* scopeName(VerifyScope scope) {
+    switch (scope) {
+        case VerifyScope::REGISTRY: return "registry";
+        case VerifyScope::CACHE: return "cache";
+        case VerifyScope::PROJECT: return "project";
+    }
+    return "unknown";
+}
+
+RegistryIndex loadIndex(const fs::path& cacheDir) {
+    const auto& config = ConfigManager::instance();
+    auto index = RegistryIndex::load(config.getRegistryUrl(), config.config().networkTimeout, cacheDir);
+    if (!index) {
+        throw CommandError("verify", "could not load the registry index");
+    }
+    return std::move(*index);
+}
+
+} // namespace
+
+Verifier::Verifier(Context& ctx) : ctx_(ctx) {}
+
+std::vector<Verifier::Entry> Verifier::registryEntries(VerifyReport& report) const {
+    fs::path root = ConfigManager::instance().getRegistryPath();
+    if (root.empty()) {
+        throw CommandError("verify", "--registry needs a file:// registry (got " +
+                                         ConfigManager::instance().getRegistryUrl() + ")");
+    }
+    auto index = loadIndex(ctx_.getCacheDir());
+
+    std::vector<Entry> entries;
+    for (const auto& name : index.packageNames()) {
+        for (const auto& record : *index.versions(name)) {
+            // A scanned registry (no index.json) has nothing recorded to compare against
+            if (record.sha256.empty()) {
+                report.unverifiable++;
+                continue;
+            }
+            entries.push_back({name + "@" + record.version, root / record.archivePath(),
+                               record.sha256, record.size, std::nullopt, ""});
+            for (const auto& [from, delta] : record.deltas) {
+                entries.push_back({name + "@" + from + "->" + record.version, root / record.deltaPath(from),
+                                   delta.sha256, delta.size, std::nullopt, ""});
+            }
+        }
+    }
+    return entries;
+}
+
+std::vector<Verifier::Entry> Verifier::cacheEntries(VerifyReport& report) const {
+    auto index = loadIndex(ctx_.getCacheDir());
+    fs::path cacheDir = ctx_.getCacheDir();
+
+    // The cache only holds what was needed, so absent entries are not errors
+    std::vector<Entry> entries;
+    for (const auto& name : index.packageNames()) {
+        for (const auto& record : *index.versions(name)) {
+            fs::path archive = Installer::cachedArchive(cacheDir, name, record.version);
+            fs::path packed = CompressedCache::packedPath(archive);
+            bool isPacked = !FileSystem::isFile(archive) && FileSystem::isFile(packed);
+            if (FileSystem::isFile(archive) || isPacked) {
+                if (record.sha256.empty()) {
+                    report.unverifiable++;
+                } else {
+                    // A packed entry is re-fetched raw; the recorded size is that of the raw archive
+                    FetchJob job{index.archiveUrl(record), archive, record.sha256, record.size};
+                    entries.push_back({name + "@" + record.version, isPacked ? packed : archive,
+                                       record.sha256, isPacked ? 0 : record.size, job, "", isPacked});
+                }
+            }
+            for (const auto& [from, delta] : record.deltas) {
+                fs::path file = cacheDir / (name + "-" + from + "-" + record.version + ".delta");
+                if (FileSystem::isFile(file)) {
+                    FetchJob job{index.deltaUrl(record, from), file, delta.sha256, delta.size};
+                    entries.push_back({name + "@" + from + "->" + record.version, file,
+                                       delta.sha256, delta.size, job, ""});
+                }
+            }
+        }
+    }
+    return entries;
+}
+
+std::vector<Verifier::Entry> Verifier::projectEntries(VerifyReport& report) const {
+    fs::path root = *ctx_.getProjectRoot();
+    auto lock = Lockfile::load(root / "ambar.lock");
+    if (!lock) {
+        throw CommandError("verify", "no ambar.lock in this project (run amb install first)");
+    }
+    auto index = loadIndex(ctx_.getCacheDir());
+
+    auto url = Url::parse(ConfigManager::instance().getRegistryUrl());
+    TransportOptions options;
+    options.timeoutSeconds = ConfigManager::instance().config().networkTimeout;
+    auto transport = url ? TransportFactory::instance().create(url->scheme, options) : nullptr;
+    CompressedCache compressed(ctx_.getCacheDir());
+
+    std::vector<Entry> entries;
+    for (const auto& [key, locked] : lock->packages) {
+        fs::path dir = ctx_.getModulesDir() / locked.name / locked.version;
+        if (!FileSystem::isDirectory(dir)) {
+            entries.push_back({key + " (not installed)", dir, "", 0, std::nullopt, key});
+            continue;
+        }
+
+        // Per-file digests published with the package, else those of the cached archive
+        std::optional<FileDigests> digests;
+        const PackageRecord* record = index.find(locked.name, locked.version);
+        if (record && transport) {
+            try {
+                if (auto content = transport->getText(url->join(record->digestsPath()))) {
+                    auto j = json::parse(*content, nullptr, false);
+                    if (j.is_object()) {
+                        digests = j.get<FileDigests>();
+                    }
+                }
+            } catch (const std::exception& e) {
+                Logger::debug("No digest list for {}: {}", key, e.what());
+            }
+        }
+        fs::path archive = Installer::cachedArchive(ctx_.getCacheDir(), locked.name, locked.version);
+        if (!digests && FileSystem::isFile(archive) && Sha256::hashFile(archive) == locked.sha256) {
+            digests = digestArchive(archive);
+        } else if (!digests && FileSystem::isFile(CompressedCache::packedPath(archive))) {
+            auto data = compressed.unpack(archive);
+            if (data && Sha256::hash(*data) == locked.sha256) {
+                digests = digestArchiveData(*data);
+            }
+        }
+        if (!digests) {
+            Logger::warning("No recorded file digests for {}, skipping it", key);
+            report.unverifiable++;
+            continue;
+        }
+
+        for (const auto& [rel, sha256] : *digests) {
+            entries.push_back({key + "/" + rel, dir / rel, sha256, 0, std::nullopt, key});
+        }
+    }
+    return entries;
+}
+
+VerifyReport Verifier::run(const VerifyOptions& options) {
+    auto start = std::chrono::steady_clock::now();
+    VerifyReport report;
+
+    std::optional<FileLock> guard;
+    std::vector<Entry> entries;
+    fs::path target;
+    switch (options.scope) {
+        case VerifyScope::REGISTRY:
+            entries = registryEntries(report);
+            target = ConfigManager::instance().getRegistryPath();
+            break;
+        case VerifyScope::CACHE:
+            // Shared like any other reader; re-fetched entries are additions
+            guard = FileLock::acquire(ctx_.getCacheDir() / ".lock", LockMode::SHARED);
+            entries = cacheEntries(report);
+            target = ctx_.getCacheDir();
+            break;
+        case VerifyScope::PROJECT:
+            if (!ctx_.isInsideProject()) {
+                throw CommandError("verify", "not in an Ambar project directory");
+            }
+            target = *ctx_.getProjectRoot();
+            guard = FileLock::acquire(target / "ambar_modules" / ".lock",
+                                      options.repair ? LockMode::EXCLUSIVE : LockMode::SHARED);
+            entries = projectEntries(report);
+            break;
+    }
+
+    // One checkpoint per scope and target, e.g. ~/.ambar/verify/cache-1a2b3c4d5e6f.checkpoint
+    fs::path checkpoint = ctx_.getAmbRoot() / "verify" /
+        (std::string(scopeName(options.scope)) + "-" + Sha256::hash(target.string()).substr(0, 12) + ".checkpoint");
+    if (options.restart) {
+        FileSystem::removeFile(checkpoint);
+    }
+    std::unordered_set<std::string> done;
+    if (auto content = FileSystem::readFile(checkpoint)) {
+        size_t begin = 0;
+        for (size_t end; (end = content->find('\n', begin)) != std::string::npos; begin = end + 1) {
+            done.insert(content->substr(begin, end - begin));
+        }
+        Logger::info("Resuming from a checkpoint with {} verified entries", done.size());
+    }
+
+    // Largest first so one big archive does not end up alone at the tail of the run
+    std::vector<uint64_t> sizes(entries.size(), 0);
+    std::vector<size_t> order(entries.size());
+    for (size_t i = 0; i < entries.size(); ++i) {
+        std::error_code ec;
+        auto size = fs::file_size(entries[i].path, ec);
+        sizes[i] = ec ? 0 : size;
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return sizes[a] > sizes[b]; });
+
+    CompressedCache compressed(ctx_.getCacheDir());
+    std::vector<uint8_t> status(entries.size(), PENDING);
+    std::mutex mutex;
+    std::string pending;
+    size_t pendingCount = 0;
+    auto lastFlush = std::chrono::steady_clock::now();
+    auto lastProgress = lastFlush;
+    std::atomic<size_t> finished{0};
+    std::atomic<uint64_t> bytes{0};
+    FileSystem::createDirectories(checkpoint.parent_path());
+
+    auto flush = [&] {
+        if (!pending.empty()) {
+            FileSystem::appendFile(checkpoint, pending);
+            pending.clear();
+            pendingCount = 0;
+        }
+    };
+
+    parallelFor(ctx_.scheduler(), order.size(), [&](size_t n) {
+        size_t i = order[n];
+        const auto& entry = entries[i];
+
+        std::error_code ec;
+        bool isFile = fs::is_regular_file(entry.path, ec);
+        auto size = isFile ? fs::file_size(entry.path, ec) : 0;
+        auto mtime = isFile ? fs::last_write_time(entry.path, ec).time_since_epoch().count() : 0;
+        std::string key = entry.sha256 + "\t" + std::to_string(size) + "\t" + std::to_string(mtime) +
+                          "\t" + entry.path.string();
+
+        if (!isFile || ec) {
+            status[i] = MISSING;
+        } else if (done.count(key)) {
+            status[i] = RESUMED;
+        } else if (entry.size > 0 && size != entry.size) {
+            status[i] = MISMATCHED;
+        } else if (entry.packed) {
+            // Undecodable counts as a mismatch: the archive cannot be read back either
+            auto data = compressed.unpack(fs::path(entry.path).replace_extension());
+            status[i] = data && Sha256::hash(*data) == entry.sha256 ? VERIFIED : MISMATCHED;
+            bytes += size;
+        } else {
+            status[i] = Sha256::hashFile(entry.path) == entry.sha256 ? VERIFIED : MISMATCHED;
+            bytes += size;
+        }
+        finished++;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (status[i] == VERIFIED) {
+            pending += key + "\n";
+            pendingCount++;
+        }
+        auto now = std::chrono::steady_clock::now();
+        if (pendingCount >= CHECKPOINT_BATCH || now - lastFlush >= CHECKPOINT_INTERVAL) {
+            flush();
+            lastFlush = now;
+        }
+        if (now - lastProgress >= PROGRESS_INTERVAL) {
+            Logger::info("Verified {} of {} entries ({} MB)", finished.load(), entries.size(),
+                         bytes.load() / (1024 * 1024));
+            lastProgress = now;
+        }
+    }, TaskPriority::HIGH);
+    flush();
+
+    std::vector<const Entry*> bad;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        switch (status[i]) {
+            case VERIFIED: report.checked++; break;
+            case RESUMED: report.resumed++; break;
+            case MISMATCHED:
+                report.checked++;
+                report.mismatched++;
+                report.problems.push_back("digest mismatch: " + entries[i].label);
+                bad.push_back(&entries[i]);
+                break;
+            case MISSING:
+                report.missing++;
+                report.problems.push_back("missing: " + entries[i].label);
+                bad.push_back(&entries[i]);
+                break;
+            default: break;
+        }
+    }
+    report.bytes = bytes;
+
+    if (options.repair && !bad.empty()) {
+        if (options.scope == VerifyScope::CACHE) {
+            repairCache(bad, report);
+        } else if (options.scope == VerifyScope::PROJECT) {
+            repairProject(bad, report);
+        } else {
+            Logger::warning("Registry entries cannot be re-fetched: the registry is their origin");
+        }
+    }
+
+    // The run completed, so the next one starts from scratch
+    FileSystem::removeFile(checkpoint);
+    report.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    return report;
+}
+
+void Verifier::repairCache(const std::vector<const Entry*>& bad, VerifyReport& report) const {
+    std::vector<FetchJob> jobs;
+    for (const auto* entry : bad) {
+        if (entry->refetch) {
+            FileSystem::removeFile(entry->path);
+            jobs.push_back(*entry->refetch);
+        }
+    }
+
+    Fetcher fetcher(Fetcher::defaultOptions());
+    auto result = fetcher.fetchAll(jobs);
+    report.repaired += jobs.size() - result.failed;
+    for (const auto& error : result.errors) {
+        report.problems.push_back("re-fetch failed: " + error);
+    }
+}
+
+void Verifier::repairProject(const std::vector<const Entry*>& bad, VerifyReport& report) const {
+    auto lock = Lockfile::load(*ctx_.getProjectRoot() / "ambar.lock");
+    auto index = loadIndex(ctx_.getCacheDir());
+
+    std::map<std::string, size_t> packages;  // name@version -> bad entries
+    for (const auto* entry : bad) {
+        packages[entry->package]++;
+    }
+
+    // Reinstall from a verified archive: the fetcher re-checks (or re-downloads) it
+    std::vector<FetchJob> jobs;
+    std::vector<const LockEntry*> targets;
+    for (const auto& [key, count] : packages) {
+        auto it = lock->packages.find(key);
+        if (it == lock->packages.end()) {
+            continue;
+        }
+        const auto& locked = it->second;
+        PackageRecord location;
+        location.name = locked.name;
+        location.version = locked.version;
+        const auto* record = index.find(locked.name, locked.version);
+        jobs.push_back({index.archiveUrl(record ? *record : location),
+                        Installer::cachedArchive(ctx_.getCacheDir(), locked.name, locked.version),
+                        locked.sha256, record ? record->size : 0});
+        targets.push_back(&locked);
+    }
+
+    Fetcher fetcher(Fetcher::defaultOptions());
+    auto result = fetcher.fetchAll(jobs);
+    for (const auto& error : result.errors) {
+        report.problems.push_back("re-fetch failed: " + error);
+    }
+
+    fs::path hooksDir = HookRunner(ctx_, ctx_.getModulesDir()).stateDir();
+    for (size_t i = 0; i < targets.size(); ++i) {
+        const auto& locked = *targets[i];
+        if (!FileSystem::isFile(jobs[i].destination)) {
+            continue;
+        }
+        fs::path dir = ctx_.getModulesDir() / locked.name / locked.version;
+        if (Installer::replacePackage(jobs[i].destination, dir)) {
+            Logger::debug("Reinstalled {}", locked.key());
+            // Hook outputs went with the old tree, so the next install must run them again
+            FileSystem::removeFile(hooksDir / (locked.key() + ".json"));
+            FileSystem::removeFile(hooksDir / (locked.key() + ".log"));
+            report.repaired += packages[locked.key()];
+        } else {
+            report.problems.push_back("reinstall failed: " + locked.key());
+        }
+    }
+}
+
+} // namespace amb
\ No newline at end of file
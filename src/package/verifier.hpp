@@ -0,0 +1,75 @@
+#pragma once
+
+#include "registry/fetcher.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace amb {
+
+namespace fs = std::filesystem;
+
+class Context;
+
+enum class VerifyScope {
+    REGISTRY,   // archives and deltas of the configured file:// registry against index.json
+    CACHE,      // cached archives and deltas against the registry index
+    PROJECT     // installed files of ambar.lock packages against their per-file digests
+};
+
+struct VerifyOptions {
+    VerifyScope scope = VerifyScope::CACHE;
+    bool repair = false;    // re-fetch bad cache entries / reinstall bad project packages
+    bool restart = false;   // ignore the checkpoint of an interrupted run
+};
+
+struct VerifyReport {
+    size_t checked = 0;       // entries hashed by this run
+    size_t resumed = 0;       // entries already verified by an interrupted run
+    size_t unverifiable = 0;  // no recorded digest to compare against
+    size_t mismatched = 0;
+    size_t missing = 0;
+    size_t repaired = 0;
+    uint64_t bytes = 0;       // bytes hashed
+    std::chrono::milliseconds elapsed{0};
+    std::vector<std::string> problems;
+
+    bool ok() const { return mismatched + missing <= repaired; }
+};
+
+// Bulk integrity check behind `amb verify`. Entries are hashed in parallel on the
+// scheduler, largest first, and every verified entry is appended to a checkpoint under
+// <amb root>/verify so an interrupted run resumes where it stopped (an entry is only
+// skipped while its size and mtime are unchanged).
+class Verifier {
+public:
+    explicit Verifier(Context& ctx);
+
+    VerifyReport run(const VerifyOptions& options);
+
+private:
+    struct Entry {
+        std::string label;
+        fs::path path;
+        std::string sha256;
+        uint64_t size = 0;               // expected size, 0 if unknown
+        std::optional<FetchJob> refetch; // cache scope repair
+        std::string package;             // project scope repair (name@version)
+        bool packed = false;             // `path` is a CompressedCache file, hashed once decoded
+    };
+
+    std::vector<Entry> registryEntries(VerifyReport& report) const;
+    std::vector<Entry> cacheEntries(VerifyReport& report) const;
+    std::vector<Entry> projectEntries(VerifyReport& report) const;
+
+    void repairCache(const std::vector<const Entry*>& bad, VerifyReport& report) const;
+    void repairProject(const std::vector<const Entry*>& bad, VerifyReport& report) const;
+
+    Context& ctx_;
+};
+
+} // namespace amb
\ No newline at end of file
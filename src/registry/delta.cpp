@@ -0,0 +1,237 @@
+#include "registry/delta.hpp"
+#include "utils/archive.hpp"
+#include "utils/filesystem.hpp"
+#include "utils/logger.hpp"
+#include "utils/sha256.hpp"
+#include "json.hpp"
+
+#include <set>
+
+using json = nlohmann::json;
+
+namespace amb {
+
+std::optional<FileDigests> loadFileDigests(const fs::path& path) {
+    auto content = FileSystem::readFile(path);
+    if (!content) {
+        return std::nullopt;
+    }
+    try {
+        return json::parse(*content).get<FileDigests>();
+    } catch (const std::exception& e) {
+        Logger::warning("Invalid digest list {}: {}", path.string(), e.what());
+        return std::nullopt;
+    }
+}
+
+bool saveFileDigests(const fs::path& path, const FileDigests& digests) {
+    return FileSystem::writeFile(path, json(digests).dump(1) + "\n");
+}
+
+namespace {
+
+std::optional<FileDigests> digestEntries(const ZipReader& reader) {
+    FileDigests digests;
+    for (const auto& entry : reader.entries()) {
+        if (entry.isDirectory) {
+            continue;
+        }
+        auto content = reader.read(entry);
+        if (!content) {
+            return std::nullopt;
+        }
+        digests[entry.path] = Sha256::hash(*content);
+    }
+    return digests;
+}
+
+} // namespace
+
+std::optional<FileDigests> digestArchive(const fs::path& archive) {
+    ZipReader reader;
+    if (!reader.open(archive)) {
+        return std::nullopt;
+    }
+    return digestEntries(reader);
+}
+
+std::optional<FileDigests> digestArchiveData(std::string_view archive) {
+    ZipReader reader;
+    if (!reader.openMemory(archive)) {
+        return std::nullopt;
+    }
+    return digestEntries(reader);
+}
+
+std::optional<uint64_t> PackageDelta::build(const std::string& name,
+                                            const std::string& from, const FileDigests& fromFiles,
+                                            const std::string& to, const fs::path& toArchive,
+                                            const fs::path& output) {
+    ZipReader reader;
+    if (!reader.open(toArchive)) {
+        return std::nullopt;
+    }
+
+    DeltaManifest manifest;
+    manifest.name = name;
+    manifest.from = from;
+    manifest.to = to;
+
+    ZipWriter writer;
+    writer.open(output);
+    uint64_t payload = 0;
+
+    for (const auto& entry : reader.entries()) {
+        if (entry.isDirectory) {
+            continue;
+        }
+        auto content = reader.read(entry);
+        if (!content) {
+            return std::nullopt;
+        }
+
+        auto digest = Sha256::hash(*content);
+        manifest.files[entry.path] = digest;
+
+        auto previous = fromFiles.find(entry.path);
+        if (previous == fromFiles.end() || previous->second != digest) {
+            manifest.changed.push_back(entry.path);
+            writer.add(FILES_PREFIX + entry.path, *content);
+            payload += content->size();
+        }
+    }
+
+    for (const auto& [path, _] : fromFiles) {
+        if (!manifest.files.count(path)) {
+            manifest.removed.push_back(path);
+        }
+    }
+
+    json j;
+    j["name"] = manifest.name;
+    j["from"] = manifest.from;
+    j["to"] = manifest.to;
+    j["files"] = manifest.files;
+    j["changed"] = manifest.changed;
+    j["removed"] = manifest.removed;
+    writer.add(MANIFEST_ENTRY, j.dump());
+
+    if (!writer.close()) {
+        return std::nullopt;
+    }
+    return payload;
+}
+
+namespace {
+
+std::optional<DeltaManifest> parseManifest(const ZipReader& reader) {
+    const auto* entry = reader.find(PackageDelta::MANIFEST_ENTRY);
+    if (!entry) {
+        return std::nullopt;
+    }
+    auto content = reader.read(*entry);
+    if (!content) {
+        return std::nullopt;
+    }
+    try {
+        auto j = json::parse(*content);
+        DeltaManifest m;
+        m.name = j.at("name").get<std::string>();
+        m.from = j.at("from").get<std::string>();
+        m.to = j.at("to").get<std::string>();
+        m.files = j.at("files").get<FileDigests>();
+        m.changed = j.value("changed", std::vector<std::string>{});
+        m.removed = j.value("removed", std::vector<std::string>{});
+        return m;
+    } catch (const std::exception& e) {
+        Logger::error("Invalid delta manifest: {}", e.what());
+        return std::nullopt;
+    }
+}
+
+} // namespace
+
+std::optional<DeltaManifest> PackageDelta::readManifest(const fs::path& delta) {
+    ZipReader reader;
+    if (!reader.open(delta)) {
+        return std::nullopt;
+    }
+    return parseManifest(reader);
+}
+
+bool PackageDelta::apply(const fs::path& delta, const fs::path& baseDir,
+                         const fs::path& baseArchive, const fs::path& target) {
+    ZipReader reader;
+    if (!reader.open(delta)) {
+        return false;
+    }
+    auto manifest = parseManifest(reader);
+    if (!manifest) {
+        return false;
+    }
+
+    ZipReader base;
+    bool haveBaseDir = !baseDir.empty() && FileSystem::isDirectory(baseDir);
+    bool haveBase = !haveBaseDir && !baseArchive.empty() && base.open(baseArchive);
+    if (!haveBaseDir && !haveBase) {
+        Logger::error("No base version available to apply delta {} -> {}", manifest->from, manifest->to);
+        return false;
+    }
+
+    std::set<std::string> changed(manifest->changed.begin(), manifest->changed.end());
+    std::vector<FileWrite> writes;
+
+    if (!FileSystem::createDirectories(target)) {
+        return false;
+    }
+
+    for (const auto& [path, digest] : manifest->files) {
+        if (!isSafeArchivePath(path)) {
+            Logger::error("Refusing unsafe path '{}' in delta", path);
+            return false;
+        }
+        fs::path out = target / fs::path(path);
+
+        if (changed.count(path)) {
+            const auto* entry = reader.find(FILES_PREFIX + path);
+            auto content = entry ? reader.read(*entry) : std::nullopt;
+            if (!content || Sha256::hash(*content) != digest) {
+                Logger::error("Delta payload for '{}' failed verification", path);
+                return false;
+            }
+            writes.push_back(FileWrite{std::move(out), std::move(*content)});
+            continue;
+        }
+
+        // The installed base may have been edited in place (by hand or by a hook), so
+        // it is hashed like everything else; its contents are copied, never linked, so
+        // a later write to one version cannot show through in the other
+        if (haveBaseDir) {
+            auto content = FileSystem::readFile(baseDir / fs::path(path));
+            if (content && Sha256::hash(*content) == digest) {
+                writes.push_back(FileWrite{std::move(out), std::move(*content)});
+                continue;
+            }
+            Logger::warning("Installed file '{}' in {} does not match the expected digest",
+                            path, baseDir.string());
+            if (!haveBase) {
+                haveBase = !baseArchive.empty() && base.open(baseArchive);
+            }
+            if (!haveBase) {
+                return false;
+            }
+        }
+
+        const auto* entry = base.find(path);
+        auto content = entry ? base.read(*entry) : std::nullopt;
+        if (!content || Sha256::hash(*content) != digest) {
+            Logger::error("Base file '{}' does not match the expected digest", path);
+            return false;
+        }
+        writes.push_back(FileWrite{std::move(out), std::move(*content)});
+    }
+
+    return FileSystem::writeFiles(writes);
+}
+
+} // namespace amb
\ No newline at end of file
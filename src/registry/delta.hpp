@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace amb {
+
+namespace fs = std::filesystem;
+
+// Per-file SHA-256 digests of one package version (registry/<name>/<version>/files.json)
+using FileDigests = std::map<std::string, std::string>; // relative path -> sha256
+
+std::optional<FileDigests> loadFileDigests(const fs::path& path);
+bool saveFileDigests(const fs::path& path, const FileDigests& digests);
+// Digests of every file inside a package archive, on disk or already in memory
+std::optional<FileDigests> digestArchive(const fs::path& archive);
+std::optional<FileDigests> digestArchiveData(std::string_view archive);
+
+// Describes how to turn version `from` into version `to`
+struct DeltaManifest {
+    std::string name;
+    std::string from;
+    std::string to;
+    FileDigests files;                 // every file of `to`
+    std::vector<std::string> changed;  // shipped inside the delta under files/
+    std::vector<std::string> removed;  // present in `from` only (informational)
+};
+
+// Per-file delta artifacts between adjacent versions.
+// A delta is a ZIP holding delta.json plus the changed/added files of the new version;
+// unchanged files are taken from the previous version already on disk.
+class PackageDelta {
+public:
+    static constexpr const char* MANIFEST_ENTRY = "delta.json";
+    static constexpr const char* FILES_PREFIX = "files/";
+
+    // Writes a delta from `fromFiles` to the contents of `toArchive`.
+    // Returns the number of payload bytes, or nullopt on failure.
+    static std::optional<uint64_t> build(const std::string& name,
+                                         const std::string& from, const FileDigests& fromFiles,
+                                         const std::string& to, const fs::path& toArchive,
+                                         const fs::path& output);
+
+    static std::optional<DeltaManifest> readManifest(const fs::path& delta);
+
+    // Materializes the new version in `target`. Unchanged files are copied from
+    // `baseDir` when they still match their digest, otherwise from `baseArchive`.
+    static bool apply(const fs::path& delta, const fs::path& baseDir,
+                      const fs::path& baseArchive, const fs::path& target);
+};
+
+} // namespace amb
\ No newline at end of file
@@ -0,0 +1,275 @@
+#include "registry/fetcher.hpp"
+#include "amb/config.hpp"
+#include "utils/error.hpp"
+#include "utils/file_lock.hpp"
+#include "utils/filesystem.hpp"
+#include "utils/logger.hpp"
+#include "utils/resource_usage.hpp"
+#include "utils/sha256.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <thread>
+
+namespace amb {
+
+bool verifyArtifact(const fs::path& path, const std::string& sha256, uint64_t size) {
+    std::error_code ec;
+    if (!fs::is_regular_file(path, ec)) {
+        return false;
+    }
+    if (size > 0 && fs::file_size(path, ec) != size) {
+        return false;
+    }
+    if (!sha256.empty() && Sha256::hashFile(path) != sha256) {
+        return false;
+    }
+    return true;
+}
+
+Fetcher::Fetcher(Options options) : options_(std::move(options)) {
+    options_.maxConnections = std::max<size_t>(1, options_.maxConnections);
+    options_.maxConnectionsPerHost = std::max<size_t>(1, options_.maxConnectionsPerHost);
+}
+
+Fetcher::~Fetcher() = default;
+
+Fetcher::Options Fetcher::defaultOptions() {
+    Options options;
+    if (ConfigManager::instance().isInitialized()) {
+        options.timeoutSeconds = std::max(1, ConfigManager::instance().config().networkTimeout);
+    }
+    return options;
+}
+
+Transport& Fetcher::transportFor(const std::string& scheme) {
+    std::lock_guard lock(transportMutex_);
+    auto it = transports_.find(scheme);
+    if (it != transports_.end()) {
+        return *it->second;
+    }
+
+    TransportOptions transportOptions;
+    transportOptions.timeoutSeconds = options_.timeoutSeconds;
+    auto transport = TransportFactory::instance().create(scheme, transportOptions);
+    if (!transport) {
+        throw PackageError("unsupported registry URL scheme '" + scheme + "'");
+    }
+    auto& ref = *transport;
+    transports_[scheme] = std::move(transport);
+    return ref;
+}
+
+void Fetcher::acquireHost(const std::string& hostKey) {
+    std::unique_lock lock(hostMutex_);
+    hostCv_.wait(lock, [&] { return activePerHost_[hostKey] < options_.maxConnectionsPerHost; });
+    activePerHost_[hostKey]++;
+}
+
+void Fetcher::releaseHost(const std::string& hostKey) {
+    {
+        std::lock_guard lock(hostMutex_);
+        activePerHost_[hostKey]--;
+    }
+    hostCv_.notify_all();
+}
+
+void Fetcher::cancel(const fs::path& destination) {
+    std::lock_guard lock(cancelMutex_);
+    cancelled_.insert(destination);
+}
+
+bool Fetcher::isCancelled(const fs::path& destination) {
+    std::lock_guard lock(cancelMutex_);
+    return cancelled_.count(destination) > 0;
+}
+
+FetchReport Fetcher::fetchAll(const std::vector<FetchJob>& jobs) {
+    FetchReport report;
+    if (jobs.empty()) {
+        return report;
+    }
+
+    std::atomic<size_t> next{0};
+    auto worker = [&] {
+        for (size_t i = next++; i < jobs.size(); i = next++) {
+            try {
+                auto outcome = fetchOne(jobs[i], report);
+                std::lock_guard lock(reportMutex_);
+                if (outcome == Outcome::Cached) {
+                    ResourceUsage::add(ResourceUsage::Counter::ARCHIVE_CACHE_HITS);
+                    report.cached++;
+                } else if (outcome == Outcome::Cancelled) {
+                    report.cancelled++;
+                } else {
+                    ResourceUsage::add(ResourceUsage::Counter::ARCHIVE_DOWNLOADS);
+                    report.downloaded++;
+                }
+            } catch (const std::exception& e) {
+                std::lock_guard lock(reportMutex_);
+                report.failed++;
+                report.errors.push_back(jobs[i].url + ": " + e.what());
+            }
+        }
+    };
+
+    size_t workers = std::min(options_.maxConnections, jobs.size());
+    std::vector<std::thread> threads;
+    threads.reserve(workers - 1);
+    for (size_t i = 1; i < workers; ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    Logger::debug("Fetch finished: {} downloaded, {} cached, {} failed, {} cancelled, {} bytes ({} resumed)",
+                  report.downloaded, report.cached, report.failed, report.cancelled, report.bytes,
+                  report.resumedBytes);
+    return report;
+}
+
+Fetcher::Outcome Fetcher::fetchOne(const FetchJob& job, FetchReport& report) {
+    auto url = Url::parse(job.url);
+    if (!url) {
+        throw PackageError("invalid URL '" + job.url + "'");
+    }
+    if (isCancelled(job.destination)) {
+        return Outcome::Cancelled;
+    }
+
+    // One downloader per artifact across processes; later ones find it cached
+    fs::path lockPath = job.destination;
+    lockPath += ".lock";
+    auto guard = FileLock::acquire(lockPath, LockMode::EXCLUSIVE);
+
+    if (verifyArtifact(job.destination, job.sha256, job.size)) {
+        return Outcome::Cached;
+    }
+
+    FileSystem::createDirectories(job.destination.parent_path());
+
+    auto backoff = options_.initialBackoff;
+    auto maxBackoff = std::chrono::milliseconds(std::chrono::seconds(options_.timeoutSeconds));
+
+    for (int attemptNo = 0;; ++attemptNo) {
+        if (isCancelled(job.destination)) {
+            return Outcome::Cancelled;
+        }
+        acquireHost(url->hostKey());
+        try {
+            bool done = attempt(job, *url, report);
+            releaseHost(url->hostKey());
+            if (done) {
+                return Outcome::Downloaded;
+            }
+            if (isCancelled(job.destination)) {
+                return Outcome::Cancelled;
+            }
+        } catch (const NetworkError& e) {
+            releaseHost(url->hostKey());
+            if (attemptNo >= options_.maxRetries) {
+                throw;
+            }
+            Logger::debug("Fetch of {} failed ({}), retrying in {}ms",
+                          job.url, e.what(), backoff.count());
+        } catch (...) {
+            releaseHost(url->hostKey());
+            throw;
+        }
+
+        std::this_thread::sleep_for(backoff);
+        backoff = std::min(backoff * 2, maxBackoff);
+    }
+}
+
+bool Fetcher::attempt(const FetchJob& job, const Url& url, FetchReport& report) {
+    fs::path part = job.destination;
+    part += ".part";
+
+    std::error_code ec;
+    uint64_t offset = fs::is_regular_file(part, ec) ? fs::file_size(part, ec) : 0;
+    if (job.size > 0 && offset > job.size) {
+        fs::remove(part, ec);
+        offset = 0;
+    }
+
+    std::ofstream out(part, std::ios::binary | (offset > 0 ? std::ios::app : std::ios::trunc));
+    if (!out.is_open()) {
+        throw FilesystemError("cannot write " + part.string());
+    }
+
+    uint64_t written = offset;
+    auto& transport = transportFor(url.scheme);
+    auto info = transport.get(url, offset, [&](uint64_t position, const char* data, size_t size) {
+        if (isCancelled(job.destination)) {
+            return false;
+        }
+        if (position != written) {
+            // Server ignored the range request: start over
+            out.close();
+            out.open(part, std::ios::binary | std::ios::trunc);
+            written = 0;
+            if (position != 0) {
+                return false;
+            }
+        }
+        if (written == offset) {
+            std::lock_guard lock(cancelMutex_);
+            if (!firstByte_) {
+                firstByte_ = true;
+                Logger::debug("First byte received from {}", url.toString());
+            }
+        }
+        out.write(data, static_cast<std::streamsize>(size));
+        written += size;
+        received_ += size;
+        if (auto* progress = progress_.load()) {
+            progress->advance(size);
+        }
+        return out.good();
+    });
+    out.close();
+
+    if (isCancelled(job.destination)) {
+        fs::remove(part, ec);
+        FileSystem::invalidate(part);
+        return false;
+    }
+
+    if (!info.found) {
+        fs::remove(part, ec);
+        throw PackageError("not found in registry: " + url.toString());
+    }
+
+    {
+        std::lock_guard lock(reportMutex_);
+        report.bytes += info.received;
+        if (info.rangeHonored) {
+            report.resumedBytes += offset;
+        }
+    }
+
+    uint64_t expected = job.size > 0 ? job.size : info.totalSize;
+    if (expected > 0 && written < expected) {
+        throw NetworkError("incomplete transfer (" + std::to_string(written) + "/" +
+                           std::to_string(expected) + " bytes)");
+    }
+
+    if (!verifyArtifact(part, job.sha256, job.size)) {
+        fs::remove(part, ec);
+        throw NetworkError("digest mismatch for " + url.toString());
+    }
+
+    fs::rename(part, job.destination, ec);
+    FileSystem::invalidate(part);
+    FileSystem::invalidate(job.destination);
+    if (ec) {
+        throw FilesystemError("cannot move " + part.string() + ": " + ec.message());
+    }
+    return true;
+}
+
+} // namespace amb
\ No newline at end of file
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "core/output.hpp"
+#include "registry/transport.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace amb {
+
+namespace fs = std::filesystem;
+
+struct FetchJob {
+    std::string url;
+    fs::path destination;
+    std::string sha256;     // expected digest, empty to skip verification
+    uint64_t size = 0;      // expected size, 0 if unknown
+};
+
+struct FetchReport {
+    size_t downloaded = 0;  // jobs that hit the network
+    size_t cached = 0;      // destination already present and valid
+    size_t failed = 0;
+    size_t cancelled = 0;   // abandoned through Fetcher::cancel()
+    uint64_t bytes = 0;         // bytes received over the transport
+    uint64_t resumedBytes = 0;  // bytes reused from partial downloads
+    std::vector<std::string> errors;
+
+    bool ok() const { return failed == 0; }
+};
+
+// Downloads registry artifacts concurrently.
+// - at most `maxConnections` transfers in flight, `maxConnectionsPerHost` per host
+// - partial downloads are kept as "<destination>.part" and resumed with range requests
+// - transient failures are retried with exponential backoff bounded by the network timeout
+// - cancel() abandons a job, queued or in flight; its partial download is removed
+class Fetcher {
+public:
+    struct Options {
+        size_t maxConnections = 16;
+        size_t maxConnectionsPerHost = 6;
+        int timeoutSeconds = 30;
+        int maxRetries = 4;
+        std::chrono::milliseconds initialBackoff{250};
+    };
+
+    explicit Fetcher(Options options);
+    ~Fetcher();
+
+    // Options derived from the global configuration (networkTimeout)
+    static Options defaultOptions();
+
+    FetchReport fetchAll(const std::vector<FetchJob>& jobs);
+
+    // Safe to call from any thread while fetchAll() runs
+    void cancel(const fs::path& destination);
+
+    // Bytes received from now on are added to `progress` (null to stop), which must
+    // outlive the transfers
+    void setProgress(Output::Progress* progress) { progress_ = progress; }
+    // Bytes received over the fetcher's lifetime
+    uint64_t received() const { return received_; }
+
+private:
+    enum class Outcome { Downloaded, Cached, Cancelled };
+
+    bool isCancelled(const fs::path& destination);
+
+    Outcome fetchOne(const FetchJob& job, FetchReport& report);
+    bool attempt(const FetchJob& job, const Url& url, FetchReport& report);
+    Transport& transportFor(const std::string& scheme);
+
+    void acquireHost(const std::string& hostKey);
+    void releaseHost(const std::string& hostKey);
+
+    Options options_;
+
+    std::mutex transportMutex_;
+    std::map<std::string, std::unique_ptr<Transport>> transports_;
+
+    std::mutex hostMutex_;
+    std::condition_variable hostCv_;
+    std::map<std::string, size_t> activePerHost_;
+
+    std::mutex reportMutex_;
+
+    std::mutex cancelMutex_;
+    std::set<fs::path> cancelled_;
+    bool firstByte_ = false;
+
+    std::atomic<Output::Progress*> progress_{nullptr};
+    std::atomic<uint64_t> received_{0};
+};
+
+// True if `path` exists and matches the expected digest/size
+bool verifyArtifact(const fs::path& path, const std::string& sha256, uint64_t size);
+
+} // namespace amb
\ No newline at end of file
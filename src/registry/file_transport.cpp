@@ -0,0 +1,52 @@
+#include "registry/file_transport.hpp"
+#include "utils/error.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace amb {
+
+TransferInfo FileTransport::get(const Url& url, uint64_t offset, const DataSink& sink) {
+    namespace fs = std::filesystem;
+
+    TransferInfo info;
+    fs::path path(url.path);
+
+    std::error_code ec;
+    if (!fs::is_regular_file(path, ec)) {
+        info.found = false;
+        return info;
+    }
+    info.totalSize = fs::file_size(path, ec);
+    info.rangeHonored = true;
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        throw NetworkError("cannot open " + path.string());
+    }
+    if (offset >= info.totalSize) {
+        return info;
+    }
+    file.seekg(static_cast<std::streamoff>(offset));
+
+    std::vector<char> buffer(1 << 16);
+    while (file) {
+        file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        auto got = static_cast<size_t>(file.gcount());
+        if (got == 0) {
+            break;
+        }
+        bool keepGoing = sink(offset + info.received, buffer.data(), got);
+        info.received += got;
+        if (!keepGoing) {
+            break;
+        }
+    }
+    if (file.bad()) {
+        throw NetworkError("read failed for " + path.string());
+    }
+    return info;
+}
+
+} // namespace amb
\ No newline at end of file
@@ -0,0 +1,14 @@
+#pragma once
+
+#include "registry/transport.hpp"
+
+namespace amb {
+
+// Serves file:// registries straight from the local filesystem
+class FileTransport : public Transport {
+public:
+    std::string scheme() const override { return "file"; }
+    TransferInfo get(const Url& url, uint64_t offset, const DataSink& sink) override;
+};
+
+} // namespace amb
\ No newline at end of file
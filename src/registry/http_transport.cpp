@@ -0,0 +1,442 @@
+#include "registry/http_transport.hpp"
+#include "utils/error.hpp"
+#include "utils/logger.hpp"
+#include "utils/resource_usage.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+namespace amb {
+
+namespace {
+
+#ifdef _WIN32
+using socket_t = SOCKET;
+using io_len_t = int;
+constexpr socket_t INVALID_SOCK = INVALID_SOCKET;
+
+void closeSocket(socket_t s) { closesocket(s); }
+
+void ensureWinsock() {
+    static const bool started = [] {
+        WSADATA data;
+        return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+    }();
+    if (!started) {
+        throw NetworkError("WSAStartup failed");
+    }
+}
+#else
+using socket_t = int;
+using io_len_t = size_t;
+constexpr socket_t INVALID_SOCK = -1;
+
+void closeSocket(socket_t s) { ::close(s); }
+void ensureWinsock() {}
+#endif
+
+// Thrown when a pooled keep-alive connection turned out to be closed by the server
+struct StaleConnection : NetworkError {
+    StaleConnection() : NetworkError("stale keep-alive connection") {}
+};
+
+// Raw body chunk callback used by Connection
+using ChunkFn = std::function<bool(const char* data, size_t size)>;
+
+std::string toLower(std::string s) {
+    std::transform(s.begin(), s.end(), s.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return s;
+}
+
+} // namespace
+
+class HttpTransport::Connection {
+public:
+    Connection(const Url& url, int timeoutSeconds) : timeoutSeconds_(timeoutSeconds) {
+        ensureWinsock();
+
+        addrinfo hints{};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo* result = nullptr;
+        std::string port = std::to_string(url.port);
+        if (getaddrinfo(url.host.c_str(), port.c_str(), &hints, &result) != 0 || !result) {
+            throw NetworkError("cannot resolve host " + url.host);
+        }
+
+        std::string lastError = "connection failed";
+        for (addrinfo* ai = result; ai && sock_ == INVALID_SOCK; ai = ai->ai_next) {
+            socket_t s = ::socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+            if (s == INVALID_SOCK) {
+                continue;
+            }
+            if (connectWithTimeout(s, ai->ai_addr, static_cast<int>(ai->ai_addrlen))) {
+                sock_ = s;
+            } else {
+                lastError = "cannot connect to " + url.hostKey();
+                closeSocket(s);
+            }
+        }
+        freeaddrinfo(result);
+
+        if (sock_ == INVALID_SOCK) {
+            throw NetworkError(lastError);
+        }
+        applyTimeouts();
+    }
+
+    ~Connection() {
+        if (sock_ != INVALID_SOCK) {
+            closeSocket(sock_);
+        }
+    }
+
+    Connection(const Connection&) = delete;
+    Connection& operator=(const Connection&) = delete;
+
+    void sendAll(const std::string& data) {
+        size_t sent = 0;
+        while (sent < data.size()) {
+            auto n = ::send(sock_, data.data() + sent, static_cast<io_len_t>(data.size() - sent), 0);
+            if (n <= 0) {
+                throw NetworkError("send failed");
+            }
+            sent += static_cast<size_t>(n);
+        }
+        ResourceUsage::add(ResourceUsage::Counter::NETWORK_SENT, data.size());
+    }
+
+    // Reads one CRLF-terminated line (without the terminator)
+    std::string readLine() {
+        std::string line;
+        while (true) {
+            auto nl = std::find(buffer_.begin() + static_cast<std::ptrdiff_t>(pos_), buffer_.end(), '\n');
+            if (nl != buffer_.end()) {
+                size_t end = static_cast<size_t>(nl - buffer_.begin());
+                line.append(buffer_, pos_, end - pos_);
+                pos_ = end + 1;
+                if (!line.empty() && line.back() == '\r') {
+                    line.pop_back();
+                }
+                return line;
+            }
+            line.append(buffer_, pos_, std::string::npos);
+            pos_ = buffer_.size();
+            if (!fill()) {
+                throw NetworkError("connection closed while reading headers");
+            }
+        }
+    }
+
+    // Streams exactly `length` bytes; returns false if the sink aborted
+    bool readExact(uint64_t length, const ChunkFn& sink, uint64_t& received) {
+        while (length > 0) {
+            if (pos_ == buffer_.size() && !fill()) {
+                throw NetworkError("connection closed mid-body");
+            }
+            size_t take = static_cast<size_t>(std::min<uint64_t>(length, buffer_.size() - pos_));
+            length -= take;
+            received += take;
+            bool keepGoing = !sink || sink(buffer_.data() + pos_, take);
+            pos_ += take;
+            if (!keepGoing) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Streams until the peer closes the connection
+    bool readToEnd(const ChunkFn& sink, uint64_t& received) {
+        while (true) {
+            if (pos_ == buffer_.size() && !fill()) {
+                return true;
+            }
+            size_t take = buffer_.size() - pos_;
+            received += take;
+            bool keepGoing = !sink || sink(buffer_.data() + pos_, take);
+            pos_ += take;
+            if (!keepGoing) {
+                return false;
+            }
+        }
+    }
+
+    bool hasReceivedData() const { return receivedAny_; }
+    void resetActivity() { receivedAny_ = false; }
+
+private:
+    bool fill() {
+        buffer_.resize(64 * 1024);
+        pos_ = 0;
+        auto n = ::recv(sock_, buffer_.data(), static_cast<io_len_t>(buffer_.size()), 0);
+        if (n < 0) {
+            buffer_.clear();
+            throw NetworkError("receive failed or timed out");
+        }
+        buffer_.resize(static_cast<size_t>(n));
+        if (n > 0) {
+            receivedAny_ = true;
+            ResourceUsage::add(ResourceUsage::Counter::NETWORK_RECEIVED, static_cast<uint64_t>(n));
+        }
+        return n > 0;
+    }
+
+    bool connectWithTimeout(socket_t s, const sockaddr* addr, int len) {
+#ifdef _WIN32
+        u_long nonBlocking = 1;
+        ioctlsocket(s, FIONBIO, &nonBlocking);
+        int rc = ::connect(s, addr, len);
+        if (rc != 0 && WSAGetLastError() != WSAEWOULDBLOCK) {
+            return false;
+        }
+        WSAPOLLFD pfd{};
+        pfd.fd = s;
+        pfd.events = POLLOUT;
+        rc = WSAPoll(&pfd, 1, timeoutSeconds_ * 1000);
+        nonBlocking = 0;
+        ioctlsocket(s, FIONBIO, &nonBlocking);
+#else
+        int flags = fcntl(s, F_GETFL, 0);
+        fcntl(s, F_SETFL, flags | O_NONBLOCK);
+        int rc = ::connect(s, addr, static_cast<socklen_t>(len));
+        if (rc != 0 && errno != EINPROGRESS) {
+            return false;
+        }
+        pollfd pfd{};
+        pfd.fd = s;
+        pfd.events = POLLOUT;
+        rc = rc == 0 ? 1 : ::poll(&pfd, 1, timeoutSeconds_ * 1000);
+        fcntl(s, F_SETFL, flags);
+#endif
+        if (rc <= 0) {
+            return false;
+        }
+        int err = 0;
+        socklen_t errLen = sizeof(err);
+        getsockopt(s, SOL_SOCKET, SO_ERROR, reinterpret_cast<char*>(&err), &errLen);
+        return err == 0;
+    }
+
+    void applyTimeouts() {
+#ifdef _WIN32
+        DWORD ms = static_cast<DWORD>(timeoutSeconds_) * 1000;
+        setsockopt(sock_, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&ms), sizeof(ms));
+        setsockopt(sock_, SOL_SOCKET, SO_SNDTIMEO, reinterpret_cast<const char*>(&ms), sizeof(ms));
+#else
+        timeval tv{};
+        tv.tv_sec = timeoutSeconds_;
+        setsockopt(sock_, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+        setsockopt(sock_, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+#endif
+    }
+
+    socket_t sock_ = INVALID_SOCK;
+    int timeoutSeconds_;
+    std::string buffer_;
+    size_t pos_ = 0;
+    bool receivedAny_ = false;
+};
+
+HttpTransport::HttpTransport(const TransportOptions& options) : options_(options) {}
+
+HttpTransport::~HttpTransport() = default;
+
+TransferInfo HttpTransport::get(const Url& url, uint64_t offset, const DataSink& sink) {
+    return request(url, offset, sink, 0);
+}
+
+std::unique_ptr<HttpTransport::Connection> HttpTransport::acquire(const Url& url, bool& reused) {
+    {
+        std::lock_guard lock(poolMutex_);
+        auto& idle = idle_[url.hostKey()];
+        if (!idle.empty()) {
+            auto conn = std::move(idle.back());
+            idle.pop_back();
+            conn->resetActivity();
+            reused = true;
+            return conn;
+        }
+    }
+    reused = false;
+    return std::make_unique<Connection>(url, options_.timeoutSeconds);
+}
+
+void HttpTransport::release(const std::string& hostKey, std::unique_ptr<Connection> conn) {
+    std::lock_guard lock(poolMutex_);
+    idle_[hostKey].push_back(std::move(conn));
+}
+
+TransferInfo HttpTransport::request(const Url& url, uint64_t offset, const DataSink& sink, int redirects) {
+    if (url.scheme == "https") {
+        throw NetworkError("https is not supported by the built-in transport: " + url.toString());
+    }
+
+    for (int attempt = 0;; ++attempt) {
+        bool reused = false;
+        auto conn = acquire(url, reused);
+
+        try {
+            std::ostringstream req;
+            req << "GET " << url.path << " HTTP/1.1\r\n"
+                << "Host: " << url.host;
+            if (url.port != 80) {
+                req << ":" << url.port;
+            }
+            req << "\r\n"
+                << "User-Agent: amb/0.1.0\r\n"
+                << "Accept-Encoding: identity\r\n"
+                << "Connection: keep-alive\r\n";
+            if (offset > 0) {
+                req << "Range: bytes=" << offset << "-\r\n";
+            }
+            req << "\r\n";
+            conn->sendAll(req.str());
+
+            std::string statusLine;
+            try {
+                statusLine = conn->readLine();
+            } catch (const NetworkError&) {
+                if (reused && !conn->hasReceivedData()) {
+                    throw StaleConnection();
+                }
+                throw;
+            }
+
+            int status = 0;
+            {
+                std::istringstream ss(statusLine);
+                std::string httpVersion;
+                ss >> httpVersion >> status;
+                if (!httpVersion.starts_with("HTTP/") || status == 0) {
+                    throw NetworkError("malformed status line from " + url.hostKey());
+                }
+            }
+
+            std::map<std::string, std::string> headers;
+            for (std::string line = conn->readLine(); !line.empty(); line = conn->readLine()) {
+                auto colon = line.find(':');
+                if (colon == std::string::npos) {
+                    continue;
+                }
+                std::string value = line.substr(colon + 1);
+                value.erase(0, value.find_first_not_of(" \t"));
+                headers[toLower(line.substr(0, colon))] = value;
+            }
+
+            bool keepAlive = toLower(headers["connection"]) != "close";
+            bool chunked = toLower(headers["transfer-encoding"]).find("chunked") != std::string::npos;
+            std::optional<uint64_t> contentLength;
+            if (headers.count("content-length")) {
+                contentLength = std::stoull(headers["content-length"]);
+            }
+
+            TransferInfo info;
+            uint64_t position = 0;
+            ChunkFn bodySink = [&](const char* data, size_t size) {
+                bool keepGoing = sink(position, data, size);
+                position += size;
+                return keepGoing;
+            };
+
+            if (status >= 300 && status < 400 && headers.count("location")) {
+                bodySink = nullptr;
+            } else if (status == 404 || status == 410) {
+                info.found = false;
+                bodySink = nullptr;
+            } else if (status == 416) {
+                // Requested range starts at/after the end: the partial file is already complete
+                info.rangeHonored = true;
+                auto range = headers["content-range"];
+                auto slash = range.find('/');
+                if (slash != std::string::npos && range.substr(slash + 1) != "*") {
+                    info.totalSize = std::stoull(range.substr(slash + 1));
+                }
+                bodySink = nullptr;
+            } else if (status == 206) {
+                info.rangeHonored = true;
+                position = offset;
+                auto range = headers["content-range"];
+                auto slash = range.find('/');
+                if (slash != std::string::npos && range.substr(slash + 1) != "*") {
+                    info.totalSize = std::stoull(range.substr(slash + 1));
+                }
+            } else if (status == 200) {
+                info.rangeHonored = offset == 0;
+                info.totalSize = contentLength.value_or(0);
+            } else {
+                throw NetworkError("HTTP " + std::to_string(status) + " for " + url.toString());
+            }
+
+            // Body
+            bool complete = true;
+            if (chunked) {
+                while (true) {
+                    std::string sizeLine = conn->readLine();
+                    uint64_t chunk = std::stoull(sizeLine, nullptr, 16);
+                    if (chunk == 0) {
+                        while (!conn->readLine().empty()) {
+                        }
+                        break;
+                    }
+                    if (!conn->readExact(chunk, bodySink, info.received)) {
+                        complete = false;
+                        break;
+                    }
+                    conn->readLine();
+                }
+            } else if (contentLength) {
+                complete = conn->readExact(*contentLength, bodySink, info.received);
+            } else {
+                complete = conn->readToEnd(bodySink, info.received);
+                keepAlive = false;
+            }
+
+            if (!bodySink) {
+                info.received = 0;
+            }
+            if (complete && keepAlive) {
+                release(url.hostKey(), std::move(conn));
+            }
+
+            if (status >= 300 && status < 400 && headers.count("location")) {
+                if (redirects >= 5) {
+                    throw NetworkError("too many redirects for " + url.toString());
+                }
+                auto target = Url::parse(headers["location"]);
+                if (!target) {
+                    target = url;
+                    target->path = headers["location"];
+                }
+                return request(*target, offset, sink, redirects + 1);
+            }
+
+            return info;
+
+        } catch (const StaleConnection&) {
+            if (attempt > 0) {
+                throw NetworkError("connection to " + url.hostKey() + " closed unexpectedly");
+            }
+            Logger::debug("Reconnecting to {} (stale keep-alive connection)", url.hostKey());
+        }
+    }
+}
+
+} // namespace amb
\ No newline at end of file
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "registry/transport.hpp"
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace amb {
+
+// Plain HTTP/1.1 transport with keep-alive connection reuse and Range support.
+// TLS is not built in; https:// registries are rejected with a NetworkError.
+class HttpTransport : public Transport {
+public:
+    explicit HttpTransport(const TransportOptions& options);
+    ~HttpTransport() override;
+
+    std::string scheme() const override { return "http"; }
+    TransferInfo get(const Url& url, uint64_t offset, const DataSink& sink) override;
+
+    class Connection;
+
+private:
+    TransferInfo request(const Url& url, uint64_t offset, const DataSink& sink, int redirects);
+
+    std::unique_ptr<Connection> acquire(const Url& url, bool& reused);
+    void release(const std::string& hostKey, std::unique_ptr<Connection> conn);
+
+    TransportOptions options_;
+    std::mutex poolMutex_;
+    std::map<std::string, std::vector<std::unique_ptr<Connection>>> idle_;
+};
+
+} // namespace amb
\ No newline at end of file
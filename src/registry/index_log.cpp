@@ -0,0 +1,293 @@
+#include "registry/index_log.hpp"
+#include "utils/archive.hpp"
+#include "utils/file_lock.hpp"
+#include "utils/filesystem.hpp"
+#include "utils/logger.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+namespace amb {
+
+namespace {
+
+constexpr size_t CRC_DIGITS = 8;
+
+std::string checksum(std::string_view body) {
+    char hex[CRC_DIGITS + 1];
+    std::snprintf(hex, sizeof(hex), "%08x", crc32(body.data(), body.size()));
+    return std::string(hex, CRC_DIGITS);
+}
+
+// "<name> <version>", as in yank lines
+bool splitVersion(std::string_view payload, PackageRecord& record) {
+    auto space = payload.find(' ');
+    if (space == std::string_view::npos || space == 0 || space + 1 == payload.size()) {
+        return false;
+    }
+    record.name = std::string(payload.substr(0, space));
+    record.version = std::string(payload.substr(space + 1));
+    return true;
+}
+
+// nullopt when the line is damaged. Ops from newer writers come back as a generation 0
+// compact, which parse() skips.
+std::optional<IndexLogEntry> decode(std::string_view line) {
+    if (line.size() < CRC_DIGITS + 2 || line[CRC_DIGITS] != ' ' ||
+        checksum(line.substr(CRC_DIGITS + 1)) != line.substr(0, CRC_DIGITS)) {
+        return std::nullopt;
+    }
+    auto body = line.substr(CRC_DIGITS + 1);
+    auto space = body.find(' ');
+    auto op = body.substr(0, space);
+    auto payload = space == std::string_view::npos ? std::string_view{} : body.substr(space + 1);
+
+    IndexLogEntry entry;
+    if (op == "publish") {
+        auto record = RegistryIndex::parseRecord(std::string(payload));
+        if (!record) {
+            return std::nullopt;
+        }
+        entry.record = std::move(*record);
+    } else if (op == "yank" || op == "unyank") {
+        entry.op = op == "yank" ? IndexLogEntry::Op::YANK : IndexLogEntry::Op::UNYANK;
+        if (!splitVersion(payload, entry.record)) {
+            return std::nullopt;
+        }
+    } else if (op == "compact") {
+        entry.op = IndexLogEntry::Op::COMPACT;
+        try {
+            entry.generation = std::stoull(std::string(payload));
+        } catch (const std::exception&) {
+            return std::nullopt;
+        }
+    } else {
+        Logger::debug("Skipping unknown change log entry '{}'", std::string(op));
+        entry.op = IndexLogEntry::Op::COMPACT;
+    }
+    return entry;
+}
+
+bool writeSnapshot(const fs::path& registryRoot, const RegistryIndex& index) {
+    // Replaced atomically so concurrent readers never see a partial file
+    fs::path path = registryRoot / RegistryIndex::INDEX_FILE;
+    fs::path staging = path;
+    staging += ".tmp";
+    if (!FileSystem::writeFile(staging, index.serialize())) {
+        return false;
+    }
+    std::error_code ec;
+    fs::rename(staging, path, ec);
+    FileSystem::invalidate(staging);
+    FileSystem::invalidate(path);
+    if (ec) {
+        Logger::error("Failed to update registry index: {}", ec.message());
+        return false;
+    }
+    return true;
+}
+
+std::optional<RegistryIndex> readSnapshot(const fs::path& registryRoot) {
+    fs::path path = registryRoot / RegistryIndex::INDEX_FILE;
+    if (!FileSystem::isFile(path)) {
+        return RegistryIndex::scan(registryRoot);
+    }
+    auto content = FileSystem::readFile(path);
+    auto index = content ? RegistryIndex::parse(*content) : std::nullopt;
+    if (!index) {
+        Logger::error("Registry index {} is unreadable", path.string());
+    }
+    return index;
+}
+
+// The snapshot, once the registry has a log to append to. The caller holds the index lock.
+std::optional<RegistryIndex> startLog(const fs::path& registryRoot) {
+    auto snapshot = readSnapshot(registryRoot);
+    if (!snapshot) {
+        return std::nullopt;
+    }
+    uint64_t generation = snapshot->logPosition().generation;
+    if (generation == 0) {
+        snapshot->setLogPosition({1, 0});
+        if (!FileSystem::writeFile(registryRoot / IndexLog::fileName(1), "") ||
+            !writeSnapshot(registryRoot, *snapshot)) {
+            return std::nullopt;
+        }
+        Logger::debug("Started the change log of {}", registryRoot.string());
+    } else if (!FileSystem::isFile(registryRoot / IndexLog::fileName(generation)) &&
+               !FileSystem::writeFile(registryRoot / IndexLog::fileName(generation), "")) {
+        return std::nullopt;
+    }
+    return snapshot;
+}
+
+// Drops a line a writer left half-written when it died; no reader consumed it
+bool repairTail(const fs::path& logPath) {
+    uintmax_t size = FileSystem::fileSize(logPath);
+    if (size == 0) {
+        return true;
+    }
+    char last = 0;
+    {
+        std::ifstream in(logPath, std::ios::binary);
+        in.seekg(-1, std::ios::end);
+        in.get(last);
+    }
+    if (last == '\n') {
+        return true;
+    }
+    auto data = FileSystem::readFile(logPath);
+    if (!data) {
+        return false;
+    }
+    auto end = data->rfind('\n');
+    std::error_code ec;
+    fs::resize_file(logPath, end == std::string::npos ? 0 : end + 1, ec);
+    FileSystem::invalidate(logPath);
+    Logger::warning("Dropped a torn entry at the end of {}", logPath.string());
+    return !ec;
+}
+
+bool compactLocked(const fs::path& registryRoot, const RegistryIndex& snapshot) {
+    uint64_t generation = snapshot.logPosition().generation;
+    fs::path logPath = registryRoot / IndexLog::fileName(generation);
+    auto data = FileSystem::readFile(logPath).value_or("");
+
+    RegistryIndex index = snapshot;
+    std::string_view pending(data);
+    pending.remove_prefix(std::min<size_t>(snapshot.logPosition().offset, pending.size()));
+    auto tail = IndexLog::parse(pending);
+    if (tail.corrupt) {
+        Logger::error("Change log {} is corrupt, not compacting it", logPath.string());
+        return false;
+    }
+    for (const auto& entry : tail.entries) {
+        IndexLog::apply(index, entry);
+    }
+
+    // New log first, so the snapshot never names a log that is not there
+    index.setLogPosition({generation + 1, 0});
+    if (!FileSystem::writeFile(registryRoot / IndexLog::fileName(generation + 1), "") ||
+        !writeSnapshot(registryRoot, index)) {
+        return false;
+    }
+    IndexLogEntry marker;
+    marker.op = IndexLogEntry::Op::COMPACT;
+    marker.generation = generation + 1;
+    FileSystem::appendFile(logPath, IndexLog::encode(marker));
+    // One older log stays readable for clients that are in the middle of it
+    if (generation > 1) {
+        FileSystem::removeFile(registryRoot / IndexLog::fileName(generation - 1));
+    }
+    Logger::debug("Compacted {} ({} entries) into generation {}",
+                  logPath.string(), tail.entries.size(), generation + 1);
+    return true;
+}
+
+} // namespace
+
+std::string IndexLog::fileName(uint64_t generation) {
+    return "index-" + std::to_string(generation) + ".log";
+}
+
+std::string IndexLog::encode(const IndexLogEntry& entry) {
+    std::string body;
+    switch (entry.op) {
+        case IndexLogEntry::Op::PUBLISH:
+            body = "publish " + RegistryIndex::serializeRecord(entry.record);
+            break;
+        case IndexLogEntry::Op::YANK:
+            body = "yank " + entry.record.name + " " + entry.record.version;
+            break;
+        case IndexLogEntry::Op::UNYANK:
+            body = "unyank " + entry.record.name + " " + entry.record.version;
+            break;
+        case IndexLogEntry::Op::COMPACT:
+            body = "compact " + std::to_string(entry.generation);
+            break;
+    }
+    return checksum(body) + " " + body + "\n";
+}
+
+IndexLog::Tail IndexLog::parse(std::string_view data) {
+    Tail tail;
+    while (tail.consumed < data.size()) {
+        auto end = data.find('\n', tail.consumed);
+        if (end == std::string_view::npos) {
+            break;
+        }
+        auto entry = decode(data.substr(tail.consumed, end - tail.consumed));
+        if (!entry) {
+            tail.corrupt = true;
+            break;
+        }
+        if (entry->op != IndexLogEntry::Op::COMPACT || entry->generation > 0) {
+            tail.entries.push_back(std::move(*entry));
+        }
+        tail.consumed = end + 1;
+    }
+    return tail;
+}
+
+bool IndexLog::apply(RegistryIndex& index, const IndexLogEntry& entry) {
+    switch (entry.op) {
+        case IndexLogEntry::Op::PUBLISH:
+            index.add(entry.record);
+            return true;
+        case IndexLogEntry::Op::YANK:
+        case IndexLogEntry::Op::UNYANK:
+            return index.setYanked(entry.record.name, entry.record.version,
+                                   entry.op == IndexLogEntry::Op::YANK);
+        case IndexLogEntry::Op::COMPACT:
+            break;
+    }
+    return true;
+}
+
+bool IndexLog::append(const fs::path& registryRoot, const IndexLogEntry& entry) {
+    auto guard = FileLock::acquire(FileLock::siblingLockPath(registryRoot / RegistryIndex::INDEX_FILE),
+                                   LockMode::EXCLUSIVE);
+    auto snapshot = startLog(registryRoot);
+    if (!snapshot) {
+        return false;
+    }
+    fs::path logPath = registryRoot / fileName(snapshot->logPosition().generation);
+    if (!repairTail(logPath) || !FileSystem::appendFile(logPath, encode(entry))) {
+        Logger::error("Failed to append to {}", logPath.string());
+        return false;
+    }
+    if (FileSystem::fileSize(logPath) >= COMPACT_BYTES) {
+        compactLocked(registryRoot, *snapshot);
+    }
+    return true;
+}
+
+bool IndexLog::compact(const fs::path& registryRoot) {
+    auto guard = FileLock::acquire(FileLock::siblingLockPath(registryRoot / RegistryIndex::INDEX_FILE),
+                                   LockMode::EXCLUSIVE);
+    auto snapshot = startLog(registryRoot);
+    return snapshot && compactLocked(registryRoot, *snapshot);
+}
+
+std::optional<RegistryIndex> IndexLog::read(const fs::path& registryRoot) {
+    auto index = readSnapshot(registryRoot);
+    if (!index || index->logPosition().generation == 0) {
+        return index;
+    }
+    LogPosition position = index->logPosition();
+    auto data = FileSystem::readFile(registryRoot / fileName(position.generation)).value_or("");
+    std::string_view pending(data);
+    pending.remove_prefix(std::min<size_t>(position.offset, pending.size()));
+    auto tail = parse(pending);
+    for (const auto& entry : tail.entries) {
+        if (entry.op == IndexLogEntry::Op::COMPACT) {
+            break;
+        }
+        apply(*index, entry);
+    }
+    index->setLogPosition({position.generation, position.offset + tail.consumed});
+    return index;
+}
+
+} // namespace amb
\ No newline at end of file
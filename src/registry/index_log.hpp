@@ -0,0 +1,63 @@
+#pragma once
+
+#include "registry/registry_index.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace amb {
+
+namespace fs = std::filesystem;
+
+// One change to the registry index
+struct IndexLogEntry {
+    enum class Op {
+        PUBLISH,  // record: the new version
+        YANK,     // record: name and version only
+        UNYANK,
+        COMPACT   // generation: the log this one was folded into
+    };
+
+    Op op = Op::PUBLISH;
+    PackageRecord record;
+    uint64_t generation = 0;
+};
+
+// Append-only change log of a filesystem registry, next to index.json:
+//   index.json         snapshot, with the log position it includes ("log": {generation, offset})
+//   index-<G>.log      one "<crc32 hex> <op> <payload>" line per change since the snapshot
+// Clients keep the index they last saw and read only the log bytes past its offset.
+// Once a log passes COMPACT_BYTES it is folded into a new snapshot and generation G+1
+// starts; the old log ends with a "compact" line so clients tailing it know to reload.
+class IndexLog {
+public:
+    static constexpr uint64_t COMPACT_BYTES = 1024 * 1024;
+
+    static std::string fileName(uint64_t generation);
+    static std::string encode(const IndexLogEntry& entry);
+
+    struct Tail {
+        std::vector<IndexLogEntry> entries;
+        size_t consumed = 0;   // bytes of complete lines read; a torn last line is left for later
+        bool corrupt = false;  // a line failed its checksum; reading stopped before it
+    };
+    static Tail parse(std::string_view data);
+
+    // False when a yank names a version the index does not have
+    static bool apply(RegistryIndex& index, const IndexLogEntry& entry);
+
+    // Appends under the index lock, starting the log first for registries that only
+    // have an index.json (or nothing), and compacts when the log has grown enough
+    static bool append(const fs::path& registryRoot, const IndexLogEntry& entry);
+    static bool compact(const fs::path& registryRoot);
+
+    // Snapshot plus every change logged since
+    static std::optional<RegistryIndex> read(const fs::path& registryRoot);
+};
+
+} // namespace amb
\ No newline at end of file
@@ -0,0 +1,121 @@
+#include "registry/prefetcher.hpp"
+#include "utils/logger.hpp"
+
+#include <algorithm>
+
+namespace amb {
+
+Prefetcher::Prefetcher(Fetcher::Options options)
+    : fetcher_(options), maxWorkers_(std::max<size_t>(1, options.maxConnections)) {}
+
+Prefetcher::~Prefetcher() {
+    retain({});
+    finish();
+}
+
+void Prefetcher::add(FetchJob job) {
+    std::lock_guard lock(mutex_);
+    if (!added_.insert(job.destination).second) {
+        return;
+    }
+    if (!started_) {
+        started_ = std::chrono::steady_clock::now();
+    }
+    queue_.push_back(std::move(job));
+    if (active_ < maxWorkers_) {
+        active_++;
+        threads_.emplace_back(&Prefetcher::work, this);
+    }
+}
+
+void Prefetcher::retain(const std::vector<FetchJob>& jobs) {
+    std::set<fs::path> keep;
+    for (const auto& job : jobs) {
+        keep.insert(job.destination);
+    }
+
+    std::lock_guard lock(mutex_);
+    for (const auto& destination : added_) {
+        if (!keep.count(destination) && cancelled_.insert(destination).second) {
+            fetcher_.cancel(destination);
+        }
+    }
+    // Queued jobs never reach the fetcher, so they are counted here
+    auto before = queue_.size();
+    std::erase_if(queue_, [&](const FetchJob& job) { return cancelled_.count(job.destination) > 0; });
+    report_.cancelled += before - queue_.size();
+}
+
+void Prefetcher::setProgress(Output::Progress* progress) {
+    if (progress) {
+        progress->advance(fetcher_.received());
+    }
+    fetcher_.setProgress(progress);
+}
+
+FetchReport Prefetcher::finish() {
+    std::vector<std::thread> threads;
+    {
+        std::unique_lock lock(mutex_);
+        idle_.wait(lock, [&] { return active_ == 0; });
+        threads.swap(threads_);
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    // A failed guess that resolution rejected afterwards is not worth reporting
+    std::lock_guard lock(mutex_);
+    FetchReport report = report_;
+    for (const auto& [destination, error] : failures_) {
+        if (!cancelled_.count(destination)) {
+            report.failed++;
+            report.errors.push_back(error);
+        }
+    }
+    if (!threads.empty()) {
+        Logger::debug("Prefetch finished: {} downloaded, {} cached, {} cancelled, {} failed",
+                      report.downloaded, report.cached, report.cancelled, report.failed);
+    }
+    return report;
+}
+
+double Prefetcher::seconds() const {
+    std::lock_guard lock(mutex_);
+    if (!started_ || ended_ < *started_) {
+        return 0;
+    }
+    return std::chrono::duration<double>(ended_ - *started_).count();
+}
+
+void Prefetcher::work() {
+    for (;;) {
+        FetchJob job;
+        {
+            std::lock_guard lock(mutex_);
+            if (queue_.empty()) {
+                active_--;
+                idle_.notify_all();
+                return;
+            }
+            job = std::move(queue_.front());
+            queue_.pop_front();
+        }
+
+        // A single job runs on this thread; the fetcher still applies the per-host limit
+        auto result = fetcher_.fetchAll({job});
+
+        std::lock_guard lock(mutex_);
+        report_.downloaded += result.downloaded;
+        report_.cached += result.cached;
+        report_.cancelled += result.cancelled;
+        report_.bytes += result.bytes;
+        report_.resumedBytes += result.resumedBytes;
+        if (!result.errors.empty()) {
+            failures_[job.destination] = result.errors.front();
+        }
+        ended_ = std::chrono::steady_clock::now();
+    }
+}
+
+} // namespace amb
\ No newline at end of file
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "registry/fetcher.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace amb {
+
+namespace fs = std::filesystem;
+
+// Speculative downloads in the background: jobs start as soon as they are added, while
+// the caller goes on reading the lockfile, loading the index and resolving. Once the
+// real job list is known, retain() cancels the guesses it rejected and finish() joins
+// the rest. Workers are spawned on demand, up to the fetcher's connection limit.
+class Prefetcher {
+public:
+    explicit Prefetcher(Fetcher::Options options);
+    ~Prefetcher();  // cancels whatever is left and waits for the workers
+
+    Prefetcher(const Prefetcher&) = delete;
+    Prefetcher& operator=(const Prefetcher&) = delete;
+
+    // No-op for a destination that was already added
+    void add(FetchJob job);
+    // Cancels every job whose destination is not one of `jobs`, queued or in flight
+    void retain(const std::vector<FetchJob>& jobs);
+    // Waits for the remaining jobs; the report covers everything added so far
+    FetchReport finish();
+
+    // Wall time from the first job starting to the last one ending
+    double seconds() const;
+
+    // See Fetcher::setProgress(); what the guesses received so far counts too
+    void setProgress(Output::Progress* progress);
+
+private:
+    void work();
+
+    Fetcher fetcher_;
+    size_t maxWorkers_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable idle_;
+    std::deque<FetchJob> queue_;
+    std::set<fs::path> added_;
+    std::set<fs::path> cancelled_;
+    std::vector<std::thread> threads_;
+    size_t active_ = 0;
+    FetchReport report_;  // failures are kept apart until finish()
+    std::map<fs::path, std::string> failures_;
+    std::optional<std::chrono::steady_clock::time_point> started_;
+    std::chrono::steady_clock::time_point ended_;
+};
+
+} // namespace amb
\ No newline at end of file
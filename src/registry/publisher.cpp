@@ -0,0 +1,186 @@
+#include "registry/publisher.hpp"
+#include "amb/version.hpp"
+#include "core/manifest.hpp"
+#include "registry/delta.hpp"
+#include "registry/index_log.hpp"
+#include "registry/registry_index.hpp"
+#include "utils/archive.hpp"
+#include "utils/error.hpp"
+#include "utils/filesystem.hpp"
+#include "utils/logger.hpp"
+#include "utils/sha256.hpp"
+
+#include <algorithm>
+
+namespace amb {
+
+namespace {
+
+// Project-local state that never belongs in a published archive
+bool isPublishable(const fs::path& relative) {
+    for (const auto& part : relative) {
+        auto s = part.string();
+        if (s.starts_with(".") || s == "ambar_modules") {
+            return false;
+        }
+    }
+    return relative != "ambar.lock";
+}
+
+} // namespace
+
+Publisher::Publisher(fs::path registryRoot, std::optional<Ed25519::Seed> signingKey)
+    : registryRoot_(std::move(registryRoot)), signingKey_(std::move(signingKey)) {}
+
+std::optional<PublishResult> Publisher::publish(const fs::path& packageDir) {
+    auto manifest = Manifest::load(packageDir / "ambar.json");
+    if (!manifest) {
+        throw PackageError("no valid ambar.json in " + packageDir.string());
+    }
+
+    // Required fields (blueprint §4.2)
+    for (const auto& [field, value] : {std::pair{"name", manifest->name},
+                                       std::pair{"version", manifest->version},
+                                       std::pair{"author", manifest->author},
+                                       std::pair{"description", manifest->description},
+                                       std::pair{"license", manifest->license}}) {
+        if (value.empty()) {
+            throw PackageError(manifest->name, std::string("missing required field '") + field + "'");
+        }
+    }
+    Version parsed;
+    if (!parsed.fromString(manifest->version)) {
+        throw PackageError(manifest->name, "version '" + manifest->version + "' is not valid SemVer");
+    }
+
+    PackageRecord record;
+    record.name = manifest->name;
+    record.version = manifest->version;
+    record.dependencies = manifest->dependencies;
+
+    // The version directories are the registry's own record of what exists, so neither
+    // this check nor the delta base below needs the whole index
+    if (FileSystem::isFile(registryRoot_ / record.archivePath())) {
+        throw PackageError(manifest->name, "version " + manifest->version + " is already published");
+    }
+
+    fs::path versionDir = registryRoot_ / manifest->name / manifest->version;
+    fs::path archive = registryRoot_ / record.archivePath();
+    if (!FileSystem::createDirectories(versionDir)) {
+        return std::nullopt;
+    }
+
+    // Archive + per-file digests
+    std::vector<fs::path> files;
+    for (const auto& entry : fs::recursive_directory_iterator(packageDir)) {
+        if (entry.is_regular_file() && isPublishable(fs::relative(entry.path(), packageDir))) {
+            files.push_back(entry.path());
+        }
+    }
+    std::sort(files.begin(), files.end());
+
+    ZipWriter writer;
+    writer.open(archive);
+    FileDigests digests;
+    for (const auto& file : files) {
+        auto content = FileSystem::readFile(file);
+        auto relative = fs::relative(file, packageDir).generic_string();
+        if (!content || !writer.add(relative, *content)) {
+            throw PackageError(manifest->name, "cannot archive " + relative);
+        }
+        digests[relative] = Sha256::hash(*content);
+    }
+    if (!writer.close()) {
+        return std::nullopt;
+    }
+
+    record.sha256 = Sha256::hashFile(archive);
+    record.size = FileSystem::fileSize(archive);
+    manifest->save(versionDir / "ambar.json");
+    saveFileDigests(registryRoot_ / record.digestsPath(), digests);
+
+    if (signingKey_) {
+        auto publicKey = Ed25519::publicKey(*signingKey_);
+        auto signature = Ed25519::sign(*signingKey_, signaturePayload(record.name, record.version, record.sha256));
+        record.publicKey = Sha256::toHex(publicKey.data(), publicKey.size());
+        record.signature = Sha256::toHex(signature.data(), signature.size());
+    }
+
+    PublishResult result;
+    result.name = record.name;
+    result.version = record.version;
+    result.sha256 = record.sha256;
+    result.archiveSize = record.size;
+    result.publicKey = record.publicKey;
+
+    // Delta from the closest older version
+    std::optional<PackageRecord> previous;
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(registryRoot_ / record.name, ec)) {
+        Version candidate;
+        PackageRecord older;
+        older.name = record.name;
+        older.version = entry.path().filename().string();
+        if (entry.is_directory() && candidate.fromString(older.version) && candidate < parsed &&
+            FileSystem::isFile(registryRoot_ / older.archivePath()) &&
+            (!previous || Version(previous->version) < candidate)) {
+            previous = std::move(older);
+        }
+    }
+
+    if (previous) {
+        auto previousDigests = loadFileDigests(registryRoot_ / previous->digestsPath());
+        if (!previousDigests) {
+            previousDigests = digestArchive(registryRoot_ / previous->archivePath());
+        }
+
+        fs::path deltaPath = registryRoot_ / record.deltaPath(previous->version);
+        if (previousDigests &&
+            PackageDelta::build(record.name, previous->version, *previousDigests,
+                                record.version, archive, deltaPath)) {
+            uint64_t deltaSize = FileSystem::fileSize(deltaPath);
+            if (static_cast<double>(deltaSize) <= MAX_DELTA_RATIO * static_cast<double>(record.size)) {
+                record.deltas[previous->version] = DeltaRecord{Sha256::hashFile(deltaPath), deltaSize};
+                result.deltaFrom = previous->version;
+                result.deltaSize = deltaSize;
+            } else {
+                Logger::debug("Delta {} -> {} is {} bytes, not worth shipping",
+                              previous->version, record.version, deltaSize);
+                FileSystem::removeFile(deltaPath);
+            }
+        }
+    }
+
+    IndexLogEntry entry;
+    entry.record = record;
+    if (!IndexLog::append(registryRoot_, entry)) {
+        return std::nullopt;
+    }
+
+    return result;
+}
+
+bool Publisher::yank(const std::string& name, const std::string& version, bool yanked) {
+    auto index = IndexLog::read(registryRoot_);
+    if (!index) {
+        throw PackageError("registry index in " + registryRoot_.string() + " is unreadable");
+    }
+    const auto* record = index->find(name, version);
+    if (!record) {
+        throw PackageError(name, "version " + version + " is not published");
+    }
+    if (record->yanked == yanked) {
+        return false;
+    }
+
+    IndexLogEntry entry;
+    entry.op = yanked ? IndexLogEntry::Op::YANK : IndexLogEntry::Op::UNYANK;
+    entry.record.name = name;
+    entry.record.version = version;
+    if (!IndexLog::append(registryRoot_, entry)) {
+        throw PackageError(name, "cannot record the change in the registry log");
+    }
+    return true;
+}
+
+} // namespace amb
\ No newline at end of file
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "utils/ed25519.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+
+namespace amb {
+
+namespace fs = std::filesystem;
+
+struct PublishResult {
+    std::string name;
+    std::string version;
+    std::string sha256;
+    uint64_t archiveSize = 0;
+    std::optional<std::string> deltaFrom;  // previous version a delta was produced against
+    uint64_t deltaSize = 0;
+    std::string publicKey;  // hex, empty when published unsigned
+};
+
+// Publishes packages into a filesystem registry (blueprint §8):
+//   <name>/<version>/<name>-<version>.zip   package archive
+//   <name>/<version>/ambar.json            manifest (resolution without unpacking)
+//   <name>/<version>/files.json            per-file digests
+//   <name>/<version>/<name>-<prev>-<version>.delta   optional delta from the previous version
+// and records each change in the registry's index log (registry/index_log.hpp).
+class Publisher {
+public:
+    // With a signing key the archive digest is signed and the signature recorded in the index
+    explicit Publisher(fs::path registryRoot, std::optional<Ed25519::Seed> signingKey = std::nullopt);
+
+    std::optional<PublishResult> publish(const fs::path& packageDir);
+    // Yanked versions stay installable from a lockfile but are never picked by a new
+    // resolution. False when the version already was in that state.
+    bool yank(const std::string& name, const std::string& version, bool yanked = true);
+
+    // Deltas larger than this fraction of the full archive are not worth shipping
+    static constexpr double MAX_DELTA_RATIO = 0.75;
+
+private:
+    fs::path registryRoot_;
+    std::optional<Ed25519::Seed> signingKey_;
+};
+
+} // namespace amb
\ No newline at end of file
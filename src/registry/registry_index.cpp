@@ -0,0 +1,405 @@
+#include "registry/registry_index.hpp"
+#include "core/manifest.hpp"
+#include "registry/index_log.hpp"
+#include "utils/archive.hpp"
+#include "utils/file_lock.hpp"
+#include "utils/filesystem.hpp"
+#include "utils/logger.hpp"
+#include "utils/sha256.hpp"
+#include "json.hpp"
+
+#include <algorithm>
+
+using json = nlohmann::json;
+
+namespace amb {
+
+std::string PackageRecord::archivePath() const {
+    return name + "/" + version + "/" + name + "-" + version + ".zip";
+}
+
+std::string PackageRecord::deltaPath(const std::string& from) const {
+    return name + "/" + version + "/" + name + "-" + from + "-" + version + ".delta";
+}
+
+std::string PackageRecord::digestsPath() const {
+    return name + "/" + version + "/files.json";
+}
+
+std::string signaturePayload(const std::string& name, const std::string& version,
+                             const std::string& sha256) {
+    return "amb-package-v1\n" + name + "\n" + version + "\n" + sha256;
+}
+
+namespace {
+
+json recordToJson(const PackageRecord& record) {
+    json v;
+    v["version"] = record.version;
+    v["sha256"] = record.sha256;
+    v["size"] = record.size;
+    v["dependencies"] = record.dependencies;
+    if (!record.deltas.empty()) {
+        json deltas = json::object();
+        for (const auto& [from, d] : record.deltas) {
+            deltas[from] = {{"sha256", d.sha256}, {"size", d.size}};
+        }
+        v["deltas"] = std::move(deltas);
+    }
+    if (!record.signature.empty()) {
+        v["public_key"] = record.publicKey;
+        v["signature"] = record.signature;
+    }
+    if (record.yanked) {
+        v["yanked"] = true;
+    }
+    return v;
+}
+
+PackageRecord recordFromJson(const std::string& name, const json& v) {
+    PackageRecord record;
+    record.name = name;
+    record.version = v.at("version").get<std::string>();
+    record.sha256 = v.value("sha256", "");
+    record.size = v.value("size", uint64_t{0});
+    if (v.contains("dependencies")) {
+        record.dependencies = v["dependencies"].get<std::map<std::string, std::string>>();
+    }
+    if (v.contains("deltas")) {
+        for (const auto& [from, d] : v["deltas"].items()) {
+            record.deltas[from] = DeltaRecord{d.value("sha256", ""), d.value("size", uint64_t{0})};
+        }
+    }
+    record.publicKey = v.value("public_key", "");
+    record.signature = v.value("signature", "");
+    record.yanked = v.value("yanked", false);
+    return record;
+}
+
+} // namespace
+
+std::optional<RegistryIndex> RegistryIndex::load(const std::string& registryUrl, int timeoutSeconds,
+                                                 const fs::path& cacheDir) {
+    auto url = Url::parse(registryUrl);
+    if (!url) {
+        Logger::error("Invalid registry URL: {}", registryUrl);
+        return std::nullopt;
+    }
+
+    TransportOptions options;
+    options.timeoutSeconds = timeoutSeconds;
+    auto transport = TransportFactory::instance().create(url->scheme, options);
+    if (!transport) {
+        Logger::error("Unsupported registry URL scheme: {}", url->scheme);
+        return std::nullopt;
+    }
+
+    fs::path cachePath;
+    if (!cacheDir.empty()) {
+        cachePath = cacheDir / "index" / (Sha256::hash(registryUrl).substr(0, 16) + ".json");
+    }
+
+    std::optional<RegistryIndex> index;
+    try {
+        // The index seen last time, brought up to date with the log bytes written since
+        if (!cachePath.empty() && FileSystem::isFile(cachePath)) {
+            auto cached = FileSystem::readFile(cachePath);
+            index = cached ? parse(*cached) : std::nullopt;
+            if (index && index->log_.generation > 0 && index->tail(*transport, *url) == TailResult::CURRENT) {
+                index->setBaseUrl(registryUrl);
+                index->saveCache(cachePath);
+                return index;
+            }
+            index.reset();
+        }
+
+        // A compaction between reading the snapshot and its log sends us round again
+        for (int attempt = 0; attempt < 3 && !index; ++attempt) {
+            auto content = transport->getText(url->join(INDEX_FILE));
+            if (!content) {
+                if (url->scheme == "file") {
+                    Logger::debug("Registry has no {}, scanning {}", INDEX_FILE, url->path);
+                    index = scan(url->path);
+                }
+                break;
+            }
+            index = parse(*content);
+            if (!index || index->log_.generation == 0) {
+                break;
+            }
+            // Without a cache directory the log is still replayed, just not kept
+            switch (index->tail(*transport, *url)) {
+                case TailResult::CURRENT:
+                    if (!cachePath.empty()) {
+                        index->saveCache(cachePath);
+                    }
+                    break;
+                case TailResult::MISSING:
+                    Logger::debug("Registry log {} is missing, using the snapshot alone",
+                                  IndexLog::fileName(index->log_.generation));
+                    break;
+                case TailResult::CORRUPT:
+                    Logger::warning("Registry log {} is damaged; changes past the damage are ignored",
+                                 IndexLog::fileName(index->log_.generation));
+                    break;
+                case TailResult::COMPACTED:
+                    index.reset();
+                    break;
+            }
+        }
+    } catch (const std::exception& e) {
+        Logger::error("Failed to load registry index from {}: {}", registryUrl, e.what());
+        return std::nullopt;
+    }
+
+    if (index) {
+        index->setBaseUrl(registryUrl);
+    } else {
+        Logger::error("Registry index not available at {}", registryUrl);
+    }
+    return index;
+}
+
+RegistryIndex::TailResult RegistryIndex::tail(Transport& transport, const Url& registryUrl) {
+    // Servers that ignore the range resend the whole log; the bytes already applied are skipped
+    std::string data;
+    uint64_t offset = log_.offset;
+    auto info = transport.get(registryUrl.join(IndexLog::fileName(log_.generation)), offset,
+                              [&](uint64_t position, const char* bytes, size_t size) {
+                                  if (position + size <= offset) {
+                                      return true;
+                                  }
+                                  size_t skip = position < offset ? static_cast<size_t>(offset - position) : 0;
+                                  data.append(bytes + skip, size - skip);
+                                  return true;
+                              });
+    if (!info.found) {
+        return TailResult::MISSING;
+    }
+
+    auto tail = IndexLog::parse(data);
+    for (const auto& entry : tail.entries) {
+        if (entry.op == IndexLogEntry::Op::COMPACT) {
+            Logger::debug("Registry log {} was compacted into generation {}",
+                          IndexLog::fileName(log_.generation), entry.generation);
+            return TailResult::COMPACTED;
+        }
+        IndexLog::apply(*this, entry);
+    }
+    log_.offset += tail.consumed;
+    Logger::debug("Registry log {}: {} new change(s), {} byte(s) read",
+                  IndexLog::fileName(log_.generation), tail.entries.size(), data.size());
+    return tail.corrupt ? TailResult::CORRUPT : TailResult::CURRENT;
+}
+
+void RegistryIndex::saveCache(const fs::path& cachePath) const {
+    auto guard = FileLock::acquire(FileLock::siblingLockPath(cachePath), LockMode::EXCLUSIVE);
+    fs::path staging = cachePath;
+    staging += ".tmp";
+    if (!FileSystem::writeFile(staging, serialize())) {
+        return;
+    }
+    std::error_code ec;
+    fs::rename(staging, cachePath, ec);
+    FileSystem::invalidate(staging);
+    FileSystem::invalidate(cachePath);
+}
+
+std::optional<RegistryIndex> RegistryIndex::parse(const std::string& content) {
+    try {
+        auto j = json::parse(content);
+        RegistryIndex index;
+
+        for (const auto& [name, versions] : j.at("packages").items()) {
+            for (const auto& v : versions) {
+                index.add(recordFromJson(name, v));
+            }
+        }
+        if (j.contains("log")) {
+            index.log_.generation = j["log"].value("generation", uint64_t{0});
+            index.log_.offset = j["log"].value("offset", uint64_t{0});
+        }
+        return index;
+
+    } catch (const std::exception& e) {
+        Logger::error("Failed to parse registry index: {}", e.what());
+        return std::nullopt;
+    }
+}
+
+RegistryIndex RegistryIndex::scan(const fs::path& registryRoot) {
+    RegistryIndex index;
+
+    for (const auto& pkgDir : FileSystem::listDirectories(registryRoot)) {
+        std::string name = FileSystem::filename(pkgDir);
+        for (const auto& versionDir : FileSystem::listDirectories(pkgDir)) {
+            PackageRecord record;
+            record.name = name;
+            record.version = FileSystem::filename(versionDir);
+
+            auto archive = versionDir / (name + "-" + record.version + ".zip");
+            if (!FileSystem::isFile(archive)) {
+                continue;
+            }
+            record.size = FileSystem::fileSize(archive);
+
+            // Prefer a manifest published next to the archive, else read it from the archive
+            std::optional<Manifest> manifest = Manifest::load(versionDir / "ambar.json");
+            if (!manifest) {
+                ZipReader reader;
+                if (reader.open(archive)) {
+                    if (const auto* entry = reader.find("ambar.json")) {
+                        if (auto content = reader.read(*entry)) {
+                            manifest = Manifest::parse(*content);
+                        }
+                    }
+                }
+            }
+            if (manifest) {
+                record.dependencies = manifest->dependencies;
+            }
+
+            index.add(std::move(record));
+        }
+    }
+
+    return index;
+}
+
+std::string RegistryIndex::serialize() const {
+    json packages = json::object();
+    for (const auto& [name, versions] : packages_) {
+        json list = json::array();
+        for (const auto& record : versions) {
+            list.push_back(recordToJson(record));
+        }
+        packages[name] = std::move(list);
+    }
+
+    json j;
+    j["packages"] = std::move(packages);
+    if (log_.generation > 0) {
+        j["log"] = {{"generation", log_.generation}, {"offset", log_.offset}};
+    }
+    return j.dump(2) + "\n";
+}
+
+std::string RegistryIndex::serializeRecord(const PackageRecord& record) {
+    json v = recordToJson(record);
+    v["name"] = record.name;
+    return v.dump();
+}
+
+std::optional<PackageRecord> RegistryIndex::parseRecord(const std::string& content) {
+    try {
+        auto v = json::parse(content);
+        return recordFromJson(v.at("name").get<std::string>(), v);
+    } catch (const std::exception& e) {
+        Logger::debug("Bad package record: {}", e.what());
+        return std::nullopt;
+    }
+}
+
+void RegistryIndex::add(PackageRecord record) {
+    auto& versions = packages_[record.name];
+    Version incoming(record.version);
+
+    auto it = std::find_if(versions.begin(), versions.end(),
+                           [&](const PackageRecord& r) { return r.version == record.version; });
+    if (it != versions.end()) {
+        *it = std::move(record);
+        return;
+    }
+
+    auto pos = std::upper_bound(versions.begin(), versions.end(), incoming,
+                                [](const Version& v, const PackageRecord& r) { return v < Version(r.version); });
+    versions.insert(pos, std::move(record));
+}
+
+bool RegistryIndex::setYanked(const std::string& name, const std::string& version, bool yanked) {
+    auto it = packages_.find(name);
+    if (it == packages_.end()) {
+        return false;
+    }
+    for (auto& record : it->second) {
+        if (record.version == version) {
+            record.yanked = yanked;
+            return true;
+        }
+    }
+    return false;
+}
+
+const PackageRecord* RegistryIndex::find(const std::string& name, const std::string& version) const {
+    auto it = packages_.find(name);
+    if (it == packages_.end()) {
+        return nullptr;
+    }
+    for (const auto& record : it->second) {
+        if (record.version == version) {
+            return &record;
+        }
+    }
+    return nullptr;
+}
+
+const PackageRecord* RegistryIndex::best(const std::string& name, const std::string& range) const {
+    auto it = packages_.find(name);
+    if (it == packages_.end()) {
+        return nullptr;
+    }
+    for (auto rit = it->second.rbegin(); rit != it->second.rend(); ++rit) {
+        if (!rit->yanked && Version(rit->version).satisfies(range)) {
+            return &*rit;
+        }
+    }
+    return nullptr;
+}
+
+const std::vector<PackageRecord>* RegistryIndex::versions(const std::string& name) const {
+    auto it = packages_.find(name);
+    return it == packages_.end() ? nullptr : &it->second;
+}
+
+std::vector<std::string> RegistryIndex::packageNames() const {
+    std::vector<std::string> names;
+    names.reserve(packages_.size());
+    for (const auto& [name, _] : packages_) {
+        names.push_back(name);
+    }
+    return names;
+}
+
+size_t RegistryIndex::size() const {
+    size_t total = 0;
+    for (const auto& [_, versions] : packages_) {
+        total += versions.size();
+    }
+    return total;
+}
+
+std::string RegistryIndex::archiveUrl(const PackageRecord& record) const {
+    std::string base = baseUrl_;
+    if (!base.empty() && base.back() != '/') {
+        base += '/';
+    }
+    return base + record.archivePath();
+}
+
+std::string RegistryIndex::deltaUrl(const PackageRecord& record, const std::string& from) const {
+    std::string base = baseUrl_;
+    if (!base.empty() && base.back() != '/') {
+        base += '/';
+    }
+    return base + record.deltaPath(from);
+}
+
+std::string RegistryIndex::digestsUrl(const PackageRecord& record) const {
+    std::string base = baseUrl_;
+    if (!base.empty() && base.back() != '/') {
+        base += '/';
+    }
+    return base + record.digestsPath();
+}
+
+} // namespace amb
\ No newline at end of file
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "amb/version.hpp"
+#include "registry/transport.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace amb {
+
+namespace fs = std::filesystem;
+
+// Delta artifact turning an older version into this one
+struct DeltaRecord {
+    std::string sha256;
+    uint64_t size = 0;
+};
+
+// One published version of a package
+struct PackageRecord {
+    std::string name;
+    std::string version;
+    std::string sha256;   // digest of the archive
+    uint64_t size = 0;    // archive size in bytes
+    std::map<std::string, std::string> dependencies; // name -> version range
+    std::map<std::string, DeltaRecord> deltas;       // from-version -> delta artifact
+    std::string publicKey;  // Ed25519 publisher key (hex), empty when unsigned
+    std::string signature;  // Ed25519 signature of signaturePayload() (hex)
+    bool yanked = false;    // still installable when locked, never picked by a new resolution
+
+    // Layout from blueprint §8: <name>/<version>/<name>-<version>.zip
+    std::string archivePath() const;
+    // <name>/<version>/<name>-<from>-<version>.delta
+    std::string deltaPath(const std::string& from) const;
+    // <name>/<version>/files.json
+    std::string digestsPath() const;
+};
+
+// What a package signature covers: name, version and archive digest
+std::string signaturePayload(const std::string& name, const std::string& version,
+                             const std::string& sha256);
+
+// Where in the registry's change log (registry/index_log.hpp) an index is up to
+struct LogPosition {
+    uint64_t generation = 0;  // 0: the registry keeps no log
+    uint64_t offset = 0;      // bytes of index-<generation>.log already applied
+};
+
+// Registry index (registry/index.json): every package version with its digest and dependencies
+class RegistryIndex {
+public:
+    static constexpr const char* INDEX_FILE = "index.json";
+
+    // Loads the index of the registry at `registryUrl`. file:// registries without
+    // an index.json are scanned directly. With a `cacheDir`, the index of a registry
+    // that keeps a change log is cached there and refreshed with the log's new bytes.
+    static std::optional<RegistryIndex> load(const std::string& registryUrl, int timeoutSeconds = 30,
+                                             const fs::path& cacheDir = {});
+    static std::optional<RegistryIndex> parse(const std::string& content);
+    static RegistryIndex scan(const fs::path& registryRoot);
+
+    std::string serialize() const;
+    // One version as a JSON object, as in a change log "publish" line
+    static std::string serializeRecord(const PackageRecord& record);
+    static std::optional<PackageRecord> parseRecord(const std::string& content);
+
+    void add(PackageRecord record);
+    // False when the version is not in the index
+    bool setYanked(const std::string& name, const std::string& version, bool yanked);
+    const PackageRecord* find(const std::string& name, const std::string& version) const;
+    // Highest version satisfying `range` that is not yanked
+    const PackageRecord* best(const std::string& name, const std::string& range) const;
+    const std::vector<PackageRecord>* versions(const std::string& name) const;
+    std::vector<std::string> packageNames() const;
+    size_t size() const;
+
+    const LogPosition& logPosition() const { return log_; }
+    void setLogPosition(LogPosition position) { log_ = position; }
+
+    const std::string& baseUrl() const { return baseUrl_; }
+    void setBaseUrl(const std::string& url) { baseUrl_ = url; }
+    std::string archiveUrl(const PackageRecord& record) const;
+    std::string deltaUrl(const PackageRecord& record, const std::string& from) const;
+    std::string digestsUrl(const PackageRecord& record) const;
+
+private:
+    enum class TailResult { CURRENT, COMPACTED, MISSING, CORRUPT };
+
+    // Applies the log bytes past log_.offset
+    TailResult tail(Transport& transport, const Url& registryUrl);
+    void saveCache(const fs::path& cachePath) const;
+
+    std::string baseUrl_;
+    LogPosition log_;
+    std::map<std::string, std::vector<PackageRecord>> packages_; // versions sorted ascending
+};
+
+} // namespace amb
\ No newline at end of file
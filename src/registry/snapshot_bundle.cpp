@@ -0,0 +1,205 @@
+#include "registry/snapshot_bundle.hpp"
+#include "utils/archive.hpp"
+#include "utils/filesystem.hpp"
+#include "utils/logger.hpp"
+
+#include <algorithm>
+#include <mutex>
+
+namespace amb {
+
+namespace {
+
+constexpr char MAGIC[8] = {'A', 'M', 'B', 'S', 'N', 'A', 'P', '1'};
+constexpr size_t HEADER_SIZE = 32;
+
+uint64_t readLe(std::string_view data, size_t pos, size_t bytes) {
+    uint64_t value = 0;
+    for (size_t i = bytes; i-- > 0;) {
+        value = (value << 8) | static_cast<uint8_t>(data[pos + i]);
+    }
+    return value;
+}
+
+void writeLe(std::string& out, uint64_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; ++i) {
+        out.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+    }
+}
+
+std::string header(uint64_t directoryOffset, uint64_t directorySize, uint32_t count, uint32_t crc) {
+    std::string out(MAGIC, sizeof(MAGIC));
+    writeLe(out, directoryOffset, 8);
+    writeLe(out, directorySize, 8);
+    writeLe(out, count, 4);
+    writeLe(out, crc, 4);
+    return out;
+}
+
+} // namespace
+
+// SnapshotBundle ------------------------------------------------------------
+
+std::shared_ptr<const SnapshotBundle> SnapshotBundle::open(const fs::path& path) {
+    static std::mutex mutex;
+    static std::map<fs::path, std::shared_ptr<const SnapshotBundle>> opened;
+
+    fs::path key = fs::absolute(path).lexically_normal();
+    std::lock_guard lock(mutex);
+    auto it = opened.find(key);
+    if (it != opened.end()) {
+        return it->second;
+    }
+
+    auto file = MappedFile::open(key);
+    if (!file) {
+        return nullptr;
+    }
+    auto bundle = std::make_shared<SnapshotBundle>();
+    bundle->path_ = key;
+    bundle->file_ = std::move(*file);
+    if (!bundle->parse()) {
+        Logger::error("{} is not a valid snapshot bundle", key.string());
+        return nullptr;
+    }
+    Logger::debug("Mapped snapshot {} ({} members)", key.string(), bundle->members_.size());
+    opened.emplace(key, bundle);
+    return bundle;
+}
+
+bool SnapshotBundle::parse() {
+    std::string_view data = file_.data();
+    if (data.size() < HEADER_SIZE || data.substr(0, sizeof(MAGIC)) != std::string_view(MAGIC, sizeof(MAGIC))) {
+        return false;
+    }
+    uint64_t directoryOffset = readLe(data, 8, 8);
+    uint64_t directorySize = readLe(data, 16, 8);
+    auto count = static_cast<uint32_t>(readLe(data, 24, 4));
+    auto crc = static_cast<uint32_t>(readLe(data, 28, 4));
+    if (directoryOffset < HEADER_SIZE || directoryOffset > data.size() ||
+        directorySize > data.size() - directoryOffset) {
+        return false;
+    }
+
+    std::string_view directory = data.substr(directoryOffset, directorySize);
+    if (crc32(directory.data(), directory.size()) != crc) {
+        return false;
+    }
+
+    size_t pos = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        if (pos + 20 > directory.size()) {
+            return false;
+        }
+        uint64_t offset = readLe(directory, pos, 8);
+        uint64_t size = readLe(directory, pos + 8, 8);
+        auto length = static_cast<size_t>(readLe(directory, pos + 16, 4));
+        pos += 20;
+        if (length > directory.size() - pos || offset < HEADER_SIZE || offset > directoryOffset ||
+            size > directoryOffset - offset) {
+            return false;
+        }
+        members_.emplace(std::string(directory.substr(pos, length)), data.substr(offset, size));
+        pos += length;
+    }
+    return true;
+}
+
+std::optional<std::pair<fs::path, std::string>> SnapshotBundle::locate(const std::string& path) {
+    // The bundle is the longest prefix naming a regular file
+    for (size_t slash = path.rfind('/'); slash != std::string::npos && slash > 0;
+         slash = path.rfind('/', slash - 1)) {
+        fs::path candidate(path.substr(0, slash));
+        if (FileSystem::isFile(candidate)) {
+            return std::make_pair(candidate, path.substr(slash + 1));
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<std::string_view> SnapshotBundle::find(const std::string& member) const {
+    auto it = members_.find(member);
+    if (it == members_.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+// SnapshotWriter ------------------------------------------------------------
+
+SnapshotWriter::~SnapshotWriter() {
+    if (out_.is_open()) {
+        out_.close();
+        FileSystem::removeFile(staging_);
+    }
+}
+
+bool SnapshotWriter::open(const fs::path& bundle) {
+    path_ = bundle;
+    staging_ = bundle;
+    staging_ += ".tmp";
+    written_.clear();
+
+    out_.open(staging_, std::ios::binary | std::ios::trunc);
+    FileSystem::invalidate(staging_);
+    if (!out_.is_open()) {
+        Logger::error("Failed to create {}", staging_.string());
+        return false;
+    }
+    // Rewritten by close() once the directory position is known
+    std::string placeholder = header(0, 0, 0, 0);
+    out_.write(placeholder.data(), static_cast<std::streamsize>(placeholder.size()));
+    offset_ = placeholder.size();
+    return out_.good();
+}
+
+bool SnapshotWriter::add(const std::string& member, std::string_view content) {
+    if (!out_.is_open() || !isSafeArchivePath(member)) {
+        return false;
+    }
+    written_.push_back({member, offset_, content.size()});
+    out_.write(content.data(), static_cast<std::streamsize>(content.size()));
+    offset_ += content.size();
+    return out_.good();
+}
+
+bool SnapshotWriter::close() {
+    if (!out_.is_open()) {
+        return false;
+    }
+
+    std::sort(written_.begin(), written_.end(),
+              [](const Written& a, const Written& b) { return a.path < b.path; });
+    std::string directory;
+    for (const auto& w : written_) {
+        writeLe(directory, w.offset, 8);
+        writeLe(directory, w.size, 8);
+        writeLe(directory, w.path.size(), 4);
+        directory += w.path;
+    }
+    out_.write(directory.data(), static_cast<std::streamsize>(directory.size()));
+
+    std::string head = header(offset_, directory.size(), static_cast<uint32_t>(written_.size()),
+                              crc32(directory.data(), directory.size()));
+    out_.seekp(0);
+    out_.write(head.data(), static_cast<std::streamsize>(head.size()));
+    out_.close();
+    if (!out_) {
+        Logger::error("Failed to write {}", staging_.string());
+        FileSystem::removeFile(staging_);
+        return false;
+    }
+
+    std::error_code ec;
+    fs::rename(staging_, path_, ec);
+    FileSystem::invalidate(staging_);
+    FileSystem::invalidate(path_);
+    if (ec) {
+        Logger::error("Failed to move {} into place: {}", path_.string(), ec.message());
+        FileSystem::removeFile(staging_);
+        return false;
+    }
+    return true;
+}
+
+} // namespace amb
\ No newline at end of file
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "utils/mapped_file.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace amb {
+
+namespace fs = std::filesystem;
+
+// A registry subset packed into one file, for machines that reach no registry.
+// Members are stored under their registry paths (index.json, <name>/<version>/...):
+//
+//   header     "AMBSNAP1", directory offset (u64), directory size (u64),
+//              member count (u32), CRC-32 of the directory (u32)
+//   members    contents back to back, uncompressed (archives already are)
+//   directory  per member, sorted by path: offset (u64), size (u64), path length (u32), path
+//
+// All integers are little-endian. Readers map the file and serve members in place.
+class SnapshotBundle {
+public:
+    static constexpr const char* EXTENSION = ".ambs";
+
+    // Mapped once per process and shared by every reader; nullptr if the file is not
+    // a valid bundle
+    static std::shared_ptr<const SnapshotBundle> open(const fs::path& path);
+
+    // Splits "<bundle file>/<member path>" as produced by joining onto a snapshot:// URL
+    static std::optional<std::pair<fs::path, std::string>> locate(const std::string& path);
+
+    // A view into the mapping, valid while the bundle is alive
+    std::optional<std::string_view> find(const std::string& member) const;
+    const std::map<std::string, std::string_view>& members() const { return members_; }
+    const fs::path& path() const { return path_; }
+
+private:
+    bool parse();
+
+    fs::path path_;
+    MappedFile file_;
+    std::map<std::string, std::string_view> members_;
+};
+
+// Streams members into a new bundle; nothing is visible at the target path until close()
+class SnapshotWriter {
+public:
+    SnapshotWriter() = default;
+    ~SnapshotWriter();  // drops the partial file unless close() succeeded
+    SnapshotWriter(const SnapshotWriter&) = delete;
+    SnapshotWriter& operator=(const SnapshotWriter&) = delete;
+
+    bool open(const fs::path& bundle);
+    bool add(const std::string& member, std::string_view content);
+    bool close();
+
+private:
+    struct Written {
+        std::string path;
+        uint64_t offset;
+        uint64_t size;
+    };
+
+    fs::path path_;
+    fs::path staging_;
+    std::ofstream out_;
+    uint64_t offset_ = 0;
+    std::vector<Written> written_;
+};
+
+} // namespace amb
\ No newline at end of file
@@ -0,0 +1,33 @@
+#include "registry/snapshot_transport.hpp"
+#include "registry/snapshot_bundle.hpp"
+#include "utils/error.hpp"
+
+namespace amb {
+
+TransferInfo SnapshotTransport::get(const Url& url, uint64_t offset, const DataSink& sink) {
+    TransferInfo info;
+    auto location = SnapshotBundle::locate(url.path);
+    if (!location) {
+        info.found = false;
+        return info;
+    }
+    auto bundle = SnapshotBundle::open(location->first);
+    if (!bundle) {
+        throw NetworkError("cannot read snapshot " + location->first.string());
+    }
+    auto member = bundle->find(location->second);
+    if (!member) {
+        info.found = false;
+        return info;
+    }
+
+    info.totalSize = member->size();
+    info.rangeHonored = true;
+    if (offset < member->size()) {
+        info.received = member->size() - offset;
+        sink(offset, member->data() + offset, static_cast<size_t>(info.received));
+    }
+    return info;
+}
+
+} // namespace amb
\ No newline at end of file
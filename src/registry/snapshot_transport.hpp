@@ -0,0 +1,15 @@
+#pragma once
+
+#include "registry/transport.hpp"
+
+namespace amb {
+
+// Serves snapshot:// registries out of a mapped snapshot bundle:
+// snapshot:///bundles/app.ambs/index.json is the index.json member of /bundles/app.ambs
+class SnapshotTransport : public Transport {
+public:
+    std::string scheme() const override { return "snapshot"; }
+    TransferInfo get(const Url& url, uint64_t offset, const DataSink& sink) override;
+};
+
+} // namespace amb
\ No newline at end of file
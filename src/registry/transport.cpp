@@ -0,0 +1,129 @@
+#include "registry/transport.hpp"
+#include "registry/file_transport.hpp"
+#include "registry/http_transport.hpp"
+#include "registry/snapshot_transport.hpp"
+#include "utils/logger.hpp"
+
+#include <algorithm>
+#include <cctype>
+
+namespace amb {
+
+std::optional<Url> Url::parse(const std::string& text) {
+    auto sep = text.find("://");
+    if (sep == std::string::npos) {
+        return std::nullopt;
+    }
+
+    Url url;
+    url.scheme = text.substr(0, sep);
+    std::transform(url.scheme.begin(), url.scheme.end(), url.scheme.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    std::string rest = text.substr(sep + 3);
+
+    if (url.scheme == "file" || url.scheme == "snapshot") {
+        // file://./registry, file:///abs/path, snapshot:///abs/bundle.ambs
+        url.path = rest;
+        return url;
+    }
+
+    auto slash = rest.find('/');
+    std::string authority = rest.substr(0, slash);
+    url.path = slash == std::string::npos ? "/" : rest.substr(slash);
+
+    auto colon = authority.rfind(':');
+    if (colon != std::string::npos) {
+        try {
+            int port = std::stoi(authority.substr(colon + 1));
+            if (port <= 0 || port > 65535) {
+                return std::nullopt;
+            }
+            url.port = static_cast<uint16_t>(port);
+        } catch (...) {
+            return std::nullopt;
+        }
+        authority = authority.substr(0, colon);
+    } else {
+        url.port = url.scheme == "https" ? 443 : 80;
+    }
+
+    if (authority.empty()) {
+        return std::nullopt;
+    }
+    url.host = authority;
+    return url;
+}
+
+std::string Url::hostKey() const {
+    if (scheme == "file" || scheme == "snapshot") {
+        return scheme;
+    }
+    return host + ":" + std::to_string(port);
+}
+
+std::string Url::toString() const {
+    if (scheme == "file" || scheme == "snapshot") {
+        return scheme + "://" + path;
+    }
+    return scheme + "://" + host + ":" + std::to_string(port) + path;
+}
+
+Url Url::join(const std::string& relative) const {
+    Url out = *this;
+    if (!out.path.empty() && out.path.back() != '/') {
+        out.path += '/';
+    }
+    out.path += relative;
+    return out;
+}
+
+std::optional<std::string> Transport::getText(const Url& url) {
+    std::string body;
+    auto info = get(url, 0, [&](uint64_t, const char* data, size_t size) {
+        body.append(data, size);
+        return true;
+    });
+    if (!info.found) {
+        return std::nullopt;
+    }
+    return body;
+}
+
+TransportFactory& TransportFactory::instance() {
+    static TransportFactory instance;
+    return instance;
+}
+
+TransportFactory::TransportFactory() {
+    registerTransport("file", [](const TransportOptions&) {
+        return std::make_unique<FileTransport>();
+    });
+    registerTransport("http", [](const TransportOptions& options) {
+        return std::make_unique<HttpTransport>(options);
+    });
+    registerTransport("snapshot", [](const TransportOptions&) {
+        return std::make_unique<SnapshotTransport>();
+    });
+}
+
+void TransportFactory::registerTransport(const std::string& scheme, TransportCreator creator) {
+    if (supports(scheme)) {
+        Logger::warning("Transport '{}' already registered, overwriting", scheme);
+    }
+    creators_[scheme] = std::move(creator);
+}
+
+std::unique_ptr<Transport> TransportFactory::create(const std::string& scheme,
+                                                    const TransportOptions& options) const {
+    auto it = creators_.find(scheme);
+    if (it == creators_.end()) {
+        return nullptr;
+    }
+    return it->second(options);
+}
+
+bool TransportFactory::supports(const std::string& scheme) const {
+    return creators_.find(scheme) != creators_.end();
+}
+
+} // namespace amb
\ No newline at end of file
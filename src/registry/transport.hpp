@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace amb {
+
+// Parsed registry URL (file://, http:// or snapshot://)
+struct Url {
+    std::string scheme;
+    std::string host;
+    uint16_t port = 0;
+    std::string path;
+
+    static std::optional<Url> parse(const std::string& text);
+
+    // "host:port" - used to group connections per host
+    std::string hostKey() const;
+    std::string toString() const;
+
+    // Appends a relative path ("math_utils/1.0.0/...") to this URL
+    Url join(const std::string& relative) const;
+};
+
+// Receives downloaded bytes; `position` is the offset of `data` within the resource.
+// Returning false aborts the transfer.
+using DataSink = std::function<bool(uint64_t position, const char* data, size_t size)>;
+
+struct TransferInfo {
+    bool found = true;          // false when the resource does not exist
+    bool rangeHonored = false;  // true when data starts at the requested offset
+    uint64_t totalSize = 0;     // full resource size, 0 if unknown
+    uint64_t received = 0;      // bytes delivered to the sink
+};
+
+struct TransportOptions {
+    int timeoutSeconds = 30;
+};
+
+// Transport interface - one implementation per URL scheme.
+// get() throws NetworkError on transient failures so callers can retry.
+class Transport {
+public:
+    virtual ~Transport() = default;
+
+    virtual std::string scheme() const = 0;
+    virtual TransferInfo get(const Url& url, uint64_t offset, const DataSink& sink) = 0;
+
+    // Convenience for small documents (index files)
+    std::optional<std::string> getText(const Url& url);
+};
+
+// Transport factory, keyed by URL scheme
+class TransportFactory {
+public:
+    using TransportCreator = std::function<std::unique_ptr<Transport>(const TransportOptions&)>;
+
+    static TransportFactory& instance();
+
+    void registerTransport(const std::string& scheme, TransportCreator creator);
+    std::unique_ptr<Transport> create(const std::string& scheme, const TransportOptions& options) const;
+    bool supports(const std::string& scheme) const;
+
+private:
+    TransportFactory();
+    std::map<std::string, TransportCreator> creators_;
+};
+
+} // namespace amb
\ No newline at end of file
@@ -0,0 +1,544 @@
+#include "utils/archive.hpp"
+#include "utils/logger.hpp"
+
+#include <array>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace amb {
+
+namespace {
+
+// ---------------------------------------------------------------------------
+// CRC-32 (IEEE 802.3)
+// ---------------------------------------------------------------------------
+
+const std::array<uint32_t, 256>& crcTable() {
+    static const std::array<uint32_t, 256> table = [] {
+        std::array<uint32_t, 256> t{};
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+            }
+            t[i] = c;
+        }
+        return t;
+    }();
+    return table;
+}
+
+// ---------------------------------------------------------------------------
+// DEFLATE decoder, modelled after zlib's "puff" reference decoder
+// ---------------------------------------------------------------------------
+
+struct InflateError : std::runtime_error {
+    InflateError() : std::runtime_error("corrupt deflate stream") {}
+};
+
+constexpr int MAXBITS = 15;
+
+struct Huffman {
+    std::array<uint16_t, MAXBITS + 1> count{};
+    std::array<uint16_t, 288> symbol{};
+};
+
+class Inflater {
+public:
+    Inflater(std::string_view in, std::string& out) : in_(in), out_(out) {}
+
+    void run() {
+        int last;
+        do {
+            last = bits(1);
+            int type = bits(2);
+            switch (type) {
+                case 0: stored(); break;
+                case 1: fixed(); break;
+                case 2: dynamic(); break;
+                default: throw InflateError();
+            }
+        } while (!last);
+    }
+
+private:
+    int bits(int need) {
+        uint32_t val = bitBuf_;
+        while (bitCount_ < need) {
+            if (pos_ >= in_.size()) {
+                throw InflateError();
+            }
+            val |= uint32_t(static_cast<uint8_t>(in_[pos_++])) << bitCount_;
+            bitCount_ += 8;
+        }
+        bitBuf_ = val >> need;
+        bitCount_ -= need;
+        return static_cast<int>(val & ((1u << need) - 1));
+    }
+
+    void stored() {
+        bitBuf_ = 0;
+        bitCount_ = 0;
+        if (pos_ + 4 > in_.size()) {
+            throw InflateError();
+        }
+        auto byte = [&](size_t i) { return static_cast<uint32_t>(static_cast<uint8_t>(in_[i])); };
+        uint32_t len = byte(pos_) | (byte(pos_ + 1) << 8);
+        uint32_t nlen = byte(pos_ + 2) | (byte(pos_ + 3) << 8);
+        pos_ += 4;
+        if (len != (~nlen & 0xffff) || pos_ + len > in_.size()) {
+            throw InflateError();
+        }
+        out_.append(in_.data() + pos_, len);
+        pos_ += len;
+    }
+
+    int decode(const Huffman& h) {
+        int code = 0, first = 0, index = 0;
+        for (int len = 1; len <= MAXBITS; ++len) {
+            code |= bits(1);
+            int count = h.count[static_cast<size_t>(len)];
+            if (code - count < first) {
+                return h.symbol[static_cast<size_t>(index + (code - first))];
+            }
+            index += count;
+            first += count;
+            first <<= 1;
+            code <<= 1;
+        }
+        throw InflateError();
+    }
+
+    static int construct(Huffman& h, const uint16_t* length, int n) {
+        h.count.fill(0);
+        for (int sym = 0; sym < n; ++sym) {
+            h.count[length[sym]]++;
+        }
+        if (h.count[0] == n) {
+            return 0;
+        }
+
+        int left = 1;
+        for (size_t len = 1; len <= MAXBITS; ++len) {
+            left <<= 1;
+            left -= h.count[len];
+            if (left < 0) {
+                return left;
+            }
+        }
+
+        std::array<uint16_t, MAXBITS + 1> offs{};
+        for (size_t len = 1; len < MAXBITS; ++len) {
+            offs[len + 1] = static_cast<uint16_t>(offs[len] + h.count[len]);
+        }
+        for (int sym = 0; sym < n; ++sym) {
+            if (length[sym] != 0) {
+                h.symbol[offs[length[sym]]++] = static_cast<uint16_t>(sym);
+            }
+        }
+        return left;
+    }
+
+    void codes(const Huffman& lencode, const Huffman& distcode) {
+        static constexpr uint16_t lbase[29] = {
+            3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+            35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+        static constexpr uint16_t lext[29] = {
+            0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+            3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+        static constexpr uint16_t dbase[30] = {
+            1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+            257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+            8193, 12289, 16385, 24577};
+        static constexpr uint16_t dext[30] = {
+            0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+            7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+        int symbol;
+        do {
+            symbol = decode(lencode);
+            if (symbol < 256) {
+                out_.push_back(static_cast<char>(symbol));
+            } else if (symbol > 256) {
+                symbol -= 257;
+                if (symbol >= 29) {
+                    throw InflateError();
+                }
+                size_t s = static_cast<size_t>(symbol);
+                size_t len = lbase[s] + static_cast<size_t>(bits(lext[s]));
+
+                int dsym = decode(distcode);
+                if (dsym >= 30) {
+                    throw InflateError();
+                }
+                size_t d = static_cast<size_t>(dsym);
+                size_t dist = dbase[d] + static_cast<size_t>(bits(dext[d]));
+                if (dist > out_.size()) {
+                    throw InflateError();
+                }
+                size_t from = out_.size() - dist;
+                for (size_t i = 0; i < len; ++i) {
+                    out_.push_back(out_[from + i]);
+                }
+            }
+        } while (symbol != 256);
+    }
+
+    void fixed() {
+        static const std::pair<Huffman, Huffman> tables = [] {
+            std::pair<Huffman, Huffman> t;
+            std::array<uint16_t, 288> lengths{};
+            size_t sym = 0;
+            for (; sym < 144; ++sym) lengths[sym] = 8;
+            for (; sym < 256; ++sym) lengths[sym] = 9;
+            for (; sym < 280; ++sym) lengths[sym] = 7;
+            for (; sym < 288; ++sym) lengths[sym] = 8;
+            construct(t.first, lengths.data(), 288);
+            lengths.fill(5);
+            construct(t.second, lengths.data(), 30);
+            return t;
+        }();
+        codes(tables.first, tables.second);
+    }
+
+    void dynamic() {
+        static constexpr uint8_t order[19] = {
+            16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+        int nlen = bits(5) + 257;
+        int ndist = bits(5) + 1;
+        int ncode = bits(4) + 4;
+        if (nlen > 286 || ndist > 30) {
+            throw InflateError();
+        }
+
+        std::array<uint16_t, 320> lengths{};
+        int index = 0;
+        for (; index < ncode; ++index) {
+            lengths[order[index]] = static_cast<uint16_t>(bits(3));
+        }
+        for (; index < 19; ++index) {
+            lengths[order[index]] = 0;
+        }
+
+        Huffman lencode, distcode;
+        if (construct(lencode, lengths.data(), 19) != 0) {
+            throw InflateError();
+        }
+
+        index = 0;
+        while (index < nlen + ndist) {
+            int symbol = decode(lencode);
+            if (symbol < 16) {
+                lengths[static_cast<size_t>(index++)] = static_cast<uint16_t>(symbol);
+                continue;
+            }
+
+            uint16_t len = 0;
+            int repeat;
+            if (symbol == 16) {
+                if (index == 0) {
+                    throw InflateError();
+                }
+                len = lengths[static_cast<size_t>(index - 1)];
+                repeat = 3 + bits(2);
+            } else if (symbol == 17) {
+                repeat = 3 + bits(3);
+            } else {
+                repeat = 11 + bits(7);
+            }
+            if (index + repeat > nlen + ndist) {
+                throw InflateError();
+            }
+            while (repeat--) {
+                lengths[static_cast<size_t>(index++)] = len;
+            }
+        }
+
+        if (lengths[256] == 0) {
+            throw InflateError();
+        }
+
+        int err = construct(lencode, lengths.data(), nlen);
+        if (err < 0 || (err > 0 && nlen - lencode.count[0] != 1)) {
+            throw InflateError();
+        }
+        err = construct(distcode, lengths.data() + nlen, ndist);
+        if (err < 0 || (err > 0 && ndist - distcode.count[0] != 1)) {
+            throw InflateError();
+        }
+
+        codes(lencode, distcode);
+    }
+
+    std::string_view in_;
+    std::string& out_;
+    size_t pos_ = 0;
+    uint32_t bitBuf_ = 0;
+    int bitCount_ = 0;
+};
+
+// ---------------------------------------------------------------------------
+// Little-endian helpers
+// ---------------------------------------------------------------------------
+
+uint16_t read16(std::string_view data, size_t pos) {
+    return static_cast<uint16_t>(static_cast<uint8_t>(data[pos]) |
+                                 (static_cast<uint8_t>(data[pos + 1]) << 8));
+}
+
+uint32_t read32(std::string_view data, size_t pos) {
+    return uint32_t(read16(data, pos)) | (uint32_t(read16(data, pos + 2)) << 16);
+}
+
+void write16(std::string& out, uint16_t value) {
+    out.push_back(static_cast<char>(value & 0xff));
+    out.push_back(static_cast<char>(value >> 8));
+}
+
+void write32(std::string& out, uint32_t value) {
+    write16(out, static_cast<uint16_t>(value & 0xffff));
+    write16(out, static_cast<uint16_t>(value >> 16));
+}
+
+constexpr uint32_t LOCAL_HEADER_SIG = 0x04034b50;
+constexpr uint32_t CENTRAL_HEADER_SIG = 0x02014b50;
+constexpr uint32_t END_OF_CENTRAL_SIG = 0x06054b50;
+constexpr uint16_t DOS_DATE_1980 = 0x21; // fixed timestamp keeps archives reproducible
+
+} // namespace
+
+uint32_t crc32(const void* data, size_t size, uint32_t crc) {
+    const auto& table = crcTable();
+    auto bytes = static_cast<const uint8_t*>(data);
+    crc = ~crc;
+    for (size_t i = 0; i < size; ++i) {
+        crc = table[(crc ^ bytes[i]) & 0xff] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+std::optional<std::string> inflate(std::string_view compressed, size_t expectedSize) {
+    std::string out;
+    out.reserve(expectedSize);
+    try {
+        Inflater(compressed, out).run();
+    } catch (const InflateError&) {
+        return std::nullopt;
+    }
+    return out;
+}
+
+bool isSafeArchivePath(const std::string& path) {
+    if (path.empty() || path.front() == '/' || path.front() == '\\') {
+        return false;
+    }
+    if (path.find(':') != std::string::npos) {
+        return false;
+    }
+    std::stringstream ss(path);
+    std::string part;
+    while (std::getline(ss, part, '/')) {
+        if (part == ".." || part.find('\\') != std::string::npos) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ZipReader -----------------------------------------------------------------
+
+bool ZipReader::open(const fs::path& archive) {
+    std::ifstream file(archive, std::ios::binary);
+    if (!file.is_open()) {
+        Logger::error("Failed to open archive {}", archive.string());
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    storage_ = buffer.str();
+    data_ = storage_;
+    return parseCentralDirectory();
+}
+
+bool ZipReader::openMemory(std::string_view data) {
+    storage_.clear();
+    data_ = data;
+    return parseCentralDirectory();
+}
+
+bool ZipReader::parseCentralDirectory() {
+    entries_.clear();
+    byPath_.clear();
+    if (data_.size() < 22) {
+        return false;
+    }
+
+    // Locate the end of central directory record (may be followed by a comment)
+    size_t eocd = std::string_view::npos;
+    size_t minPos = data_.size() > 22 + 0xffff ? data_.size() - 22 - 0xffff : 0;
+    for (size_t pos = data_.size() - 22 + 1; pos-- > minPos;) {
+        if (read32(data_, pos) == END_OF_CENTRAL_SIG) {
+            eocd = pos;
+            break;
+        }
+    }
+    if (eocd == std::string_view::npos) {
+        Logger::error("Archive has no central directory");
+        return false;
+    }
+
+    uint16_t count = read16(data_, eocd + 10);
+    size_t pos = read32(data_, eocd + 16);
+
+    entries_.reserve(count);
+    for (uint16_t i = 0; i < count; ++i) {
+        if (pos + 46 > data_.size() || read32(data_, pos) != CENTRAL_HEADER_SIG) {
+            Logger::error("Corrupt central directory entry");
+            return false;
+        }
+
+        ArchiveEntry entry;
+        entry.method = read16(data_, pos + 10);
+        entry.crc32 = read32(data_, pos + 16);
+        entry.compressedSize = read32(data_, pos + 20);
+        entry.size = read32(data_, pos + 24);
+        uint16_t nameLen = read16(data_, pos + 28);
+        uint16_t extraLen = read16(data_, pos + 30);
+        uint16_t commentLen = read16(data_, pos + 32);
+        entry.localHeaderOffset = read32(data_, pos + 42);
+
+        if (pos + 46 + nameLen > data_.size()) {
+            return false;
+        }
+        entry.path = std::string(data_.substr(pos + 46, nameLen));
+        entry.isDirectory = !entry.path.empty() && entry.path.back() == '/';
+
+        byPath_.emplace(entry.path, entries_.size());
+        entries_.push_back(std::move(entry));
+        pos += 46 + size_t{nameLen} + extraLen + commentLen;
+    }
+
+    return true;
+}
+
+const ArchiveEntry* ZipReader::find(const std::string& path) const {
+    auto it = byPath_.find(path);
+    return it == byPath_.end() ? nullptr : &entries_[it->second];
+}
+
+std::optional<std::string> ZipReader::read(const ArchiveEntry& entry) const {
+    size_t pos = entry.localHeaderOffset;
+    if (pos + 30 > data_.size() || read32(data_, pos) != LOCAL_HEADER_SIG) {
+        Logger::error("Corrupt local header for {}", entry.path);
+        return std::nullopt;
+    }
+    size_t dataStart = pos + 30 + read16(data_, pos + 26) + read16(data_, pos + 28);
+    if (dataStart + entry.compressedSize > data_.size()) {
+        Logger::error("Truncated archive entry {}", entry.path);
+        return std::nullopt;
+    }
+    auto raw = data_.substr(dataStart, entry.compressedSize);
+
+    std::optional<std::string> content;
+    if (entry.method == 0) {
+        content = std::string(raw);
+    } else if (entry.method == 8) {
+        content = inflate(raw, entry.size);
+    } else {
+        Logger::error("Unsupported compression method {} for {}", entry.method, entry.path);
+        return std::nullopt;
+    }
+
+    if (!content || content->size() != entry.size ||
+        crc32(content->data(), content->size()) != entry.crc32) {
+        Logger::error("Checksum mismatch for archive entry {}", entry.path);
+        return std::nullopt;
+    }
+    return content;
+}
+
+// ZipWriter -----------------------------------------------------------------
+
+bool ZipWriter::open(const fs::path& archive) {
+    path_ = archive;
+    buffer_.clear();
+    written_.clear();
+    open_ = true;
+    return true;
+}
+
+bool ZipWriter::add(const std::string& path, std::string_view content) {
+    if (!open_ || !isSafeArchivePath(path) || content.size() > 0xffffffffu) {
+        return false;
+    }
+
+    Written w{path, crc32(content.data(), content.size()), content.size(), buffer_.size()};
+
+    write32(buffer_, LOCAL_HEADER_SIG);
+    write16(buffer_, 20);  // version needed
+    write16(buffer_, 0);   // flags
+    write16(buffer_, 0);   // stored
+    write16(buffer_, 0);   // time
+    write16(buffer_, DOS_DATE_1980);
+    write32(buffer_, w.crc32);
+    write32(buffer_, static_cast<uint32_t>(w.size));
+    write32(buffer_, static_cast<uint32_t>(w.size));
+    write16(buffer_, static_cast<uint16_t>(path.size()));
+    write16(buffer_, 0);
+    buffer_ += path;
+    buffer_.append(content.data(), content.size());
+
+    written_.push_back(std::move(w));
+    return true;
+}
+
+bool ZipWriter::close() {
+    if (!open_) {
+        return false;
+    }
+    open_ = false;
+
+    size_t centralStart = buffer_.size();
+    for (const auto& w : written_) {
+        write32(buffer_, CENTRAL_HEADER_SIG);
+        write16(buffer_, 20);  // version made by
+        write16(buffer_, 20);  // version needed
+        write16(buffer_, 0);
+        write16(buffer_, 0);
+        write16(buffer_, 0);
+        write16(buffer_, DOS_DATE_1980);
+        write32(buffer_, w.crc32);
+        write32(buffer_, static_cast<uint32_t>(w.size));
+        write32(buffer_, static_cast<uint32_t>(w.size));
+        write16(buffer_, static_cast<uint16_t>(w.path.size()));
+        write16(buffer_, 0);   // extra
+        write16(buffer_, 0);   // comment
+        write16(buffer_, 0);   // disk
+        write16(buffer_, 0);   // internal attrs
+        write32(buffer_, 0);   // external attrs
+        write32(buffer_, static_cast<uint32_t>(w.offset));
+        buffer_ += w.path;
+    }
+    size_t centralSize = buffer_.size() - centralStart;
+
+    write32(buffer_, END_OF_CENTRAL_SIG);
+    write16(buffer_, 0);
+    write16(buffer_, 0);
+    write16(buffer_, static_cast<uint16_t>(written_.size()));
+    write16(buffer_, static_cast<uint16_t>(written_.size()));
+    write32(buffer_, static_cast<uint32_t>(centralSize));
+    write32(buffer_, static_cast<uint32_t>(centralStart));
+    write16(buffer_, 0);
+
+    std::ofstream file(path_, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        Logger::error("Failed to create archive {}", path_.string());
+        return false;
+    }
+    file.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+    return file.good();
+}
+
+} // namespace amb
\ No newline at end of file
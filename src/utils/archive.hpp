@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace amb {
+
+namespace fs = std::filesystem;
+
+// Minimal ZIP support for package archives.
+// Reading handles stored and deflated entries; writing produces stored entries.
+
+uint32_t crc32(const void* data, size_t size, uint32_t crc = 0);
+
+// Decodes a raw DEFLATE stream (RFC 1951). Returns nullopt on corrupt input.
+std::optional<std::string> inflate(std::string_view compressed, size_t expectedSize = 0);
+
+struct ArchiveEntry {
+    std::string path;           // generic, '/' separated
+    uint16_t method = 0;        // 0 = stored, 8 = deflate
+    uint32_t crc32 = 0;
+    uint64_t compressedSize = 0;
+    uint64_t size = 0;
+    uint64_t localHeaderOffset = 0;
+    bool isDirectory = false;
+};
+
+class ZipReader {
+public:
+    // Opens an archive from disk (read fully into memory)
+    bool open(const fs::path& archive);
+    // Opens an archive over caller-owned memory, which must outlive the reader
+    bool openMemory(std::string_view data);
+
+    const std::vector<ArchiveEntry>& entries() const { return entries_; }
+    const ArchiveEntry* find(const std::string& path) const;
+
+    // Decompresses an entry and verifies its CRC
+    std::optional<std::string> read(const ArchiveEntry& entry) const;
+
+private:
+    bool parseCentralDirectory();
+
+    std::string storage_;
+    std::string_view data_;
+    std::vector<ArchiveEntry> entries_;
+    std::unordered_map<std::string, size_t> byPath_;
+};
+
+class ZipWriter {
+public:
+    bool open(const fs::path& archive);
+    bool add(const std::string& path, std::string_view content);
+    bool close();
+
+private:
+    struct Written {
+        std::string path;
+        uint32_t crc32;
+        uint64_t size;
+        uint64_t offset;
+    };
+
+    std::string buffer_;
+    std::vector<Written> written_;
+    fs::path path_;
+    bool open_ = false;
+};
+
+// Rejects absolute paths and paths escaping the destination directory
+bool isSafeArchivePath(const std::string& path);
+
+} // namespace amb
\ No newline at end of file
@@ -0,0 +1,898 @@
+#include "utils/ed25519.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <random>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace amb {
+
+namespace {
+
+// ---------------------------------------------------------------------------
+// 64x64 -> 128-bit products
+
+#if defined(__SIZEOF_INT128__)
+using u128 = unsigned __int128;
+
+inline u128 mul64(uint64_t a, uint64_t b) { return static_cast<u128>(a) * b; }
+inline uint64_t low64(u128 x) { return static_cast<uint64_t>(x); }
+inline uint64_t high64(u128 x) { return static_cast<uint64_t>(x >> 64); }
+#else
+struct u128 {
+    uint64_t lo = 0;
+    uint64_t hi = 0;
+};
+
+inline u128 mul64(uint64_t a, uint64_t b) {
+    u128 r;
+    r.lo = _umul128(a, b, &r.hi);
+    return r;
+}
+inline u128 operator+(u128 a, u128 b) {
+    u128 r;
+    r.lo = a.lo + b.lo;
+    r.hi = a.hi + b.hi + (r.lo < a.lo);
+    return r;
+}
+inline u128 operator+(u128 a, uint64_t b) { return a + u128{b, 0}; }
+inline u128& operator+=(u128& a, u128 b) { return a = a + b; }
+inline u128 operator>>(u128 a, unsigned n) {
+    return n >= 64 ? u128{a.hi >> (n - 64), 0} : u128{(a.lo >> n) | (a.hi << (64 - n)), a.hi >> n};
+}
+inline uint64_t low64(u128 x) { return x.lo; }
+inline uint64_t high64(u128 x) { return x.hi; }
+#endif
+
+inline uint64_t load64(const uint8_t* p) {
+    uint64_t v = 0;
+    for (size_t i = 0; i < 8; ++i) {
+        v |= uint64_t{p[i]} << (8 * i);
+    }
+    return v;
+}
+
+inline void store64(uint8_t* p, uint64_t v) {
+    for (size_t i = 0; i < 8; ++i) {
+        p[i] = static_cast<uint8_t>(v >> (8 * i));
+    }
+}
+
+// ---------------------------------------------------------------------------
+// SHA-512 (FIPS 180-4), only needed here
+
+class Sha512 {
+public:
+    void update(const uint8_t* data, size_t size) {
+        length_ += size;
+        while (size > 0) {
+            size_t take = std::min(size, buffer_.size() - bufferSize_);
+            std::memcpy(buffer_.data() + bufferSize_, data, take);
+            bufferSize_ += take;
+            data += take;
+            size -= take;
+            if (bufferSize_ == buffer_.size()) {
+                transform(buffer_.data());
+                bufferSize_ = 0;
+            }
+        }
+    }
+    void update(std::string_view data) { update(reinterpret_cast<const uint8_t*>(data.data()), data.size()); }
+
+    std::array<uint8_t, 64> digest() {
+        uint64_t bits = length_ * 8;
+        uint8_t pad = 0x80;
+        update(&pad, 1);
+        pad = 0;
+        while (bufferSize_ != 112) {
+            update(&pad, 1);
+        }
+        uint8_t tail[16] = {};
+        for (size_t i = 0; i < 8; ++i) {
+            tail[15 - i] = static_cast<uint8_t>(bits >> (8 * i));
+        }
+        update(tail, sizeof(tail));
+
+        std::array<uint8_t, 64> out{};
+        for (size_t i = 0; i < 8; ++i) {
+            for (size_t j = 0; j < 8; ++j) {
+                out[i * 8 + j] = static_cast<uint8_t>(state_[i] >> (56 - 8 * j));
+            }
+        }
+        return out;
+    }
+
+private:
+    static constexpr std::array<uint64_t, 80> K = {
+        0x428a2f98d728ae22ULL, 0x7137449123ef65cdULL, 0xb5c0fbcfec4d3b2fULL, 0xe9b5dba58189dbbcULL,
+        0x3956c25bf348b538ULL, 0x59f111f1b605d019ULL, 0x923f82a4af194f9bULL, 0xab1c5ed5da6d8118ULL,
+        0xd807aa98a3030242ULL, 0x12835b0145706fbeULL, 0x243185be4ee4b28cULL, 0x550c7dc3d5ffb4e2ULL,
+        0x72be5d74f27b896fULL, 0x80deb1fe3b1696b1ULL, 0x9bdc06a725c71235ULL, 0xc19bf174cf692694ULL,
+        0xe49b69c19ef14ad2ULL, 0xefbe4786384f25e3ULL, 0x0fc19dc68b8cd5b5ULL, 0x240ca1cc77ac9c65ULL,
+        0x2de92c6f592b0275ULL, 0x4a7484aa6ea6e483ULL, 0x5cb0a9dcbd41fbd4ULL, 0x76f988da831153b5ULL,
+        0x983e5152ee66dfabULL, 0xa831c66d2db43210ULL, 0xb00327c898fb213fULL, 0xbf597fc7beef0ee4ULL,
+        0xc6e00bf33da88fc2ULL, 0xd5a79147930aa725ULL, 0x06ca6351e003826fULL, 0x142929670a0e6e70ULL,
+        0x27b70a8546d22ffcULL, 0x2e1b21385c26c926ULL, 0x4d2c6dfc5ac42aedULL, 0x53380d139d95b3dfULL,
+        0x650a73548baf63deULL, 0x766a0abb3c77b2a8ULL, 0x81c2c92e47edaee6ULL, 0x92722c851482353bULL,
+        0xa2bfe8a14cf10364ULL, 0xa81a664bbc423001ULL, 0xc24b8b70d0f89791ULL, 0xc76c51a30654be30ULL,
+        0xd192e819d6ef5218ULL, 0xd69906245565a910ULL, 0xf40e35855771202aULL, 0x106aa07032bbd1b8ULL,
+        0x19a4c116b8d2d0c8ULL, 0x1e376c085141ab53ULL, 0x2748774cdf8eeb99ULL, 0x34b0bcb5e19b48a8ULL,
+        0x391c0cb3c5c95a63ULL, 0x4ed8aa4ae3418acbULL, 0x5b9cca4f7763e373ULL, 0x682e6ff3d6b2b8a3ULL,
+        0x748f82ee5defb2fcULL, 0x78a5636f43172f60ULL, 0x84c87814a1f0ab72ULL, 0x8cc702081a6439ecULL,
+        0x90befffa23631e28ULL, 0xa4506cebde82bde9ULL, 0xbef9a3f7b2c67915ULL, 0xc67178f2e372532bULL,
+        0xca273eceea26619cULL, 0xd186b8c721c0c207ULL, 0xeada7dd6cde0eb1eULL, 0xf57d4f7fee6ed178ULL,
+        0x06f067aa72176fbaULL, 0x0a637dc5a2c898a6ULL, 0x113f9804bef90daeULL, 0x1b710b35131c471bULL,
+        0x28db77f523047d84ULL, 0x32caab7b40c72493ULL, 0x3c9ebe0a15c9bebcULL, 0x431d67c49c100d4cULL,
+        0x4cc5d4becb3e42b6ULL, 0x597f299cfc657e2aULL, 0x5fcb6fab3ad6faecULL, 0x6c44198c4a475817ULL
+    };
+
+    static uint64_t rotr(uint64_t x, unsigned n) { return (x >> n) | (x << (64 - n)); }
+
+    void transform(const uint8_t* block) {
+        uint64_t w[80];
+        for (size_t i = 0; i < 16; ++i) {
+            w[i] = 0;
+            for (size_t j = 0; j < 8; ++j) {
+                w[i] = (w[i] << 8) | block[i * 8 + j];
+            }
+        }
+        for (size_t i = 16; i < 80; ++i) {
+            uint64_t s0 = rotr(w[i - 15], 1) ^ rotr(w[i - 15], 8) ^ (w[i - 15] >> 7);
+            uint64_t s1 = rotr(w[i - 2], 19) ^ rotr(w[i - 2], 61) ^ (w[i - 2] >> 6);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+
+        uint64_t a = state_[0], b = state_[1], c = state_[2], d = state_[3];
+        uint64_t e = state_[4], f = state_[5], g = state_[6], h = state_[7];
+        for (size_t i = 0; i < 80; ++i) {
+            uint64_t t1 = h + (rotr(e, 14) ^ rotr(e, 18) ^ rotr(e, 41)) + ((e & f) ^ (~e & g)) + K[i] + w[i];
+            uint64_t t2 = (rotr(a, 28) ^ rotr(a, 34) ^ rotr(a, 39)) + ((a & b) ^ (a & c) ^ (b & c));
+            h = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + t2;
+        }
+        state_[0] += a; state_[1] += b; state_[2] += c; state_[3] += d;
+        state_[4] += e; state_[5] += f; state_[6] += g; state_[7] += h;
+    }
+
+    std::array<uint64_t, 8> state_ = {
+        0x6a09e667f3bcc908ULL, 0xbb67ae8584caa73bULL, 0x3c6ef372fe94f82bULL, 0xa54ff53a5f1d36f1ULL,
+        0x510e527fade682d1ULL, 0x9b05688c2b3e6c1fULL, 0x1f83d9abfb41bd6bULL, 0x5be0cd19137e2179ULL
+    };
+    std::array<uint8_t, 128> buffer_{};
+    size_t bufferSize_ = 0;
+    uint64_t length_ = 0;
+};
+
+// ---------------------------------------------------------------------------
+// Field arithmetic mod p = 2^255 - 19, five 51-bit limbs. Every operation returns
+// limbs below 2^52, which is what mul() and sub() expect from their inputs.
+
+constexpr uint64_t MASK51 = (uint64_t{1} << 51) - 1;
+
+struct Fe {
+    uint64_t v[5];
+};
+
+constexpr Fe FE_ZERO = {{0, 0, 0, 0, 0}};
+constexpr Fe FE_ONE = {{1, 0, 0, 0, 0}};
+
+inline void carry(Fe& a) {
+    uint64_t c;
+    c = a.v[0] >> 51; a.v[0] &= MASK51; a.v[1] += c;
+    c = a.v[1] >> 51; a.v[1] &= MASK51; a.v[2] += c;
+    c = a.v[2] >> 51; a.v[2] &= MASK51; a.v[3] += c;
+    c = a.v[3] >> 51; a.v[3] &= MASK51; a.v[4] += c;
+    c = a.v[4] >> 51; a.v[4] &= MASK51; a.v[0] += c * 19;
+    c = a.v[0] >> 51; a.v[0] &= MASK51; a.v[1] += c;
+}
+
+inline Fe add(const Fe& a, const Fe& b) {
+    Fe r;
+    for (size_t i = 0; i < 5; ++i) {
+        r.v[i] = a.v[i] + b.v[i];
+    }
+    carry(r);
+    return r;
+}
+
+// a + 4p - b keeps every limb positive
+inline Fe sub(const Fe& a, const Fe& b) {
+    Fe r;
+    r.v[0] = a.v[0] + 0x1FFFFFFFFFFFB4ULL - b.v[0];
+    for (size_t i = 1; i < 5; ++i) {
+        r.v[i] = a.v[i] + 0x1FFFFFFFFFFFFCULL - b.v[i];
+    }
+    carry(r);
+    return r;
+}
+
+inline Fe neg(const Fe& a) {
+    return sub(FE_ZERO, a);
+}
+
+// Carries 128-bit limb products back into 51-bit limbs
+inline Fe reduceWide(u128 r0, u128 r1, u128 r2, u128 r3, u128 r4) {
+    Fe r;
+    r1 += r0 >> 51; r.v[0] = low64(r0) & MASK51;
+    r2 += r1 >> 51; r.v[1] = low64(r1) & MASK51;
+    r3 += r2 >> 51; r.v[2] = low64(r2) & MASK51;
+    r4 += r3 >> 51; r.v[3] = low64(r3) & MASK51;
+    u128 c = mul64(low64(r4 >> 51), 19) + r.v[0];
+    r.v[4] = low64(r4) & MASK51;
+    r.v[0] = low64(c) & MASK51;
+    r.v[1] += low64(c >> 51);
+    return r;
+}
+
+inline Fe mul(const Fe& a, const Fe& b) {
+    uint64_t b1 = b.v[1] * 19, b2 = b.v[2] * 19, b3 = b.v[3] * 19, b4 = b.v[4] * 19;
+
+    u128 r0 = mul64(a.v[0], b.v[0]) + mul64(a.v[1], b4) + mul64(a.v[2], b3) + mul64(a.v[3], b2) + mul64(a.v[4], b1);
+    u128 r1 = mul64(a.v[0], b.v[1]) + mul64(a.v[1], b.v[0]) + mul64(a.v[2], b4) + mul64(a.v[3], b3) + mul64(a.v[4], b2);
+    u128 r2 = mul64(a.v[0], b.v[2]) + mul64(a.v[1], b.v[1]) + mul64(a.v[2], b.v[0]) + mul64(a.v[3], b4) + mul64(a.v[4], b3);
+    u128 r3 = mul64(a.v[0], b.v[3]) + mul64(a.v[1], b.v[2]) + mul64(a.v[2], b.v[1]) + mul64(a.v[3], b.v[0]) + mul64(a.v[4], b4);
+    u128 r4 = mul64(a.v[0], b.v[4]) + mul64(a.v[1], b.v[3]) + mul64(a.v[2], b.v[2]) + mul64(a.v[3], b.v[1]) + mul64(a.v[4], b.v[0]);
+
+    return reduceWide(r0, r1, r2, r3, r4);
+}
+
+inline Fe sq(const Fe& a) {
+    uint64_t d0 = a.v[0] * 2, d1 = a.v[1] * 2, d2 = a.v[2] * 2, d3 = a.v[3] * 2;
+    uint64_t a3 = a.v[3] * 19, a4 = a.v[4] * 19;
+
+    u128 r0 = mul64(a.v[0], a.v[0]) + mul64(d1, a4) + mul64(d2, a3);
+    u128 r1 = mul64(d0, a.v[1]) + mul64(d2, a4) + mul64(a.v[3], a3);
+    u128 r2 = mul64(d0, a.v[2]) + mul64(a.v[1], a.v[1]) + mul64(d3, a4);
+    u128 r3 = mul64(d0, a.v[3]) + mul64(d1, a.v[2]) + mul64(a.v[4], a4);
+    u128 r4 = mul64(d0, a.v[4]) + mul64(d1, a.v[3]) + mul64(a.v[2], a.v[2]);
+    return reduceWide(r0, r1, r2, r3, r4);
+}
+
+inline Fe sqTimes(Fe a, size_t n) {
+    while (n-- > 0) {
+        a = sq(a);
+    }
+    return a;
+}
+
+// Ignores bit 255, as RFC 8032 decoding does
+Fe fromBytes(const uint8_t* s) {
+    Fe r;
+    r.v[0] = load64(s) & MASK51;
+    r.v[1] = (load64(s + 6) >> 3) & MASK51;
+    r.v[2] = (load64(s + 12) >> 6) & MASK51;
+    r.v[3] = (load64(s + 19) >> 1) & MASK51;
+    r.v[4] = (load64(s + 24) >> 12) & MASK51;
+    return r;
+}
+
+// Canonical (fully reduced) encoding
+std::array<uint8_t, 32> toBytes(Fe a) {
+    carry(a);
+    uint64_t q = (a.v[0] + 19) >> 51;
+    q = (a.v[1] + q) >> 51;
+    q = (a.v[2] + q) >> 51;
+    q = (a.v[3] + q) >> 51;
+    q = (a.v[4] + q) >> 51;
+    a.v[0] += 19 * q;
+    a.v[1] += a.v[0] >> 51; a.v[0] &= MASK51;
+    a.v[2] += a.v[1] >> 51; a.v[1] &= MASK51;
+    a.v[3] += a.v[2] >> 51; a.v[2] &= MASK51;
+    a.v[4] += a.v[3] >> 51; a.v[3] &= MASK51;
+    a.v[4] &= MASK51;
+
+    std::array<uint8_t, 32> out{};
+    store64(out.data(), a.v[0] | (a.v[1] << 51));
+    store64(out.data() + 8, (a.v[1] >> 13) | (a.v[2] << 38));
+    store64(out.data() + 16, (a.v[2] >> 26) | (a.v[3] << 25));
+    store64(out.data() + 24, (a.v[3] >> 39) | (a.v[4] << 12));
+    return out;
+}
+
+bool isZero(const Fe& a) {
+    auto bytes = toBytes(a);
+    uint8_t acc = 0;
+    for (uint8_t b : bytes) {
+        acc |= b;
+    }
+    return acc == 0;
+}
+
+bool equal(const Fe& a, const Fe& b) {
+    return isZero(sub(a, b));
+}
+
+bool isNegative(const Fe& a) {
+    return toBytes(a)[0] & 1;
+}
+
+// z^(2^250 - 1), also returning z^11 for invert()
+Fe pow2250(const Fe& z, Fe* z11) {
+    Fe z2 = sq(z);
+    Fe z9 = mul(sqTimes(z2, 2), z);
+    Fe t = mul(z9, z2);
+    if (z11) {
+        *z11 = t;
+    }
+    Fe z5 = mul(sq(t), z9);                       // 2^5 - 1
+    Fe z10 = mul(sqTimes(z5, 5), z5);             // 2^10 - 1
+    Fe z20 = mul(sqTimes(z10, 10), z10);          // 2^20 - 1
+    Fe z40 = mul(sqTimes(z20, 20), z20);          // 2^40 - 1
+    Fe z50 = mul(sqTimes(z40, 10), z10);          // 2^50 - 1
+    Fe z100 = mul(sqTimes(z50, 50), z50);         // 2^100 - 1
+    Fe z200 = mul(sqTimes(z100, 100), z100);      // 2^200 - 1
+    return mul(sqTimes(z200, 50), z50);           // 2^250 - 1
+}
+
+// z^(p - 2)
+Fe invert(const Fe& z) {
+    Fe z11;
+    Fe t = pow2250(z, &z11);
+    return mul(sqTimes(t, 5), z11);
+}
+
+// z^((p - 5) / 8), the square-root candidate exponent
+Fe pow22523(const Fe& z) {
+    return mul(sqTimes(pow2250(z, nullptr), 2), z);
+}
+
+inline void select(Fe& r, const Fe& a, uint64_t mask) {
+    for (size_t i = 0; i < 5; ++i) {
+        r.v[i] ^= (r.v[i] ^ a.v[i]) & mask;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Group arithmetic on -x^2 + y^2 = 1 + d x^2 y^2 in extended coordinates. The
+// unified formulas are complete, so the identity needs no special case.
+
+struct Ge {
+    Fe X, Y, Z, T;
+};
+
+// Addend form: (Y + X, Y - X, 2Z, 2dT)
+struct GeCached {
+    Fe yPlusX, yMinusX, z2, t2d;
+};
+
+struct Curve {
+    Fe d;
+    Fe d2;
+    Fe sqrtm1;
+    Ge base;
+    std::array<GeCached, 16> baseTable;  // [0..15]B
+};
+
+const Curve& curve();
+
+constexpr Ge GE_IDENTITY = {FE_ZERO, FE_ONE, FE_ONE, FE_ZERO};
+
+GeCached toCached(const Ge& p, const Fe& d2) {
+    return {add(p.Y, p.X), sub(p.Y, p.X), add(p.Z, p.Z), mul(p.T, d2)};
+}
+
+GeCached toCached(const Ge& p) {
+    return toCached(p, curve().d2);
+}
+
+Ge add(const Ge& p, const GeCached& q) {
+    Fe a = mul(sub(p.Y, p.X), q.yMinusX);
+    Fe b = mul(add(p.Y, p.X), q.yPlusX);
+    Fe c = mul(p.T, q.t2d);
+    Fe d = mul(p.Z, q.z2);
+    Fe e = sub(b, a), f = sub(d, c), g = add(d, c), h = add(b, a);
+    return {mul(e, f), mul(g, h), mul(f, g), mul(e, h)};
+}
+
+Ge sub(const Ge& p, const GeCached& q) {
+    Fe a = mul(sub(p.Y, p.X), q.yPlusX);
+    Fe b = mul(add(p.Y, p.X), q.yMinusX);
+    Fe c = mul(p.T, q.t2d);
+    Fe d = mul(p.Z, q.z2);
+    Fe e = sub(b, a), f = add(d, c), g = sub(d, c), h = add(b, a);
+    return {mul(e, f), mul(g, h), mul(f, g), mul(e, h)};
+}
+
+Ge dbl(const Ge& p) {
+    Fe a = sq(p.X);
+    Fe b = sq(p.Y);
+    Fe z2 = sq(p.Z);
+    Fe c = add(z2, z2);
+    Fe h = add(a, b);
+    Fe e = sub(h, sq(add(p.X, p.Y)));
+    Fe g = sub(a, b);
+    Fe f = add(c, g);
+    return {mul(e, f), mul(g, h), mul(f, g), mul(e, h)};
+}
+
+Ge negate(const Ge& p) {
+    return {neg(p.X), p.Y, p.Z, neg(p.T)};
+}
+
+bool isIdentity(const Ge& p) {
+    return isZero(p.X) && equal(p.Y, p.Z);
+}
+
+// Clears the small-order component
+Ge mulCofactor(const Ge& p) {
+    return dbl(dbl(dbl(p)));
+}
+
+std::array<uint8_t, 32> encode(const Ge& p) {
+    Fe zInv = invert(p.Z);
+    auto out = toBytes(mul(p.Y, zInv));
+    out[31] = static_cast<uint8_t>(out[31] | (isNegative(mul(p.X, zInv)) << 7));
+    return out;
+}
+
+// Rejects non-canonical y and x = 0 with the sign bit set
+bool decode(const uint8_t* s, Ge& out, const Fe& d, const Fe& sqrtm1) {
+    Fe y = fromBytes(s);
+    auto canonical = toBytes(y);
+    canonical[31] = static_cast<uint8_t>(canonical[31] | (s[31] & 0x80));
+    if (std::memcmp(canonical.data(), s, 32) != 0) {
+        return false;
+    }
+
+    Fe y2 = sq(y);
+    Fe u = sub(y2, FE_ONE);
+    Fe v = add(mul(d, y2), FE_ONE);
+    Fe v3 = mul(sq(v), v);
+    Fe x = mul(mul(u, v3), pow22523(mul(u, mul(sq(v3), v))));
+
+    Fe vx2 = mul(v, sq(x));
+    if (!equal(vx2, u)) {
+        if (!equal(vx2, neg(u))) {
+            return false;
+        }
+        x = mul(x, sqrtm1);
+    }
+    bool sign = s[31] >> 7;
+    if (sign && isZero(x)) {
+        return false;
+    }
+    if (isNegative(x) != sign) {
+        x = neg(x);
+    }
+    out = {x, y, FE_ONE, mul(x, y)};
+    return true;
+}
+
+bool decode(const uint8_t* s, Ge& out) {
+    return decode(s, out, curve().d, curve().sqrtm1);
+}
+
+const Curve& curve() {
+    static const Curve instance = [] {
+        auto small = [](uint64_t n) { return Fe{{n, 0, 0, 0, 0}}; };
+        Curve c;
+        c.d = neg(mul(small(121665), invert(small(121666))));
+        c.d2 = add(c.d, c.d);
+        // 2^((p - 1) / 4) = 2^(2^253 - 5)
+        c.sqrtm1 = mul(sqTimes(pow2250(small(2), nullptr), 3), small(8));
+
+        // B = (x, 4/5) with x even
+        auto y = toBytes(mul(small(4), invert(small(5))));
+        decode(y.data(), c.base, c.d, c.sqrtm1);
+
+        Ge multiple = GE_IDENTITY;
+        for (auto& entry : c.baseTable) {
+            entry = toCached(multiple, c.d2);
+            multiple = add(multiple, toCached(c.base, c.d2));
+        }
+        return c;
+    }();
+    return instance;
+}
+
+// ---------------------------------------------------------------------------
+// Scalars mod L = 2^252 + 27742317777372353535851937790883648493, four 64-bit limbs
+
+struct Scalar {
+    uint64_t v[4];
+};
+
+constexpr uint64_t L[4] = {0x5812631a5cf5d3edULL, 0x14def9dea2f79cd6ULL, 0, 0x1000000000000000ULL};
+// floor(2^512 / L) for Barrett reduction
+constexpr uint64_t MU[5] = {0xed9ce5a30a2c131bULL, 0x2106215d086329a7ULL, 0xffffffffffffffebULL,
+                            0xffffffffffffffffULL, 0xf};
+
+// out[0 .. na + nb) = a * b
+void mulLimbs(const uint64_t* a, size_t na, const uint64_t* b, size_t nb, uint64_t* out) {
+    std::fill(out, out + na + nb, 0);
+    for (size_t i = 0; i < na; ++i) {
+        uint64_t carryOut = 0;
+        for (size_t j = 0; j < nb; ++j) {
+            u128 t = mul64(a[i], b[j]) + out[i + j] + carryOut;
+            out[i + j] = low64(t);
+            carryOut = high64(t);
+        }
+        out[i + nb] = carryOut;
+    }
+}
+
+// r = a - b over `n` limbs, returning the borrow
+uint64_t subLimbs(const uint64_t* a, const uint64_t* b, uint64_t* r, size_t n) {
+    uint64_t borrow = 0;
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t t = a[i] - b[i];
+        uint64_t b1 = a[i] < b[i];
+        r[i] = t - borrow;
+        borrow = b1 | (t < borrow);
+    }
+    return borrow;
+}
+
+// x mod L for x < 2^512 (HAC 14.42); branch-free so signing does not leak through timing
+Scalar reduce(const uint64_t x[8]) {
+    uint64_t q2[10];
+    mulLimbs(x + 3, 5, MU, 5, q2);
+    uint64_t q3l[9];
+    mulLimbs(q2 + 5, 5, L, 4, q3l);
+
+    uint64_t r[5];
+    subLimbs(x, q3l, r, 5);
+    const uint64_t l5[5] = {L[0], L[1], L[2], L[3], 0};
+    for (size_t round = 0; round < 2; ++round) {
+        uint64_t t[5];
+        uint64_t keep = uint64_t{0} - subLimbs(r, l5, t, 5);  // all ones when r < L
+        for (size_t i = 0; i < 5; ++i) {
+            r[i] = (r[i] & keep) | (t[i] & ~keep);
+        }
+    }
+    return {{r[0], r[1], r[2], r[3]}};
+}
+
+Scalar reduceBytes(const uint8_t* bytes, size_t size) {
+    uint64_t x[8] = {};
+    for (size_t i = 0; i < size; ++i) {
+        x[i / 8] |= uint64_t{bytes[i]} << (8 * (i % 8));
+    }
+    return reduce(x);
+}
+
+// a * b + c mod L
+Scalar mulAdd(const Scalar& a, const Scalar& b, const Scalar& c) {
+    uint64_t x[8];
+    mulLimbs(a.v, 4, b.v, 4, x);
+    uint64_t carryOut = 0;
+    for (size_t i = 0; i < 8; ++i) {
+        u128 t = u128{x[i]} + (i < 4 ? c.v[i] : 0) + carryOut;
+        x[i] = low64(t);
+        carryOut = high64(t);
+    }
+    return reduce(x);
+}
+
+Scalar negate(const Scalar& a) {
+    uint64_t r[4];
+    subLimbs(L, a.v, r, 4);
+    Scalar zero{{0, 0, 0, 0}};
+    return std::equal(a.v, a.v + 4, zero.v) ? zero : Scalar{{r[0], r[1], r[2], r[3]}};
+}
+
+Scalar loadScalar(const uint8_t* bytes) {
+    return {{load64(bytes), load64(bytes + 8), load64(bytes + 16), load64(bytes + 24)}};
+}
+
+std::array<uint8_t, 32> storeScalar(const Scalar& s) {
+    std::array<uint8_t, 32> out{};
+    for (size_t i = 0; i < 4; ++i) {
+        store64(out.data() + 8 * i, s.v[i]);
+    }
+    return out;
+}
+
+// S must be below L (RFC 8032 5.1.7), otherwise signatures would be malleable
+bool isCanonical(const uint8_t* bytes) {
+    Scalar s = loadScalar(bytes);
+    uint64_t r[4];
+    return subLimbs(s.v, L, r, 4) != 0;
+}
+
+// `width` bits of `s` starting at bit `offset`
+inline uint64_t bits(const Scalar& s, size_t offset, size_t width) {
+    size_t limb = offset / 64;
+    size_t shift = offset % 64;
+    if (limb >= 4) {
+        return 0;
+    }
+    uint64_t value = s.v[limb] >> shift;
+    if (shift + width > 64 && limb + 1 < 4) {
+        value |= s.v[limb + 1] << (64 - shift);
+    }
+    return value & ((uint64_t{1} << width) - 1);
+}
+
+// H(R || A || M) mod L
+Scalar challenge(const uint8_t* r, const uint8_t* a, std::string_view message) {
+    Sha512 hasher;
+    hasher.update(r, 32);
+    hasher.update(a, 32);
+    hasher.update(message);
+    auto digest = hasher.digest();
+    return reduceBytes(digest.data(), digest.size());
+}
+
+// ---------------------------------------------------------------------------
+// Scalar multiplication
+
+// [s]B for secret s: double-and-always-add with a masked select
+Ge baseMulConstantTime(const Scalar& s) {
+    GeCached base = curve().baseTable[1];
+    Ge p = GE_IDENTITY;
+    for (size_t i = 256; i-- > 0;) {
+        p = dbl(p);
+        Ge q = add(p, base);
+        uint64_t mask = uint64_t{0} - ((s.v[i / 64] >> (i % 64)) & 1);
+        select(p.X, q.X, mask);
+        select(p.Y, q.Y, mask);
+        select(p.Z, q.Z, mask);
+        select(p.T, q.T, mask);
+    }
+    return p;
+}
+
+// [a]B + [b]P with interleaved 4-bit windows (public scalars only)
+Ge doubleScalarMul(const Scalar& a, const Scalar& b, const Ge& point) {
+    const auto& baseTable = curve().baseTable;
+    std::array<GeCached, 16> table;
+    Ge multiple = GE_IDENTITY;
+    GeCached cached = toCached(point);
+    for (auto& entry : table) {
+        entry = toCached(multiple);
+        multiple = add(multiple, cached);
+    }
+
+    Ge r = GE_IDENTITY;
+    for (size_t w = 64; w-- > 0;) {
+        if (w != 63) {
+            r = dbl(dbl(dbl(dbl(r))));
+        }
+        if (uint64_t digit = bits(a, w * 4, 4)) {
+            r = add(r, baseTable[digit]);
+        }
+        if (uint64_t digit = bits(b, w * 4, 4)) {
+            r = add(r, table[digit]);
+        }
+    }
+    return r;
+}
+
+// sum [scalars_i] points_i with Pippenger's bucket method: per c-bit window every point
+// costs one addition, plus 2^(c+1) to fold the buckets, so large batches amortize well
+Ge multiScalarMul(const std::vector<Scalar>& scalars, const std::vector<Ge>& points) {
+    const size_t n = points.size();
+    constexpr size_t SCALAR_BITS = 253;
+    // Wider windows need more buckets than fit in cache
+    constexpr size_t MAX_WINDOW = 12;
+
+    size_t width = 1;
+    double best = 0;
+    for (size_t c = 1; c <= MAX_WINDOW; ++c) {
+        double windows = static_cast<double>((SCALAR_BITS + c - 1) / c);
+        double cost = windows * (static_cast<double>(n) + static_cast<double>(uint64_t{2} << c));
+        if (c == 1 || cost < best) {
+            best = cost;
+            width = c;
+        }
+    }
+
+    std::vector<GeCached> cached;
+    cached.reserve(n);
+    for (const auto& p : points) {
+        cached.push_back(toCached(p));
+    }
+
+    std::vector<Ge> buckets(size_t{1} << width);
+    std::vector<char> used(buckets.size());
+    Ge acc = GE_IDENTITY;
+    size_t windows = (SCALAR_BITS + width - 1) / width;
+    for (size_t w = windows; w-- > 0;) {
+        for (size_t i = 0; i < width && w + 1 != windows; ++i) {
+            acc = dbl(acc);
+        }
+
+        std::fill(used.begin(), used.end(), 0);
+        for (size_t i = 0; i < n; ++i) {
+            uint64_t digit = bits(scalars[i], w * width, width);
+            if (digit == 0) {
+                continue;
+            }
+            buckets[digit] = used[digit] ? add(buckets[digit], cached[i]) : points[i];
+            used[digit] = 1;
+        }
+
+        // sum_k k * bucket_k as a running sum of running sums
+        Ge running = GE_IDENTITY;
+        Ge total = GE_IDENTITY;
+        bool any = false;
+        for (size_t k = buckets.size(); k-- > 1;) {
+            if (used[k]) {
+                running = any ? add(running, toCached(buckets[k])) : buckets[k];
+                any = true;
+            }
+            if (any) {
+                total = add(total, toCached(running));
+            }
+        }
+        acc = add(acc, toCached(total));
+    }
+    return acc;
+}
+
+template <size_t N>
+std::optional<std::array<uint8_t, N>> parseHex(std::string_view hex) {
+    if (hex.size() != N * 2) {
+        return std::nullopt;
+    }
+    auto nibble = [](char c) -> int {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    };
+    std::array<uint8_t, N> out{};
+    for (size_t i = 0; i < N; ++i) {
+        int hi = nibble(hex[i * 2]);
+        int lo = nibble(hex[i * 2 + 1]);
+        if (hi < 0 || lo < 0) {
+            return std::nullopt;
+        }
+        out[i] = static_cast<uint8_t>(hi * 16 + lo);
+    }
+    return out;
+}
+
+} // namespace
+
+Ed25519::Seed Ed25519::generateSeed() {
+    std::random_device device;
+    Seed seed{};
+    for (size_t i = 0; i < seed.size(); i += 4) {
+        uint32_t word = device();
+        std::memcpy(seed.data() + i, &word, 4);
+    }
+    return seed;
+}
+
+Ed25519::PublicKey Ed25519::publicKey(const Seed& seed) {
+    Sha512 hasher;
+    hasher.update(seed.data(), seed.size());
+    auto h = hasher.digest();
+    h[0] &= 248;
+    h[31] &= 127;
+    h[31] |= 64;
+    return encode(baseMulConstantTime(loadScalar(h.data())));
+}
+
+Ed25519::Signature Ed25519::sign(const Seed& seed, std::string_view message) {
+    Sha512 expand;
+    expand.update(seed.data(), seed.size());
+    auto h = expand.digest();
+    h[0] &= 248;
+    h[31] &= 127;
+    h[31] |= 64;
+    Scalar a = loadScalar(h.data());
+    auto publicKey = encode(baseMulConstantTime(a));
+
+    Sha512 nonceHasher;
+    nonceHasher.update(h.data() + 32, 32);
+    nonceHasher.update(message);
+    auto nonceDigest = nonceHasher.digest();
+    Scalar r = reduceBytes(nonceDigest.data(), nonceDigest.size());
+    auto encodedR = encode(baseMulConstantTime(r));
+
+    Scalar k = challenge(encodedR.data(), publicKey.data(), message);
+    auto s = storeScalar(mulAdd(k, a, r));
+
+    Signature signature{};
+    std::memcpy(signature.data(), encodedR.data(), 32);
+    std::memcpy(signature.data() + 32, s.data(), 32);
+    return signature;
+}
+
+bool Ed25519::verify(const PublicKey& key, std::string_view message, const Signature& signature) {
+    Ge a, r;
+    if (!isCanonical(signature.data() + 32) || !decode(key.data(), a) || !decode(signature.data(), r)) {
+        return false;
+    }
+    Scalar k = challenge(signature.data(), key.data(), message);
+    // [8]([S]B - [k]A - R) == identity
+    Ge check = sub(doubleScalarMul(loadScalar(signature.data() + 32), k, negate(a)), toCached(r));
+    return isIdentity(mulCofactor(check));
+}
+
+std::vector<bool> Ed25519::verifyBatch(const std::vector<BatchItem>& items) {
+    std::vector<bool> verdicts(items.size(), false);
+    if (items.size() < 2) {
+        for (size_t i = 0; i < items.size(); ++i) {
+            verdicts[i] = verify(items[i].key, items[i].message, items[i].signature);
+        }
+        return verdicts;
+    }
+
+    // Random 128-bit weights z_i so a forged signature cannot cancel against the
+    // others: derived from a fresh secret seed, one SHA-512 per item
+    Seed secret = generateSeed();
+    auto weight = [&](size_t i) {
+        uint8_t index[8];
+        store64(index, i);
+        Sha512 hasher;
+        hasher.update(secret.data(), secret.size());
+        hasher.update(index, sizeof(index));
+        auto digest = hasher.digest();
+        return Scalar{{load64(digest.data()), load64(digest.data() + 8), 0, 0}};
+    };
+
+    // sum z_i R_i + sum (z_i k_i) A_i - (sum z_i S_i) B, one term per distinct key
+    std::vector<Scalar> scalars(1, Scalar{{0, 0, 0, 0}});
+    std::vector<Ge> points(1, curve().base);
+    std::map<PublicKey, size_t> keyTerms;
+    std::vector<size_t> batched;
+    Scalar sumS{{0, 0, 0, 0}};
+
+    for (size_t i = 0; i < items.size(); ++i) {
+        const auto& item = items[i];
+        Ge r;
+        if (!isCanonical(item.signature.data() + 32) || !decode(item.signature.data(), r)) {
+            continue;
+        }
+        auto term = keyTerms.find(item.key);
+        if (term == keyTerms.end()) {
+            Ge a;
+            if (!decode(item.key.data(), a)) {
+                continue;
+            }
+            term = keyTerms.emplace(item.key, points.size()).first;
+            points.push_back(a);
+            scalars.push_back(Scalar{{0, 0, 0, 0}});
+        }
+
+        Scalar z = weight(i);
+        Scalar k = challenge(item.signature.data(), item.key.data(), item.message);
+        scalars[term->second] = mulAdd(z, k, scalars[term->second]);
+        sumS = mulAdd(z, loadScalar(item.signature.data() + 32), sumS);
+        points.push_back(r);
+        scalars.push_back(z);
+        batched.push_back(i);
+    }
+    scalars[0] = negate(sumS);
+
+    if (isIdentity(mulCofactor(multiScalarMul(scalars, points)))) {
+        for (size_t i : batched) {
+            verdicts[i] = true;
+        }
+        return verdicts;
+    }
+
+    // At least one bad signature: find it the slow way
+    for (size_t i : batched) {
+        verdicts[i] = verify(items[i].key, items[i].message, items[i].signature);
+    }
+    return verdicts;
+}
+
+std::optional<Ed25519::Seed> Ed25519::parseSeed(std::string_view hex) {
+    return parseHex<32>(hex);
+}
+
+std::optional<Ed25519::PublicKey> Ed25519::parsePublicKey(std::string_view hex) {
+    return parseHex<32>(hex);
+}
+
+std::optional<Ed25519::Signature> Ed25519::parseSignature(std::string_view hex) {
+    return parseHex<64>(hex);
+}
+
+} // namespace amb
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace amb {
+
+// Ed25519 signatures (RFC 8032). Verification is cofactored, [8][S]B = [8]R + [8][k]A,
+// so a signature accepted by verify() is accepted by verifyBatch() and vice versa.
+class Ed25519 {
+public:
+    using Seed = std::array<uint8_t, 32>;       // private key
+    using PublicKey = std::array<uint8_t, 32>;
+    using Signature = std::array<uint8_t, 64>;
+
+    struct BatchItem {
+        PublicKey key;
+        std::string message;
+        Signature signature;
+    };
+
+    static Seed generateSeed();
+    static PublicKey publicKey(const Seed& seed);
+    static Signature sign(const Seed& seed, std::string_view message);
+
+    static bool verify(const PublicKey& key, std::string_view message, const Signature& signature);
+
+    // Checks every item with one multi-scalar multiplication over random linear
+    // combinations of the equations; items sharing a key share its term. If the
+    // combined check fails the items are re-checked one by one. One verdict per item.
+    static std::vector<bool> verifyBatch(const std::vector<BatchItem>& items);
+
+    // Lowercase hex as stored in the registry index; nullopt on bad length or digits
+    static std::optional<Seed> parseSeed(std::string_view hex);
+    static std::optional<PublicKey> parsePublicKey(std::string_view hex);
+    static std::optional<Signature> parseSignature(std::string_view hex);
+};
+
+} // namespace amb
\ No newline at end of file
@@ -0,0 +1,172 @@
+#include "utils/file_lock.hpp"
+#include "utils/error.hpp"
+#include "utils/filesystem.hpp"
+#include "utils/logger.hpp"
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <system_error>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#endif
+
+namespace amb {
+
+namespace {
+
+std::atomic<uint64_t> acquiredCount{0};
+std::atomic<uint64_t> contendedCount{0};
+std::atomic<int64_t> waitedMicros{0};
+std::atomic<int64_t> longestWaitMicros{0};
+
+void recordWait(std::chrono::microseconds waited) {
+    contendedCount++;
+    waitedMicros += waited.count();
+    int64_t longest = longestWaitMicros;
+    while (waited.count() > longest && !longestWaitMicros.compare_exchange_weak(longest, waited.count())) {
+    }
+}
+
+const char* modeName(LockMode mode) {
+    return mode == LockMode::SHARED ? "shared" : "exclusive";
+}
+
+} // namespace
+
+FileLock::~FileLock() {
+    release();
+}
+
+FileLock::FileLock(FileLock&& other) noexcept {
+    *this = std::move(other);
+}
+
+FileLock& FileLock::operator=(FileLock&& other) noexcept {
+    if (this != &other) {
+        release();
+#ifdef _WIN32
+        handle_ = other.handle_;
+        other.handle_ = nullptr;
+#else
+        fd_ = other.fd_;
+        other.fd_ = -1;
+#endif
+        path_ = std::move(other.path_);
+    }
+    return *this;
+}
+
+bool FileLock::owns() const {
+#ifdef _WIN32
+    return handle_ != nullptr;
+#else
+    return fd_ >= 0;
+#endif
+}
+
+void FileLock::release() {
+    if (!owns()) {
+        return;
+    }
+    // Closing the descriptor drops the lock; the lock file itself stays so that
+    // waiters never end up holding a lock on an unlinked inode
+#ifdef _WIN32
+    CloseHandle(handle_);
+    handle_ = nullptr;
+#else
+    ::close(fd_);
+    fd_ = -1;
+#endif
+}
+
+FileLock FileLock::acquire(const fs::path& path, LockMode mode) {
+    return std::move(*open(path, mode, true));
+}
+
+std::optional<FileLock> FileLock::tryAcquire(const fs::path& path, LockMode mode) {
+    return open(path, mode, false);
+}
+
+std::optional<FileLock> FileLock::open(const fs::path& path, LockMode mode, bool wait) {
+    std::error_code ec;
+    fs::create_directories(path.parent_path(), ec);
+
+    FileLock lock;
+    lock.path_ = path;
+
+#ifdef _WIN32
+    HANDLE handle = CreateFileW(path.wstring().c_str(), GENERIC_READ | GENERIC_WRITE,
+                                FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+                                OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        throw FilesystemError("cannot open lock file " + path.string());
+    }
+    lock.handle_ = handle;
+
+    DWORD flags = mode == LockMode::EXCLUSIVE ? LOCKFILE_EXCLUSIVE_LOCK : 0;
+    auto tryLock = [&](DWORD extra) {
+        OVERLAPPED overlapped{};
+        return LockFileEx(handle, flags | extra, 0, MAXDWORD, MAXDWORD, &overlapped) != 0;
+    };
+    bool immediate = tryLock(LOCKFILE_FAIL_IMMEDIATELY);
+#else
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        throw FilesystemError("cannot open lock file " + path.string() + ": " + std::strerror(errno));
+    }
+    lock.fd_ = fd;
+
+    int operation = mode == LockMode::EXCLUSIVE ? LOCK_EX : LOCK_SH;
+    auto tryLock = [&](int extra) {
+        int rc;
+        do {
+            rc = ::flock(fd, operation | extra);
+        } while (rc != 0 && errno == EINTR);
+        return rc == 0;
+    };
+    bool immediate = tryLock(LOCK_NB);
+#endif
+
+    if (!immediate) {
+        if (!wait) {
+            return std::nullopt;
+        }
+
+        Logger::debug("Waiting for {} lock on {}", modeName(mode), path.string());
+        auto start = std::chrono::steady_clock::now();
+        if (!tryLock(0)) {
+            throw FilesystemError("cannot lock " + path.string());
+        }
+        auto waited = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start);
+        recordWait(waited);
+        Logger::debug("Acquired {} lock on {} after {}ms", modeName(mode), path.string(),
+                      waited.count() / 1000);
+    }
+
+    acquiredCount++;
+    // Whoever held the lock before may have changed what it guards
+    FileSystem::invalidate(path.parent_path());
+    return lock;
+}
+
+FileLock::Stats FileLock::stats() {
+    Stats stats;
+    stats.acquired = acquiredCount;
+    stats.contended = contendedCount;
+    stats.waited = std::chrono::microseconds(waitedMicros.load());
+    stats.longestWait = std::chrono::microseconds(longestWaitMicros.load());
+    return stats;
+}
+
+fs::path FileLock::siblingLockPath(const fs::path& target) {
+    return target.parent_path() / ("." + target.filename().string() + ".lock");
+}
+
+} // namespace amb
\ No newline at end of file
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+
+namespace amb {
+
+namespace fs = std::filesystem;
+
+enum class LockMode {
+    SHARED,     // many readers
+    EXCLUSIVE   // one writer
+};
+
+// Advisory inter-process lock on a lock file (flock on POSIX, LockFileEx on Windows).
+// Every FileLock opens its own descriptor, so two holders in one process exclude
+// each other just like two processes do.
+//
+// Scopes used by amb, always taken in this order:
+//   <project>/ambar_modules/.lock         project state (ambar.lock, ambar.json)
+//   <cache>/.lock                         cache index: shared to add/read, exclusive to prune
+//   <cache>/<artifact>.lock               one download
+//   <lib>/<name>/.<version>.lock          one installed package version
+class FileLock {
+public:
+    struct Stats {
+        uint64_t acquired = 0;
+        uint64_t contended = 0;                    // had to wait for another holder
+        std::chrono::microseconds waited{0};       // total time spent waiting
+        std::chrono::microseconds longestWait{0};
+    };
+
+    FileLock() = default;
+    ~FileLock();
+
+    FileLock(FileLock&& other) noexcept;
+    FileLock& operator=(FileLock&& other) noexcept;
+    FileLock(const FileLock&) = delete;
+    FileLock& operator=(const FileLock&) = delete;
+
+    // Blocks until the lock is held. Throws FilesystemError if the lock file cannot be opened.
+    static FileLock acquire(const fs::path& path, LockMode mode);
+    // Returns nullopt instead of waiting when another holder conflicts
+    static std::optional<FileLock> tryAcquire(const fs::path& path, LockMode mode);
+
+    bool owns() const;
+    const fs::path& path() const { return path_; }
+    void release();
+
+    // Process-wide lock telemetry (reported in --verbose output)
+    static Stats stats();
+
+    // <dir>/.<name>.lock for a directory that is created and replaced as a whole
+    static fs::path siblingLockPath(const fs::path& target);
+
+private:
+    static std::optional<FileLock> open(const fs::path& path, LockMode mode, bool wait);
+
+#ifdef _WIN32
+    void* handle_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+    fs::path path_;
+};
+
+} // namespace amb
\ No newline at end of file
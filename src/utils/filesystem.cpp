@@ -1,26 +1,247 @@
 #include "utils/filesystem.hpp"
 #include "utils/error.hpp"
 #include "utils/logger.hpp"
+#include "utils/archive.hpp"
+#include "utils/sha256.hpp"
 
 #include <fstream>
+#include <iomanip>
+#include <iterator>
 #include <sstream>
 #include <algorithm>
 #include <random>
+#include <set>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <shared_mutex>
+#include <cerrno>
+#include <cstring>
 #ifdef _WIN32
 #include <windows.h>
 #else
 #include <unistd.h>
 #include <pwd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#endif
+#ifdef __linux__
+#include <sys/sendfile.h>
 #endif
 
 namespace amb {
 
+namespace {
+
+#ifndef _WIN32
+bool isUnsupported(int error) {
+    return error == ENOSYS || error == EXDEV || error == EINVAL || error == EOPNOTSUPP;
+}
+
+// Copies `size` bytes from the current offsets, keeping the data in the kernel when
+// possible: copy_file_range (which may reflink), then sendfile, then read/write.
+bool copyContents(int in, int out, uint64_t size) {
+    constexpr size_t MAX_CHUNK = size_t{1} << 30;
+    [[maybe_unused]] bool useRange = true;
+    [[maybe_unused]] bool useSendfile = true;
+    std::vector<char> buffer;
+
+    uint64_t copied = 0;
+    while (copied < size) {
+        size_t chunk = static_cast<size_t>(std::min<uint64_t>(size - copied, MAX_CHUNK));
+        ssize_t n = 0;
+#ifdef __linux__
+        if (useRange) {
+            n = ::copy_file_range(in, nullptr, out, nullptr, chunk, 0);
+            if (n < 0 && isUnsupported(errno)) {
+                useRange = false;
+                continue;
+            }
+        } else if (useSendfile) {
+            n = ::sendfile(out, in, nullptr, chunk);
+            if (n < 0 && isUnsupported(errno)) {
+                useSendfile = false;
+                continue;
+            }
+        } else
+#endif
+        {
+            buffer.resize(256 * 1024);
+            n = ::read(in, buffer.data(), std::min(chunk, buffer.size()));
+            for (ssize_t done = 0; n > 0 && done < n;) {
+                ssize_t w = ::write(out, buffer.data() + done, static_cast<size_t>(n - done));
+                if (w == 0) {
+                    errno = EIO; // no progress and no error: do not spin on it
+                    return false;
+                }
+                if (w < 0 && errno != EINTR) {
+                    return false;
+                }
+                done += std::max<ssize_t>(w, 0);
+            }
+        }
+
+        if (n == 0) {
+            errno = EIO; // source shrank while copying: the copy would be truncated
+            return false;
+        }
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        copied += static_cast<uint64_t>(n);
+    }
+    return true;
+}
+#endif
+
+enum class Kind : uint8_t { MISSING, FILE, DIRECTORY, OTHER, UNKNOWN };
+
+// Path -> kind for the current command. `generation` moves on every invalidation so a
+// stat that raced with a write is not stored after the write invalidated its path.
+struct StatCache {
+    std::atomic<bool> enabled{false};
+    std::shared_mutex mutex;
+    std::map<std::string, Kind> entries;
+    std::atomic<uint64_t> generation{0};
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> misses{0};
+    std::atomic<uint64_t> invalidations{0};
+};
+
+StatCache& statCache() {
+    static StatCache cache;
+    return cache;
+}
+
+// Paths are almost always built by appending names, so normalizing (which costs more
+// than the stat it saves) is reserved for the ones that need it
+std::string cacheKey(const fs::path& path) {
+    std::string key = path.generic_string();
+    bool normal = !key.ends_with('/') && key.find("//") == std::string::npos &&
+                  key.find("/./") == std::string::npos && key.find("/../") == std::string::npos &&
+                  !key.ends_with("/.") && !key.ends_with("/..") && !key.starts_with("./") &&
+                  !key.starts_with("../");
+    return normal ? key : path.lexically_normal().generic_string();
+}
+
+Kind statKind(const fs::path& path) {
+    std::error_code ec;
+    auto status = fs::status(path, ec);
+    switch (status.type()) {
+        case fs::file_type::not_found: return Kind::MISSING;
+        case fs::file_type::regular: return Kind::FILE;
+        case fs::file_type::directory: return Kind::DIRECTORY;
+        case fs::file_type::none:
+            Logger::error("Failed to stat {}: {}", path.string(), ec.message());
+            return Kind::UNKNOWN;
+        default: return Kind::OTHER;
+    }
+}
+
+Kind probe(const fs::path& path) {
+    auto& cache = statCache();
+    if (!cache.enabled.load(std::memory_order_relaxed)) {
+        return statKind(path);
+    }
+
+    std::string key = cacheKey(path);
+    {
+        std::shared_lock lock(cache.mutex);
+        auto it = cache.entries.find(key);
+        if (it != cache.entries.end()) {
+            cache.hits.fetch_add(1, std::memory_order_relaxed);
+            return it->second;
+        }
+    }
+
+    uint64_t generation = cache.generation.load(std::memory_order_acquire);
+    Kind kind = statKind(path);
+    cache.misses.fetch_add(1, std::memory_order_relaxed);
+    if (kind != Kind::UNKNOWN) {
+        std::unique_lock lock(cache.mutex);
+        if (cache.generation.load(std::memory_order_relaxed) == generation) {
+            cache.entries.emplace(std::move(key), kind);
+        }
+    }
+    return kind;
+}
+
+} // namespace
+
+void FileSystem::enableStatCache(bool enabled) {
+    auto& cache = statCache();
+    std::unique_lock lock(cache.mutex);
+    cache.entries.clear();
+    cache.generation++;
+    cache.hits = 0;
+    cache.misses = 0;
+    cache.invalidations = 0;
+    cache.enabled = enabled;
+}
+
+StatCacheStats FileSystem::statCacheStats() {
+    auto& cache = statCache();
+    return {cache.hits.load(), cache.misses.load(), cache.invalidations.load()};
+}
+
+void FileSystem::invalidate(const fs::path& path) {
+    auto& cache = statCache();
+    if (!cache.enabled.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    std::string key = cacheKey(path);
+    std::unique_lock lock(cache.mutex);
+    cache.generation++;
+    if (cache.entries.empty()) {
+        return;
+    }
+
+    uint64_t dropped = cache.entries.erase(key);
+    std::string prefix = key.ends_with('/') ? key : key + "/";
+    auto first = cache.entries.lower_bound(prefix);
+    auto last = first;
+    while (last != cache.entries.end() && last->first.starts_with(prefix)) {
+        ++last;
+        dropped++;
+    }
+    cache.entries.erase(first, last);
+
+    // Creating `path` may have created missing ancestors too
+    for (fs::path parent = fs::path(key).parent_path(); !parent.empty() && parent != parent.root_path();
+         parent = parent.parent_path()) {
+        auto it = cache.entries.find(parent.generic_string());
+        if (it != cache.entries.end() && it->second != Kind::DIRECTORY) {
+            cache.entries.erase(it);
+            dropped++;
+        }
+    }
+    cache.invalidations.fetch_add(dropped, std::memory_order_relaxed);
+}
+
+void FileSystem::invalidateAll() {
+    auto& cache = statCache();
+    if (!cache.enabled.load(std::memory_order_relaxed)) {
+        return;
+    }
+    std::unique_lock lock(cache.mutex);
+    cache.generation++;
+    cache.invalidations.fetch_add(cache.entries.size(), std::memory_order_relaxed);
+    cache.entries.clear();
+}
+
 bool FileSystem::createDirectory(const fs::path& path) {
     try {
-        if (exists(path)) {
-            return isDirectory(path);
+        Kind kind = probe(path);
+        if (kind != Kind::MISSING) {
+            return kind == Kind::DIRECTORY;
         }
-        return fs::create_directory(path);
+        bool created = fs::create_directory(path);
+        invalidate(path);
+        return created;
     } catch (const fs::filesystem_error& e) {
         Logger::error("Failed to create directory {}: {}", path.string(), e.what());
         return false;
@@ -29,10 +250,12 @@ bool FileSystem::createDirectory(const fs::path& path) {
 
 bool FileSystem::createDirectories(const fs::path& path) {
     try {
-        if (exists(path)) {
-            return isDirectory(path);
+        Kind kind = probe(path);
+        if (kind != Kind::MISSING) {
+            return kind == Kind::DIRECTORY;
         }
         fs::create_directories(path);
+        invalidate(path);
         return true;
     } catch (const fs::filesystem_error& e) {
         Logger::error("Failed to create directories {}: {}", path.string(), e.what());
@@ -45,7 +268,9 @@ bool FileSystem::removeDirectory(const fs::path& path) {
         if (!exists(path)) {
             return true;
         }
-        return fs::remove(path);
+        bool removed = fs::remove(path);
+        invalidate(path);
+        return removed;
     } catch (const fs::filesystem_error& e) {
         Logger::error("Failed to remove directory {}: {}", path.string(), e.what());
         return false;
@@ -58,6 +283,7 @@ bool FileSystem::removeDirectories(const fs::path& path) {
             return true;
         }
         fs::remove_all(path);
+        invalidate(path);
         return true;
     } catch (const fs::filesystem_error& e) {
         Logger::error("Failed to remove directories {}: {}", path.string(), e.what());
@@ -65,6 +291,43 @@ bool FileSystem::removeDirectories(const fs::path& path) {
     }
 }
 
+bool FileSystem::copyDirectory(const fs::path& from, const fs::path& to) {
+    std::vector<fs::path> files;
+    try {
+        if (!isDirectory(from)) {
+            Logger::error("Cannot copy {}: not a directory", from.string());
+            return false;
+        }
+
+        // Build the whole directory skeleton first so parallel file copies never wait on a mkdir
+        fs::create_directories(to);
+        for (const auto& entry : fs::recursive_directory_iterator(from)) {
+            auto relative = entry.path().lexically_relative(from);
+            if (entry.is_symlink()) {
+                fs::remove(to / relative);
+                fs::copy_symlink(entry.path(), to / relative);
+            } else if (entry.is_directory()) {
+                fs::create_directory(to / relative, entry.path());
+            } else if (entry.is_regular_file()) {
+                files.push_back(std::move(relative));
+            }
+        }
+    } catch (const fs::filesystem_error& e) {
+        Logger::error("Failed to copy directory {}: {}", from.string(), e.what());
+        return false;
+    }
+
+    invalidate(to);
+
+    std::atomic<size_t> failures{0};
+    IoEngine::instance().parallelFor(files.size(), [&](size_t i) {
+        if (!copyFile(from / files[i], to / files[i])) {
+            failures++;
+        }
+    });
+    return failures == 0;
+}
+
 std::optional<std::string> FileSystem::readFile(const fs::path& path) {
     try {
         if (!isFile(path)) {
@@ -94,6 +357,7 @@ bool FileSystem::writeFile(const fs::path& path, const std::string& content) {
         }
         
         std::ofstream file(path, std::ios::binary);
+        invalidate(path);
         if (!file.is_open()) {
             return false;
         }
@@ -107,31 +371,171 @@ bool FileSystem::writeFile(const fs::path& path, const std::string& content) {
     }
 }
 
-bool FileSystem::exists(const fs::path& path) {
+bool FileSystem::appendFile(const fs::path& path, const std::string& content) {
+    try {
+        if (path.has_parent_path()) {
+            createDirectories(path.parent_path());
+        }
+        
+        std::ofstream file(path, std::ios::binary | std::ios::app);
+        invalidate(path);
+        if (!file.is_open()) {
+            return false;
+        }
+        
+        file.write(content.data(), static_cast<std::streamsize>(content.size()));
+        return file.good();
+        
+    } catch (const std::exception& e) {
+        Logger::error("Failed to append to file {}: {}", path.string(), e.what());
+        return false;
+    }
+}
+
+bool FileSystem::writeFiles(const std::vector<FileWrite>& files, bool sync) {
+    // Directories go first so no write in the batch waits on (or races) a mkdir
+    std::set<fs::path> parents;
+    for (const auto& file : files) {
+        if (file.path.has_parent_path()) {
+            parents.insert(file.path.parent_path());
+        }
+    }
+    for (const auto& parent : parents) {
+        if (!createDirectories(parent)) {
+            return false;
+        }
+    }
+
+    size_t failures = IoEngine::instance().writeFiles(files, sync);
+    for (const auto& file : files) {
+        invalidate(file.path);
+    }
+    if (failures > 0) {
+        Logger::error("Failed to write {} of {} file(s)", failures, files.size());
+        return false;
+    }
+    return true;
+}
+
+bool FileSystem::removeFile(const fs::path& path) {
     try {
-        return fs::exists(path);
+        if (!exists(path)) {
+            return true;
+        }
+        bool removed = fs::remove(path);
+        invalidate(path);
+        return removed;
     } catch (const fs::filesystem_error& e) {
-        Logger::error("Failed to check existence of {}: {}", path.string(), e.what());
+        Logger::error("Failed to remove file {}: {}", path.string(), e.what());
         return false;
     }
 }
 
-bool FileSystem::isDirectory(const fs::path& path) {
+bool FileSystem::linkDirectory(const fs::path& target, const fs::path& link) {
+    std::error_code ec;
+    if (fs::is_symlink(link, ec)) {
+        fs::remove(link, ec);
+    }
+    fs::create_directory_symlink(target, link, ec);
+    invalidate(link);
+    if (ec) {
+        Logger::debug("Cannot link {} to {}: {}", link.string(), target.string(), ec.message());
+        return false;
+    }
+    return true;
+}
+
+bool FileSystem::copyFile(const fs::path& from, const fs::path& to) {
+#ifdef _WIN32
     try {
-        return fs::is_directory(path);
+        fs::copy_file(from, to, fs::copy_options::overwrite_existing);
+        invalidate(to);
+        return true;
     } catch (const fs::filesystem_error& e) {
-        Logger::error("Failed to check if {} is directory: {}", path.string(), e.what());
+        Logger::error("Failed to copy {} to {}: {}", from.string(), to.string(), e.what());
         return false;
     }
+#else
+    int in = ::open(from.c_str(), O_RDONLY | O_CLOEXEC);
+    if (in < 0) {
+        Logger::error("Failed to open {}: {}", from.string(), std::strerror(errno));
+        return false;
+    }
+    struct stat st {};
+    if (::fstat(in, &st) != 0) {
+        ::close(in);
+        return false;
+    }
+
+    auto mode = static_cast<mode_t>(st.st_mode & 07777);
+    int out = ::open(to.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, mode);
+    invalidate(to);
+    if (out < 0) {
+        Logger::error("Failed to create {}: {}", to.string(), std::strerror(errno));
+        ::close(in);
+        return false;
+    }
+
+    // Keep permission bits (umask-free) and timestamps; mtime feeds change detection
+#ifdef __APPLE__
+    struct timespec times[2] = {st.st_atimespec, st.st_mtimespec};
+#else
+    struct timespec times[2] = {st.st_atim, st.st_mtim};
+#endif
+    bool ok = copyContents(in, out, static_cast<uint64_t>(st.st_size)) &&
+              ::fchmod(out, mode) == 0 && ::futimens(out, times) == 0;
+    int error = errno;
+
+    ::close(in);
+    ok = ::close(out) == 0 && ok;
+    if (!ok) {
+        Logger::error("Failed to copy {} to {}: {}", from.string(), to.string(), std::strerror(error));
+    }
+    return ok;
+#endif
+}
+
+bool FileSystem::exists(const fs::path& path) {
+    Kind kind = probe(path);
+    return kind != Kind::MISSING && kind != Kind::UNKNOWN;
+}
+
+bool FileSystem::isDirectory(const fs::path& path) {
+    return probe(path) == Kind::DIRECTORY;
 }
 
 bool FileSystem::isFile(const fs::path& path) {
+    return probe(path) == Kind::FILE;
+}
+
+uintmax_t FileSystem::fileSize(const fs::path& path) {
     try {
-        return fs::is_regular_file(path);
+        return fs::file_size(path);
     } catch (const fs::filesystem_error& e) {
-        Logger::error("Failed to check if {} is file: {}", path.string(), e.what());
-        return false;
+        Logger::error("Failed to get size of {}: {}", path.string(), e.what());
+        return 0;
+    }
+}
+
+std::string FileSystem::filename(const fs::path& path) {
+    return path.filename().string();
+}
+
+std::string FileSystem::formatSize(uint64_t bytes) {
+    static const char* units[] = {"B", "KB", "MB", "GB", "TB"};
+    double value = static_cast<double>(bytes);
+    size_t unit = 0;
+    while (value >= 1024.0 && unit + 1 < std::size(units)) {
+        value /= 1024.0;
+        unit++;
     }
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(unit == 0 ? 0 : 1) << value << " " << units[unit];
+    return out.str();
+}
+
+std::string FileSystem::extension(const fs::path& path) {
+    return path.extension().string();
 }
 
 std::vector<fs::path> FileSystem::listFiles(const fs::path& dir) {
@@ -202,6 +606,12 @@ fs::path FileSystem::getHomeDirectory() {
     #endif
 }
 
+fs::path FileSystem::getTempDirectory() {
+    std::error_code ec;
+    auto path = fs::temp_directory_path(ec);
+    return ec ? fs::path("/tmp") : path;
+}
+
 fs::path FileSystem::getCurrentDirectory() {
     try {
         return fs::current_path();
@@ -214,6 +624,8 @@ fs::path FileSystem::getCurrentDirectory() {
 bool FileSystem::setCurrentDirectory(const fs::path& path) {
     try {
         fs::current_path(path);
+        // Relative keys now name other files
+        invalidateAll();
         return true;
     } catch (const fs::filesystem_error& e) {
         Logger::error("Failed to set current directory to {}: {}", path.string(), e.what());
@@ -222,23 +634,121 @@ bool FileSystem::setCurrentDirectory(const fs::path& path) {
 }
 
 std::string FileSystem::calculateFileHash(const fs::path& path) {
-    // Simplified hash for MVP - use file size and modification time
-    // In production, use SHA256 from OpenSSL or similar
+    // Content digest (hex SHA-256); empty if the file cannot be read
+    if (!isFile(path)) {
+        return "";
+    }
+    auto digest = Sha256::hashFile(path);
+    if (digest.empty()) {
+        Logger::error("Failed to calculate hash for {}", path.string());
+    }
+    return digest;
+}
+
+std::string FileSystem::calculateStringHash(const std::string& content) {
+    return Sha256::hash(content);
+}
+
+namespace {
+
+bool extractEntries(const ZipReader& reader, const std::string& label, const fs::path& destination) {
+    // Bound how much decompressed data is held before handing a batch to the I/O engine
+    constexpr size_t BATCH_BYTES = 32 * 1024 * 1024;
+
+    if (!FileSystem::createDirectories(destination)) {
+        return false;
+    }
+
+    std::vector<FileWrite> batch;
+    size_t batchBytes = 0;
+
+    for (const auto& entry : reader.entries()) {
+        if (!isSafeArchivePath(entry.path)) {
+            Logger::error("Refusing unsafe archive path '{}' in {}", entry.path, label);
+            return false;
+        }
+
+        fs::path target = destination / fs::path(entry.path);
+        if (entry.isDirectory) {
+            if (!FileSystem::createDirectories(target)) {
+                return false;
+            }
+            continue;
+        }
+
+        auto content = reader.read(entry);
+        if (!content) {
+            Logger::error("Failed to extract '{}' from {}", entry.path, label);
+            return false;
+        }
+        batchBytes += content->size();
+        batch.push_back(FileWrite{std::move(target), std::move(*content)});
+
+        if (batchBytes >= BATCH_BYTES) {
+            if (!FileSystem::writeFiles(batch)) {
+                return false;
+            }
+            batch.clear();
+            batchBytes = 0;
+        }
+    }
+
+    return FileSystem::writeFiles(batch);
+}
+
+} // namespace
+
+bool FileSystem::extractZip(const fs::path& archive, const fs::path& destination) {
+    ZipReader reader;
+    if (!reader.open(archive)) {
+        return false;
+    }
+    return extractEntries(reader, archive.string(), destination);
+}
+
+bool FileSystem::extractZipData(std::string_view archive, const std::string& label,
+                                const fs::path& destination) {
+    ZipReader reader;
+    if (!reader.openMemory(archive)) {
+        Logger::error("Failed to open archive {}", label);
+        return false;
+    }
+    return extractEntries(reader, label, destination);
+}
+
+bool FileSystem::createZip(const fs::path& source, const fs::path& archive) {
     try {
-        if (!isFile(path)) {
-            return "";
+        std::vector<fs::path> files;
+        for (const auto& entry : fs::recursive_directory_iterator(source)) {
+            if (entry.is_regular_file()) {
+                files.push_back(entry.path());
+            }
         }
-        
-        auto size = fileSize(path);
-        auto time = fs::last_write_time(path);
-        
-        std::stringstream ss;
-        ss << std::hex << size << "-" << time.time_since_epoch().count();
-        return ss.str();
-        
-    } catch (const std::exception& e) {
-        Logger::error("Failed to calculate hash for {}: {}", path.string(), e.what());
-        return "";
+        // Stable ordering keeps archives (and their digests) reproducible
+        std::sort(files.begin(), files.end());
+
+        ZipWriter writer;
+        if (!writer.open(archive)) {
+            return false;
+        }
+        for (const auto& file : files) {
+            auto content = readFile(file);
+            if (!content) {
+                Logger::error("Failed to read {}", file.string());
+                return false;
+            }
+            if (!writer.add(fs::relative(file, source).generic_string(), *content)) {
+                Logger::error("Failed to add {} to archive", file.string());
+                return false;
+            }
+        }
+        bool closed = writer.close();
+        invalidate(archive);
+        return closed;
+
+    } catch (const fs::filesystem_error& e) {
+        Logger::error("Failed to create archive {}: {}", archive.string(), e.what());
+        return false;
     }
 }
 
@@ -1,28 +1,57 @@
 #pragma once
 
+#include <cstdint>
 #include <filesystem>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <optional>
 #include <functional>
 
+#include "utils/io_engine.hpp"
+
 namespace amb {
 
 namespace fs = std::filesystem;
 
+// Counters of the stat cache since it was last enabled
+struct StatCacheStats {
+    uint64_t hits = 0;           // probes answered without a syscall
+    uint64_t misses = 0;         // probes that had to stat()
+    uint64_t invalidations = 0;  // cached entries dropped because the tree changed
+};
+
 class FileSystem {
 public:
+    // Stat cache: while enabled, exists/isDirectory/isFile answers (negative ones
+    // included) are remembered, so repeated probes of one path cost a single stat().
+    // Writes through FileSystem invalidate what they touch; acquiring a FileLock
+    // invalidates the locked directory, and running a child process drops everything,
+    // since other processes may have changed those. Code that changes the tree by other
+    // means calls invalidate() itself.
+    static void enableStatCache(bool enabled);
+    static StatCacheStats statCacheStats();
+    // Forgets `path`, everything below it and anything cached about its ancestors
+    // other than being directories
+    static void invalidate(const fs::path& path);
+    static void invalidateAll();
+    
     // Directory operations
     static bool createDirectory(const fs::path& path);
     static bool createDirectories(const fs::path& path);
     static bool removeDirectory(const fs::path& path);
     static bool removeDirectories(const fs::path& path);
     static bool copyDirectory(const fs::path& from, const fs::path& to);
+    // Symlink `link` -> `target` (relative to link's directory), replacing a stale link.
+    // Fails where symlinks need privileges (Windows without developer mode).
+    static bool linkDirectory(const fs::path& target, const fs::path& link);
     
     // File operations
     static std::optional<std::string> readFile(const fs::path& path);
     static bool writeFile(const fs::path& path, const std::string& content);
     static bool appendFile(const fs::path& path, const std::string& content);
+    // Writes a batch of files through the IoEngine, creating parent directories first
+    static bool writeFiles(const std::vector<FileWrite>& files, bool sync = false);
     static bool copyFile(const fs::path& from, const fs::path& to);
     static bool removeFile(const fs::path& path);
     
@@ -34,6 +63,8 @@ public:
     static uintmax_t fileSize(const fs::path& path);
     static std::string filename(const fs::path& path);
     static std::string extension(const fs::path& path);
+    // "512 B", "1.5 MB", ... for user-facing reports
+    static std::string formatSize(uint64_t bytes);
     
     // Directory listing
     static std::vector<fs::path> listFiles(const fs::path& dir);
@@ -56,12 +87,15 @@ public:
     static std::vector<fs::path> findFiles(const fs::path& dir, const std::string& pattern);
     static std::vector<fs::path> findFilesRecursive(const fs::path& dir, const std::string& pattern);
     
-    // Hash operations (simplified for MVP)
+    // Hash operations (hex SHA-256 of the content)
     static std::string calculateFileHash(const fs::path& path);
     static std::string calculateStringHash(const std::string& content);
     
     // Archive operations (for future use)
     static bool extractZip(const fs::path& archive, const fs::path& destination);
+    // Same, for an archive already in memory (e.g. mapped); `label` names it in errors
+    static bool extractZipData(std::string_view archive, const std::string& label,
+                               const fs::path& destination);
     static bool createZip(const fs::path& source, const fs::path& archive);
 };
 
@@ -0,0 +1,444 @@
+#include "utils/io_engine.hpp"
+#include "utils/logger.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <optional>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define AMB_HAVE_IO_URING 1
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace amb {
+
+namespace {
+
+#ifndef _WIN32
+bool writeWhole(int fd, const char* data, size_t size, uint64_t offset) {
+    while (size > 0) {
+        ssize_t n = ::pwrite(fd, data, size, static_cast<off_t>(offset));
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
+        offset += static_cast<uint64_t>(n);
+    }
+    return true;
+}
+#endif
+
+bool writeFileBlocking(const FileWrite& file, bool sync) {
+#ifdef _WIN32
+    std::ofstream out(file.path, std::ios::binary | std::ios::trunc);
+    out.write(file.content.data(), static_cast<std::streamsize>(file.content.size()));
+    out.flush();
+    (void)sync;
+    return out.good();
+#else
+    int fd = ::open(file.path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+    if (fd < 0) {
+        return false;
+    }
+    bool ok = writeWhole(fd, file.content.data(), file.content.size(), 0) && (!sync || ::fsync(fd) == 0);
+    return ::close(fd) == 0 && ok;
+#endif
+}
+
+#ifdef AMB_HAVE_IO_URING
+
+// Minimal io_uring ring over the raw syscalls (no liburing dependency).
+// Batches never exceed the ring size and are fully reaped before the next one,
+// so the submission queue cannot overflow.
+class Ring {
+public:
+    static constexpr unsigned ENTRIES = 256;
+
+    static std::unique_ptr<Ring> create() {
+        std::unique_ptr<Ring> ring(new Ring());
+        if (!ring->init()) {
+            return nullptr;
+        }
+        return ring;
+    }
+
+    ~Ring() {
+        if (sqes_) {
+            ::munmap(sqes_, sqesSize_);
+        }
+        if (cqRing_ && cqRing_ != sqRing_) {
+            ::munmap(cqRing_, cqRingSize_);
+        }
+        if (sqRing_) {
+            ::munmap(sqRing_, sqRingSize_);
+        }
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+    }
+
+    unsigned capacity() const { return entries_; }
+
+    io_uring_sqe* next() {
+        unsigned index = localTail_ & *sqMask_;
+        localTail_++;
+        io_uring_sqe* sqe = &sqes_[index];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sqArray_[index] = index;
+        return sqe;
+    }
+
+    // Submits everything queued and hands `expected` completions to onComplete(user_data, res)
+    template <typename F>
+    bool run(unsigned expected, F&& onComplete, std::atomic<uint64_t>& submissions) {
+        unsigned toSubmit = localTail_ - *sqTail_;
+        std::atomic_ref<unsigned>(*sqTail_).store(localTail_, std::memory_order_release);
+
+        unsigned done = 0;
+        while (true) {
+            std::atomic_ref<unsigned> cqHead(*cqHead_);
+            unsigned head = cqHead.load(std::memory_order_relaxed);
+            unsigned tail = std::atomic_ref<unsigned>(*cqTail_).load(std::memory_order_acquire);
+            while (head != tail && done < expected) {
+                const io_uring_cqe& cqe = cqes_[head & *cqMask_];
+                onComplete(cqe.user_data, cqe.res);
+                head++;
+                done++;
+            }
+            cqHead.store(head, std::memory_order_release);
+
+            if (done == expected && toSubmit == 0) {
+                return true;
+            }
+
+            // The kernel skips the wait when it could not submit everything, so asking for
+            // all outstanding completions cannot block on requests that were never queued
+            long rc = ::syscall(__NR_io_uring_enter, fd_, toSubmit, expected - done,
+                                IORING_ENTER_GETEVENTS, nullptr, 0);
+            submissions++;
+            if (rc < 0) {
+                if (errno == EINTR || errno == EAGAIN || errno == EBUSY) {
+                    continue;
+                }
+                Logger::debug("io_uring_enter failed: {}", std::strerror(errno));
+                return false;
+            }
+            toSubmit -= std::min(toSubmit, static_cast<unsigned>(rc));
+        }
+    }
+
+private:
+    Ring() = default;
+
+    bool init() {
+        io_uring_params params{};
+        long fd = ::syscall(__NR_io_uring_setup, ENTRIES, &params);
+        if (fd < 0) {
+            return false;
+        }
+        fd_ = static_cast<int>(fd);
+
+        sqRingSize_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqRingSize_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (single) {
+            sqRingSize_ = cqRingSize_ = std::max(sqRingSize_, cqRingSize_);
+        }
+
+        sqRing_ = map(sqRingSize_, IORING_OFF_SQ_RING);
+        if (!sqRing_) {
+            return false;
+        }
+        cqRing_ = single ? sqRing_ : map(cqRingSize_, IORING_OFF_CQ_RING);
+        sqesSize_ = params.sq_entries * sizeof(io_uring_sqe);
+        sqes_ = static_cast<io_uring_sqe*>(map(sqesSize_, IORING_OFF_SQES));
+        if (!cqRing_ || !sqes_) {
+            return false;
+        }
+
+        auto* sq = static_cast<char*>(sqRing_);
+        auto* cq = static_cast<char*>(cqRing_);
+        sqTail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sqMask_ = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sqArray_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        cqHead_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cqTail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cqMask_ = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+        entries_ = params.sq_entries;
+        localTail_ = *sqTail_;
+        return true;
+    }
+
+    void* map(size_t size, off_t offset) {
+        void* ptr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, offset);
+        return ptr == MAP_FAILED ? nullptr : ptr;
+    }
+
+    int fd_ = -1;
+    unsigned entries_ = 0;
+    unsigned localTail_ = 0;
+
+    void* sqRing_ = nullptr;
+    void* cqRing_ = nullptr;
+    size_t sqRingSize_ = 0;
+    size_t cqRingSize_ = 0;
+    io_uring_sqe* sqes_ = nullptr;
+    size_t sqesSize_ = 0;
+
+    unsigned* sqTail_ = nullptr;
+    unsigned* sqMask_ = nullptr;
+    unsigned* sqArray_ = nullptr;
+    unsigned* cqHead_ = nullptr;
+    unsigned* cqTail_ = nullptr;
+    unsigned* cqMask_ = nullptr;
+    io_uring_cqe* cqes_ = nullptr;
+};
+
+// io_uring lengths are 32-bit; bigger files go through the blocking path
+constexpr size_t MAX_RING_WRITE = size_t{1} << 30;
+
+// Writes one chunk (at most capacity/3 files) in two round trips: all opens, then a
+// linked write -> [fsync] -> close chain per file. Returns the failure count, or
+// nullopt if the ring itself stopped working.
+std::optional<size_t> writeChunk(Ring& ring, const FileWrite* files, size_t count, bool sync,
+                                 std::atomic<uint64_t>& submissions) {
+    enum : uint64_t { WRITE = 0, FSYNC = 1, CLOSE = 2, OPS = 3 };
+
+    std::vector<int> fds(count, -1);
+    unsigned opens = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (files[i].content.size() > MAX_RING_WRITE) {
+            continue;
+        }
+        io_uring_sqe* sqe = ring.next();
+        sqe->opcode = IORING_OP_OPENAT;
+        sqe->fd = AT_FDCWD;
+        sqe->addr = reinterpret_cast<uint64_t>(files[i].path.c_str());
+        sqe->len = 0666;
+        sqe->open_flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+        sqe->user_data = i;
+        opens++;
+    }
+
+    bool unsupported = false;
+    auto opened = [&](uint64_t index, int res) {
+        fds[index] = res;
+        unsupported = unsupported || res == -EINVAL;
+    };
+    if (!ring.run(opens, opened, submissions) || unsupported) {
+        for (int fd : fds) {
+            if (fd >= 0) {
+                ::close(fd);
+            }
+        }
+        return std::nullopt;
+    }
+
+    std::vector<int> results(count * OPS, -ECANCELED);
+    unsigned ops = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (fds[i] < 0) {
+            continue;
+        }
+        io_uring_sqe* write = ring.next();
+        write->opcode = IORING_OP_WRITE;
+        write->fd = fds[i];
+        write->addr = reinterpret_cast<uint64_t>(files[i].content.data());
+        write->len = static_cast<uint32_t>(files[i].content.size());
+        write->flags = IOSQE_IO_LINK;
+        write->user_data = i * OPS + WRITE;
+        ops++;
+
+        if (sync) {
+            io_uring_sqe* fsync = ring.next();
+            fsync->opcode = IORING_OP_FSYNC;
+            fsync->fd = fds[i];
+            fsync->flags = IOSQE_IO_LINK;
+            fsync->user_data = i * OPS + FSYNC;
+            ops++;
+        }
+
+        io_uring_sqe* close = ring.next();
+        close->opcode = IORING_OP_CLOSE;
+        close->fd = fds[i];
+        close->user_data = i * OPS + CLOSE;
+        ops++;
+    }
+
+    auto completed = [&](uint64_t data, int res) { results[data] = res; };
+    if (!ring.run(ops, completed, submissions)) {
+        // The caller redoes the batch blocking; descriptors whose CLOSE was not reaped
+        // (or was cancelled by a broken link) are still open
+        for (size_t i = 0; i < count; ++i) {
+            if (fds[i] >= 0 && results[i * OPS + CLOSE] == -ECANCELED) {
+                ::close(fds[i]);
+            }
+        }
+        return std::nullopt;
+    }
+
+    size_t failures = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const auto& file = files[i];
+        if (file.content.size() > MAX_RING_WRITE) {
+            if (!writeFileBlocking(file, sync)) {
+                failures++;
+            }
+            continue;
+        }
+        if (fds[i] < 0) {
+            Logger::debug("Cannot open {}: {}", file.path.string(), std::strerror(-fds[i]));
+            failures++;
+            continue;
+        }
+
+        int written = results[i * OPS + WRITE];
+        int closed = results[i * OPS + CLOSE];
+        bool ok = static_cast<size_t>(std::max(written, 0)) == file.content.size() &&
+                  (!sync || results[i * OPS + FSYNC] == 0) && closed == 0;
+
+        if (!ok && closed == -ECANCELED) {
+            // A short write breaks the link, leaving the descriptor open: finish it here
+            size_t offset = static_cast<size_t>(std::max(written, 0));
+            ok = writeWhole(fds[i], file.content.data() + offset, file.content.size() - offset, offset) &&
+                 (!sync || ::fsync(fds[i]) == 0);
+            ok = ::close(fds[i]) == 0 && ok;
+        }
+        if (!ok) {
+            Logger::debug("Failed to write {}", file.path.string());
+            failures++;
+        }
+    }
+    return failures;
+}
+
+#endif
+
+} // namespace
+
+IoEngine& IoEngine::instance() {
+    static IoEngine engine;
+    return engine;
+}
+
+IoEngine::IoEngine() : backend_(Backend::THREAD_POOL) {
+#ifdef AMB_HAVE_IO_URING
+    // Rings can be disabled by sysctl or seccomp; probe once
+    uringAvailable_ = Ring::create() != nullptr;
+    if (uringAvailable_) {
+        backend_ = Backend::IO_URING;
+    }
+#endif
+    Logger::debug("I/O engine: {}", backendName());
+}
+
+const char* IoEngine::backendName() const {
+    return backend_ == Backend::IO_URING ? "io_uring" : "thread pool";
+}
+
+bool IoEngine::setBackend(Backend backend) {
+    if (backend == Backend::IO_URING && !uringAvailable_) {
+        return false;
+    }
+    backend_ = backend;
+    return true;
+}
+
+void IoEngine::setExecutor(Executor executor) {
+    std::lock_guard<std::mutex> lock(executorMutex_);
+    executor_ = std::move(executor);
+}
+
+IoEngine::Stats IoEngine::stats() const {
+    return Stats{files_, bytes_, submissions_, failures_};
+}
+
+void IoEngine::parallelFor(size_t count, const std::function<void(size_t)>& fn) const {
+    Executor executor;
+    {
+        std::lock_guard<std::mutex> lock(executorMutex_);
+        executor = executor_;
+    }
+
+    if (executor && count > 1) {
+        executor(count, fn);
+        return;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        fn(i);
+    }
+}
+
+size_t IoEngine::writeBlocking(const FileWrite* files, size_t count, bool sync) {
+    std::atomic<size_t> failures{0};
+    parallelFor(count, [&](size_t i) {
+        if (!writeFileBlocking(files[i], sync)) {
+            Logger::debug("Failed to write {}", files[i].path.string());
+            failures++;
+        }
+    });
+    return failures;
+}
+
+size_t IoEngine::writeFiles(const std::vector<FileWrite>& files, bool sync) {
+    if (files.empty()) {
+        return 0;
+    }
+
+    files_ += files.size();
+    for (const auto& file : files) {
+        bytes_ += file.content.size();
+    }
+
+    size_t failures = 0;
+    bool done = false;
+
+#ifdef AMB_HAVE_IO_URING
+    if (backend_ == Backend::IO_URING) {
+        // One ring per thread: batches from parallel extractions never contend
+        thread_local std::unique_ptr<Ring> ring = Ring::create();
+        if (ring) {
+            size_t perChunk = ring->capacity() / 3;
+            size_t begin = 0;
+            for (; begin < files.size(); begin += perChunk) {
+                size_t count = std::min(perChunk, files.size() - begin);
+                auto result = writeChunk(*ring, files.data() + begin, count, sync, submissions_);
+                if (!result) {
+                    Logger::debug("io_uring batch failed, falling back to blocking writes");
+                    ring.reset();
+                    break;
+                }
+                failures += *result;
+            }
+            if (begin < files.size()) {
+                failures += writeBlocking(files.data() + begin, files.size() - begin, sync);
+            }
+            done = true;
+        }
+    }
+#endif
+
+    if (!done) {
+        failures += writeBlocking(files.data(), files.size(), sync);
+    }
+    failures_ += failures;
+    return failures;
+}
+
+} // namespace amb
\ No newline at end of file
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace amb {
+
+namespace fs = std::filesystem;
+
+// A file to be created (or truncated) and written in full
+struct FileWrite {
+    fs::path path;
+    std::string content;
+};
+
+// Batched file writer behind FileSystem::writeFiles.
+// On Linux the open/write/fsync/close sequence of a whole batch is submitted through
+// io_uring (one submission for the opens, one linked chain per file for the rest);
+// elsewhere, or when the kernel refuses a ring, the same batch runs as blocking calls
+// spread over the executor installed by Context.
+class IoEngine {
+public:
+    enum class Backend {
+        IO_URING,
+        THREAD_POOL
+    };
+
+    // Runs fn(0..count-1), possibly in parallel, and returns when all calls finished
+    using Executor = std::function<void(size_t count, const std::function<void(size_t)>& fn)>;
+
+    struct Stats {
+        uint64_t files = 0;
+        uint64_t bytes = 0;
+        uint64_t submissions = 0;  // io_uring_enter calls
+        uint64_t failures = 0;
+    };
+
+    static IoEngine& instance();
+
+    Backend backend() const { return backend_; }
+    const char* backendName() const;
+    // Returns false if `backend` is not available on this system
+    bool setBackend(Backend backend);
+
+    // Serial when unset
+    void setExecutor(Executor executor);
+    // Runs fn(0..count-1) on the installed executor (shared by other blocking file work)
+    void parallelFor(size_t count, const std::function<void(size_t)>& fn) const;
+
+    // Parent directories must exist. Returns the number of files that failed.
+    size_t writeFiles(const std::vector<FileWrite>& files, bool sync = false);
+
+    Stats stats() const;
+
+private:
+    IoEngine();
+
+    size_t writeBlocking(const FileWrite* files, size_t count, bool sync);
+
+    Backend backend_;
+    bool uringAvailable_ = false;
+
+    mutable std::mutex executorMutex_;
+    Executor executor_;
+
+    std::atomic<uint64_t> files_{0};
+    std::atomic<uint64_t> bytes_{0};
+    std::atomic<uint64_t> submissions_{0};
+    std::atomic<uint64_t> failures_{0};
+};
+
+} // namespace amb
\ No newline at end of file
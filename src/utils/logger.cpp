@@ -9,6 +9,7 @@ LogLevel Logger::currentLevel_ = LogLevel::INFO;
 bool Logger::quiet_ = false;
 bool Logger::initialized_ = false;
 std::mutex Logger::logMutex_;
+Logger::Sink Logger::sink_;
 
 void Logger::init(LogLevel level) {
     std::lock_guard lock(logMutex_);
@@ -30,6 +31,15 @@ LogLevel Logger::getLevel() {
     return currentLevel_;
 }
 
+void Logger::setSink(Sink sink) {
+    std::lock_guard lock(logMutex_);
+    sink_ = std::move(sink);
+}
+
+std::string Logger::formatLine(LogLevel level, const std::string& message) {
+    return "[" + getTimestamp() + "] [" + levelToString(level) + "] " + message;
+}
+
 void Logger::debug(const std::string& message) {
     log(LogLevel::DEBUG, message);
 }
@@ -58,9 +68,11 @@ void Logger::log(LogLevel level, const std::string& message) {
     
     std::lock_guard lock(logMutex_);
     
-    std::cerr << "[" << getTimestamp() << "] ";
-    std::cerr << "[" << levelToString(level) << "] ";
-    std::cerr << message << std::endl;
+    if (sink_) {
+        sink_(level, message);
+        return;
+    }
+    std::cerr << formatLine(level, message) << std::endl;
 }
 
 std::string Logger::levelToString(LogLevel level) {
@@ -4,6 +4,7 @@
 #include <iostream>
 #include <sstream>
 #include <mutex>
+#include <functional>
 
 namespace amb {
 
@@ -22,6 +23,14 @@ public:
     static void setQuiet(bool quiet);
     static LogLevel getLevel();
     
+    // Where messages go instead of stderr (the command output stream); empty restores stderr
+    using Sink = std::function<void(LogLevel level, const std::string& message)>;
+    static void setSink(Sink sink);
+    
+    // "[12:00:00.000] [WARN] message", as written to stderr
+    static std::string formatLine(LogLevel level, const std::string& message);
+    static std::string levelToString(LogLevel level);
+    
     // Basic logging methods
     static void debug(const std::string& message);
     static void info(const std::string& message);
@@ -57,7 +66,6 @@ public:
     
 private:
     static void log(LogLevel level, const std::string& message);
-    static std::string levelToString(LogLevel level);
     static std::string getTimestamp();
     
     // Simple string formatting (replace with fmt if available)
@@ -85,6 +93,7 @@ private:
     static bool quiet_;
     static bool initialized_;
     static std::mutex logMutex_;
+    static Sink sink_;
 };
 
 } // namespace amb
\ No newline at end of file
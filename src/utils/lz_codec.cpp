@@ -0,0 +1,307 @@
+#include "utils/lz_codec.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <queue>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace amb {
+
+namespace {
+
+constexpr size_t MIN_MATCH = 4;
+constexpr size_t MAX_OFFSET = 65535;
+constexpr int HASH_BITS = 16;
+
+// Training: substrings counted, candidate segment length and total sample budget
+constexpr size_t KMER = 8;
+constexpr size_t SEGMENT = 64;
+constexpr size_t MAX_TRAINING_BYTES = 8 * 1024 * 1024;
+
+uint32_t read32(const char* p) {
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+uint64_t read64(const char* p) {
+    uint64_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+size_t hash4(uint32_t value) {
+    return (value * 2654435761u) >> (32 - HASH_BITS);
+}
+
+std::string_view tail(std::string_view dictionary) {
+    return dictionary.size() > LZ_MAX_DICTIONARY ? dictionary.substr(dictionary.size() - LZ_MAX_DICTIONARY)
+                                                 : dictionary;
+}
+
+// Lengths past a nibble's 15 continue in bytes of 255 plus a final smaller one
+void putLength(std::string& out, size_t length) {
+    for (; length >= 255; length -= 255) {
+        out.push_back(static_cast<char>(255));
+    }
+    out.push_back(static_cast<char>(length));
+}
+
+// One sequence; `matchLength` 0 marks the final, literal-only one
+void emit(std::string& out, const char* literals, size_t literalLength, size_t offset, size_t matchLength) {
+    size_t matchCode = matchLength >= MIN_MATCH ? matchLength - MIN_MATCH : 0;
+    out.push_back(static_cast<char>((std::min<size_t>(literalLength, 15) << 4) | std::min<size_t>(matchCode, 15)));
+    if (literalLength >= 15) {
+        putLength(out, literalLength - 15);
+    }
+    out.append(literals, literalLength);
+    if (matchLength == 0) {
+        return;
+    }
+    out.push_back(static_cast<char>(offset & 0xff));
+    out.push_back(static_cast<char>(offset >> 8));
+    if (matchCode >= 15) {
+        putLength(out, matchCode - 15);
+    }
+}
+
+} // namespace
+
+std::string lzCompress(std::string_view input, std::string_view dictionary) {
+    dictionary = tail(dictionary);
+
+    // Dictionary and input as one history, so matches cross into the dictionary freely
+    std::string window;
+    window.reserve(dictionary.size() + input.size());
+    window.append(dictionary).append(input);
+    const char* base = window.data();
+    const size_t start = dictionary.size();
+    const size_t end = window.size();
+
+    std::vector<uint32_t> table(size_t{1} << HASH_BITS, 0);  // position + 1, 0 = empty
+    for (size_t i = 0; i + MIN_MATCH <= start; ++i) {
+        table[hash4(read32(base + i))] = static_cast<uint32_t>(i + 1);
+    }
+
+    std::string out;
+    out.reserve(input.size() / 2 + 16);
+    size_t anchor = start;
+    size_t pos = start;
+    size_t misses = 0;
+    while (pos + MIN_MATCH <= end) {
+        uint32_t sequence = read32(base + pos);
+        size_t slot = hash4(sequence);
+        size_t candidate = table[slot];
+        table[slot] = static_cast<uint32_t>(pos + 1);
+
+        if (candidate == 0 || pos - (candidate - 1) > MAX_OFFSET || read32(base + candidate - 1) != sequence) {
+            // Incompressible stretches are skipped through faster and faster
+            pos += 1 + (misses++ >> 6);
+            continue;
+        }
+
+        size_t ref = candidate - 1;
+        size_t length = MIN_MATCH;
+        while (pos + length < end && base[ref + length] == base[pos + length]) {
+            ++length;
+        }
+        while (pos > anchor && ref > 0 && base[pos - 1] == base[ref - 1]) {
+            --pos;
+            --ref;
+            ++length;
+        }
+        emit(out, base + anchor, pos - anchor, pos - ref, length);
+
+        size_t next = pos + length;
+        for (size_t i = pos + 1; i < next && i + MIN_MATCH <= end; ++i) {
+            table[hash4(read32(base + i))] = static_cast<uint32_t>(i + 1);
+        }
+        pos = anchor = next;
+        misses = 0;
+    }
+    emit(out, base + anchor, end - anchor, 0, 0);
+    return out;
+}
+
+std::optional<std::string> lzDecompress(std::string_view block, size_t size, std::string_view dictionary) {
+    std::string out(size, '\0');
+    if (!lzDecompress(block, out.data(), size, dictionary)) {
+        return std::nullopt;
+    }
+    return out;
+}
+
+bool lzDecompress(std::string_view block, char* dst, size_t size, std::string_view dictionary) {
+    dictionary = tail(dictionary);
+
+    size_t produced = 0;
+    auto ip = reinterpret_cast<const uint8_t*>(block.data());
+    const auto end = ip + block.size();
+
+    auto readLength = [&](size_t& length) {
+        uint8_t byte = 255;
+        while (byte == 255) {
+            if (ip == end) {
+                return false;
+            }
+            byte = *ip++;
+            length += byte;
+        }
+        return true;
+    };
+
+    while (ip < end) {
+        uint8_t token = *ip++;
+
+        size_t literals = token >> 4;
+        if (literals == 15 && !readLength(literals)) {
+            return false;
+        }
+        if (literals > static_cast<size_t>(end - ip) || literals > size - produced) {
+            return false;
+        }
+        std::memcpy(dst + produced, ip, literals);
+        ip += literals;
+        produced += literals;
+        if (ip == end) {
+            break;
+        }
+
+        if (end - ip < 2) {
+            return false;
+        }
+        size_t offset = static_cast<size_t>(ip[0]) | static_cast<size_t>(ip[1]) << 8;
+        ip += 2;
+        size_t length = token & 15;
+        if (length == 15 && !readLength(length)) {
+            return false;
+        }
+        length += MIN_MATCH;
+        if (offset == 0 || offset > produced + dictionary.size() || length > size - produced) {
+            return false;
+        }
+
+        if (offset > produced) {
+            // Starts in the dictionary and may run on into the output
+            size_t back = offset - produced;
+            size_t take = std::min(back, length);
+            std::memcpy(dst + produced, dictionary.data() + dictionary.size() - back, take);
+            produced += take;
+            length -= take;
+            offset = produced;
+        }
+        char* d = dst + produced;
+        const char* s = d - offset;
+        if (offset >= length) {
+            std::memcpy(d, s, length);
+        } else {
+            // Overlapping: the match repeats bytes it is producing
+            for (size_t i = 0; i < length; ++i) {
+                d[i] = s[i];
+            }
+        }
+        produced += length;
+    }
+
+    return produced == size;
+}
+
+std::string lzTrainDictionary(const std::vector<std::string_view>& samples, size_t capacity) {
+    capacity = std::min(capacity, LZ_MAX_DICTIONARY);
+
+    std::vector<std::string_view> used;
+    size_t budget = MAX_TRAINING_BYTES;
+    for (auto sample : samples) {
+        if (sample.size() < KMER) {
+            continue;
+        }
+        if (sample.size() > budget) {
+            break;
+        }
+        budget -= sample.size();
+        used.push_back(sample);
+    }
+
+    // How many samples contain each substring: content shared by many files pays off,
+    // repetition inside one file is found by the codec anyway
+    std::unordered_map<uint64_t, uint32_t> frequency;
+    for (auto sample : used) {
+        std::unordered_set<uint64_t> seen;
+        for (size_t i = 0; i + KMER <= sample.size(); ++i) {
+            uint64_t kmer = read64(sample.data() + i);
+            if (seen.insert(kmer).second) {
+                frequency[kmer]++;
+            }
+        }
+    }
+
+    struct Segment {
+        std::string_view text;
+        uint64_t score = 0;
+    };
+    auto score = [&](std::string_view text) {
+        uint64_t total = 0;
+        std::unordered_set<uint64_t> counted;
+        for (size_t i = 0; i + KMER <= text.size(); ++i) {
+            uint64_t kmer = read64(text.data() + i);
+            auto it = frequency.find(kmer);
+            if (it != frequency.end() && it->second > 1 && counted.insert(kmer).second) {
+                total += it->second;
+            }
+        }
+        return total;
+    };
+
+    std::vector<Segment> segments;
+    for (auto sample : used) {
+        for (size_t i = 0; i + KMER <= sample.size(); i += SEGMENT / 2) {
+            segments.push_back({sample.substr(i, SEGMENT), 0});
+        }
+    }
+    auto byScore = [&](size_t a, size_t b) { return segments[a].score < segments[b].score; };
+    std::priority_queue<size_t, std::vector<size_t>, decltype(byScore)> queue(byScore);
+    for (size_t i = 0; i < segments.size(); ++i) {
+        segments[i].score = score(segments[i].text);
+        if (segments[i].score > 0) {
+            queue.push(i);
+        }
+    }
+
+    // Lazy greedy cover: a popped segment is rescored, since earlier picks may have
+    // covered its substrings, and taken only if it still beats the next best
+    std::vector<std::string_view> picked;
+    size_t total = 0;
+    while (!queue.empty() && total < capacity) {
+        size_t top = queue.top();
+        queue.pop();
+        uint64_t current = score(segments[top].text);
+        if (current == 0) {
+            continue;
+        }
+        if (!queue.empty() && current < segments[queue.top()].score) {
+            segments[top].score = current;
+            queue.push(top);
+            continue;
+        }
+        const auto& text = segments[top].text;
+        for (size_t i = 0; i + KMER <= text.size(); ++i) {
+            frequency.erase(read64(text.data() + i));
+        }
+        picked.push_back(text);
+        total += text.size();
+    }
+
+    std::string dictionary;
+    dictionary.reserve(total);
+    for (auto it = picked.rbegin(); it != picked.rend(); ++it) {
+        dictionary.append(*it);
+    }
+    if (dictionary.size() > capacity) {
+        dictionary.erase(0, dictionary.size() - capacity);
+    }
+    return dictionary;
+}
+
+} // namespace amb
\ No newline at end of file
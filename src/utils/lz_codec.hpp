@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace amb {
+
+// Built-in LZ77 block codec, byte oriented like LZ4: sequences of literals and
+// (16-bit offset, length) matches, decoded with plain copies. A preset dictionary acts
+// as history before the block, which is what lets small source files compress.
+
+constexpr size_t LZ_MAX_DICTIONARY = 65535;  // matches reach back at most this far
+
+std::string lzCompress(std::string_view input, std::string_view dictionary = {});
+
+// `size` is the decoded size recorded by the caller. Returns nullopt on corrupt input.
+std::optional<std::string> lzDecompress(std::string_view block, size_t size, std::string_view dictionary = {});
+// Same, into `size` bytes at `out`; false on corrupt input
+bool lzDecompress(std::string_view block, char* out, size_t size, std::string_view dictionary = {});
+
+// Builds a dictionary of at most `capacity` bytes from the segments that recur across
+// the most samples (a greedy cover of their 8-byte substrings). The most useful
+// segments end up last, nearest the data.
+std::string lzTrainDictionary(const std::vector<std::string_view>& samples, size_t capacity = 32 * 1024);
+
+} // namespace amb
\ No newline at end of file
@@ -0,0 +1,113 @@
+#include "utils/mapped_file.hpp"
+#include "utils/logger.hpp"
+
+#include <cerrno>
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace amb {
+
+MappedFile::~MappedFile() {
+    release();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        release();
+        data_ = other.data_;
+        size_ = other.size_;
+        other.data_ = nullptr;
+        other.size_ = 0;
+#ifdef _WIN32
+        mapping_ = other.mapping_;
+        other.mapping_ = nullptr;
+#endif
+    }
+    return *this;
+}
+
+void MappedFile::release() {
+    if (!data_) {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(data_);
+    CloseHandle(mapping_);
+    mapping_ = nullptr;
+#else
+    ::munmap(const_cast<void*>(data_), size_);
+#endif
+    data_ = nullptr;
+    size_ = 0;
+}
+
+std::optional<MappedFile> MappedFile::open(const fs::path& path) {
+    MappedFile file;
+#ifdef _WIN32
+    HANDLE handle = CreateFileW(path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE,
+                                nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        Logger::error("Cannot open {}", path.string());
+        return std::nullopt;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(handle, &size) || size.QuadPart == 0) {
+        CloseHandle(handle);
+        Logger::error("Cannot map {}: empty or unreadable", path.string());
+        return std::nullopt;
+    }
+    // The mapping keeps the file open on its own
+    HANDLE mapping = CreateFileMappingW(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(handle);
+    if (!mapping) {
+        Logger::error("Cannot map {}", path.string());
+        return std::nullopt;
+    }
+    const void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!data) {
+        CloseHandle(mapping);
+        Logger::error("Cannot map {}", path.string());
+        return std::nullopt;
+    }
+    file.mapping_ = mapping;
+    file.data_ = data;
+    file.size_ = static_cast<size_t>(size.QuadPart);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        Logger::error("Cannot open {}: {}", path.string(), std::strerror(errno));
+        return std::nullopt;
+    }
+    struct stat st {};
+    if (::fstat(fd, &st) != 0 || st.st_size == 0) {
+        ::close(fd);
+        Logger::error("Cannot map {}: empty or unreadable", path.string());
+        return std::nullopt;
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+    void* data = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    // The mapping keeps the file open on its own
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        Logger::error("Cannot map {}: {}", path.string(), std::strerror(errno));
+        return std::nullopt;
+    }
+    file.data_ = data;
+    file.size_ = size;
+#endif
+    return file;
+}
+
+} // namespace amb
\ No newline at end of file
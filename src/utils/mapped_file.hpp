@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <string_view>
+
+namespace amb {
+
+namespace fs = std::filesystem;
+
+// Read-only memory mapping of a whole file (mmap on POSIX, a file mapping on Windows).
+// Pages are read on first touch, so opening a large file costs no I/O by itself.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // nullopt when the file cannot be opened or mapped
+    static std::optional<MappedFile> open(const fs::path& path);
+
+    std::string_view data() const { return {static_cast<const char*>(data_), size_}; }
+    size_t size() const { return size_; }
+
+private:
+    void release();
+
+    const void* data_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    void* mapping_ = nullptr;
+#endif
+};
+
+} // namespace amb
\ No newline at end of file
@@ -0,0 +1,114 @@
+#include "utils/process.hpp"
+#include "utils/filesystem.hpp"
+#include "utils/logger.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+#endif
+
+namespace amb {
+
+#ifdef _WIN32
+
+ProcessResult Process::runShell(const std::string& command, const fs::path& cwd,
+                                const fs::path& log,
+                                const std::map<std::string, std::string>& env) {
+    ProcessResult result;
+    auto start = std::chrono::steady_clock::now();
+
+    // cmd.exe has no per-command environment, so variables are set inline
+    std::string line = "cd /d \"" + cwd.string() + "\"";
+    for (const auto& [key, value] : env) {
+        line += " && set \"" + key + "=" + value + "\"";
+    }
+    line += " && (" + command + ") >> \"" + log.string() + "\" 2>&1";
+    result.exitCode = std::system(line.c_str());
+
+    result.duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+    // The command may have changed any file
+    FileSystem::invalidateAll();
+    return result;
+}
+
+#else
+
+ProcessResult Process::runShell(const std::string& command, const fs::path& cwd,
+                                const fs::path& log,
+                                const std::map<std::string, std::string>& env) {
+    ProcessResult result;
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::string> variables;
+    for (char** entry = environ; *entry; ++entry) {
+        std::string variable(*entry);
+        auto eq = variable.find('=');
+        if (eq != std::string::npos && env.count(variable.substr(0, eq))) {
+            continue;
+        }
+        variables.push_back(std::move(variable));
+    }
+    for (const auto& [key, value] : env) {
+        variables.push_back(key + "=" + value);
+    }
+    std::vector<char*> envp;
+    for (auto& variable : variables) {
+        envp.push_back(variable.data());
+    }
+    envp.push_back(nullptr);
+
+    // The working directory is changed by the shell: posix_spawn has no portable chdir
+    std::string script = "cd \"$AMB_HOOK_CWD\" && " + command;
+    std::string cwdVariable = "AMB_HOOK_CWD=" + cwd.string();
+    envp.insert(envp.end() - 1, cwdVariable.data());
+
+    std::string shell = "/bin/sh";
+    std::string flag = "-c";
+    char* argv[] = {shell.data(), flag.data(), script.data(), nullptr};
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+    posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, log.c_str(),
+                                     O_WRONLY | O_CREAT | O_APPEND, 0644);
+    posix_spawn_file_actions_adddup2(&actions, STDOUT_FILENO, STDERR_FILENO);
+
+    pid_t pid = 0;
+    int rc = posix_spawn(&pid, shell.c_str(), &actions, nullptr, argv, envp.data());
+    posix_spawn_file_actions_destroy(&actions);
+
+    if (rc != 0) {
+        Logger::error("Failed to start '{}': {}", command, std::strerror(rc));
+    } else {
+        int status = 0;
+        while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {
+        }
+        if (WIFEXITED(status)) {
+            result.exitCode = WEXITSTATUS(status);
+        } else if (WIFSIGNALED(status)) {
+            result.exitCode = 128 + WTERMSIG(status);
+        }
+    }
+
+    result.duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+    // The command may have changed any file
+    FileSystem::invalidateAll();
+    return result;
+}
+
+#endif
+
+} // namespace amb
\ No newline at end of file
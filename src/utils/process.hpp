@@ -0,0 +1,27 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <map>
+#include <string>
+
+namespace amb {
+
+namespace fs = std::filesystem;
+
+struct ProcessResult {
+    int exitCode = -1;                        // -1 when the process could not be started
+    std::chrono::milliseconds duration{0};
+};
+
+// Runs shell commands (manifest scripts) outside the amb process
+class Process {
+public:
+    // Runs `command` through the platform shell in `cwd`, appending stdout and stderr to
+    // `log`. `env` is added to the inherited environment. Safe to call from several threads.
+    static ProcessResult runShell(const std::string& command, const fs::path& cwd,
+                                  const fs::path& log,
+                                  const std::map<std::string, std::string>& env = {});
+};
+
+} // namespace amb
\ No newline at end of file
@@ -0,0 +1,82 @@
+#include "utils/resource_usage.hpp"
+
+#include <atomic>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#include <fstream>
+#include <string>
+#endif
+
+namespace amb {
+
+namespace {
+
+std::atomic<uint64_t> counters[ResourceUsage::COUNTERS];
+
+#ifdef _WIN32
+double seconds(const FILETIME& time) {
+    ULARGE_INTEGER value;
+    value.LowPart = time.dwLowDateTime;
+    value.HighPart = time.dwHighDateTime;
+    return static_cast<double>(value.QuadPart) / 1e7;  // 100ns units
+}
+#endif
+
+} // namespace
+
+ResourceUsage ResourceUsage::sample() {
+    ResourceUsage usage;
+#ifdef _WIN32
+    HANDLE process = GetCurrentProcess();
+    FILETIME created, exited, kernel, user;
+    if (GetProcessTimes(process, &created, &exited, &kernel, &user)) {
+        usage.cpuSeconds = seconds(kernel) + seconds(user);
+    }
+    PROCESS_MEMORY_COUNTERS memory;
+    if (GetProcessMemoryInfo(process, &memory, sizeof(memory))) {
+        usage.peakRssBytes = memory.PeakWorkingSetSize;
+    }
+    IO_COUNTERS io;
+    if (GetProcessIoCounters(process, &io)) {
+        usage.bytesRead = io.ReadTransferCount;
+        usage.bytesWritten = io.WriteTransferCount;
+    }
+#else
+    rusage ru{};
+    if (getrusage(RUSAGE_SELF, &ru) == 0) {
+        usage.cpuSeconds = static_cast<double>(ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) +
+                           static_cast<double>(ru.ru_utime.tv_usec + ru.ru_stime.tv_usec) / 1e6;
+#ifdef __APPLE__
+        usage.peakRssBytes = static_cast<uint64_t>(ru.ru_maxrss);         // bytes
+#else
+        usage.peakRssBytes = static_cast<uint64_t>(ru.ru_maxrss) * 1024;  // kilobytes
+#endif
+    }
+    // Linux only: characters passed through read/write calls, cache hits included
+    std::ifstream io("/proc/self/io");
+    std::string key;
+    uint64_t value = 0;
+    while (io >> key >> value) {
+        if (key == "rchar:") {
+            usage.bytesRead = value;
+        } else if (key == "wchar:") {
+            usage.bytesWritten = value;
+        }
+    }
+#endif
+    return usage;
+}
+
+void ResourceUsage::add(Counter counter, uint64_t amount) {
+    counters[static_cast<size_t>(counter)].fetch_add(amount, std::memory_order_relaxed);
+}
+
+uint64_t ResourceUsage::count(Counter counter) {
+    return counters[static_cast<size_t>(counter)].load(std::memory_order_relaxed);
+}
+
+} // namespace amb
\ No newline at end of file
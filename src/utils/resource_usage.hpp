@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace amb {
+
+// What the running process has cost so far, recorded per command for `amb stats`
+struct ResourceUsage {
+    double cpuSeconds = 0;       // user + system
+    uint64_t peakRssBytes = 0;
+    uint64_t bytesRead = 0;      // I/O the OS attributes to the process; 0 where unknown
+    uint64_t bytesWritten = 0;
+
+    static ResourceUsage sample();
+
+    // Process-wide counters bumped by the components doing the work
+    enum class Counter {
+        NETWORK_RECEIVED,     // bytes read from registry sockets
+        NETWORK_SENT,
+        ARCHIVE_DOWNLOADS,    // fetch jobs that hit the transport
+        ARCHIVE_CACHE_HITS,   // fetch jobs satisfied by the local cache
+        BUILD_CACHE_HITS,
+        BUILD_CACHE_MISSES,
+    };
+    static constexpr size_t COUNTERS = 6;
+
+    static void add(Counter counter, uint64_t amount = 1);
+    static uint64_t count(Counter counter);
+};
+
+} // namespace amb
\ No newline at end of file
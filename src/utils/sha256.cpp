@@ -0,0 +1,267 @@
+#include "utils/sha256.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define AMB_SHA256_X86 1
+#include <immintrin.h>
+#endif
+
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace amb {
+
+namespace {
+
+constexpr std::array<uint32_t, 64> K = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+inline uint32_t rotr(uint32_t x, uint32_t n) {
+    return (x >> n) | (x << (32 - n));
+}
+
+#ifdef AMB_SHA256_X86
+// SHA extensions (Goldmont, Zen and later): roughly 5-8x the portable rounds, which is
+// what lets bulk verification keep up with the disk. State is kept as ABEF/CDGH pairs.
+__attribute__((target("sha,sse4.1")))
+void transformShaNi(uint32_t* state, const uint8_t* data, size_t blocks) {
+    const __m128i byteSwap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+    __m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state)), 0xB1);
+    __m128i state1 = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state + 4)), 0x1B);
+    __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);
+    state1 = _mm_blend_epi16(state1, tmp, 0xF0);
+
+    for (; blocks > 0; --blocks, data += 64) {
+        __m128i abef = state0;
+        __m128i cdgh = state1;
+        __m128i msg[4];
+
+        for (size_t i = 0; i < 16; ++i) {
+            if (i < 4) {
+                msg[i] = _mm_shuffle_epi8(
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i * 16)), byteSwap);
+            } else {
+                // W[t..t+3] from W[t-16..t-13], W[t-15..t-12], W[t-7..t-4] and W[t-4..t-1]
+                __m128i next = _mm_sha256msg1_epu32(msg[i % 4], msg[(i + 1) % 4]);
+                next = _mm_add_epi32(next, _mm_alignr_epi8(msg[(i + 3) % 4], msg[(i + 2) % 4], 4));
+                msg[i % 4] = _mm_sha256msg2_epu32(next, msg[(i + 3) % 4]);
+            }
+            __m128i rounds = _mm_add_epi32(msg[i % 4],
+                                           _mm_loadu_si128(reinterpret_cast<const __m128i*>(&K[i * 4])));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, rounds);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(rounds, 0x0E));
+        }
+
+        state0 = _mm_add_epi32(state0, abef);
+        state1 = _mm_add_epi32(state1, cdgh);
+    }
+
+    tmp = _mm_shuffle_epi32(state0, 0x1B);
+    state1 = _mm_shuffle_epi32(state1, 0xB1);
+    state0 = _mm_blend_epi16(tmp, state1, 0xF0);
+    state1 = _mm_alignr_epi8(state1, tmp, 8);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state), state0);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state + 4), state1);
+}
+
+bool hasShaNi() {
+    static const bool supported = __builtin_cpu_supports("sha") && __builtin_cpu_supports("sse4.1");
+    return supported;
+}
+#endif
+
+} // namespace
+
+Sha256::Sha256() {
+    reset();
+}
+
+void Sha256::reset() {
+    state_ = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+              0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+    bufferSize_ = 0;
+    length_ = 0;
+}
+
+void Sha256::transform(const uint8_t* block, size_t blocks) {
+#ifdef AMB_SHA256_X86
+    if (hasShaNi()) {
+        transformShaNi(state_.data(), block, blocks);
+        return;
+    }
+#endif
+    for (; blocks > 0; --blocks, block += 64) {
+        transformPortable(block);
+    }
+}
+
+void Sha256::transformPortable(const uint8_t* block) {
+    std::array<uint32_t, 64> w{};
+    for (size_t i = 0; i < 16; ++i) {
+        w[i] = (uint32_t(block[i * 4]) << 24) | (uint32_t(block[i * 4 + 1]) << 16) |
+               (uint32_t(block[i * 4 + 2]) << 8) | uint32_t(block[i * 4 + 3]);
+    }
+    for (size_t i = 16; i < 64; ++i) {
+        uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = state_[0], b = state_[1], c = state_[2], d = state_[3];
+    uint32_t e = state_[4], f = state_[5], g = state_[6], h = state_[7];
+
+    for (size_t i = 0; i < 64; ++i) {
+        uint32_t S1 = rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25);
+        uint32_t ch = (e & f) ^ (~e & g);
+        uint32_t t1 = h + S1 + ch + K[i] + w[i];
+        uint32_t S0 = rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22);
+        uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+        uint32_t t2 = S0 + maj;
+        h = g; g = f; f = e; e = d + t1;
+        d = c; c = b; b = a; a = t1 + t2;
+    }
+
+    state_[0] += a; state_[1] += b; state_[2] += c; state_[3] += d;
+    state_[4] += e; state_[5] += f; state_[6] += g; state_[7] += h;
+}
+
+void Sha256::update(const void* data, size_t size) {
+    auto bytes = static_cast<const uint8_t*>(data);
+    length_ += size;
+
+    if (bufferSize_ > 0) {
+        size_t take = std::min(size, buffer_.size() - bufferSize_);
+        std::memcpy(buffer_.data() + bufferSize_, bytes, take);
+        bufferSize_ += take;
+        bytes += take;
+        size -= take;
+        if (bufferSize_ < buffer_.size()) {
+            return;
+        }
+        transform(buffer_.data(), 1);
+        bufferSize_ = 0;
+    }
+
+    if (size >= 64) {
+        transform(bytes, size / 64);
+        bytes += size / 64 * 64;
+        size %= 64;
+    }
+
+    if (size > 0) {
+        std::memcpy(buffer_.data(), bytes, size);
+        bufferSize_ = size;
+    }
+}
+
+Sha256::Digest Sha256::digest() {
+    uint64_t bitLength = length_ * 8;
+
+    uint8_t pad = 0x80;
+    update(&pad, 1);
+    uint8_t zero = 0;
+    while (bufferSize_ != 56) {
+        update(&zero, 1);
+    }
+
+    std::array<uint8_t, 8> lengthBytes{};
+    for (size_t i = 0; i < 8; ++i) {
+        lengthBytes[i] = static_cast<uint8_t>(bitLength >> (56 - i * 8));
+    }
+    update(lengthBytes.data(), lengthBytes.size());
+
+    Digest out{};
+    for (size_t i = 0; i < 8; ++i) {
+        out[i * 4] = static_cast<uint8_t>(state_[i] >> 24);
+        out[i * 4 + 1] = static_cast<uint8_t>(state_[i] >> 16);
+        out[i * 4 + 2] = static_cast<uint8_t>(state_[i] >> 8);
+        out[i * 4 + 3] = static_cast<uint8_t>(state_[i]);
+    }
+    return out;
+}
+
+std::string Sha256::hexDigest() {
+    auto d = digest();
+    return toHex(d.data(), d.size());
+}
+
+std::string Sha256::toHex(const uint8_t* data, size_t size) {
+    static const char* digits = "0123456789abcdef";
+    std::string hex(size * 2, '0');
+    for (size_t i = 0; i < size; ++i) {
+        hex[i * 2] = digits[data[i] >> 4];
+        hex[i * 2 + 1] = digits[data[i] & 0x0f];
+    }
+    return hex;
+}
+
+std::string Sha256::hash(std::string_view data) {
+    Sha256 hasher;
+    hasher.update(data);
+    return hasher.hexDigest();
+}
+
+std::string Sha256::hashFile(const fs::path& path) {
+    Sha256 hasher;
+    std::vector<char> buffer(1 << 20);
+
+#ifdef _WIN32
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return "";
+    }
+    while (file) {
+        file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        auto got = file.gcount();
+        if (got > 0) {
+            hasher.update(buffer.data(), static_cast<size_t>(got));
+        }
+    }
+    if (file.bad()) {
+        return "";
+    }
+#else
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return "";
+    }
+#ifdef POSIX_FADV_SEQUENTIAL
+    // Doubles the kernel readahead window; verification reads whole files once
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+    while (true) {
+        ssize_t got = ::read(fd, buffer.data(), buffer.size());
+        if (got < 0 && errno == EINTR) {
+            continue;
+        }
+        if (got < 0) {
+            ::close(fd);
+            return "";
+        }
+        if (got == 0) {
+            break;
+        }
+        hasher.update(buffer.data(), static_cast<size_t>(got));
+    }
+    ::close(fd);
+#endif
+    return hasher.hexDigest();
+}
+
+} // namespace amb
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+namespace amb {
+
+namespace fs = std::filesystem;
+
+// Incremental SHA-256 (FIPS 180-4)
+class Sha256 {
+public:
+    using Digest = std::array<uint8_t, 32>;
+
+    Sha256();
+
+    void update(const void* data, size_t size);
+    void update(std::string_view data) { update(data.data(), data.size()); }
+
+    // Finalizes the hash; the object must be reset() before reuse
+    Digest digest();
+    std::string hexDigest();
+    void reset();
+
+    // One-shot helpers
+    static std::string hash(std::string_view data);
+    static std::string hashFile(const fs::path& path); // empty on failure
+    static std::string toHex(const uint8_t* data, size_t size);
+
+private:
+    // Processes `blocks` consecutive 64-byte blocks (SHA-NI when the CPU has it)
+    void transform(const uint8_t* block, size_t blocks);
+    void transformPortable(const uint8_t* block);
+
+    std::array<uint32_t, 8> state_{};
+    std::array<uint8_t, 64> buffer_{};
+    size_t bufferSize_ = 0;
+    uint64_t length_ = 0;
+};
+
+} // namespace amb
\ No newline at end of file